@@ -4,6 +4,9 @@ import { GoogleSignin } from '@react-native-google-signin/google-signin';
 import { AppProvider } from './src/utils/AppContext';
 import AppNavigator from './src/navigation/AppNavigator';
 import { name as appName } from './app.json';
+import { recoverMergeJournals } from './src/services/AudioRecordingService';
+import MetricsService from './src/services/MetricsService';
+import { recoverTasks } from './src/services/TaskRecoveryService';
 
 const App = () => {
   useEffect(() => {
@@ -15,6 +18,13 @@ const App = () => {
       ],
     });
     console.log('[App] Google Sign-In configured at app startup');
+
+    // Finish segment cleanup that a crash interrupted after a merge, then
+    // reconcile the background tasks persisted by the last launch
+    recoverMergeJournals().then(() => recoverTasks());
+
+    // Keep a daily record of the runtime metrics when PERSIST_METRICS is set
+    MetricsService.start();
   }, []);
 
   return (
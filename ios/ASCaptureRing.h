@@ -0,0 +1,228 @@
+// ios/ASCaptureRing.h
+// Capture ring: a single-producer/single-consumer ring of mono float frames
+// between the audio input callback and a writer thread that drains it.
+//
+// The producer side (ASCaptureRingPush) is wait-free: it never blocks, locks,
+// allocates or makes a system call. Frames that do not fit are dropped and
+// counted. The writer wakes on a fixed period and hands contiguous runs of
+// frames to its sink (encode + write), so a sink may stall for as long as the
+// free part of the ring lasts without losing audio: the stall budget.
+//
+// Plain C11 and header-only, so the Linux stress test
+// (scripts/stressCaptureRing.js) builds exactly this code.
+
+#ifndef ASCaptureRing_h
+#define ASCaptureRing_h
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __APPLE__
+#include <pthread/qos.h>
+#endif
+
+typedef struct {
+    float *frames;
+    size_t capacity; // power of two
+    size_t mask;
+    _Atomic uint64_t writeIndex; // advanced by the producer only
+    _Atomic uint64_t readIndex;  // advanced by the consumer only
+    // Stats written by the producer only (plain load + store, no read-modify-write)
+    _Atomic uint64_t pushedFrames;
+    _Atomic uint64_t droppedFrames;
+    _Atomic uint64_t overruns;
+    _Atomic uint64_t highWaterFrames;
+} ASCaptureRing;
+
+typedef struct {
+    uint64_t capacityFrames;
+    uint64_t highWaterFrames;
+    uint64_t pushedFrames;
+    uint64_t droppedFrames;
+    uint64_t overruns;
+    uint64_t writtenFrames;
+    uint64_t maxSinkNanos;
+    int sinkError;
+} ASCaptureStats;
+
+// Smallest power-of-two capacity that holds `budgetSeconds` of audio on top of
+// one callback's worth of frames.
+static inline size_t ASCaptureRingCapacityForBudget(double sampleRate, double budgetSeconds, size_t callbackFrames) {
+    size_t needed = (size_t)(sampleRate * budgetSeconds) + callbackFrames;
+    size_t capacity = 1024;
+    while (capacity < needed) capacity <<= 1;
+    return capacity;
+}
+
+// Seconds the writer can stall before the ring overflows
+static inline double ASCaptureRingStallBudget(const ASCaptureRing *ring, double sampleRate, size_t callbackFrames) {
+    return ring->capacity > callbackFrames ? (double)(ring->capacity - callbackFrames) / sampleRate : 0;
+}
+
+static inline bool ASCaptureRingInit(ASCaptureRing *ring, size_t capacity) {
+    memset(ring, 0, sizeof(*ring));
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+    ring->frames = calloc(capacity, sizeof(float));
+    if (!ring->frames) return false;
+    // Touch every page now, so the producer never takes a page fault on its first lap
+    volatile float *touch = ring->frames;
+    for (size_t i = 0; i < capacity; i += 1024) touch[i] = 0;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+    return true;
+}
+
+static inline void ASCaptureRingDestroy(ASCaptureRing *ring) {
+    free(ring->frames);
+    ring->frames = NULL;
+}
+
+static inline void ASCaptureRingAddStat(_Atomic uint64_t *stat, uint64_t value) {
+    atomic_store_explicit(stat, atomic_load_explicit(stat, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+// Producer: copies what fits and returns the number of frames accepted
+static inline size_t ASCaptureRingPush(ASCaptureRing *ring, const float *frames, size_t count) {
+    uint64_t write = atomic_load_explicit(&ring->writeIndex, memory_order_relaxed);
+    uint64_t read = atomic_load_explicit(&ring->readIndex, memory_order_acquire);
+    size_t used = (size_t)(write - read);
+    size_t space = ring->capacity - used;
+    size_t accepted = count < space ? count : space;
+
+    size_t start = (size_t)(write & ring->mask);
+    size_t first = accepted < ring->capacity - start ? accepted : ring->capacity - start;
+    if (first > 0) memcpy(ring->frames + start, frames, first * sizeof(float));
+    if (accepted > first) memcpy(ring->frames, frames + first, (accepted - first) * sizeof(float));
+    atomic_store_explicit(&ring->writeIndex, write + accepted, memory_order_release);
+
+    ASCaptureRingAddStat(&ring->pushedFrames, accepted);
+    if (used + accepted > atomic_load_explicit(&ring->highWaterFrames, memory_order_relaxed)) {
+        atomic_store_explicit(&ring->highWaterFrames, used + accepted, memory_order_relaxed);
+    }
+    if (accepted < count) {
+        ASCaptureRingAddStat(&ring->overruns, 1);
+        ASCaptureRingAddStat(&ring->droppedFrames, count - accepted);
+    }
+    return accepted;
+}
+
+// Consumer: the next contiguous run of readable frames (0 when empty)
+static inline size_t ASCaptureRingPeek(ASCaptureRing *ring, const float **frames) {
+    uint64_t read = atomic_load_explicit(&ring->readIndex, memory_order_relaxed);
+    uint64_t write = atomic_load_explicit(&ring->writeIndex, memory_order_acquire);
+    size_t available = (size_t)(write - read);
+    size_t start = (size_t)(read & ring->mask);
+    size_t run = ring->capacity - start;
+    *frames = ring->frames + start;
+    return available < run ? available : run;
+}
+
+static inline void ASCaptureRingConsume(ASCaptureRing *ring, size_t count) {
+    uint64_t read = atomic_load_explicit(&ring->readIndex, memory_order_relaxed);
+    atomic_store_explicit(&ring->readIndex, read + count, memory_order_release);
+}
+
+// --- Writer thread ---
+
+// Encodes/writes `count` frames; returns 0 on success. Runs on the writer thread only.
+typedef int (*ASCaptureSink)(void *context, const float *frames, size_t count);
+
+typedef struct {
+    ASCaptureRing *ring;
+    ASCaptureSink sink;
+    void *context;
+    uint32_t periodMicros;
+    pthread_t thread;
+    _Atomic bool running;
+    _Atomic int sinkError;
+    _Atomic uint64_t writtenFrames;
+    _Atomic uint64_t maxSinkNanos;
+} ASCaptureWriter;
+
+static inline uint64_t ASCaptureNowNanos(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+// Drains everything readable. After a sink error the frames are still consumed
+// (and not written), so the producer never backs up behind a dead sink.
+static inline void ASCaptureWriterDrain(ASCaptureWriter *writer) {
+    const float *frames;
+    size_t count;
+    while ((count = ASCaptureRingPeek(writer->ring, &frames)) > 0) {
+        if (atomic_load_explicit(&writer->sinkError, memory_order_relaxed) == 0) {
+            uint64_t start = ASCaptureNowNanos();
+            int error = writer->sink(writer->context, frames, count);
+            uint64_t elapsed = ASCaptureNowNanos() - start;
+            if (elapsed > atomic_load_explicit(&writer->maxSinkNanos, memory_order_relaxed)) {
+                atomic_store_explicit(&writer->maxSinkNanos, elapsed, memory_order_relaxed);
+            }
+            if (error != 0) {
+                atomic_store_explicit(&writer->sinkError, error, memory_order_relaxed);
+            } else {
+                ASCaptureRingAddStat(&writer->writtenFrames, count);
+            }
+        }
+        ASCaptureRingConsume(writer->ring, count);
+    }
+}
+
+static inline void *ASCaptureWriterMain(void *argument) {
+    ASCaptureWriter *writer = argument;
+    struct timespec period = { writer->periodMicros / 1000000, (long)(writer->periodMicros % 1000000) * 1000 };
+    for (;;) {
+        // Read the flag before draining, so the last pass sees every frame pushed before stop
+        bool running = atomic_load_explicit(&writer->running, memory_order_acquire);
+        ASCaptureWriterDrain(writer);
+        if (!running) break;
+        nanosleep(&period, NULL);
+    }
+    return NULL;
+}
+
+static inline int ASCaptureWriterStart(ASCaptureWriter *writer, ASCaptureRing *ring, ASCaptureSink sink,
+                                       void *context, uint32_t periodMicros) {
+    memset(writer, 0, sizeof(*writer));
+    writer->ring = ring;
+    writer->sink = sink;
+    writer->context = context;
+    writer->periodMicros = periodMicros > 0 ? periodMicros : 10000;
+    atomic_store_explicit(&writer->running, true, memory_order_release);
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+#ifdef __APPLE__
+    pthread_attr_set_qos_class_np(&attributes, QOS_CLASS_USER_INITIATED, 0);
+#endif
+    int result = pthread_create(&writer->thread, &attributes, ASCaptureWriterMain, writer);
+    pthread_attr_destroy(&attributes);
+    if (result != 0) atomic_store_explicit(&writer->running, false, memory_order_release);
+    return result;
+}
+
+// Stops the thread after a final drain; the sink sees every accepted frame
+static inline void ASCaptureWriterStop(ASCaptureWriter *writer) {
+    if (!atomic_exchange_explicit(&writer->running, false, memory_order_acq_rel)) return;
+    pthread_join(writer->thread, NULL);
+}
+
+static inline ASCaptureStats ASCaptureStatsRead(ASCaptureRing *ring, ASCaptureWriter *writer) {
+    ASCaptureStats stats = {
+        .capacityFrames = ring->capacity,
+        .highWaterFrames = atomic_load_explicit(&ring->highWaterFrames, memory_order_relaxed),
+        .pushedFrames = atomic_load_explicit(&ring->pushedFrames, memory_order_relaxed),
+        .droppedFrames = atomic_load_explicit(&ring->droppedFrames, memory_order_relaxed),
+        .overruns = atomic_load_explicit(&ring->overruns, memory_order_relaxed),
+        .writtenFrames = writer ? atomic_load_explicit(&writer->writtenFrames, memory_order_relaxed) : 0,
+        .maxSinkNanos = writer ? atomic_load_explicit(&writer->maxSinkNanos, memory_order_relaxed) : 0,
+        .sinkError = writer ? atomic_load_explicit(&writer->sinkError, memory_order_relaxed) : 0,
+    };
+    return stats;
+}
+
+#endif /* ASCaptureRing_h */
@@ -0,0 +1,158 @@
+// ios/ASJSONBody.h
+// Request body writer for the JSON API uploads (summaries, titles). The body is
+// a cached prefix holding the static fields, already serialized, then one large
+// string field (the transcript or summary) escaped straight into the upload
+// file, then the closing brace. The text is never assembled into a JSON string
+// in memory, on either side of the bridge. Optionally the output is gzipped on
+// the way out (Content-Encoding: gzip) for endpoints that accept it.
+//
+// Output goes through a 64 KiB buffer into a file descriptor; zlib runs on
+// whole buffers. Plain C11 and header-only, so the Linux benchmark
+// (scripts/benchmarkRequestBody.js) builds exactly this code. Link with -lz.
+
+#ifndef ASJSONBody_h
+#define ASJSONBody_h
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define AS_JSON_BODY_BUFFER (64 * 1024)
+
+typedef struct {
+    int fd;
+    bool gzip;
+    z_stream zs;
+    uint8_t *buffer; // uncompressed bytes waiting to be written or deflated
+    size_t fill;
+    uint8_t *deflated; // gzip only
+    uint64_t rawBytes; // JSON bytes
+    uint64_t wireBytes; // bytes written to the file
+    int error; // errno of the first failure, or -1 for a zlib failure
+    // Optional: sees the JSON bytes in order before compression (set after opening)
+    void (*observe)(void *context, const uint8_t *bytes, size_t length);
+    void *observeContext;
+} ASJSONBodyWriter;
+
+static inline bool ASJSONBodyWriteFully(ASJSONBodyWriter *writer, const uint8_t *bytes, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(writer->fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            writer->error = errno;
+            return false;
+        }
+        bytes += written;
+        length -= (size_t)written;
+        writer->wireBytes += (uint64_t)written;
+    }
+    return true;
+}
+
+// gzip level: 1 is several times faster than the default 6 for a few percent more bytes on text
+static inline bool ASJSONBodyWriterOpen(ASJSONBodyWriter *writer, int fd, bool gzip, int level) {
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = fd;
+    writer->gzip = gzip;
+    writer->buffer = malloc(AS_JSON_BODY_BUFFER);
+    if (!writer->buffer) return false;
+    if (gzip) {
+        writer->deflated = malloc(AS_JSON_BODY_BUFFER);
+        // windowBits 15 + 16: a gzip header and trailer around the deflate stream
+        if (!writer->deflated || deflateInit2(&writer->zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            free(writer->deflated);
+            free(writer->buffer);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Hands the buffered bytes to the file, through zlib when compressing
+static inline bool ASJSONBodyDrain(ASJSONBodyWriter *writer, bool finish) {
+    if (writer->error) return false;
+    if (writer->observe && writer->fill > 0) writer->observe(writer->observeContext, writer->buffer, writer->fill);
+    if (!writer->gzip) {
+        bool ok = ASJSONBodyWriteFully(writer, writer->buffer, writer->fill);
+        writer->fill = 0;
+        return ok;
+    }
+    writer->zs.next_in = writer->buffer;
+    writer->zs.avail_in = (uInt)writer->fill;
+    int status;
+    do {
+        writer->zs.next_out = writer->deflated;
+        writer->zs.avail_out = AS_JSON_BODY_BUFFER;
+        status = deflate(&writer->zs, finish ? Z_FINISH : Z_NO_FLUSH);
+        if (status == Z_STREAM_ERROR) {
+            writer->error = -1;
+            return false;
+        }
+        if (!ASJSONBodyWriteFully(writer, writer->deflated, AS_JSON_BODY_BUFFER - writer->zs.avail_out)) return false;
+    } while (writer->zs.avail_out == 0 || (finish && status != Z_STREAM_END));
+    writer->fill = 0;
+    return true;
+}
+
+static inline bool ASJSONBodyAppend(ASJSONBodyWriter *writer, const void *bytes, size_t length) {
+    const uint8_t *cursor = bytes;
+    writer->rawBytes += length;
+    while (length > 0) {
+        size_t count = AS_JSON_BODY_BUFFER - writer->fill;
+        if (count > length) count = length;
+        memcpy(writer->buffer + writer->fill, cursor, count);
+        writer->fill += count;
+        cursor += count;
+        length -= count;
+        if (writer->fill == AS_JSON_BODY_BUFFER && !ASJSONBodyDrain(writer, false)) return false;
+    }
+    return !writer->error;
+}
+
+// Appends UTF-8 text as the inside of a JSON string: quotes, backslashes and
+// control characters escaped, everything else (including non-ASCII) copied in runs
+static inline bool ASJSONBodyAppendEscaped(ASJSONBodyWriter *writer, const uint8_t *text, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = text[i];
+        if (byte >= 0x20 && byte != '"' && byte != '\\') continue;
+        if (i > run && !ASJSONBodyAppend(writer, text + run, i - run)) return false;
+        char escape[6] = { '\\', 0, 0, 0, 0, 0 };
+        size_t escapeLength = 2;
+        switch (byte) {
+            case '"': escape[1] = '"'; break;
+            case '\\': escape[1] = '\\'; break;
+            case '\n': escape[1] = 'n'; break;
+            case '\r': escape[1] = 'r'; break;
+            case '\t': escape[1] = 't'; break;
+            case '\b': escape[1] = 'b'; break;
+            case '\f': escape[1] = 'f'; break;
+            default:
+                memcpy(escape + 1, "u00", 3);
+                escape[4] = hex[byte >> 4];
+                escape[5] = hex[byte & 0xf];
+                escapeLength = 6;
+        }
+        if (!ASJSONBodyAppend(writer, escape, escapeLength)) return false;
+        run = i + 1;
+    }
+    return length > run ? ASJSONBodyAppend(writer, text + run, length - run) : !writer->error;
+}
+
+// Flushes everything (and the gzip trailer) and frees the buffers; false if any write failed
+static inline bool ASJSONBodyWriterClose(ASJSONBodyWriter *writer) {
+    bool ok = ASJSONBodyDrain(writer, true);
+    if (writer->gzip) deflateEnd(&writer->zs);
+    free(writer->deflated);
+    free(writer->buffer);
+    writer->deflated = NULL;
+    writer->buffer = NULL;
+    return ok && !writer->error;
+}
+
+#endif /* ASJSONBody_h */
@@ -0,0 +1,212 @@
+// ios/ASMetrics.h
+// Runtime metrics registry: counters, gauges and histograms updated from the
+// recorder, export and transfer paths, read back whole by getMetrics().
+//
+// Every update is a few relaxed atomics on the metric itself (no lock, no
+// allocation), so the hot paths can record unconditionally. Metrics are
+// registered by name the first time a call site runs (AS_METRIC caches the
+// handle in a static at that site); registering takes a lock and is idempotent,
+// so the same name from two modules is the same metric. The registry holds up
+// to AS_METRICS_MAX metrics for the life of the process.
+//
+// Histograms are HDR-style log-linear: exact up to 31, then each power of two
+// is split into 16 buckets, so any recorded value is reported within 1/32 of
+// itself (bucket midpoints) across the whole uint64 range in 976 buckets.
+// Readers copy the buckets without stopping writers; a snapshot can be a few
+// values behind but its count, percentiles and buckets always agree.
+//
+// Plain C11 (plus statement expressions) and header-only, so the Linux
+// benchmark (scripts/benchmarkMetrics.js) builds exactly this code. The
+// registry is defined in the one translation unit that defines
+// AS_METRICS_IMPLEMENTATION before including this header (AudioRecorderModule.m).
+
+#ifndef ASMetrics_h
+#define ASMetrics_h
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AS_METRICS_MAX 64
+#define AS_METRICS_LINEAR 32 // values below this get a bucket each
+#define AS_METRICS_SUB_BITS 4 // 16 buckets per power of two above it
+#define AS_METRICS_BUCKETS (AS_METRICS_LINEAR + (64 - 5) * (1 << AS_METRICS_SUB_BITS))
+
+typedef enum {
+    ASMetricCounter,
+    ASMetricGauge,
+    ASMetricHistogram,
+} ASMetricKind;
+
+typedef struct {
+    const char *name; // string literal, "area.metric"
+    const char *unit; // string literal or NULL
+    ASMetricKind kind;
+    _Atomic uint64_t count; // counter value; histogram values recorded
+    _Atomic int64_t value; // gauge
+    _Atomic int64_t peak; // gauge high-water mark
+    _Atomic uint64_t sum;
+    _Atomic uint64_t min;
+    _Atomic uint64_t max;
+    _Atomic uint64_t *buckets; // histograms only
+} ASMetric;
+
+extern ASMetric ASMetricsRegistry[AS_METRICS_MAX];
+extern _Atomic int ASMetricsCount;
+extern pthread_mutex_t ASMetricsLock;
+extern _Atomic uint64_t ASMetricsDroppedRegistrations;
+
+// --- Registration ---
+
+// The metric called `name`, created on first use; NULL when the registry is
+// full (updates to NULL are ignored, and counted in ASMetricsDroppedRegistrations)
+static inline ASMetric *ASMetricsRegister(const char *name, ASMetricKind kind, const char *unit) {
+    pthread_mutex_lock(&ASMetricsLock);
+    int count = atomic_load_explicit(&ASMetricsCount, memory_order_relaxed);
+    ASMetric *metric = NULL;
+    for (int i = 0; i < count && !metric; i++) {
+        if (strcmp(ASMetricsRegistry[i].name, name) == 0) metric = &ASMetricsRegistry[i];
+    }
+    if (!metric && count < AS_METRICS_MAX) {
+        _Atomic uint64_t *buckets = NULL;
+        if (kind == ASMetricHistogram) buckets = calloc(AS_METRICS_BUCKETS, sizeof(*buckets));
+        if (kind != ASMetricHistogram || buckets) {
+            metric = &ASMetricsRegistry[count];
+            metric->name = name;
+            metric->unit = unit;
+            metric->kind = kind;
+            atomic_store_explicit(&metric->min, UINT64_MAX, memory_order_relaxed);
+            metric->buckets = buckets;
+            atomic_store_explicit(&ASMetricsCount, count + 1, memory_order_release);
+        }
+    }
+    if (!metric) atomic_fetch_add_explicit(&ASMetricsDroppedRegistrations, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&ASMetricsLock);
+    return metric;
+}
+
+// A handle for `name` cached at the call site (one acquire load after the first call)
+#define AS_METRIC(name, kind, unit) ({ \
+    static ASMetric *_Atomic asMetricHandle; \
+    ASMetric *asMetric = atomic_load_explicit(&asMetricHandle, memory_order_acquire); \
+    if (!asMetric) { \
+        asMetric = ASMetricsRegister(name, kind, unit); \
+        atomic_store_explicit(&asMetricHandle, asMetric, memory_order_release); \
+    } \
+    asMetric; \
+})
+
+// --- Updates ---
+
+static inline void ASMetricAdd(ASMetric *metric, uint64_t amount) {
+    if (metric) atomic_fetch_add_explicit(&metric->count, amount, memory_order_relaxed);
+}
+
+static inline void ASMetricRaisePeak(ASMetric *metric, int64_t value) {
+    int64_t peak = atomic_load_explicit(&metric->peak, memory_order_relaxed);
+    while (value > peak && !atomic_compare_exchange_weak_explicit(&metric->peak, &peak, value,
+                                                                  memory_order_relaxed, memory_order_relaxed)) {}
+}
+
+static inline void ASMetricSet(ASMetric *metric, int64_t value) {
+    if (!metric) return;
+    atomic_store_explicit(&metric->value, value, memory_order_relaxed);
+    ASMetricRaisePeak(metric, value);
+}
+
+static inline void ASMetricGaugeAdd(ASMetric *metric, int64_t delta) {
+    if (!metric) return;
+    ASMetricRaisePeak(metric, atomic_fetch_add_explicit(&metric->value, delta, memory_order_relaxed) + delta);
+}
+
+static inline int ASMetricsBucketIndex(uint64_t value) {
+    if (value < AS_METRICS_LINEAR) return (int)value;
+    int magnitude = 63 - __builtin_clzll(value); // >= 5
+    int shift = magnitude - AS_METRICS_SUB_BITS;
+    return AS_METRICS_LINEAR + (magnitude - 5) * (1 << AS_METRICS_SUB_BITS)
+        + (int)((value >> shift) & ((1 << AS_METRICS_SUB_BITS) - 1));
+}
+
+// Smallest value in bucket `index`; the bucket holds [lower, lower + width)
+static inline uint64_t ASMetricsBucketLower(int index, uint64_t *width) {
+    if (index < AS_METRICS_LINEAR) {
+        *width = 1;
+        return (uint64_t)index;
+    }
+    int offset = index - AS_METRICS_LINEAR;
+    int shift = offset / (1 << AS_METRICS_SUB_BITS) + 5 - AS_METRICS_SUB_BITS;
+    *width = 1ull << shift;
+    return ((uint64_t)((1 << AS_METRICS_SUB_BITS) + offset % (1 << AS_METRICS_SUB_BITS))) << shift;
+}
+
+static inline void ASMetricRecord(ASMetric *metric, uint64_t value) {
+    if (!metric || !metric->buckets) return;
+    atomic_fetch_add_explicit(&metric->buckets[ASMetricsBucketIndex(value)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&metric->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&metric->sum, value, memory_order_relaxed);
+    uint64_t min = atomic_load_explicit(&metric->min, memory_order_relaxed);
+    while (value < min && !atomic_compare_exchange_weak_explicit(&metric->min, &min, value,
+                                                                 memory_order_relaxed, memory_order_relaxed)) {}
+    uint64_t max = atomic_load_explicit(&metric->max, memory_order_relaxed);
+    while (value > max && !atomic_compare_exchange_weak_explicit(&metric->max, &max, value,
+                                                                 memory_order_relaxed, memory_order_relaxed)) {}
+}
+
+#define AS_METRIC_COUNT(name, amount) ASMetricAdd(AS_METRIC(name, ASMetricCounter, NULL), (uint64_t)(amount))
+#define AS_METRIC_GAUGE_SET(name, value) ASMetricSet(AS_METRIC(name, ASMetricGauge, NULL), (int64_t)(value))
+#define AS_METRIC_GAUGE_ADD(name, delta) ASMetricGaugeAdd(AS_METRIC(name, ASMetricGauge, NULL), (int64_t)(delta))
+#define AS_METRIC_RECORD(name, unit, value) ASMetricRecord(AS_METRIC(name, ASMetricHistogram, unit), (uint64_t)(value))
+
+// --- Reading ---
+
+typedef struct {
+    uint64_t count; // sum of the buckets copied
+    uint64_t sum;
+    uint64_t min; // 0 when empty
+    uint64_t max;
+    uint64_t buckets[AS_METRICS_BUCKETS];
+} ASMetricsHistogramSnapshot;
+
+static inline void ASMetricsHistogramRead(const ASMetric *metric, ASMetricsHistogramSnapshot *snapshot) {
+    snapshot->count = 0;
+    for (int i = 0; i < AS_METRICS_BUCKETS; i++) {
+        snapshot->buckets[i] = metric->buckets ? atomic_load_explicit(&metric->buckets[i], memory_order_relaxed) : 0;
+        snapshot->count += snapshot->buckets[i];
+    }
+    snapshot->sum = atomic_load_explicit(&metric->sum, memory_order_relaxed);
+    uint64_t min = atomic_load_explicit(&metric->min, memory_order_relaxed);
+    snapshot->min = min == UINT64_MAX ? 0 : min;
+    snapshot->max = atomic_load_explicit(&metric->max, memory_order_relaxed);
+}
+
+// The value at `fraction` (0-1) of the recorded values: its bucket's midpoint,
+// kept within the recorded min and max
+static inline uint64_t ASMetricsPercentile(const ASMetricsHistogramSnapshot *snapshot, double fraction) {
+    if (snapshot->count == 0) return 0;
+    uint64_t rank = (uint64_t)(fraction * (double)snapshot->count);
+    if (rank >= snapshot->count) rank = snapshot->count - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < AS_METRICS_BUCKETS; i++) {
+        seen += snapshot->buckets[i];
+        if (seen > rank) {
+            uint64_t width;
+            uint64_t value = ASMetricsBucketLower(i, &width) + width / 2;
+            if (value < snapshot->min) value = snapshot->min;
+            if (snapshot->max && value > snapshot->max) value = snapshot->max;
+            return value;
+        }
+    }
+    return snapshot->max;
+}
+
+#ifdef AS_METRICS_IMPLEMENTATION
+ASMetric ASMetricsRegistry[AS_METRICS_MAX];
+_Atomic int ASMetricsCount;
+pthread_mutex_t ASMetricsLock = PTHREAD_MUTEX_INITIALIZER;
+_Atomic uint64_t ASMetricsDroppedRegistrations;
+#endif
+
+#endif /* ASMetrics_h */
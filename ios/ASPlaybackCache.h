@@ -0,0 +1,175 @@
+// ios/ASPlaybackCache.h
+// Playback cache: a bounded LRU map from a string key to a reference-counted
+// value, shared by every playback item. AudioRecorderModule keeps two: the
+// parsed segment assets (keyed by path, size and mtime, so a rewritten file is
+// a new key) and the compositions built from them (keyed by the segment keys).
+//
+// Bounded by entry count and by total cost (seconds of audio). Lookups and
+// inserts take a mutex, since prefetches fill the cache from a background
+// queue. Entries are few (tens), so the LRU is a linear scan over an array.
+//
+// Plain C11 and header-only, so the Linux benchmark
+// (scripts/benchmarkPlaybackCache.js) builds exactly this code.
+
+#ifndef ASPlaybackCache_h
+#define ASPlaybackCache_h
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+// Retain returns the value it was given; release drops one reference
+typedef void *(*ASPlaybackCacheRetain)(void *value);
+typedef void (*ASPlaybackCacheRelease)(void *value);
+
+typedef struct {
+    char *key;
+    void *value;
+    uint64_t cost;
+    uint64_t lastUsed;
+    bool prefetched; // inserted by a prefetch and not looked up since
+} ASPlaybackCacheEntry;
+
+typedef struct {
+    uint64_t entries;
+    uint64_t cost;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t prefetches;
+    uint64_t prefetchHits; // first lookups of a prefetched entry
+} ASPlaybackCacheStats;
+
+typedef struct {
+    pthread_mutex_t lock;
+    ASPlaybackCacheEntry *entries;
+    size_t count;
+    size_t maxEntries;
+    uint64_t maxCost;
+    uint64_t cost;
+    uint64_t clock;
+    ASPlaybackCacheRetain retain;
+    ASPlaybackCacheRelease release;
+    ASPlaybackCacheStats stats;
+} ASPlaybackCache;
+
+static inline bool ASPlaybackCacheInit(ASPlaybackCache *cache, size_t maxEntries, uint64_t maxCost,
+                                       ASPlaybackCacheRetain retain, ASPlaybackCacheRelease release) {
+    memset(cache, 0, sizeof(*cache));
+    if (maxEntries == 0) return false;
+    cache->entries = calloc(maxEntries + 1, sizeof(ASPlaybackCacheEntry)); // +1: the entry being inserted
+    if (!cache->entries) return false;
+    pthread_mutex_init(&cache->lock, NULL);
+    cache->maxEntries = maxEntries;
+    cache->maxCost = maxCost;
+    cache->retain = retain;
+    cache->release = release;
+    return true;
+}
+
+static inline void ASPlaybackCacheDropAt(ASPlaybackCache *cache, size_t index) {
+    ASPlaybackCacheEntry entry = cache->entries[index];
+    cache->entries[index] = cache->entries[--cache->count];
+    cache->cost -= entry.cost;
+    free(entry.key);
+    if (cache->release) cache->release(entry.value);
+}
+
+static inline void ASPlaybackCacheRemoveAll(ASPlaybackCache *cache) {
+    pthread_mutex_lock(&cache->lock);
+    while (cache->count > 0) ASPlaybackCacheDropAt(cache, cache->count - 1);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static inline void ASPlaybackCacheDestroy(ASPlaybackCache *cache) {
+    if (!cache->entries) return;
+    ASPlaybackCacheRemoveAll(cache);
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->entries);
+    cache->entries = NULL;
+}
+
+static inline ssize_t ASPlaybackCacheIndexOf(ASPlaybackCache *cache, const char *key) {
+    for (size_t i = 0; i < cache->count; i++) {
+        if (strcmp(cache->entries[i].key, key) == 0) return (ssize_t)i;
+    }
+    return -1;
+}
+
+// The cached value, retained for the caller (who releases it), or NULL on a miss
+static inline void *ASPlaybackCacheLookup(ASPlaybackCache *cache, const char *key) {
+    void *value = NULL;
+    pthread_mutex_lock(&cache->lock);
+    ssize_t index = ASPlaybackCacheIndexOf(cache, key);
+    if (index >= 0) {
+        ASPlaybackCacheEntry *entry = &cache->entries[index];
+        entry->lastUsed = ++cache->clock;
+        if (entry->prefetched) {
+            entry->prefetched = false;
+            cache->stats.prefetchHits++;
+        }
+        value = cache->retain ? cache->retain(entry->value) : entry->value;
+        cache->stats.hits++;
+    } else {
+        cache->stats.misses++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return value;
+}
+
+// Presence only: no stats, no change in recency (a prefetch checking what to load)
+static inline bool ASPlaybackCacheContains(ASPlaybackCache *cache, const char *key) {
+    pthread_mutex_lock(&cache->lock);
+    bool found = ASPlaybackCacheIndexOf(cache, key) >= 0;
+    pthread_mutex_unlock(&cache->lock);
+    return found;
+}
+
+// Inserts (or replaces) the value, retaining it, then evicts least recently
+// used entries until both bounds hold. The new entry is never evicted, so an
+// item costlier than maxCost still caches until the next insert.
+static inline void ASPlaybackCacheInsert(ASPlaybackCache *cache, const char *key, void *value,
+                                         uint64_t cost, bool prefetched) {
+    pthread_mutex_lock(&cache->lock);
+    ssize_t existing = ASPlaybackCacheIndexOf(cache, key);
+    if (existing >= 0) ASPlaybackCacheDropAt(cache, (size_t)existing);
+
+    char *ownedKey = strdup(key);
+    if (!ownedKey) {
+        pthread_mutex_unlock(&cache->lock);
+        return;
+    }
+    ASPlaybackCacheEntry *entry = &cache->entries[cache->count++];
+    entry->key = ownedKey;
+    entry->value = cache->retain ? cache->retain(value) : value;
+    entry->cost = cost;
+    entry->lastUsed = ++cache->clock;
+    entry->prefetched = prefetched;
+    cache->cost += cost;
+    if (prefetched) cache->stats.prefetches++;
+
+    while (cache->count > 1 && (cache->count > cache->maxEntries || cache->cost > cache->maxCost)) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < cache->count; i++) {
+            if (cache->entries[i].lastUsed < cache->entries[oldest].lastUsed) oldest = i;
+        }
+        if (cache->entries[oldest].lastUsed == cache->clock) break; // only the new entry left to evict
+        ASPlaybackCacheDropAt(cache, oldest);
+        cache->stats.evictions++;
+    }
+    pthread_mutex_unlock(&cache->lock);
+}
+
+static inline ASPlaybackCacheStats ASPlaybackCacheStatsRead(ASPlaybackCache *cache) {
+    pthread_mutex_lock(&cache->lock);
+    ASPlaybackCacheStats stats = cache->stats;
+    stats.entries = cache->count;
+    stats.cost = cache->cost;
+    pthread_mutex_unlock(&cache->lock);
+    return stats;
+}
+
+#endif /* ASPlaybackCache_h */
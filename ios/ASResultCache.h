@@ -0,0 +1,357 @@
+// ios/ASResultCache.h
+// Result cache for the AI requests: responses keyed by a 32-byte digest of the
+// request (endpoint and exact JSON body, so model, instructions and input all
+// count). Asking the same question again, after an error further down the
+// pipeline or for a duplicate recording, is answered from disk.
+//
+// Stored in one append-only file: put records (key, length, CRC-32, response)
+// and touch records (key only) that keep the recency order across launches.
+// Opening scans the record headers to rebuild the index and cuts off a torn
+// tail left by a crash; response CRCs are checked on lookup. Bounded by total
+// response bytes: past the bound the least recently used entries are dropped
+// down to 3/4 of it. Dropped entries and touches stay in the file until dead
+// records make up half of it; it is then rewritten with only the live entries,
+// oldest first.
+//
+// Entries are few (hundreds), so the index is an array scanned linearly, as in
+// ASPlaybackCache.h. Every call takes a mutex. Plain C11 and header-only, so the
+// Linux benchmark (scripts/benchmarkResultCache.js) builds exactly this code.
+// Link with -lz (CRC-32).
+
+#ifndef ASResultCache_h
+#define ASResultCache_h
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define AS_RESULT_CACHE_KEY_BYTES 32
+#define AS_RESULT_CACHE_PUT 0x31435341u // "ASC1"
+#define AS_RESULT_CACHE_TOUCH 0x54435341u // "ASCT"
+#define AS_RESULT_CACHE_MIN_COMPACT (64 * 1024) // smaller files are never worth rewriting
+
+typedef struct {
+    uint32_t magic;
+    uint32_t length; // response bytes; 0 for a touch
+    uint32_t crc; // CRC-32 of the key and the response
+    uint8_t key[AS_RESULT_CACHE_KEY_BYTES];
+} ASResultCacheRecord;
+
+typedef struct {
+    uint8_t key[AS_RESULT_CACHE_KEY_BYTES];
+    uint64_t offset; // of the response bytes
+    uint32_t length;
+    uint32_t crc;
+    uint64_t lastUsed;
+} ASResultCacheEntry;
+
+typedef struct {
+    uint64_t entries;
+    uint64_t bytes; // response bytes held
+    uint64_t fileBytes;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t inserts;
+    uint64_t evictions;
+    uint64_t compactions;
+} ASResultCacheStats;
+
+typedef struct {
+    pthread_mutex_t lock;
+    int fd;
+    char *path;
+    ASResultCacheEntry *entries;
+    size_t count;
+    size_t capacity;
+    uint64_t maxBytes;
+    uint64_t bytes;
+    uint64_t fileBytes;
+    uint64_t liveFileBytes; // put records of live entries
+    uint64_t clock;
+    ASResultCacheStats stats;
+} ASResultCache;
+
+static inline uint32_t ASResultCacheCRC(const uint8_t *key, const void *value, size_t length) {
+    uLong crc = crc32(0L, key, AS_RESULT_CACHE_KEY_BYTES);
+    return (uint32_t)crc32(crc, value, (uInt)length);
+}
+
+static inline bool ASResultCacheWriteAll(int fd, const void *bytes, size_t length, uint64_t offset) {
+    const uint8_t *cursor = bytes;
+    while (length > 0) {
+        ssize_t written = pwrite(fd, cursor, length, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        cursor += written;
+        length -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+    return true;
+}
+
+static inline bool ASResultCacheReadAll(int fd, void *bytes, size_t length, uint64_t offset) {
+    uint8_t *cursor = bytes;
+    while (length > 0) {
+        ssize_t count = pread(fd, cursor, length, (off_t)offset);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+        cursor += count;
+        length -= (size_t)count;
+        offset += (uint64_t)count;
+    }
+    return true;
+}
+
+static inline ASResultCacheEntry *ASResultCacheFind(ASResultCache *cache, const uint8_t *key) {
+    for (size_t i = 0; i < cache->count; i++) {
+        if (memcmp(cache->entries[i].key, key, AS_RESULT_CACHE_KEY_BYTES) == 0) return &cache->entries[i];
+    }
+    return NULL;
+}
+
+static inline void ASResultCacheRemoveAt(ASResultCache *cache, size_t index) {
+    cache->bytes -= cache->entries[index].length;
+    cache->liveFileBytes -= sizeof(ASResultCacheRecord) + cache->entries[index].length;
+    cache->entries[index] = cache->entries[--cache->count];
+}
+
+static inline ASResultCacheEntry *ASResultCacheAdd(ASResultCache *cache, const uint8_t *key) {
+    if (cache->count == cache->capacity) {
+        size_t capacity = cache->capacity ? cache->capacity * 2 : 64;
+        ASResultCacheEntry *entries = realloc(cache->entries, capacity * sizeof(*entries));
+        if (!entries) return NULL;
+        cache->entries = entries;
+        cache->capacity = capacity;
+    }
+    ASResultCacheEntry *entry = &cache->entries[cache->count++];
+    memcpy(entry->key, key, AS_RESULT_CACHE_KEY_BYTES);
+    return entry;
+}
+
+static inline bool ASResultCacheAppend(ASResultCache *cache, uint32_t magic, const uint8_t *key,
+                                       const void *value, uint32_t length, uint32_t crc) {
+    ASResultCacheRecord record = { .magic = magic, .length = length, .crc = crc };
+    memcpy(record.key, key, AS_RESULT_CACHE_KEY_BYTES);
+    if (!ASResultCacheWriteAll(cache->fd, &record, sizeof(record), cache->fileBytes)
+        || (length > 0 && !ASResultCacheWriteAll(cache->fd, value, length, cache->fileBytes + sizeof(record)))) {
+        // Writes are positioned, so the next record overwrites whatever part of this one made it
+        return false;
+    }
+    cache->fileBytes += sizeof(record) + length;
+    return true;
+}
+
+static int ASResultCacheCompareLastUsed(const void *a, const void *b) {
+    uint64_t left = ((const ASResultCacheEntry *)a)->lastUsed, right = ((const ASResultCacheEntry *)b)->lastUsed;
+    return left < right ? -1 : left > right;
+}
+
+// Rewrites the file with the live entries, least recently used first, so a
+// scan on open rebuilds the same order; on failure the old file stays in use
+static inline bool ASResultCacheCompact(ASResultCache *cache) {
+    size_t pathLength = strlen(cache->path);
+    char *tempPath = malloc(pathLength + 5);
+    if (!tempPath) return false;
+    memcpy(tempPath, cache->path, pathLength);
+    memcpy(tempPath + pathLength, ".tmp", 5);
+    int fd = open(tempPath, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        free(tempPath);
+        return false;
+    }
+
+    qsort(cache->entries, cache->count, sizeof(*cache->entries), ASResultCacheCompareLastUsed);
+    uint64_t *offsets = malloc((cache->count + 1) * sizeof(*offsets));
+    uint8_t *value = NULL;
+    size_t valueCapacity = 0;
+    uint64_t written = 0;
+    bool ok = offsets != NULL;
+    for (size_t i = 0; ok && i < cache->count; i++) {
+        ASResultCacheEntry *entry = &cache->entries[i];
+        if (entry->length > valueCapacity) {
+            uint8_t *grown = realloc(value, entry->length);
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            value = grown;
+            valueCapacity = entry->length;
+        }
+        ASResultCacheRecord record = { .magic = AS_RESULT_CACHE_PUT, .length = entry->length, .crc = entry->crc };
+        memcpy(record.key, entry->key, AS_RESULT_CACHE_KEY_BYTES);
+        ok = ASResultCacheReadAll(cache->fd, value, entry->length, entry->offset)
+            && ASResultCacheWriteAll(fd, &record, sizeof(record), written)
+            && ASResultCacheWriteAll(fd, value, entry->length, written + sizeof(record));
+        offsets[i] = written + sizeof(record);
+        written += sizeof(record) + entry->length;
+    }
+    free(value);
+    ok = ok && fsync(fd) == 0 && rename(tempPath, cache->path) == 0;
+    if (!ok) {
+        close(fd);
+        unlink(tempPath);
+        free(offsets);
+        free(tempPath);
+        return false;
+    }
+    close(cache->fd);
+    cache->fd = fd;
+    cache->fileBytes = written;
+    cache->liveFileBytes = written;
+    for (size_t i = 0; i < cache->count; i++) {
+        cache->entries[i].offset = offsets[i];
+        cache->entries[i].lastUsed = i + 1;
+    }
+    cache->clock = cache->count;
+    cache->stats.compactions++;
+    free(offsets);
+    free(tempPath);
+    return true;
+}
+
+// Drops least recently used entries down to 3/4 of the bound once it is exceeded
+static inline void ASResultCacheEvict(ASResultCache *cache) {
+    if (cache->bytes <= cache->maxBytes) return;
+    while (cache->count > 1 && cache->bytes > cache->maxBytes / 4 * 3) {
+        size_t oldest = 0;
+        for (size_t i = 1; i < cache->count; i++) {
+            if (cache->entries[i].lastUsed < cache->entries[oldest].lastUsed) oldest = i;
+        }
+        ASResultCacheRemoveAt(cache, oldest);
+        cache->stats.evictions++;
+    }
+}
+
+static inline void ASResultCacheCompactIfWasteful(ASResultCache *cache) {
+    if (cache->fileBytes >= AS_RESULT_CACHE_MIN_COMPACT && cache->fileBytes > cache->liveFileBytes * 2) {
+        ASResultCacheCompact(cache);
+    }
+}
+
+// Opens (or creates) the cache file; false if it cannot be opened at all
+static inline bool ASResultCacheOpen(ASResultCache *cache, const char *path, uint64_t maxBytes) {
+    memset(cache, 0, sizeof(*cache));
+    cache->fd = open(path, O_RDWR | O_CREAT, 0600);
+    if (cache->fd < 0) return false;
+    cache->path = strdup(path);
+    cache->maxBytes = maxBytes;
+    pthread_mutex_init(&cache->lock, NULL);
+
+    struct stat info;
+    uint64_t size = fstat(cache->fd, &info) == 0 ? (uint64_t)info.st_size : 0;
+    uint64_t offset = 0;
+    ASResultCacheRecord record;
+    while (offset + sizeof(record) <= size && ASResultCacheReadAll(cache->fd, &record, sizeof(record), offset)) {
+        uint64_t end = offset + sizeof(record) + record.length;
+        bool valid = (record.magic == AS_RESULT_CACHE_PUT && record.length > 0)
+            || (record.magic == AS_RESULT_CACHE_TOUCH && record.length == 0);
+        if (!valid || end > size) break;
+        ASResultCacheEntry *entry = ASResultCacheFind(cache, record.key);
+        if (record.magic == AS_RESULT_CACHE_PUT) {
+            if (entry) ASResultCacheRemoveAt(cache, (size_t)(entry - cache->entries));
+            entry = ASResultCacheAdd(cache, record.key);
+            if (!entry) break;
+            entry->offset = offset + sizeof(record);
+            entry->length = record.length;
+            entry->crc = record.crc;
+            cache->bytes += record.length;
+            cache->liveFileBytes += sizeof(record) + record.length;
+        }
+        if (entry) entry->lastUsed = ++cache->clock;
+        offset = end;
+    }
+    if (offset < size) {
+        // A torn tail from a crash; if it cannot be cut, new records overwrite it
+        int truncated = ftruncate(cache->fd, (off_t)offset);
+        (void)truncated;
+    }
+    cache->fileBytes = offset;
+    // Entries dropped before the last close are back from their put records (and the
+    // bound may have shrunk); dropping them again is not news
+    ASResultCacheEvict(cache);
+    cache->stats.evictions = 0;
+    ASResultCacheCompactIfWasteful(cache);
+    return true;
+}
+
+// The response for the key in a malloc'd buffer (free it), or NULL
+static inline uint8_t *ASResultCacheLookup(ASResultCache *cache, const uint8_t *key, size_t *length) {
+    pthread_mutex_lock(&cache->lock);
+    ASResultCacheEntry *entry = ASResultCacheFind(cache, key);
+    uint8_t *value = entry ? malloc(entry->length) : NULL;
+    if (value && (!ASResultCacheReadAll(cache->fd, value, entry->length, entry->offset)
+                  || ASResultCacheCRC(key, value, entry->length) != entry->crc)) {
+        // Damaged on disk: forget it (its bytes go at the next rewrite)
+        free(value);
+        value = NULL;
+        ASResultCacheRemoveAt(cache, (size_t)(entry - cache->entries));
+    } else if (value) {
+        *length = entry->length;
+        entry->lastUsed = ++cache->clock;
+        ASResultCacheAppend(cache, AS_RESULT_CACHE_TOUCH, key, NULL, 0, 0);
+        ASResultCacheCompactIfWasteful(cache);
+    }
+    if (value) cache->stats.hits++;
+    else cache->stats.misses++;
+    pthread_mutex_unlock(&cache->lock);
+    return value;
+}
+
+// Stores a response, replacing any under the same key; responses larger than the bound are not kept
+static inline bool ASResultCacheInsert(ASResultCache *cache, const uint8_t *key, const void *value, size_t length) {
+    if (length == 0 || length > cache->maxBytes || length > UINT32_MAX) return false;
+    pthread_mutex_lock(&cache->lock);
+    uint32_t crc = ASResultCacheCRC(key, value, length);
+    uint64_t offset = cache->fileBytes + sizeof(ASResultCacheRecord);
+    bool ok = ASResultCacheAppend(cache, AS_RESULT_CACHE_PUT, key, value, (uint32_t)length, crc);
+    if (ok) {
+        ASResultCacheEntry *entry = ASResultCacheFind(cache, key);
+        if (entry) ASResultCacheRemoveAt(cache, (size_t)(entry - cache->entries));
+        entry = ASResultCacheAdd(cache, key);
+        ok = entry != NULL;
+        if (ok) {
+            entry->offset = offset;
+            entry->length = (uint32_t)length;
+            entry->crc = crc;
+            entry->lastUsed = ++cache->clock;
+            cache->bytes += length;
+            cache->liveFileBytes += sizeof(ASResultCacheRecord) + length;
+            cache->stats.inserts++;
+        }
+        ASResultCacheEvict(cache);
+        ASResultCacheCompactIfWasteful(cache);
+    }
+    pthread_mutex_unlock(&cache->lock);
+    return ok;
+}
+
+static inline ASResultCacheStats ASResultCacheStatsRead(ASResultCache *cache) {
+    pthread_mutex_lock(&cache->lock);
+    ASResultCacheStats stats = cache->stats;
+    stats.entries = cache->count;
+    stats.bytes = cache->bytes;
+    stats.fileBytes = cache->fileBytes;
+    pthread_mutex_unlock(&cache->lock);
+    return stats;
+}
+
+static inline void ASResultCacheClose(ASResultCache *cache) {
+    if (cache->fd >= 0) close(cache->fd);
+    free(cache->entries);
+    free(cache->path);
+    pthread_mutex_destroy(&cache->lock);
+    memset(cache, 0, sizeof(*cache));
+    cache->fd = -1;
+}
+
+#endif /* ASResultCache_h */
@@ -0,0 +1,319 @@
+// ios/ASTrace.h
+// Hot-path tracing: timed spans and instant events recorded into a per-thread
+// ring of fixed-size events, dumped on demand as Chrome trace JSON (loads in
+// Perfetto and chrome://tracing).
+//
+// Recording is lock-free and allocation-free after a thread's first event: the
+// owning thread writes the next slot of its own ring and publishes it with one
+// release store; the oldest events are overwritten. The dump reads every ring
+// from another thread and drops any event that may have been overwritten while
+// it was being copied. Rings are registered once on a lock-free list and kept
+// for the life of the process (threads are pooled, so they are few).
+//
+// Levels are compile-time: AS_TRACE_LEVEL 0 compiles every macro away, 1 keeps
+// the coarse spans (rollover, export, body builds, transfer completion), 2 adds
+// the per-callback detail (capture writes, delegate callbacks, event emission).
+// Defaults to 2 in debug builds and 1 otherwise. On top of that, nothing is
+// recorded until ASTraceStart() (one relaxed load per span when off).
+//
+// Event names must be string literals (only the pointer is stored) and read
+// "category.event", e.g. "recorder.rollover"; the part before the dot is the
+// trace category. A span can carry a short copied label and one integer value.
+// Plain C11 and header-only, so the Linux benchmark (scripts/benchmarkTrace.js)
+// builds exactly this code. The shared state is defined in the one translation
+// unit that defines AS_TRACE_IMPLEMENTATION before including this header
+// (AudioRecorderModule.m).
+
+#ifndef ASTrace_h
+#define ASTrace_h
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifndef AS_TRACE_LEVEL
+#if defined(DEBUG) && DEBUG
+#define AS_TRACE_LEVEL 2
+#else
+#define AS_TRACE_LEVEL 1
+#endif
+#endif
+
+// Events per thread (power of two); 64 bytes each
+#ifndef AS_TRACE_RING_EVENTS
+#define AS_TRACE_RING_EVENTS 4096
+#endif
+
+typedef struct {
+    uint64_t start; // ticks
+    uint64_t duration; // ticks; 0 for instants
+    const char *name;
+    int64_t value;
+    uint8_t instant;
+    uint8_t hasValue;
+    char label[30];
+} ASTraceEvent; // 64 bytes
+
+typedef struct ASTraceRing {
+    struct ASTraceRing *next;
+    uint64_t threadId;
+    char threadName[32];
+    _Atomic uint64_t writeIndex; // advanced by the owning thread only
+    // One cache line per event: a slot that straddled two lines cost the writer two
+    _Alignas(64) ASTraceEvent events[AS_TRACE_RING_EVENTS];
+} ASTraceRing;
+
+extern _Atomic bool ASTraceRecording;
+extern _Atomic uint64_t ASTraceEpochTicks;
+extern _Atomic uint64_t ASTraceEpochNanos;
+extern _Atomic(ASTraceRing *) ASTraceRings;
+extern _Thread_local ASTraceRing *ASTraceLocalRing;
+
+static inline uint64_t ASTraceNanos(void) {
+#if defined(__APPLE__)
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// Spans are timed in raw counter ticks, converted to time only in the dump: a
+// clock_gettime per edge would be most of the span budget on its own
+static inline uint64_t ASTraceTicks(void) {
+#if defined(__APPLE__)
+    return mach_absolute_time();
+#elif defined(__x86_64__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return ASTraceNanos();
+#endif
+}
+
+static inline bool ASTraceIsRecording(void) {
+    return atomic_load_explicit(&ASTraceRecording, memory_order_relaxed);
+}
+
+// The calling thread's ring, created and registered on its first event
+static inline ASTraceRing *ASTraceAttachThread(void) {
+    ASTraceRing *ring = aligned_alloc(64, sizeof(ASTraceRing));
+    if (!ring) return NULL;
+    memset(ring, 0, sizeof(ASTraceRing));
+#if defined(__APPLE__)
+    pthread_threadid_np(NULL, &ring->threadId);
+#elif defined(__linux__)
+    ring->threadId = (uint64_t)syscall(SYS_gettid);
+#else
+    ring->threadId = (uint64_t)(uintptr_t)pthread_self();
+#endif
+#if defined(__APPLE__) || defined(_GNU_SOURCE)
+    pthread_getname_np(pthread_self(), ring->threadName, sizeof(ring->threadName));
+#endif
+    ASTraceRing *head = atomic_load_explicit(&ASTraceRings, memory_order_relaxed);
+    do {
+        ring->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&ASTraceRings, &head, ring, memory_order_release, memory_order_relaxed));
+    ASTraceLocalRing = ring;
+    return ring;
+}
+
+static inline void ASTraceRecord(const char *name, uint64_t start, uint64_t duration, bool instant,
+                                 bool hasValue, int64_t value, const char *label) {
+    ASTraceRing *ring = ASTraceLocalRing;
+    if (__builtin_expect(!ring, 0) && !(ring = ASTraceAttachThread())) return;
+    uint64_t index = atomic_load_explicit(&ring->writeIndex, memory_order_relaxed);
+    ASTraceEvent *event = &ring->events[index & (AS_TRACE_RING_EVENTS - 1)];
+    event->start = start;
+    event->duration = duration;
+    event->name = name;
+    event->value = value;
+    event->instant = instant;
+    event->hasValue = hasValue;
+    if (label) {
+        // Bounded copy into the fixed field (reads no further than the label's terminator)
+        strncpy(event->label, label, sizeof(event->label) - 1);
+        event->label[sizeof(event->label) - 1] = '\0';
+    } else {
+        event->label[0] = '\0';
+    }
+    atomic_store_explicit(&ring->writeIndex, index + 1, memory_order_release);
+}
+
+// --- Scoped spans ---
+
+typedef struct {
+    const char *name;
+    const char *label;
+    int64_t value;
+    uint64_t start; // 0 when not recording
+    bool hasValue;
+} ASTraceScope;
+
+static inline ASTraceScope ASTraceScopeBegin(const char *name, const char *label, bool hasValue, int64_t value) {
+    ASTraceScope scope = { name, label, value, 0, hasValue };
+    if (ASTraceIsRecording()) scope.start = ASTraceTicks();
+    return scope;
+}
+
+static inline void ASTraceScopeEnd(ASTraceScope *scope) {
+    if (scope->start == 0) return;
+    ASTraceRecord(scope->name, scope->start, ASTraceTicks() - scope->start, false, scope->hasValue,
+                  scope->value, scope->label);
+}
+
+// An async operation that began at `start` (an ASTraceTicks() value) and ends now
+static inline void ASTraceComplete(const char *name, uint64_t start, bool hasValue, int64_t value) {
+    if (start == 0 || !ASTraceIsRecording()) return;
+    ASTraceRecord(name, start, ASTraceTicks() - start, false, hasValue, value, NULL);
+}
+
+static inline void ASTraceInstant(const char *name, bool hasValue, int64_t value) {
+    if (!ASTraceIsRecording()) return;
+    ASTraceRecord(name, ASTraceTicks(), 0, true, hasValue, value, NULL);
+}
+
+#define AS_TRACE_CONCAT_(a, b) a##b
+#define AS_TRACE_CONCAT(a, b) AS_TRACE_CONCAT_(a, b)
+#define AS_TRACE_SCOPE_(name, label, hasValue, value) \
+    ASTraceScope AS_TRACE_CONCAT(asTraceScope, __LINE__) __attribute__((cleanup(ASTraceScopeEnd), unused)) = \
+        ASTraceScopeBegin(name, label, hasValue, value)
+
+#if AS_TRACE_LEVEL >= 1
+// Times the rest of the enclosing scope
+#define AS_TRACE_SPAN(name) AS_TRACE_SCOPE_(name, NULL, false, 0)
+#define AS_TRACE_SPAN_VALUE(name, value) AS_TRACE_SCOPE_(name, NULL, true, (int64_t)(value))
+#define AS_TRACE_COMPLETE(name, start, value) ASTraceComplete(name, start, true, (int64_t)(value))
+#define AS_TRACE_INSTANT(name, value) ASTraceInstant(name, true, (int64_t)(value))
+// The start to hand AS_TRACE_COMPLETE later; 0 (nothing recorded) when not tracing
+#define AS_TRACE_TICKS() (ASTraceIsRecording() ? ASTraceTicks() : 0)
+#else
+#define AS_TRACE_SPAN(name) do {} while (0)
+#define AS_TRACE_SPAN_VALUE(name, value) do {} while (0)
+#define AS_TRACE_COMPLETE(name, start, value) do { (void)(start); } while (0)
+#define AS_TRACE_INSTANT(name, value) do {} while (0)
+#define AS_TRACE_TICKS() ((uint64_t)0)
+#endif
+
+#if AS_TRACE_LEVEL >= 2
+#define AS_TRACE_DETAIL_SPAN(name) AS_TRACE_SCOPE_(name, NULL, false, 0)
+#define AS_TRACE_DETAIL_SPAN_VALUE(name, value) AS_TRACE_SCOPE_(name, NULL, true, (int64_t)(value))
+#define AS_TRACE_DETAIL_SPAN_LABEL(name, label) AS_TRACE_SCOPE_(name, label, false, 0)
+#define AS_TRACE_DETAIL_SPAN_LABEL_VALUE(name, label, value) AS_TRACE_SCOPE_(name, label, true, (int64_t)(value))
+#define AS_TRACE_DETAIL_INSTANT(name, value) ASTraceInstant(name, true, (int64_t)(value))
+#else
+#define AS_TRACE_DETAIL_SPAN(name) do {} while (0)
+#define AS_TRACE_DETAIL_SPAN_VALUE(name, value) do {} while (0)
+#define AS_TRACE_DETAIL_SPAN_LABEL(name, label) do {} while (0)
+#define AS_TRACE_DETAIL_SPAN_LABEL_VALUE(name, label, value) do {} while (0)
+#define AS_TRACE_DETAIL_INSTANT(name, value) do {} while (0)
+#endif
+
+// --- Control and dump ---
+
+// Starts recording; the dump only includes events from here on
+static inline void ASTraceStart(void) {
+    atomic_store_explicit(&ASTraceEpochNanos, ASTraceNanos(), memory_order_relaxed);
+    atomic_store_explicit(&ASTraceEpochTicks, ASTraceTicks(), memory_order_relaxed);
+    atomic_store_explicit(&ASTraceRecording, true, memory_order_release);
+}
+
+static inline void ASTraceStop(void) {
+    atomic_store_explicit(&ASTraceRecording, false, memory_order_release);
+}
+
+static inline void ASTraceWriteEscaped(FILE *out, const char *text) {
+    for (const unsigned char *at = (const unsigned char *)text; *at; at++) {
+        if (*at == '"' || *at == '\\') fprintf(out, "\\%c", *at);
+        else if (*at < 0x20) fprintf(out, "\\u%04x", *at);
+        else fputc(*at, out);
+    }
+}
+
+// Writes every ring's events since ASTraceStart() as Chrome trace JSON; returns
+// the number of events written, or -1 when the file can not be written
+static inline long ASTraceDump(const char *path) {
+    FILE *out = fopen(path, "w");
+    if (!out) return -1;
+    uint64_t epoch = atomic_load_explicit(&ASTraceEpochTicks, memory_order_relaxed);
+#if defined(__APPLE__)
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    double nanosPerTick = (double)timebase.numer / timebase.denom;
+#else
+    // Counter rate measured against the monotonic clock since ASTraceStart()
+    uint64_t elapsedTicks = ASTraceTicks() - epoch;
+    uint64_t elapsedNanos = ASTraceNanos() - atomic_load_explicit(&ASTraceEpochNanos, memory_order_relaxed);
+    double nanosPerTick = elapsedTicks > 0 && elapsedNanos > 0 ? (double)elapsedNanos / elapsedTicks : 1;
+#endif
+    ASTraceEvent *copy = malloc(sizeof(ASTraceEvent) * AS_TRACE_RING_EVENTS);
+    long written = 0;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", out);
+    for (ASTraceRing *ring = atomic_load_explicit(&ASTraceRings, memory_order_acquire); ring && copy; ring = ring->next) {
+        uint64_t end = atomic_load_explicit(&ring->writeIndex, memory_order_acquire);
+        uint64_t begin = end > AS_TRACE_RING_EVENTS ? end - AS_TRACE_RING_EVENTS : 0;
+        for (uint64_t index = begin; index < end; index++) {
+            copy[index - begin] = ring->events[index & (AS_TRACE_RING_EVENTS - 1)];
+        }
+        // Slots the owner reused while they were copied are torn; keep only the rest
+        uint64_t after = atomic_load_explicit(&ring->writeIndex, memory_order_acquire);
+        uint64_t valid = after >= AS_TRACE_RING_EVENTS ? after - AS_TRACE_RING_EVENTS + 1 : 0;
+
+        fprintf(out, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%llu,\"args\":{\"name\":\"",
+                written ? "," : "", (unsigned long long)ring->threadId);
+        ASTraceWriteEscaped(out, ring->threadName[0] ? ring->threadName : "thread");
+        fputs("\"}}", out);
+        written++;
+        for (uint64_t index = begin > valid ? begin : valid; index < end; index++) {
+            const ASTraceEvent *event = &copy[index - begin];
+            if (event->start < epoch) continue;
+            const char *dot = strchr(event->name, '.');
+            fprintf(out, ",{\"ph\":\"%s\",\"cat\":\"%.*s\",\"name\":\"%s\",\"pid\":1,\"tid\":%llu,\"ts\":%.3f",
+                    event->instant ? "i\",\"s\":\"t" : "X", dot ? (int)(dot - event->name) : 0, event->name, event->name,
+                    (unsigned long long)ring->threadId, (event->start - epoch) * nanosPerTick / 1e3);
+            if (!event->instant) fprintf(out, ",\"dur\":%.3f", event->duration * nanosPerTick / 1e3);
+            if (event->hasValue || event->label[0]) {
+                fputs(",\"args\":{", out);
+                if (event->hasValue) fprintf(out, "\"value\":%lld%s", (long long)event->value, event->label[0] ? "," : "");
+                if (event->label[0]) {
+                    fputs("\"label\":\"", out);
+                    ASTraceWriteEscaped(out, event->label);
+                    fputc('"', out);
+                }
+                fputc('}', out);
+            }
+            fputc('}', out);
+            written++;
+        }
+    }
+    fputs("]}\n", out);
+    free(copy);
+    bool ok = !ferror(out);
+    if (fclose(out) != 0) ok = false;
+    return ok ? written : -1;
+}
+
+#ifdef AS_TRACE_IMPLEMENTATION
+_Atomic bool ASTraceRecording;
+_Atomic uint64_t ASTraceEpochTicks;
+_Atomic uint64_t ASTraceEpochNanos;
+_Atomic(ASTraceRing *) ASTraceRings;
+_Thread_local ASTraceRing *ASTraceLocalRing;
+#endif
+
+#endif /* ASTrace_h */
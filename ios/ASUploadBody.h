@@ -0,0 +1,128 @@
+// ios/ASUploadBody.h
+// Upload body writer for the multipart uploads (transcription, Drive): head +
+// audio file + tail streamed into the temp file the upload runs from, instead
+// of being assembled in memory and written atomically. The file is
+// preallocated at its final size (contiguous where the volume allows), filled
+// in 1 MiB block-aligned writes and truncated to what was written. The ring
+// capture engine reserves its segment files with ASUploadBodyPreallocate too.
+//
+// Plain C11 and header-only, so the Linux pipeline benchmark
+// (scripts/benchmarkPipeline.js) builds exactly this code. On Linux the
+// reservation is fallocate(FALLOC_FL_KEEP_SIZE), the counterpart of
+// F_PREALLOCATE, when the includer defines _GNU_SOURCE.
+
+#ifndef ASUploadBody_h
+#define ASUploadBody_h
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define AS_UPLOAD_BLOCK_SIZE (1024 * 1024)
+
+typedef struct {
+    off_t written;
+    off_t expected;
+    bool preallocated;
+} ASUploadBodyResult;
+
+static inline bool ASUploadBodyWriteFully(int fd, const uint8_t *bytes, size_t length) {
+    while (length > 0) {
+        ssize_t written = write(fd, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        bytes += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+// Copies bytes into the block, writing it out each time it fills
+static inline bool ASUploadBodyAppend(int fd, uint8_t *block, size_t *fill, off_t *written, const uint8_t *bytes, size_t length) {
+    while (length > 0) {
+        size_t count = length < AS_UPLOAD_BLOCK_SIZE - *fill ? length : AS_UPLOAD_BLOCK_SIZE - *fill;
+        memcpy(block + *fill, bytes, count);
+        *fill += count;
+        bytes += count;
+        length -= count;
+        if (*fill == AS_UPLOAD_BLOCK_SIZE) {
+            if (!ASUploadBodyWriteFully(fd, block, *fill)) return false;
+            *written += *fill;
+            *fill = 0;
+        }
+    }
+    return true;
+}
+
+// Best effort: without the reservation the writes still succeed
+static inline bool ASUploadBodyPreallocate(int fd, off_t length) {
+#if defined(__APPLE__)
+    fstore_t store = { F_ALLOCATECONTIG | F_ALLOCATEALL, F_PEOFPOSMODE, 0, length, 0 };
+    if (fcntl(fd, F_PREALLOCATE, &store) != -1) return true;
+    store.fst_flags = F_ALLOCATEALL;
+    return fcntl(fd, F_PREALLOCATE, &store) != -1;
+#elif defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+    return fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, length) == 0;
+#else
+    (void)fd;
+    (void)length;
+    return false;
+#endif
+}
+
+// Writes head + the whole of `in` + tail to `out` (both open, left open).
+// On failure returns false with errno set; the caller removes the file.
+static inline bool ASUploadBodyWrite(int out, const uint8_t *head, size_t headLength, int in,
+                                     const uint8_t *tail, size_t tailLength, ASUploadBodyResult *result) {
+    memset(result, 0, sizeof(*result));
+    uint8_t *block = NULL;
+    struct stat sourceInfo;
+    if (fstat(in, &sourceInfo) != 0) return false;
+    int allocated = posix_memalign((void **)&block, (size_t)getpagesize(), AS_UPLOAD_BLOCK_SIZE);
+    if (allocated != 0) {
+        errno = allocated;
+        return false;
+    }
+    result->expected = (off_t)headLength + sourceInfo.st_size + (off_t)tailLength;
+    result->preallocated = ASUploadBodyPreallocate(out, result->expected);
+
+    size_t fill = 0;
+    off_t written = 0;
+    bool ok = ASUploadBodyAppend(out, block, &fill, &written, head, headLength);
+    while (ok) {
+        ssize_t count = read(in, block + fill, AS_UPLOAD_BLOCK_SIZE - fill);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            ok = count == 0;
+            break;
+        }
+        fill += (size_t)count;
+        if (fill == AS_UPLOAD_BLOCK_SIZE) {
+            ok = ASUploadBodyWriteFully(out, block, fill);
+            written += fill;
+            fill = 0;
+        }
+    }
+    ok = ok && ASUploadBodyAppend(out, block, &fill, &written, tail, tailLength);
+    if (ok && fill > 0) {
+        ok = ASUploadBodyWriteFully(out, block, fill);
+        written += fill;
+    }
+    // The reservation can leave allocated space past the end; drop it
+    ok = ok && ftruncate(out, written) == 0;
+
+    int savedErrno = errno;
+    free(block);
+    result->written = written;
+    errno = savedErrno;
+    return ok;
+}
+
+#endif /* ASUploadBody_h */
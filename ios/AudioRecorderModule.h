@@ -25,9 +25,25 @@ typedef NS_ENUM(NSUInteger, PauseOrigin) {
 // Notification name
 extern NSString * const AudioRecordingDidStopNotification;
 
+// The part of AVAudioRecorder the segment logic drives. AVAudioRecorder itself
+// conforms, and so does the ring-buffer capture engine (ASRingCaptureRecorder).
+@protocol ASSegmentRecorder <NSObject>
+@property (readonly) NSURL *url;
+@property (readonly, getter=isRecording) BOOL recording;
+@property (readonly) NSTimeInterval currentTime;
+@property (getter=isMeteringEnabled) BOOL meteringEnabled;
+- (BOOL)prepareToRecord;
+- (BOOL)record;
+- (BOOL)recordForDuration:(NSTimeInterval)duration;
+- (void)pause;
+- (void)stop;
+- (void)updateMeters;
+- (float)averagePowerForChannel:(NSUInteger)channelNumber;
+@end
+
 @interface AudioRecorderModule : RCTEventEmitter <RCTBridgeModule, AVAudioRecorderDelegate>
 
-@property (nonatomic, strong, readonly) AVAudioRecorder *audioRecorder;
+@property (nonatomic, strong, readonly) id<ASSegmentRecorder> audioRecorder;
 @property (nonatomic, strong) NSTimer *recordingTimer; // Should remain for progress updates
 @property (nonatomic, assign, readonly) NSTimeInterval currentRecordingDuration;
 @property (nonatomic, strong, readonly) NSString *currentRecordingFilePath;
@@ -3,6 +3,15 @@
 #import <React/RCTLog.h>
 #import <UIKit/UIApplication.h>
 #import <AVFoundation/AVFoundation.h>
+#import <AudioToolbox/AudioToolbox.h>
+#import <CommonCrypto/CommonDigest.h>
+#import "ASCaptureRing.h"
+#import "ASPlaybackCache.h"
+#import "ASUploadBody.h"
+#define AS_TRACE_IMPLEMENTATION // the trace rings' shared state lives here
+#import "ASTrace.h"
+#define AS_METRICS_IMPLEMENTATION // and the metrics registry
+#import "ASMetrics.h"
 
 // Define Notification Names
 NSNotificationName const AudioRecordingDidStartNotification = @"AudioRecordingDidStartNotification";
@@ -11,9 +20,581 @@ NSNotificationName const AudioRecordingDidStopNotification = @"AudioRecordingDid
 // Define minimum required disk space (e.g., 100MB)
 static const unsigned long long MINIMUM_REQUIRED_DISK_SPACE = 100 * 1024 * 1024;
 
-@interface AudioRecorderModule () <AVAudioRecorderDelegate>
+#pragma mark - Ring buffer capture engine
+
+// Capture with a strict split between the audio path and the disk: the input
+// tap only pushes samples into an ASCaptureRing (no locks, allocation, logging
+// or I/O), and a writer thread drains the ring and encodes/writes through
+// ExtAudioFile. The writer can stall for ASCaptureStallBudgetSeconds before any
+// audio is dropped, and drops are counted rather than silent. The segment file
+// is reserved at bitrate x segment duration up front, so the encoder's small
+// appends land in one extent, and truncated back to its length when finished.
+// One instance records one segment, like AVAudioRecorder; the module picks it
+// with startRecording({ captureEngine: 'ring' }).
+
+static const NSTimeInterval ASCaptureStallBudgetSeconds = 2.0;
+static const AVAudioFrameCount ASCaptureTapFrames = 1024;
+static const uint32_t ASCaptureWriterPeriodMicros = 20000;
+
+@class ASRingCaptureRecorder;
+
+@protocol ASRingCaptureRecorderDelegate <NSObject>
+- (void)segmentRecorderDidFinishRecording:(id<ASSegmentRecorder>)recorder successfully:(BOOL)flag;
+- (void)segmentRecorderEncodeErrorDidOccur:(id<ASSegmentRecorder>)recorder error:(NSError *)error;
+@end
+
+@interface ASRingCaptureRecorder : NSObject <ASSegmentRecorder>
+@property (readonly) NSURL *url;
+@property (readonly, getter=isRecording) BOOL recording;
+@property (getter=isMeteringEnabled) BOOL meteringEnabled;
+@property (nonatomic, weak) id<ASRingCaptureRecorderDelegate> delegate;
+- (instancetype)initWithURL:(NSURL *)url settings:(NSDictionary *)settings error:(NSError **)outError;
+- (NSDictionary *)captureStats;
+@end
+
+static int ASRingCaptureSink(void *context, const float *frames, size_t count);
+
+@implementation ASRingCaptureRecorder
+{
+    NSDictionary *_settings;
+    AVAudioEngine *_engine;
+    ExtAudioFileRef _file;
+    ASCaptureRing _ring;
+    ASCaptureWriter _writer;
+    BOOL _prepared;
+    BOOL _writerRunning;
+    BOOL _finished;
+    double _sampleRate;
+    UInt32 _bitRate;
+    int _reserveFd;              // the segment file while its reservation stands; -1 otherwise
+    uint64_t _limitFrames;       // 0 = no limit; touched by the writer thread only once recording
+    uint64_t _fileFrames;        // writer thread only
+    _Atomic bool _limitReached;
+    _Atomic float _averagePower; // written by the tap
+    float _meteredPower;
+}
+
+@synthesize url = _url;
+@synthesize recording = _recording;
+@synthesize meteringEnabled = _meteringEnabled;
+
+- (instancetype)initWithURL:(NSURL *)url settings:(NSDictionary *)settings error:(NSError **)outError
+{
+    self = [super init];
+    if (self) {
+        _url = url;
+        _settings = [settings copy];
+        _reserveFd = -1;
+        _averagePower = -160.0f;
+        _meteredPower = -160.0f;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self releaseCapture];
+}
+
+- (NSError *)errorWithStatus:(OSStatus)status description:(NSString *)description
+{
+    return [NSError errorWithDomain:NSOSStatusErrorDomain code:status userInfo:@{ NSLocalizedDescriptionKey: description }];
+}
+
+- (BOOL)prepareToRecord
+{
+    if (_prepared) return YES;
+    NSError *error = nil;
+    if (![self prepareCapture:&error]) {
+        RCTLogError(@"[AudioRecorderModule] Ring capture could not be prepared: %@", error);
+        [self releaseCapture];
+        return NO;
+    }
+    _prepared = YES;
+    return YES;
+}
+
+- (BOOL)prepareCapture:(NSError **)error
+{
+    _engine = [[AVAudioEngine alloc] init];
+    AVAudioInputNode *input = _engine.inputNode;
+    AVAudioFormat *inputFormat = [input outputFormatForBus:0];
+    _sampleRate = inputFormat.sampleRate;
+    if (_sampleRate <= 0 || inputFormat.channelCount == 0) {
+        if (error) *error = [self errorWithStatus:kAudio_ParamError description:@"No audio input available"];
+        return NO;
+    }
+
+    // Encoded file: the same AAC settings AVAudioRecorder gets; mono float in at the input rate
+    AudioStreamBasicDescription fileFormat = {0};
+    fileFormat.mFormatID = kAudioFormatMPEG4AAC;
+    fileFormat.mSampleRate = [_settings[AVSampleRateKey] doubleValue] ?: 44100.0;
+    fileFormat.mChannelsPerFrame = 1;
+    OSStatus status = ExtAudioFileCreateWithURL((__bridge CFURLRef)_url, kAudioFileM4AType, &fileFormat, NULL,
+                                                kAudioFileFlags_EraseFile, &_file);
+    if (status != noErr) {
+        if (error) *error = [self errorWithStatus:status description:@"Could not create the segment file"];
+        return NO;
+    }
+    AudioStreamBasicDescription clientFormat = {0};
+    clientFormat.mFormatID = kAudioFormatLinearPCM;
+    clientFormat.mFormatFlags = kAudioFormatFlagIsFloat | kAudioFormatFlagIsPacked;
+    clientFormat.mSampleRate = _sampleRate;
+    clientFormat.mChannelsPerFrame = 1;
+    clientFormat.mFramesPerPacket = 1;
+    clientFormat.mBitsPerChannel = 32;
+    clientFormat.mBytesPerFrame = 4;
+    clientFormat.mBytesPerPacket = 4;
+    status = ExtAudioFileSetProperty(_file, kExtAudioFileProperty_ClientDataFormat, sizeof(clientFormat), &clientFormat);
+    if (status != noErr) {
+        if (error) *error = [self errorWithStatus:status description:@"Could not set the capture format"];
+        return NO;
+    }
+    AudioConverterRef converter = NULL;
+    UInt32 size = sizeof(converter);
+    _bitRate = [_settings[AVEncoderBitRateKey] unsignedIntValue] ?: 128000;
+    if (ExtAudioFileGetProperty(_file, kExtAudioFileProperty_AudioConverter, &size, &converter) == noErr && converter) {
+        UInt32 bitRate = _bitRate;
+        AudioConverterSetProperty(converter, kAudioConverterEncodeBitRate, sizeof(bitRate), &bitRate);
+        CFArrayRef config = NULL;
+        ExtAudioFileSetProperty(_file, kExtAudioFileProperty_ConverterConfig, sizeof(config), &config);
+    }
+
+    if (!ASCaptureRingInit(&_ring, ASCaptureRingCapacityForBudget(_sampleRate, ASCaptureStallBudgetSeconds, ASCaptureTapFrames))) {
+        if (error) *error = [self errorWithStatus:kAudio_MemFullError description:@"Could not allocate the capture ring"];
+        return NO;
+    }
+
+    // The tap is the audio path: push and meter, nothing else
+    ASCaptureRing *ring = &_ring;
+    _Atomic float *averagePower = &_averagePower;
+    [input installTapOnBus:0 bufferSize:ASCaptureTapFrames format:inputFormat block:^(AVAudioPCMBuffer *buffer, AVAudioTime *when) {
+        const float *samples = buffer.floatChannelData ? buffer.floatChannelData[0] : NULL;
+        AVAudioFrameCount count = buffer.frameLength;
+        if (!samples || count == 0) return;
+        ASCaptureRingPush(ring, samples, count);
+        float sum = 0;
+        for (AVAudioFrameCount i = 0; i < count; i++) sum += samples[i] * samples[i];
+        float meanSquare = sum / count;
+        atomic_store_explicit(averagePower, meanSquare > 1e-16f ? 10.0f * log10f(meanSquare) : -160.0f, memory_order_relaxed);
+    }];
+    [_engine prepare];
+    return YES;
+}
+
+// Writer thread: encode and append, stopping at the segment's duration
+- (int)writeFrames:(const float *)frames count:(size_t)count
+{
+    AS_TRACE_DETAIL_SPAN_VALUE("capture.write", count);
+    if (_limitFrames > 0) {
+        if (_fileFrames >= _limitFrames) return 0; // past the end of the segment
+        count = (size_t)MIN((uint64_t)count, _limitFrames - _fileFrames);
+    }
+    AudioBufferList list;
+    list.mNumberBuffers = 1;
+    list.mBuffers[0].mNumberChannels = 1;
+    list.mBuffers[0].mDataByteSize = (UInt32)(count * sizeof(float));
+    list.mBuffers[0].mData = (void *)frames;
+    OSStatus status = ExtAudioFileWrite(_file, (UInt32)count, &list);
+    if (status != noErr) {
+        __weak ASRingCaptureRecorder *weakSelf = self;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            ASRingCaptureRecorder *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            [strongSelf.delegate segmentRecorderEncodeErrorDidOccur:strongSelf
+                                                              error:[strongSelf errorWithStatus:status description:@"Could not encode captured audio"]];
+            [strongSelf finishSuccessfully:NO];
+        });
+        return (int)status;
+    }
+    _fileFrames += count;
+    if (_limitFrames > 0 && _fileFrames >= _limitFrames && !atomic_exchange(&_limitReached, true)) {
+        __weak ASRingCaptureRecorder *weakSelf = self;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf finishSuccessfully:YES];
+        });
+    }
+    return 0;
+}
+
+- (BOOL)record
+{
+    if (_finished || ![self prepareToRecord]) return NO;
+    if (!_writerRunning) {
+        if (ASCaptureWriterStart(&_writer, &_ring, ASRingCaptureSink, (__bridge void *)self, ASCaptureWriterPeriodMicros) != 0) {
+            RCTLogError(@"[AudioRecorderModule] Ring capture writer thread could not start");
+            return NO;
+        }
+        _writerRunning = YES;
+    }
+    NSError *error = nil;
+    if (![_engine startAndReturnError:&error]) {
+        RCTLogError(@"[AudioRecorderModule] Ring capture engine could not start: %@", error);
+        return NO;
+    }
+    _recording = YES;
+    return YES;
+}
+
+- (BOOL)recordForDuration:(NSTimeInterval)duration
+{
+    if (![self prepareToRecord]) return NO;
+    if (!_writerRunning) {
+        _limitFrames = duration > 0 ? (uint64_t)(duration * _sampleRate) : 0; // set before the writer thread exists
+        if (duration > 0) [self reserveSegmentForDuration:duration];
+    }
+    return [self record];
+}
+
+// Best effort, like the upload bodies: without it the writes still succeed
+- (void)reserveSegmentForDuration:(NSTimeInterval)duration
+{
+    if (_reserveFd >= 0) return;
+    _reserveFd = open(_url.fileSystemRepresentation, O_WRONLY | O_CLOEXEC);
+    off_t expected = (off_t)(_bitRate / 8.0 * duration);
+    if (_reserveFd < 0 || !ASUploadBodyPreallocate(_reserveFd, expected)) {
+        AS_METRIC_COUNT("capture.segmentNotPreallocated", 1);
+    }
+}
+
+// Drops whatever of the reservation the encoded file did not use
+- (void)releaseReservation
+{
+    if (_reserveFd < 0) return;
+    struct stat info;
+    if (fstat(_reserveFd, &info) == 0) ftruncate(_reserveFd, info.st_size);
+    close(_reserveFd);
+    _reserveFd = -1;
+}
+
+- (void)pause
+{
+    if (!_recording) return;
+    [_engine pause];
+    _recording = NO;
+}
+
+- (void)stop
+{
+    [self finishSuccessfully:YES];
+}
+
+- (void)finishSuccessfully:(BOOL)flag
+{
+    if (_finished) return;
+    _finished = YES;
+    AS_TRACE_SPAN("capture.finish");
+    [_engine.inputNode removeTapOnBus:0];
+    [_engine stop];
+    _recording = NO;
+    if (_writerRunning) {
+        ASCaptureWriterStop(&_writer); // final drain: everything the tap pushed reaches the file
+        _writerRunning = NO;
+    }
+    ASCaptureStats stats = ASCaptureStatsRead(&_ring, &_writer);
+    OSStatus status = _file ? ExtAudioFileDispose(_file) : noErr;
+    _file = NULL;
+    [self releaseReservation];
+    AS_METRIC_COUNT("capture.frames", stats.pushedFrames);
+    AS_METRIC_COUNT("capture.droppedFrames", stats.droppedFrames);
+    AS_METRIC_COUNT("capture.overruns", stats.overruns);
+    AS_METRIC_GAUGE_SET("capture.ringHighWaterFrames", stats.highWaterFrames);
+    AS_METRIC_RECORD("capture.maxWriteUs", "us", stats.maxSinkNanos / 1000);
+    [self.delegate segmentRecorderDidFinishRecording:self successfully:(flag && status == noErr && stats.sinkError == 0)];
+}
+
+- (void)releaseCapture
+{
+    if (_engine) {
+        [_engine.inputNode removeTapOnBus:0];
+        [_engine stop];
+        _engine = nil;
+    }
+    if (_writerRunning) {
+        ASCaptureWriterStop(&_writer);
+        _writerRunning = NO;
+    }
+    if (_file) {
+        ExtAudioFileDispose(_file);
+        _file = NULL;
+    }
+    [self releaseReservation];
+    ASCaptureRingDestroy(&_ring);
+}
+
+- (NSTimeInterval)currentTime
+{
+    if (_sampleRate <= 0) return 0;
+    uint64_t captured = atomic_load_explicit(&_ring.pushedFrames, memory_order_relaxed) +
+                        atomic_load_explicit(&_ring.droppedFrames, memory_order_relaxed);
+    if (_limitFrames > 0) captured = MIN(captured, _limitFrames);
+    return captured / _sampleRate;
+}
+
+- (void)updateMeters
+{
+    _meteredPower = atomic_load_explicit(&_averagePower, memory_order_relaxed);
+}
+
+- (float)averagePowerForChannel:(NSUInteger)channelNumber
+{
+    return _meteringEnabled ? _meteredPower : -160.0f;
+}
+
+- (NSDictionary *)captureStats
+{
+    ASCaptureStats stats = ASCaptureStatsRead(&_ring, &_writer);
+    return @{
+        @"sampleRate": @(_sampleRate),
+        @"capacityFrames": @(stats.capacityFrames),
+        @"stallBudgetSeconds": @(_sampleRate > 0 ? ASCaptureRingStallBudget(&_ring, _sampleRate, ASCaptureTapFrames) : 0),
+        @"highWaterFrames": @(stats.highWaterFrames),
+        @"pushedFrames": @(stats.pushedFrames),
+        @"droppedFrames": @(stats.droppedFrames),
+        @"overruns": @(stats.overruns),
+        @"writtenFrames": @(stats.writtenFrames),
+        @"maxWriteMs": @(stats.maxSinkNanos / 1e6),
+    };
+}
+
+@end
+
+static int ASRingCaptureSink(void *context, const float *frames, size_t count)
+{
+    return [(__bridge ASRingCaptureRecorder *)context writeFrames:frames count:count];
+}
+
+@interface AVAudioRecorder (ASSegmentRecorder) <ASSegmentRecorder>
+@end
+
+@implementation AVAudioRecorder (ASSegmentRecorder)
+@end
+
+#pragma mark - Shared playback cache
+
+// Every playback item, export and prefetch goes through two process-wide
+// ASPlaybackCaches: segment assets with their duration and tracks loaded (the
+// file open and sample table parse), and the compositions built from them. A
+// lesson reopened, or played by two players at once, reuses both instead of
+// parsing each segment again. AVPlayer does its own decoding and read-ahead
+// within an item, so what is shared here is everything before the decoder.
+
+static const size_t ASPlaybackAssetCacheEntries = 32;
+static const size_t ASPlaybackCompositionCacheEntries = 6;
+static const uint64_t ASPlaybackCacheMaxSeconds = 4 * 60 * 60; // per cache
+static const int64_t ASPlaybackAssetLoadTimeoutSeconds = 10;
+
+static ASPlaybackCache ASSegmentAssetCache;
+static ASPlaybackCache ASCompositionCache;
+
+static void *ASPlaybackCacheRetainObject(void *value) { return (void *)CFRetain(value); }
+static void ASPlaybackCacheReleaseObject(void *value) { CFRelease(value); }
+
+static void ASPlaybackCachesSetUp(void)
+{
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        ASPlaybackCacheInit(&ASSegmentAssetCache, ASPlaybackAssetCacheEntries, ASPlaybackCacheMaxSeconds,
+                            ASPlaybackCacheRetainObject, ASPlaybackCacheReleaseObject);
+        ASPlaybackCacheInit(&ASCompositionCache, ASPlaybackCompositionCacheEntries, ASPlaybackCacheMaxSeconds,
+                            ASPlaybackCacheRetainObject, ASPlaybackCacheReleaseObject);
+    });
+}
+
+// Path, size and modification time: a file rewritten in place gets a new key
+static NSString *ASPlaybackAssetKey(NSString *path)
+{
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil];
+    if (!attributes) return nil;
+    return [NSString stringWithFormat:@"%@|%llu|%.3f", path, [attributes fileSize],
+            [[attributes fileModificationDate] timeIntervalSince1970]];
+}
+
+static NSDictionary *ASPlaybackCacheStatsDictionary(ASPlaybackCache *cache)
+{
+    ASPlaybackCacheStats stats = ASPlaybackCacheStatsRead(cache);
+    return @{
+        @"entries": @(stats.entries),
+        @"seconds": @(stats.cost),
+        @"hits": @(stats.hits),
+        @"misses": @(stats.misses),
+        @"evictions": @(stats.evictions),
+        @"prefetches": @(stats.prefetches),
+        @"prefetchHits": @(stats.prefetchHits),
+    };
+}
+
+// The loaded asset of each segment, in order (NSNull where it could not be
+// read). Misses load in parallel, so a lesson's segments parse concurrently
+// rather than one synchronous asset.duration after another.
+static NSArray *ASPlaybackSegmentAssets(NSArray<NSString *> *segmentPaths, BOOL prefetch)
+{
+    ASPlaybackCachesSetUp();
+    NSMutableArray *assets = [NSMutableArray arrayWithCapacity:segmentPaths.count];
+    NSMutableArray<NSNumber *> *missing = [NSMutableArray new];
+    NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithCapacity:segmentPaths.count];
+    dispatch_group_t group = dispatch_group_create();
+    NSArray<NSString *> *loadKeys = @[@"duration", @"tracks"];
+
+    for (NSUInteger i = 0; i < segmentPaths.count; i++) {
+        NSString *key = ASPlaybackAssetKey(segmentPaths[i]) ?: @"";
+        [keys addObject:key];
+        void *cached = key.length > 0 ? ASPlaybackCacheLookup(&ASSegmentAssetCache, key.UTF8String) : NULL;
+        if (cached) {
+            [assets addObject:CFBridgingRelease(cached)];
+            continue;
+        }
+        AVURLAsset *asset = [AVURLAsset URLAssetWithURL:[NSURL fileURLWithPath:segmentPaths[i]] options:nil];
+        [assets addObject:asset];
+        [missing addObject:@(i)];
+        dispatch_group_enter(group);
+        [asset loadValuesAsynchronouslyForKeys:loadKeys completionHandler:^{
+            dispatch_group_leave(group);
+        }];
+    }
+    if (missing.count == 0) return assets;
+
+    if (dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, ASPlaybackAssetLoadTimeoutSeconds * NSEC_PER_SEC)) != 0) {
+        RCTLogWarn(@"[AudioRecorderModule] Segment assets still loading after %llds", ASPlaybackAssetLoadTimeoutSeconds);
+    }
+    for (NSNumber *index in missing) {
+        AVURLAsset *asset = assets[index.unsignedIntegerValue];
+        NSError *error = nil;
+        BOOL loaded = YES;
+        for (NSString *loadKey in loadKeys) {
+            if ([asset statusOfValueForKey:loadKey error:&error] != AVKeyValueStatusLoaded) loaded = NO;
+        }
+        if (!loaded || [asset tracksWithMediaType:AVMediaTypeAudio].count == 0) {
+            RCTLogError(@"[AudioRecorderModule] Could not load segment %@: %@", asset.URL.path, error);
+            assets[index.unsignedIntegerValue] = [NSNull null];
+            continue;
+        }
+        NSString *key = keys[index.unsignedIntegerValue];
+        if (key.length > 0) {
+            ASPlaybackCacheInsert(&ASSegmentAssetCache, key.UTF8String, (__bridge void *)asset,
+                                  (uint64_t)ceil(CMTimeGetSeconds(asset.duration)), prefetch);
+        }
+    }
+    return assets;
+}
+
+// The segments back to back as one composition, shared by every item playing them
+static AVComposition *ASPlaybackComposition(NSArray<NSString *> *segmentPaths, BOOL prefetch)
+{
+    ASPlaybackCachesSetUp();
+    NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithCapacity:segmentPaths.count];
+    for (NSString *path in segmentPaths) {
+        NSString *key = ASPlaybackAssetKey(path);
+        if (!key) {
+            keys = nil;
+            break;
+        }
+        [keys addObject:key];
+    }
+    NSString *compositionKey = [keys componentsJoinedByString:@"\n"];
+    void *cached = compositionKey.length > 0 ? ASPlaybackCacheLookup(&ASCompositionCache, compositionKey.UTF8String) : NULL;
+    if (cached) return CFBridgingRelease(cached);
+
+    AVMutableComposition *composition = [AVMutableComposition composition];
+    CMTime cursor = kCMTimeZero;
+    BOOL complete = YES;
+    NSArray *assets = ASPlaybackSegmentAssets(segmentPaths, prefetch);
+    for (NSUInteger i = 0; i < assets.count; i++) {
+        if (assets[i] == [NSNull null]) {
+            complete = NO;
+            continue;
+        }
+        AVURLAsset *asset = assets[i];
+        CMTimeRange range = CMTimeRangeMake(kCMTimeZero, asset.duration);
+        NSError *err = nil;
+        if (![composition insertTimeRange:range ofAsset:asset atTime:cursor error:&err]) {
+            RCTLogError(@"[AudioRecorderModule] Failed to insert asset %@: %@", segmentPaths[i], err);
+            complete = NO;
+            continue;
+        }
+        cursor = CMTimeAdd(cursor, asset.duration);
+    }
+    // Items share an immutable copy; a composition missing a segment is not cached
+    AVComposition *shared = [composition copy];
+    if (compositionKey.length > 0 && complete) {
+        ASPlaybackCacheInsert(&ASCompositionCache, compositionKey.UTF8String, (__bridge void *)shared,
+                              (uint64_t)ceil(CMTimeGetSeconds(cursor)), prefetch);
+    }
+    return shared;
+}
+
+#pragma mark - Runtime metrics
+
+// The registry (ios/ASMetrics.h) is fed here and from BackgroundTransferManager.m;
+// getMetrics reads it whole
+
+static CFAbsoluteTime ASMetricsStartedAt;
+
+// Export duration by name (not AS_METRIC: the name varies, and exports are rare
+// enough for the registry lookup), plus the failure count
+static void ASRecordExport(const char *name, CFAbsoluteTime start, AVAssetExportSessionStatus status)
+{
+    ASMetricRecord(ASMetricsRegister(name, ASMetricHistogram, "ms"), (uint64_t)((CFAbsoluteTimeGetCurrent() - start) * 1000));
+    if (status != AVAssetExportSessionStatusCompleted) AS_METRIC_COUNT("export.failures", 1);
+}
+
+// With buckets, each histogram also carries its non-empty buckets as [lower bound, count]
+static NSDictionary *ASMetricsDictionary(BOOL buckets)
+{
+    NSMutableDictionary *counters = [NSMutableDictionary dictionary];
+    NSMutableDictionary *gauges = [NSMutableDictionary dictionary];
+    NSMutableDictionary *histograms = [NSMutableDictionary dictionary];
+    ASMetricsHistogramSnapshot *snapshot = malloc(sizeof(ASMetricsHistogramSnapshot));
+    int count = atomic_load_explicit(&ASMetricsCount, memory_order_acquire);
+    for (int i = 0; i < count && snapshot; i++) {
+        ASMetric *metric = &ASMetricsRegistry[i];
+        NSString *name = @(metric->name);
+        if (metric->kind == ASMetricCounter) {
+            counters[name] = @(atomic_load_explicit(&metric->count, memory_order_relaxed));
+        } else if (metric->kind == ASMetricGauge) {
+            gauges[name] = @{
+                @"value": @(atomic_load_explicit(&metric->value, memory_order_relaxed)),
+                @"peak": @(atomic_load_explicit(&metric->peak, memory_order_relaxed))
+            };
+        } else {
+            ASMetricsHistogramRead(metric, snapshot);
+            NSMutableDictionary *histogram = [@{
+                @"unit": metric->unit ? @(metric->unit) : @"",
+                @"count": @(snapshot->count),
+                @"sum": @(snapshot->sum),
+                @"min": @(snapshot->min),
+                @"max": @(snapshot->max),
+                @"mean": @(snapshot->count ? (double)snapshot->sum / snapshot->count : 0),
+                @"p50": @(ASMetricsPercentile(snapshot, 0.5)),
+                @"p90": @(ASMetricsPercentile(snapshot, 0.9)),
+                @"p99": @(ASMetricsPercentile(snapshot, 0.99)),
+                @"p999": @(ASMetricsPercentile(snapshot, 0.999))
+            } mutableCopy];
+            if (buckets) {
+                NSMutableArray *pairs = [NSMutableArray array];
+                for (int b = 0; b < AS_METRICS_BUCKETS; b++) {
+                    if (snapshot->buckets[b] == 0) continue;
+                    uint64_t width;
+                    [pairs addObject:@[@(ASMetricsBucketLower(b, &width)), @(snapshot->buckets[b])]];
+                }
+                histogram[@"buckets"] = pairs;
+            }
+            histograms[name] = histogram;
+        }
+    }
+    free(snapshot);
+    return @{
+        @"since": @(round((ASMetricsStartedAt + kCFAbsoluteTimeIntervalSince1970) * 1000)),
+        @"uptime": @(CFAbsoluteTimeGetCurrent() - ASMetricsStartedAt),
+        @"counters": counters,
+        @"gauges": gauges,
+        @"histograms": histograms
+    };
+}
+
+@interface AudioRecorderModule () <AVAudioRecorderDelegate, ASRingCaptureRecorderDelegate>
 // Redeclare readonly properties from .h as readwrite for internal mutation
-@property (nonatomic, strong, readwrite) AVAudioRecorder *audioRecorder;
+@property (nonatomic, strong, readwrite) id<ASSegmentRecorder> audioRecorder;
 @property (nonatomic, assign, readwrite) BOOL isPaused;
 @property (nonatomic, strong, readwrite) NSMutableArray *recordingSegments;
 @property (nonatomic, assign, readwrite) NSTimeInterval currentRecordingDuration;
@@ -24,6 +605,10 @@ static const unsigned long long MINIMUM_REQUIRED_DISK_SPACE = 100 * 1024 * 1024;
 @property (nonatomic, strong, readwrite) dispatch_queue_t eventDispatchQueue;
 @property (nonatomic, assign, readwrite) PauseOrigin currentPauseOrigin;
 @property (nonatomic, assign, readwrite) SegmentStopReason currentStopReason;
+@property (nonatomic, copy) NSString *captureEngine; // nil (AVAudioRecorder) or @"ring"
+@property (nonatomic, copy) NSDictionary *lastCaptureStats; // ring engine, last finished segment
+@property (nonatomic, assign) uint64_t segmentFinishedTicks; // ASTraceTicks() at the last segment's finish, for the rollover span
+@property (nonatomic, assign) CFTimeInterval segmentFinishedAt; // the same for the rollover gap metric
 
 // Do not redeclare properties that are already readwrite in the .h file:
 // - totalPauseDuration
@@ -66,6 +651,10 @@ RCT_EXPORT_MODULE();
 {
     self = [super init];
     if (self) {
+        static dispatch_once_t metricsOnce;
+        dispatch_once(&metricsOnce, ^{
+            ASMetricsStartedAt = CFAbsoluteTimeGetCurrent();
+        });
         _isPaused = NO;
         _currentRecordingDuration = 0;
         _totalPauseDuration = 0;
@@ -90,6 +679,11 @@ RCT_EXPORT_MODULE();
                                                      name:AVAudioSessionRouteChangeNotification
                                                    object:nil];
         
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(handleMemoryWarning:)
+                                                     name:UIApplicationDidReceiveMemoryWarningNotification
+                                                   object:nil];
+        
         // Initialize playback dictionaries and counters
         self.playbackPlayers = [NSMutableDictionary new];
         self.playbackTimeObservers = [NSMutableDictionary new];
@@ -122,6 +716,14 @@ RCT_EXPORT_MODULE();
     ];
 }
 
+// Every event the module emits goes through here (progress ticks included)
+- (void)sendEventWithName:(NSString *)eventName body:(id)body
+{
+    AS_TRACE_DETAIL_SPAN_LABEL("bridge.emit", eventName.UTF8String);
+    AS_METRIC_COUNT("bridge.recorderEvents", 1);
+    [super sendEventWithName:eventName body:body];
+}
+
 // Will be called when this module's first listener is added.
 -(void)startObserving
 {
@@ -175,19 +777,14 @@ RCT_EXPORT_MODULE();
 
 - (void)updateRecordingProgress
 {
-    RCTLogInfo(@"[AudioRecorderModule] updateRecordingProgress called."); // Re-enable for debugging
-    RCTLogInfo(@"[AudioRecorderModule] updateRecordingProgress: Is Main Thread? %s", [NSThread isMainThread] ? "YES" : "NO");
-    
+    // Runs every tick while recording: no logging here outside debug builds
     // Guard: Only proceed if the recorder exists and is actively recording.
     // Also ensure not paused, as sending progress events during pause might be misleading depending on UI.
     if (!self.audioRecorder || !self.audioRecorder.isRecording || self.isPaused) {
-        if (!self.audioRecorder) {
-            RCTLogInfo(@"[AudioRecorderModule] updateRecordingProgress: audioRecorder is nil. Skipping progress update.");
-        } else if (!self.audioRecorder.isRecording) {
-            RCTLogInfo(@"[AudioRecorderModule] updateRecordingProgress: audioRecorder is not recording. Skipping progress update.");
-        } else if (self.isPaused) {
-            RCTLogInfo(@"[AudioRecorderModule] updateRecordingProgress: Recording is paused. Skipping progress update.");
-        }
+#if DEBUG
+        RCTLogInfo(@"[AudioRecorderModule] updateRecordingProgress: not recording (recorder %@, paused %d). Skipping progress update.",
+                   self.audioRecorder ? @"present" : @"nil", self.isPaused);
+#endif
         return;
     }
 
@@ -201,8 +798,10 @@ RCT_EXPORT_MODULE();
     if (self.audioRecorder.recording) {
         averagePower = [self.audioRecorder averagePowerForChannel:0];
     }
+#if DEBUG
     RCTLogInfo(@"[AudioRecorderModule] Progress - currentTime: %f, metering: %f, recordingId: %@, segment: %lu",
                effectiveCurrentTime, averagePower, self.currentRecordingId, (unsigned long)(self.recordingSegments.count + 1));
+#endif
     if (hasListeners) {
         dispatch_async(self.eventDispatchQueue, ^{
             AudioRecorderModule *strongSelf = self;
@@ -397,6 +996,15 @@ RCT_EXPORT_MODULE();
     }
 }
 
+// Items already playing keep their composition; only the cache lets go
+- (void)handleMemoryWarning:(NSNotification *)notification
+{
+    ASPlaybackCachesSetUp();
+    ASPlaybackCacheRemoveAll(&ASCompositionCache);
+    ASPlaybackCacheRemoveAll(&ASSegmentAssetCache);
+    RCTLogInfo(@"[AudioRecorderModule] Memory warning: playback cache emptied");
+}
+
 - (void)handleAudioRouteChange:(NSNotification *)notification
 {
     NSInteger reason = [notification.userInfo[AVAudioSessionRouteChangeReasonKey] integerValue];
@@ -448,7 +1056,24 @@ RCT_EXPORT_MODULE();
 
 - (void)audioRecorderDidFinishRecording:(AVAudioRecorder *)recorder successfully:(BOOL)flag
 {
+    [self segmentRecorderDidFinishRecording:recorder successfully:flag];
+}
+
+- (void)segmentRecorderDidFinishRecording:(id<ASSegmentRecorder>)recorder successfully:(BOOL)flag
+{
+    AS_TRACE_SPAN("recorder.didFinish");
+    self.segmentFinishedTicks = AS_TRACE_TICKS();
+    self.segmentFinishedAt = CACurrentMediaTime();
+    // One call site per name: AS_METRIC caches the first name registered at a site
+    if (flag) {
+        AS_METRIC_COUNT("recorder.segments", 1);
+    } else {
+        AS_METRIC_COUNT("recorder.failedSegments", 1);
+    }
     RCTLogInfo(@"[AudioRecorderModule] audioRecorderDidFinishRecording: successfully: %d, recorderPath: %@", flag, recorder.url.path);
+    if ([recorder isKindOfClass:[ASRingCaptureRecorder class]]) {
+        self.lastCaptureStats = [(ASRingCaptureRecorder *)recorder captureStats];
+    }
     AudioRecorderModule *strongSelf = self;
     if (!strongSelf) return;
 
@@ -574,7 +1199,7 @@ RCT_EXPORT_MODULE();
             }
             
             // Always clear the delegate and nil out the recorder instance that just finished
-            recorder.delegate = nil;
+            [strongSelfForBlock detachSegmentRecorder:recorder];
             if (strongSelfForBlock.audioRecorder == recorder) {
                 strongSelfForBlock.audioRecorder = nil;
             }
@@ -588,6 +1213,7 @@ RCT_EXPORT_MODULE();
 }
 
 - (BOOL)startNextSegment {
+    AS_TRACE_SPAN("recorder.startNextSegment");
     // Segment finished by time - this is the path for continuous recording
     RCTLogInfo(@"[AudioRecorderModule] Starting next segment.");
     
@@ -623,11 +1249,8 @@ RCT_EXPORT_MODULE();
     }
     self.currentRecordingFilePath = nextSegmentFilePath;
 
-    NSDictionary *settings = [self getAudioRecordingSettings];
     NSError *error = nil;
-    self.audioRecorder = [[AVAudioRecorder alloc] initWithURL:[NSURL fileURLWithPath:nextSegmentFilePath] 
-                                                       settings:settings 
-                                                          error:&error];
+    self.audioRecorder = [self makeSegmentRecorderForPath:nextSegmentFilePath error:&error];
     if (!self.audioRecorder || error) {
         NSString *errorMsg = error ? error.localizedDescription : @"Failed to initialize audio recorder for next segment.";
         if (self.segmentTransitionBackgroundTaskID != UIBackgroundTaskInvalid) {
@@ -637,12 +1260,13 @@ RCT_EXPORT_MODULE();
         [self handleCriticalRecordingErrorAndStop:errorMsg];
         return NO;
     }
-    self.audioRecorder.delegate = self;
-    [self.audioRecorder setMeteringEnabled:YES];
     self.durationAtSegmentStart = CACurrentMediaTime();
     [self.audioRecorder prepareToRecord];
     
     if ([self.audioRecorder recordForDuration:self.maxSegmentDuration]) {
+        // Previous segment's finish to this one recording: the audio the rollover can miss
+        AS_TRACE_COMPLETE("recorder.rollover", self.segmentFinishedTicks, self.recordingSegments.count + 1);
+        AS_METRIC_RECORD("recorder.rolloverGapUs", "us", (CACurrentMediaTime() - self.segmentFinishedAt) * 1e6);
         RCTLogInfo(@"[AudioRecorderModule] Successfully started next segment (%lu) at %@ for %.f seconds", 
                    (unsigned long)(self.recordingSegments.count + 1), 
                    nextSegmentFilePath, 
@@ -660,7 +1284,7 @@ RCT_EXPORT_MODULE();
         return YES;
     } else {
         // Clean up the recorder
-        self.audioRecorder.delegate = nil;
+        [self detachSegmentRecorder:self.audioRecorder];
         self.audioRecorder = nil;
         // Try to delete the file if it was created
         [[NSFileManager defaultManager] removeItemAtPath:nextSegmentFilePath error:nil];
@@ -678,6 +1302,11 @@ RCT_EXPORT_MODULE();
 }
 
 - (void)audioRecorderEncodeErrorDidOccur:(AVAudioRecorder *)recorder error:(NSError *)error
+{
+    [self segmentRecorderEncodeErrorDidOccur:recorder error:error];
+}
+
+- (void)segmentRecorderEncodeErrorDidOccur:(id<ASSegmentRecorder>)recorder error:(NSError *)error
 {
     RCTLogError(@"[AudioRecorderModule] Audio encoding error: %@", error);
     [self emitError:[NSString stringWithFormat:@"Audio encoding error: %@", error.localizedDescription]];
@@ -685,6 +1314,32 @@ RCT_EXPORT_MODULE();
 
 #pragma mark - Internal Recording Control Methods
 
+// AVAudioRecorder, or the ring capture engine when the session asked for it
+- (id<ASSegmentRecorder>)makeSegmentRecorderForPath:(NSString *)filePath error:(NSError **)error
+{
+    NSURL *url = [NSURL fileURLWithPath:filePath];
+    NSDictionary *settings = [self getAudioRecordingSettings];
+    if ([self.captureEngine isEqualToString:@"ring"]) {
+        ASRingCaptureRecorder *recorder = [[ASRingCaptureRecorder alloc] initWithURL:url settings:settings error:error];
+        recorder.delegate = self;
+        recorder.meteringEnabled = YES;
+        return recorder;
+    }
+    AVAudioRecorder *recorder = [[AVAudioRecorder alloc] initWithURL:url settings:settings error:error];
+    recorder.delegate = self;
+    recorder.meteringEnabled = YES;
+    return recorder;
+}
+
+- (void)detachSegmentRecorder:(id<ASSegmentRecorder>)recorder
+{
+    if ([recorder isKindOfClass:[ASRingCaptureRecorder class]]) {
+        ((ASRingCaptureRecorder *)recorder).delegate = nil;
+    } else if ([recorder isKindOfClass:[AVAudioRecorder class]]) {
+        ((AVAudioRecorder *)recorder).delegate = nil;
+    }
+}
+
 - (void)startRecordingInternal:(NSString *)filePath recordingId:(NSString *)recordingId options:(NSDictionary *)options
 {
     RCTLogInfo(@"[AudioRecorderModule] >>> RCTLog: Entered startRecordingInternal <<< ");
@@ -706,20 +1361,18 @@ RCT_EXPORT_MODULE();
     
     // Initialize recorder
     NSError *error = nil;
-    NSURL *url = [NSURL fileURLWithPath:filePath];
-    NSDictionary *settings = [self getAudioRecordingSettings];
+    id engine = options[@"captureEngine"];
+    self.captureEngine = [engine isKindOfClass:[NSString class]] ? engine : nil;
+    self.lastCaptureStats = nil;
+    self.audioRecorder = [self makeSegmentRecorderForPath:filePath error:&error];
     
-    self.audioRecorder = [[AVAudioRecorder alloc] initWithURL:url settings:settings error:&error];
-    
-    if (error) {
+    if (!self.audioRecorder || error) {
         RCTLogError(@"[AudioRecorderModule] *** ERROR initializing AVAudioRecorder: %@ ***", error);
         [self emitError:[NSString stringWithFormat:@"Recorder Error: Initialization failed: %@", error.localizedDescription]];
         return;
     }
-    RCTLogInfo(@"[AudioRecorderModule] startRecordingInternal: AVAudioRecorder initialized successfully.");
+    RCTLogInfo(@"[AudioRecorderModule] startRecordingInternal: Recorder initialized successfully (engine: %@).", self.captureEngine ?: @"recorder");
     
-    self.audioRecorder.delegate = self;
-    [self.audioRecorder setMeteringEnabled:YES];
     self.durationAtSegmentStart = CACurrentMediaTime();
     RCTLogInfo(@"[AudioRecorderModule] startRecordingInternal: Preparing to record...");
     
@@ -1180,6 +1833,53 @@ RCT_EXPORT_METHOD(resumeRecording:(RCTPromiseResolveBlock)resolve rejecter:(RCTP
     }
 }
 
+// Ring capture engine stats: the segment being recorded, else the last one finished
+RCT_EXPORT_METHOD(getCaptureStats:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject)
+{
+    id<ASSegmentRecorder> recorder = self.audioRecorder;
+    if ([recorder isKindOfClass:[ASRingCaptureRecorder class]]) {
+        resolve([(ASRingCaptureRecorder *)recorder captureStats]);
+        return;
+    }
+    resolve(self.lastCaptureStats ?: [NSNull null]);
+}
+
+// Counters, gauges and histograms from the recorder, exports and transfers since
+// launch; options.buckets adds each histogram's buckets (to merge snapshots)
+RCT_EXPORT_METHOD(getMetrics:(NSDictionary *)options
+                  resolver:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject)
+{
+    resolve(ASMetricsDictionary([options[@"buckets"] boolValue]));
+}
+
+// Hot-path tracing (ios/ASTrace.h) across the recorder and the transfer manager
+RCT_EXPORT_METHOD(startTrace)
+{
+    ASTraceStart();
+    RCTLogInfo(@"[AudioRecorderModule] Tracing started (level %d)", AS_TRACE_LEVEL);
+}
+
+// Stops tracing and writes what the rings hold as Chrome trace JSON (open it in
+// Perfetto); resolves with the file's path
+RCT_EXPORT_METHOD(stopTrace:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject)
+{
+    ASTraceStop();
+    NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+    NSString *path = [caches stringByAppendingPathComponent:[NSString stringWithFormat:@"trace-%.0f.json", [[NSDate date] timeIntervalSince1970]]];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        long events = ASTraceDump(path.fileSystemRepresentation);
+        if (events < 0) {
+            reject(@"trace_write_failed", [NSString stringWithFormat:@"Could not write %@: %s", path, strerror(errno)], nil);
+            return;
+        }
+        RCTLogInfo(@"[AudioRecorderModule] Wrote %ld trace events to %@", events, path);
+        resolve(path);
+    });
+}
+
 RCT_EXPORT_METHOD(getCurrentState:(RCTPromiseResolveBlock)resolve
                   rejecter:(RCTPromiseRejectBlock)reject)
 {
@@ -1283,6 +1983,7 @@ RCT_EXPORT_METHOD(concatenateSegments:(NSArray<NSString *> *)segmentPaths
     
     // For multiple segments, process on background queue
     dispatch_async(audioProcessingQueue, ^{
+        AS_TRACE_SPAN_VALUE("export.compose", uniqueSegmentPaths.count);
         AVMutableComposition *composition = [AVMutableComposition composition];
         AVMutableCompositionTrack *compositionAudioTrack = [composition addMutableTrackWithMediaType:AVMediaTypeAudio preferredTrackID:kCMPersistentTrackID_Invalid];
         CMTime cursor = kCMTimeZero;
@@ -1343,7 +2044,11 @@ RCT_EXPORT_METHOD(concatenateSegments:(NSArray<NSString *> *)segmentPaths
         }
         
         // Export the file asynchronously
+        uint64_t traceStart = AS_TRACE_TICKS();
+        CFAbsoluteTime exportStart = CFAbsoluteTimeGetCurrent();
         [exportSession exportAsynchronouslyWithCompletionHandler:^{
+            AS_TRACE_COMPLETE("export.concatenate", traceStart, uniqueSegmentPaths.count);
+            ASRecordExport("export.concatenateMs", exportStart, exportSession.status);
             dispatch_async(dispatch_get_main_queue(), ^{
                 AVAssetExportSessionStatus status = exportSession.status;
                 NSError *exportError = exportSession.error;
@@ -1399,20 +2104,18 @@ RCT_EXPORT_METHOD(createPlaybackItem:(NSArray<NSString *> *)segmentPaths
         reject(@"no_segments", @"Segment paths array is empty", nil);
         return;
     }
-    // Build composition
-    AVMutableComposition *composition = [AVMutableComposition composition];
-    CMTime cursor = kCMTimeZero;
-    for (NSString *path in segmentPaths) {
-        NSURL *url = [NSURL fileURLWithPath:path];
-        AVURLAsset *asset = [AVURLAsset assetWithURL:url];
-        if (!asset) continue;
-        CMTimeRange range = CMTimeRangeMake(kCMTimeZero, asset.duration);
-        NSError *err = nil;
-        if (![composition insertTimeRange:range ofAsset:asset atTime:cursor error:&err]) {
-            RCTLogError(@"[AudioRecorderModule] Failed to insert asset %@: %@", path, err);
-        }
-        cursor = CMTimeAdd(cursor, asset.duration);
-    }
+    CFAbsoluteTime buildStart = CFAbsoluteTimeGetCurrent();
+    AVComposition *composition = ASPlaybackComposition(segmentPaths, NO);
+    ASPlaybackCacheStats assetStats = ASPlaybackCacheStatsRead(&ASSegmentAssetCache);
+    ASPlaybackCacheStats compositionStats = ASPlaybackCacheStatsRead(&ASCompositionCache);
+    AS_METRIC_RECORD("playback.compositionBuildUs", "us", (CFAbsoluteTimeGetCurrent() - buildStart) * 1e6);
+    // The caches keep running totals, so they are reported as gauges
+    AS_METRIC_GAUGE_SET("playbackCache.compositionHits", compositionStats.hits);
+    AS_METRIC_GAUGE_SET("playbackCache.compositionMisses", compositionStats.misses);
+    AS_METRIC_GAUGE_SET("playbackCache.assetHits", assetStats.hits);
+    AS_METRIC_GAUGE_SET("playbackCache.assetMisses", assetStats.misses);
+    AS_METRIC_GAUGE_SET("playbackCache.prefetchHits", compositionStats.prefetchHits + assetStats.prefetchHits);
+    AS_METRIC_GAUGE_SET("playbackCache.evictions", compositionStats.evictions + assetStats.evictions);
     AVPlayerItem *item = [AVPlayerItem playerItemWithAsset:composition];
     AVPlayer *player = [AVPlayer playerWithPlayerItem:item];
     
@@ -1442,6 +2145,27 @@ RCT_EXPORT_METHOD(createPlaybackItem:(NSArray<NSString *> *)segmentPaths
     resolve(playerId);
 }
 
+// Loads and parses the segments and builds their composition in the background,
+// so the createPlaybackItem that follows (opening a lesson, then pressing play)
+// hits the cache
+RCT_EXPORT_METHOD(prefetchPlayback:(NSArray<NSString *> *)segmentPaths)
+{
+    if (segmentPaths.count == 0) return;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        ASPlaybackComposition(segmentPaths, YES);
+    });
+}
+
+RCT_EXPORT_METHOD(getPlaybackCacheStats:(RCTPromiseResolveBlock)resolve
+                  rejecter:(RCTPromiseRejectBlock)reject)
+{
+    ASPlaybackCachesSetUp();
+    resolve(@{
+        @"assets": ASPlaybackCacheStatsDictionary(&ASSegmentAssetCache),
+        @"compositions": ASPlaybackCacheStatsDictionary(&ASCompositionCache),
+    });
+}
+
 RCT_EXPORT_METHOD(play:(nonnull NSNumber *)playerId)
 {
     AVPlayer *player = self.playbackPlayers[playerId];
@@ -1646,13 +2370,16 @@ RCT_EXPORT_METHOD(exportCompositionToFile:(NSArray<NSString *> *)segmentPaths
         return;
     }
     
-    // Build composition (reuse helper from createPlaybackItem)
+    // Build composition from the shared segment assets (a lesson just played is already parsed)
     AVMutableComposition *composition = [AVMutableComposition composition];
     CMTime insertTime = kCMTimeZero;
-    for (NSString *path in segmentPaths) {
-        NSURL *url = [NSURL fileURLWithPath:path];
-        AVURLAsset *asset = [AVURLAsset URLAssetWithURL:url options:nil];
-        if (!asset) continue;
+    NSArray *assets = ASPlaybackSegmentAssets(segmentPaths, NO);
+    for (NSUInteger i = 0; i < assets.count; i++) {
+        if (assets[i] == [NSNull null]) {
+            reject(@"insert_failed", [NSString stringWithFormat:@"Could not read segment %@", segmentPaths[i]], nil);
+            return;
+        }
+        AVURLAsset *asset = assets[i];
         CMTimeRange range = CMTimeRangeMake(kCMTimeZero, asset.duration);
         NSError *err = nil;
         AVMutableCompositionTrack *compTrack = [composition addMutableTrackWithMediaType:AVMediaTypeAudio preferredTrackID:kCMPersistentTrackID_Invalid];
@@ -1668,7 +2395,13 @@ RCT_EXPORT_METHOD(exportCompositionToFile:(NSArray<NSString *> *)segmentPaths
     // Remove existing file if any
     [[NSFileManager defaultManager] removeItemAtURL:outURL error:nil];
     
-    AVAssetExportSession *exportSession = [[AVAssetExportSession alloc] initWithAsset:composition presetName:AVAssetExportPresetAppleM4A];
+    // Passthrough copies the segments' AAC packets (no re-encode, and verifyMergedExport
+    // can compare packet hashes); AppleM4A re-encoding is only the fallback
+    NSArray<NSString *> *compatiblePresets = [AVAssetExportSession exportPresetsCompatibleWithAsset:composition];
+    NSString *presetName = [compatiblePresets containsObject:AVAssetExportPresetPassthrough]
+        ? AVAssetExportPresetPassthrough
+        : AVAssetExportPresetAppleM4A;
+    AVAssetExportSession *exportSession = [[AVAssetExportSession alloc] initWithAsset:composition presetName:presetName];
     exportSession.outputURL = outURL;
     exportSession.outputFileType = AVFileTypeAppleM4A;
     
@@ -1680,7 +2413,11 @@ RCT_EXPORT_METHOD(exportCompositionToFile:(NSArray<NSString *> *)segmentPaths
         bgTask = UIBackgroundTaskInvalid;
     }];
     
+    uint64_t traceStart = AS_TRACE_TICKS();
+    CFAbsoluteTime exportStart = CFAbsoluteTimeGetCurrent();
     [exportSession exportAsynchronouslyWithCompletionHandler:^{
+        AS_TRACE_COMPLETE("export.composition", traceStart, segmentPaths.count);
+        ASRecordExport("export.compositionMs", exportStart, exportSession.status);
         [app endBackgroundTask:bgTask];
         bgTask = UIBackgroundTaskInvalid;
         switch (exportSession.status) {
@@ -1696,4 +2433,475 @@ RCT_EXPORT_METHOD(exportCompositionToFile:(NSArray<NSString *> *)segmentPaths
     }];
 }
 
+#pragma mark - Merge Verification
+
+// Decoded audio is compared as an energy envelope: RMS level per block of
+// PCM frames, in dBFS with a floor so silence and near-silence compare equal.
+// Blocks are about a third of a second at 44.1 kHz, long enough that the
+// priming shifted at each join moves a block by a small fraction of its length.
+static const long long kVerifyBlockFrames = 16384;
+static const float kVerifyFloorDb = -60.0f;
+static const float kVerifyToleranceDb = 3.0f;
+static const double kVerifyMinSimilarity = 0.98;
+
+static float ASBlockLevelDb(double sumSquares, long long frames)
+{
+    if (frames <= 0) return kVerifyFloorDb;
+    double rms = sqrt(sumSquares / (double)frames) / 32768.0;
+    return (float)MAX(kVerifyFloorDb, 20.0 * log10(MAX(rms, 1e-6)));
+}
+
+// Fraction of the segments' blocks that the merged envelope matches within
+// kVerifyToleranceDb, each looked up within `maxLag` blocks of its position
+// (the joins shift the merged audio by up to one packet each plus priming).
+// Blocks past the end of the shorter envelope count as mismatches.
+static double ASEnvelopeSimilarity(NSData *segments, NSData *merged, NSInteger maxLag)
+{
+    const float *a = segments.bytes;
+    const float *b = merged.bytes;
+    NSInteger countA = (NSInteger)(segments.length / sizeof(float));
+    NSInteger countB = (NSInteger)(merged.length / sizeof(float));
+    NSInteger total = MAX(countA, countB);
+    if (total == 0) return 1.0;
+    NSInteger matched = 0;
+    for (NSInteger i = 0; i < countA; i++) {
+        for (NSInteger j = MAX(0, i - maxLag); j <= MIN(countB - 1, i + maxLag); j++) {
+            if (fabsf(a[i] - b[j]) <= kVerifyToleranceDb) {
+                matched++;
+                break;
+            }
+        }
+    }
+    return (double)matched / (double)total;
+}
+
+// Walk the audio of `paths` in order, counting packets and PCM frames and
+// hashing the compressed packet payloads (decode == NO), or decode to 16-bit
+// mono PCM, counting frames and building the energy envelope (decode == YES).
+// Compressed reads copy no more than the file size through memory, so hashing a
+// lesson takes a fraction of a second; decoding runs the AAC decoder over the
+// whole file.
+- (NSDictionary *)digestAudioAtPaths:(NSArray<NSString *> *)paths decode:(BOOL)decode error:(NSError **)error
+{
+    CC_SHA256_CTX sha;
+    CC_SHA256_Init(&sha);
+    long long packets = 0;
+    long long frames = 0;
+    long long payloadBytes = 0;
+    // Blocks run across file boundaries, as in the merged file
+    NSMutableData *envelope = decode ? [NSMutableData data] : nil;
+    NSMutableData *pcm = decode ? [NSMutableData data] : nil;
+    double blockSquares = 0;
+    long long blockFrames = 0;
+    
+    for (NSString *path in paths) {
+        AVURLAsset *asset = [AVURLAsset URLAssetWithURL:[NSURL fileURLWithPath:path] options:nil];
+        AVAssetTrack *track = [[asset tracksWithMediaType:AVMediaTypeAudio] firstObject];
+        if (!track) {
+            if (error) *error = [NSError errorWithDomain:@"AudioRecorderModule" code:1 userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat:@"No audio track in %@", path.lastPathComponent]}];
+            return nil;
+        }
+        AVAssetReader *reader = [AVAssetReader assetReaderWithAsset:asset error:error];
+        if (!reader) return nil;
+        NSDictionary *settings = decode ? @{
+            AVFormatIDKey: @(kAudioFormatLinearPCM),
+            AVNumberOfChannelsKey: @1,
+            AVLinearPCMBitDepthKey: @16,
+            AVLinearPCMIsFloatKey: @NO,
+            AVLinearPCMIsBigEndianKey: @NO,
+            AVLinearPCMIsNonInterleaved: @NO
+        } : nil;
+        AVAssetReaderTrackOutput *output = [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:track outputSettings:settings];
+        output.alwaysCopiesSampleData = NO;
+        [reader addOutput:output];
+        if (![reader startReading]) {
+            if (error) *error = reader.error;
+            return nil;
+        }
+        
+        CMSampleBufferRef buffer;
+        while ((buffer = [output copyNextSampleBuffer])) {
+            CMItemCount count = CMSampleBufferGetNumSamples(buffer);
+            if (decode) {
+                frames += count;
+                CMBlockBufferRef block = CMSampleBufferGetDataBuffer(buffer);
+                size_t total = block ? CMBlockBufferGetDataLength(block) : 0;
+                if (pcm.length < total) pcm.length = total;
+                if (total > 0 && CMBlockBufferCopyDataBytes(block, 0, total, pcm.mutableBytes) == kCMBlockBufferNoErr) {
+                    const int16_t *samples = pcm.bytes;
+                    size_t sampleCount = total / sizeof(int16_t);
+                    for (size_t i = 0; i < sampleCount; i++) {
+                        blockSquares += (double)samples[i] * (double)samples[i];
+                        if (++blockFrames == kVerifyBlockFrames) {
+                            float level = ASBlockLevelDb(blockSquares, blockFrames);
+                            [envelope appendBytes:&level length:sizeof(level)];
+                            blockSquares = 0;
+                            blockFrames = 0;
+                        }
+                    }
+                }
+            } else {
+                const AudioStreamBasicDescription *asbd = CMAudioFormatDescriptionGetStreamBasicDescription(CMSampleBufferGetFormatDescription(buffer));
+                packets += count;
+                frames += count * (asbd && asbd->mFramesPerPacket ? asbd->mFramesPerPacket : 1024);
+                CMBlockBufferRef block = CMSampleBufferGetDataBuffer(buffer);
+                size_t total = block ? CMBlockBufferGetDataLength(block) : 0;
+                size_t offset = 0;
+                while (offset < total) {
+                    size_t length = 0;
+                    char *data = NULL;
+                    if (CMBlockBufferGetDataPointer(block, offset, &length, NULL, &data) != kCMBlockBufferNoErr || length == 0) break;
+                    CC_SHA256_Update(&sha, data, (CC_LONG)length);
+                    offset += length;
+                }
+                payloadBytes += offset;
+            }
+            CFRelease(buffer);
+        }
+        if (reader.status != AVAssetReaderStatusCompleted) {
+            if (error) *error = reader.error;
+            return nil;
+        }
+    }
+    
+    if (decode && blockFrames > 0) {
+        float level = ASBlockLevelDb(blockSquares, blockFrames);
+        [envelope appendBytes:&level length:sizeof(level)];
+    }
+    
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(digest, &sha);
+    NSMutableString *hex = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+    for (int i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        [hex appendFormat:@"%02x", digest[i]];
+    }
+    return @{
+        @"packets": @(packets),
+        @"frames": @(frames),
+        @"payloadBytes": @(payloadBytes),
+        @"sha256": decode ? [NSNull null] : hex,
+        @"envelope": envelope ?: [NSNull null]
+    };
+}
+
+// Check that a merged export holds the same audio as its segments before the
+// segments are deleted. A passthrough merge copies the AAC packets, so the
+// packet payload hash must match exactly. If it does not (a re-encoded merge,
+// or priming packets shuffled at the joins), the audio is decoded: the frame
+// counts must agree to within one AAC packet per join plus encoder priming, so
+// nothing was truncated or dropped, and the energy envelopes must match block
+// for block, so the frames hold the same audio (silence or another recording
+// of the same length would pass a count alone). Anything else is reported as
+// not verified and the caller keeps the segments.
+RCT_EXPORT_METHOD(verifyMergedExport:(NSArray<NSString *> *)segmentPaths
+                          mergedPath:(NSString *)mergedPath
+                            resolver:(RCTPromiseResolveBlock)resolve
+                            rejecter:(RCTPromiseRejectBlock)reject)
+{
+    if (segmentPaths.count == 0) {
+        reject(@"no_segments", @"Segment paths array is empty", nil);
+        return;
+    }
+    
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        CFAbsoluteTime verifyStart = CFAbsoluteTimeGetCurrent();
+        NSError *error = nil;
+        NSDictionary *segments = [self digestAudioAtPaths:segmentPaths decode:NO error:&error];
+        NSDictionary *merged = segments ? [self digestAudioAtPaths:@[mergedPath] decode:NO error:&error] : nil;
+        if (!segments || !merged) {
+            reject(@"verify_failed", error.localizedDescription ?: @"Failed to read audio", error);
+            return;
+        }
+        
+        NSString *method = @"packets";
+        BOOL verified = [segments[@"sha256"] isEqualToString:merged[@"sha256"]]
+            && [segments[@"packets"] isEqualToNumber:merged[@"packets"]];
+        long long segmentFrames = [segments[@"frames"] longLongValue];
+        long long mergedFrames = [merged[@"frames"] longLongValue];
+        double similarity = verified ? 1.0 : 0.0;
+        
+        if (!verified) {
+            method = @"pcm";
+            NSDictionary *segmentsPCM = [self digestAudioAtPaths:segmentPaths decode:YES error:&error];
+            NSDictionary *mergedPCM = segmentsPCM ? [self digestAudioAtPaths:@[mergedPath] decode:YES error:&error] : nil;
+            if (!segmentsPCM || !mergedPCM) {
+                reject(@"verify_failed", error.localizedDescription ?: @"Failed to decode audio", error);
+                return;
+            }
+            segmentFrames = [segmentsPCM[@"frames"] longLongValue];
+            mergedFrames = [mergedPCM[@"frames"] longLongValue];
+            long long tolerance = 1024 * (long long)segmentPaths.count + 2112;
+            NSInteger maxLag = (NSInteger)(tolerance / kVerifyBlockFrames) + 1;
+            similarity = ASEnvelopeSimilarity(segmentsPCM[@"envelope"], mergedPCM[@"envelope"], maxLag);
+            verified = llabs(segmentFrames - mergedFrames) <= tolerance && similarity >= kVerifyMinSimilarity;
+        }
+        
+        double elapsedMs = (CFAbsoluteTimeGetCurrent() - verifyStart) * 1000.0;
+        AS_METRIC_RECORD("merge.verifyMs", "ms", elapsedMs);
+        if (!verified) {
+            AS_METRIC_COUNT("merge.verifyFailures", 1);
+        } else if ([method isEqualToString:@"pcm"]) {
+            AS_METRIC_COUNT("merge.verifiedByPCM", 1);
+        } else {
+            AS_METRIC_COUNT("merge.verifiedByPackets", 1);
+        }
+        resolve(@{
+            @"verified": @(verified),
+            @"method": method,
+            @"segmentFrames": @(segmentFrames),
+            @"mergedFrames": @(mergedFrames),
+            @"similarity": @(similarity),
+            @"sha256": merged[@"sha256"],
+            @"elapsedMs": @(elapsedMs)
+        });
+    });
+}
+
+#pragma mark - Archive Transcoding
+
+// Re-encode a recording to the compact archive profile used by the JS StorageManager
+// (mono AAC, 22.05 kHz, 32 kbps by default: about a quarter of the 128 kbps original).
+// AVAssetExportSession has no preset that low, so this decodes to PCM with an
+// AVAssetReader and encodes with an AVAssetWriter. The original is left in place;
+// the caller removes it once the recording points at the archive.
+RCT_EXPORT_METHOD(transcodeToArchive:(NSString *)sourcePath
+                          outputPath:(NSString *)outputPath
+                             options:(NSDictionary *)options
+                            resolver:(RCTPromiseResolveBlock)resolve
+                            rejecter:(RCTPromiseRejectBlock)reject)
+{
+    double sampleRate = options[@"sampleRate"] ? [options[@"sampleRate"] doubleValue] : 22050.0;
+    NSInteger bitRate = options[@"bitRate"] ? [options[@"bitRate"] integerValue] : 32000;
+    
+    AVURLAsset *asset = [AVURLAsset URLAssetWithURL:[NSURL fileURLWithPath:sourcePath] options:nil];
+    AVAssetTrack *sourceTrack = [[asset tracksWithMediaType:AVMediaTypeAudio] firstObject];
+    if (!sourceTrack) {
+        reject(@"no_audio_track", @"Source file has no audio track", nil);
+        return;
+    }
+    
+    NSError *error = nil;
+    AVAssetReader *reader = [AVAssetReader assetReaderWithAsset:asset error:&error];
+    if (!reader) {
+        reject(@"reader_failed", error.localizedDescription ?: @"Failed to open source file", error);
+        return;
+    }
+    AVAssetReaderTrackOutput *readerOutput = [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:sourceTrack outputSettings:@{
+        AVFormatIDKey: @(kAudioFormatLinearPCM),
+        AVSampleRateKey: @(sampleRate),
+        AVNumberOfChannelsKey: @1,
+        AVLinearPCMBitDepthKey: @16,
+        AVLinearPCMIsFloatKey: @NO,
+        AVLinearPCMIsBigEndianKey: @NO,
+        AVLinearPCMIsNonInterleaved: @NO
+    }];
+    [reader addOutput:readerOutput];
+    
+    // Write next to the output and move into place, so a failed transcode leaves nothing behind
+    NSString *tempPath = [outputPath stringByAppendingString:@".tmp"];
+    NSURL *tempURL = [NSURL fileURLWithPath:tempPath];
+    [[NSFileManager defaultManager] removeItemAtURL:tempURL error:nil];
+    AVAssetWriter *writer = [AVAssetWriter assetWriterWithURL:tempURL fileType:AVFileTypeAppleM4A error:&error];
+    if (!writer) {
+        reject(@"writer_failed", error.localizedDescription ?: @"Failed to create archive file", error);
+        return;
+    }
+    AVAssetWriterInput *writerInput = [AVAssetWriterInput assetWriterInputWithMediaType:AVMediaTypeAudio outputSettings:@{
+        AVFormatIDKey: @(kAudioFormatMPEG4AAC),
+        AVSampleRateKey: @(sampleRate),
+        AVNumberOfChannelsKey: @1,
+        AVEncoderBitRateKey: @(bitRate)
+    }];
+    writerInput.expectsMediaDataInRealTime = NO;
+    [writer addInput:writerInput];
+    
+    if (![reader startReading] || ![writer startWriting]) {
+        NSError *startError = reader.error ?: writer.error;
+        [reader cancelReading];
+        [writer cancelWriting];
+        reject(@"transcode_failed", startError.localizedDescription ?: @"Failed to start transcoding", startError);
+        return;
+    }
+    [writer startSessionAtSourceTime:kCMTimeZero];
+    
+    UIApplication *app = [UIApplication sharedApplication];
+    __block UIBackgroundTaskIdentifier bgTask = UIBackgroundTaskInvalid;
+    bgTask = [app beginBackgroundTaskWithName:@"TranscodeToArchive" expirationHandler:^{
+        [reader cancelReading];
+        [app endBackgroundTask:bgTask];
+        bgTask = UIBackgroundTaskInvalid;
+    }];
+    
+    CFAbsoluteTime transcodeStart = CFAbsoluteTimeGetCurrent();
+    uint64_t traceStart = AS_TRACE_TICKS();
+    dispatch_queue_t transcodeQueue = dispatch_queue_create("com.arcoscribe.transcodeToArchive", DISPATCH_QUEUE_SERIAL);
+    [writerInput requestMediaDataWhenReadyOnQueue:transcodeQueue usingBlock:^{
+        while (writerInput.isReadyForMoreMediaData) {
+            CMSampleBufferRef buffer = [readerOutput copyNextSampleBuffer];
+            if (buffer) {
+                BOOL appended = [writerInput appendSampleBuffer:buffer];
+                CFRelease(buffer);
+                if (appended) continue;
+                [reader cancelReading];
+            }
+            
+            // Source exhausted, cancelled or append failed: finish exactly once
+            [writerInput markAsFinished];
+            BOOL readerOK = reader.status == AVAssetReaderStatusCompleted;
+            if (!readerOK) {
+                [writer cancelWriting];
+            }
+            void (^finish)(void) = ^{
+                AS_TRACE_COMPLETE("export.transcode", traceStart, readerOK && writer.status == AVAssetWriterStatusCompleted);
+                ASRecordExport("export.transcodeMs", transcodeStart,
+                               readerOK && writer.status == AVAssetWriterStatusCompleted ? AVAssetExportSessionStatusCompleted : AVAssetExportSessionStatusFailed);
+                [app endBackgroundTask:bgTask];
+                bgTask = UIBackgroundTaskInvalid;
+                NSFileManager *fileManager = [NSFileManager defaultManager];
+                if (!readerOK || writer.status != AVAssetWriterStatusCompleted) {
+                    [fileManager removeItemAtPath:tempPath error:nil];
+                    NSError *failure = writer.error ?: reader.error;
+                    reject(@"transcode_failed", failure.localizedDescription ?: @"Transcoding failed", failure);
+                    return;
+                }
+                NSError *moveError = nil;
+                [fileManager removeItemAtPath:outputPath error:nil];
+                if (![fileManager moveItemAtPath:tempPath toPath:outputPath error:&moveError]) {
+                    reject(@"move_failed", moveError.localizedDescription ?: @"Failed to move archive into place", moveError);
+                    return;
+                }
+                unsigned long long archiveSize = [[fileManager attributesOfItemAtPath:outputPath error:nil] fileSize];
+                RCTLogInfo(@"[AudioRecorderModule] Archived %.1fs of audio to %.2f MB in %.3fs",
+                           CMTimeGetSeconds(asset.duration), (double)archiveSize / (1024 * 1024),
+                           CFAbsoluteTimeGetCurrent() - transcodeStart);
+                resolve(@{ @"path": outputPath, @"size": @(archiveSize) });
+            };
+            if (readerOK) {
+                [writer finishWritingWithCompletionHandler:finish];
+            } else {
+                finish();
+            }
+            break;
+        }
+    }];
+}
+
+#pragma mark - Time Range Extraction
+
+// Splice selected time ranges of one file into a new file (e.g. a single speaker's turns).
+// Passthrough export copies the compressed AAC packets, so nothing is re-encoded; the
+// cut points snap to the nearest packet (~23 ms at 44.1 kHz), which is inaudible at turn
+// boundaries. Falls back to AppleM4A re-encoding only if passthrough is unavailable.
+// sourcePaths is the recording's audio in order: the merged file alone, or its
+// segments while they are not merged yet (ranges are in recording time either way)
+RCT_EXPORT_METHOD(extractTimeRanges:(NSArray<NSString *> *)sourcePaths
+                             ranges:(NSArray<NSDictionary *> *)ranges
+                         outputPath:(NSString *)outputPath
+                           resolver:(RCTPromiseResolveBlock)resolve
+                           rejecter:(RCTPromiseRejectBlock)reject)
+{
+    if (ranges.count == 0) {
+        reject(@"no_ranges", @"Ranges array is empty", nil);
+        return;
+    }
+    if (sourcePaths.count == 0) {
+        reject(@"no_source", @"Source paths array is empty", nil);
+        return;
+    }
+    for (NSString *path in sourcePaths) {
+        if (![[NSFileManager defaultManager] fileExistsAtPath:path]) {
+            reject(@"file_not_found", [NSString stringWithFormat:@"Source file not found: %@", path], nil);
+            return;
+        }
+    }
+    
+    AVAsset *asset = sourcePaths.count == 1
+        ? [AVURLAsset URLAssetWithURL:[NSURL fileURLWithPath:sourcePaths.firstObject]
+                              options:@{AVURLAssetPreferPreciseDurationAndTimingKey: @YES}]
+        : ASPlaybackComposition(sourcePaths, NO);
+    AVAssetTrack *sourceTrack = [[asset tracksWithMediaType:AVMediaTypeAudio] firstObject];
+    if (!sourceTrack) {
+        reject(@"no_audio_track", @"Source file has no audio track", nil);
+        return;
+    }
+    
+    AVMutableComposition *composition = [AVMutableComposition composition];
+    AVMutableCompositionTrack *compTrack = [composition addMutableTrackWithMediaType:AVMediaTypeAudio preferredTrackID:kCMPersistentTrackID_Invalid];
+    CMTime assetDuration = asset.duration;
+    CMTime insertTime = kCMTimeZero;
+    
+    // All ranges go into a single track, so the export is one contiguous splice
+    for (NSDictionary *range in ranges) {
+        CMTime start = CMTimeMakeWithSeconds([range[@"start"] doubleValue], 44100);
+        CMTime end = CMTimeMinimum(CMTimeMakeWithSeconds([range[@"end"] doubleValue], 44100), assetDuration);
+        if (CMTimeCompare(end, start) <= 0) continue;
+        
+        NSError *err = nil;
+        CMTimeRange timeRange = CMTimeRangeFromTimeToTime(start, end);
+        if (![compTrack insertTimeRange:timeRange ofTrack:sourceTrack atTime:insertTime error:&err]) {
+            reject(@"insert_failed", err.localizedDescription ?: @"Failed to insert time range", err);
+            return;
+        }
+        insertTime = CMTimeAdd(insertTime, timeRange.duration);
+    }
+    
+    if (CMTimeCompare(insertTime, kCMTimeZero) <= 0) {
+        reject(@"no_ranges", @"No ranges fall within the source duration", nil);
+        return;
+    }
+    
+    NSURL *outURL = [NSURL fileURLWithPath:outputPath];
+    [[NSFileManager defaultManager] removeItemAtURL:outURL error:nil];
+    
+    NSArray<NSString *> *compatiblePresets = [AVAssetExportSession exportPresetsCompatibleWithAsset:composition];
+    NSString *presetName = [compatiblePresets containsObject:AVAssetExportPresetPassthrough]
+        ? AVAssetExportPresetPassthrough
+        : AVAssetExportPresetAppleM4A;
+    
+    AVAssetExportSession *exportSession = [[AVAssetExportSession alloc] initWithAsset:composition presetName:presetName];
+    exportSession.outputURL = outURL;
+    exportSession.outputFileType = AVFileTypeAppleM4A;
+    
+    UIApplication *app = [UIApplication sharedApplication];
+    __block UIBackgroundTaskIdentifier bgTask = UIBackgroundTaskInvalid;
+    bgTask = [app beginBackgroundTaskWithName:@"ExtractTimeRanges" expirationHandler:^{
+        [exportSession cancelExport];
+        [app endBackgroundTask:bgTask];
+        bgTask = UIBackgroundTaskInvalid;
+    }];
+    
+    CFAbsoluteTime exportStart = CFAbsoluteTimeGetCurrent();
+    double extractedSeconds = CMTimeGetSeconds(insertTime);
+    BOOL passthrough = [presetName isEqualToString:AVAssetExportPresetPassthrough];
+    uint64_t traceStart = AS_TRACE_TICKS();
+    
+    [exportSession exportAsynchronouslyWithCompletionHandler:^{
+        AS_TRACE_COMPLETE("export.extract", traceStart, ranges.count);
+        ASRecordExport("export.extractMs", exportStart, exportSession.status);
+        [app endBackgroundTask:bgTask];
+        bgTask = UIBackgroundTaskInvalid;
+        switch (exportSession.status) {
+            case AVAssetExportSessionStatusCompleted: {
+                double elapsed = CFAbsoluteTimeGetCurrent() - exportStart;
+                RCTLogInfo(@"[AudioRecorderModule] Extracted %.1fs of audio from %lu ranges in %.3fs (%.0fx realtime, %@)",
+                           extractedSeconds, (unsigned long)ranges.count, elapsed,
+                           elapsed > 0 ? extractedSeconds / elapsed : 0,
+                           passthrough ? @"passthrough" : @"re-encoded");
+                resolve(@{
+                    @"outputPath": outputPath,
+                    @"duration": @(extractedSeconds),
+                    @"elapsed": @(elapsed),
+                    @"passthrough": @(passthrough)
+                });
+                break;
+            }
+            case AVAssetExportSessionStatusFailed:
+            case AVAssetExportSessionStatusCancelled:
+            default:
+                reject(@"export_failed", exportSession.error.localizedDescription ?: @"Export failed", exportSession.error);
+                break;
+        }
+    }];
+}
+
 @end
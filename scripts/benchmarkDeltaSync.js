@@ -0,0 +1,122 @@
+// Delta Sync Benchmark
+// Measures chunk-manifest hashing throughput (src/utils/ChunkManifest.js, the
+// same algorithm BackgroundTransferManager runs natively), then syncs a mock
+// library to the local Drive stand-in several times with edits in between and
+// reports bytes uploaded vs. what a full re-upload would have sent.
+// Run with: node scripts/benchmarkDeltaSync.js [recordingCount]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const { setupDriveHarness } = require('./driveBenchHarness');
+
+const timeMs = (fn) => {
+  const start = process.hrtime.bigint();
+  const value = fn();
+  return { value, ms: Number(process.hrtime.bigint() - start) / 1e6 };
+};
+
+const measureHashing = async () => {
+  const manifest = await import(path.join(__dirname, '../src/utils/ChunkManifest.js'));
+  const bytes = new Uint8Array(crypto.randomBytes(32 * 1024 * 1024));
+  const mb = bytes.length / (1024 * 1024);
+
+  manifest.chunkBytes(bytes.subarray(0, 1024 * 1024), manifest.CHUNK_PROFILES.audio); // warm up
+  const chunking = timeMs(() => manifest.chunkBytes(bytes, manifest.CHUNK_PROFILES.audio));
+  const full = timeMs(() => manifest.computeManifest(bytes, manifest.CHUNK_PROFILES.audio));
+  const nodeSha = timeMs(() => crypto.createHash('sha256').update(bytes).digest('hex'));
+
+  // An insert in the middle should only disturb the chunks around it
+  const edited = new Uint8Array(bytes.length + 4096);
+  edited.set(bytes.subarray(0, bytes.length / 2));
+  edited.set(crypto.randomBytes(4096), bytes.length / 2);
+  edited.set(bytes.subarray(bytes.length / 2), bytes.length / 2 + 4096);
+  const delta = manifest.diffManifests(full.value, manifest.computeManifest(edited, manifest.CHUNK_PROFILES.audio));
+
+  console.log('Hashing (32 MB random audio, 64 KB average chunks)');
+  console.table([{
+    chunks: full.value.chunks.length,
+    avgChunkKB: Number((bytes.length / full.value.chunks.length / 1024).toFixed(1)),
+    cdcMBps: Number((mb / (chunking.ms / 1000)).toFixed(1)),
+    cdcPlusSha256MBps: Number((mb / (full.ms / 1000)).toFixed(1)),
+    nodeCryptoSha256MBps: Number((mb / (nodeSha.ms / 1000)).toFixed(1)),
+    changedKBAfter4KBInsert: Math.round(delta.changedBytes / 1024),
+  }]);
+};
+
+const main = async () => {
+  const count = parseInt(process.argv[2], 10) || 20;
+  const harness = await setupDriveHarness({ latencyMs: 5 });
+  await measureHashing();
+
+  const { driveService, mock } = harness;
+  harness.reset();
+
+  // Mock library: 1-4 MB of audio per lesson, a long transcript and a summary
+  const ids = [];
+  for (let i = 0; i < count; i++) {
+    const id = `delta-${i}`;
+    const filePath = path.join(harness.tmpDir, `${id}.m4a`);
+    fs.writeFileSync(filePath, crypto.randomBytes((1 + (i % 4)) * 1024 * 1024));
+    harness.recordings.set(id, {
+      id,
+      title: `Lesson ${i + 1}`,
+      date: new Date(2025, 6, 1 + (i % 28)).toISOString(),
+      filePath,
+      transcript: `Lesson ${i + 1}. ` + 'Keep the bow close to the bridge and let the sound ring. '.repeat(800),
+      summary: `# Lesson ${i + 1}\n\n` + '- Slow bows with a metronome at 60\n'.repeat(120),
+    });
+    ids.push(id);
+  }
+
+  const artifactBytes = (recording) => fs.statSync(recording.filePath).size +
+    Buffer.byteLength(recording.transcript) + Buffer.byteLength(recording.summary);
+
+  const restoreConsole = harness.quiet();
+  const rounds = [];
+  const runRound = async (label, edit) => {
+    ids.forEach((id, index) => edit(harness.recordings.get(id), index));
+    const fullBytes = ids.reduce((sum, id) => sum + artifactBytes(harness.recordings.get(id)), 0);
+
+    mock.resetStats();
+    harness.hashing.bytes = 0;
+    harness.hashing.ms = 0;
+    const start = process.hrtime.bigint();
+    const { results, errors } = await driveService.syncRecordings(ids);
+    await harness.drainUploads();
+    const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+    if (errors.length > 0 || results.some(result => result.errors.length > 0)) {
+      throw new Error(`Round "${label}" had sync errors`);
+    }
+
+    rounds.push({
+      round: label,
+      skippedArtifacts: results.reduce((sum, result) => sum + result.skipped.length, 0),
+      fullReuploadMB: Number((fullBytes / 1048576).toFixed(2)),
+      uploadedMB: Number((mock.stats.uploadBytes / 1048576).toFixed(2)),
+      savedPct: Number((100 * (1 - mock.stats.uploadBytes / fullBytes)).toFixed(1)),
+      audioHashedMB: Number((harness.hashing.bytes / 1048576).toFixed(2)),
+      wallMs: Number(elapsedMs.toFixed(0)),
+    });
+  };
+
+  await runRound('initial sync', () => {});
+  await runRound('no changes', () => {});
+  await runRound('30% summaries edited', (recording, index) => {
+    if (index % 10 < 3) recording.summary += '\n- Add the Kreutzer 23 variation\n';
+  });
+  await runRound('10% audio appended', (recording, index) => {
+    if (index % 10 === 0) fs.appendFileSync(recording.filePath, crypto.randomBytes(256 * 1024));
+  });
+  restoreConsole();
+
+  console.log(`\nRepeated syncs of a ${count}-recording library`);
+  console.table(rounds);
+  await harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,134 @@
+// Drive Metadata Cache Benchmark
+// Syncs a library to the local Drive stand-in, then "restarts the app" and
+// resyncs it unchanged in several ways: with nothing cached (the old
+// behaviour), with the persisted cache kept current by the changes feed, and
+// with every entry stale and the feed unavailable so entries are revalidated by
+// ETag. A last round trashes and renames folders behind the app's back and
+// checks the resync notices. Reports Drive metadata calls, HTTP round-trips
+// (batched calls share one), 304s and cache hit rates.
+// Run with: node scripts/benchmarkDriveCache.js [recordingCount] [latencyMs]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const { setupDriveHarness } = require('./driveBenchHarness');
+
+const main = async () => {
+  const count = parseInt(process.argv[2], 10) || 20;
+  const latencyMs = parseInt(process.argv[3], 10) || 40;
+
+  const harness = await setupDriveHarness({ latencyMs });
+  const { driveService, mock } = harness;
+  const { default: DriveMetadataCache } = await import(path.join(__dirname, '../src/services/DriveMetadataCache.js'));
+  harness.reset();
+
+  // Lessons spread over three months, each with audio, a transcript and a summary
+  const ids = [];
+  for (let i = 0; i < count; i++) {
+    const id = `cache-${i}`;
+    const filePath = path.join(harness.tmpDir, `${id}.m4a`);
+    fs.writeFileSync(filePath, crypto.randomBytes(64 * 1024));
+    harness.recordings.set(id, {
+      id,
+      title: `Lesson ${i + 1}`,
+      date: new Date(2025, 6 + (i % 3), 1 + (i % 28), 15).toISOString(),
+      filePath,
+      transcript: `Lesson ${i + 1}. ` + 'Let the bow arm lead from the elbow. '.repeat(100),
+      summary: `# Lesson ${i + 1}\n\n- Scales in thirds, slow\n`,
+    });
+    ids.push(id);
+  }
+
+  // A fresh process: the in-memory state is gone, the cache file may survive
+  const restart = async ({ persisted, cacheOptions = {}, changesFeed = true }) => {
+    await driveService.metadataCache.save();
+    if (!persisted) {
+      fs.rmSync(driveService.metadataCache.cachePath(), { force: true });
+    }
+    driveService.metadataCache = new DriveMetadataCache(cacheOptions);
+    driveService.appFolderId = null;
+    driveService.createdFolderIds.clear();
+    driveService.lastChangesPollAt = 0;
+    delete driveService.refreshMetadataCache;
+    if (!changesFeed) {
+      driveService.refreshMetadataCache = async () => {};
+    }
+  };
+
+  // Every recording must point at a live folder, and every artifact at a live file in it
+  const checkConsistency = () => {
+    ids.forEach((id) => {
+      const sync = harness.recordings.get(id).googleDriveSync;
+      const folder = mock.files.get(sync.folderId);
+      if (!folder || folder.trashed) {
+        throw new Error(`${id} points at a missing folder`);
+      }
+      sync.uploads.forEach((upload) => {
+        const file = mock.files.get(upload.fileId);
+        if (!file || file.trashed || !file.parents.includes(sync.folderId)) {
+          throw new Error(`${id} ${upload.type} points at a missing file`);
+        }
+      });
+    });
+  };
+
+  const restoreConsole = harness.quiet();
+  const rows = [];
+  const runRound = async (label) => {
+    mock.resetStats();
+    driveService.metadataCache.resetStats();
+    const callsBefore = driveService.batchClient.getStats().requests;
+    const start = process.hrtime.bigint();
+    const { results, errors } = await driveService.syncRecordings(ids);
+    await harness.drainUploads();
+    const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+    if (errors.length > 0 || results.some(result => result.errors.length > 0)) {
+      throw new Error(`Round "${label}" had sync errors`);
+    }
+    checkConsistency();
+
+    const cache = driveService.metadataCache.getStats();
+    rows.push({
+      round: label,
+      metadataCalls: driveService.batchClient.getStats().requests - callsBefore,
+      roundTrips: mock.stats.httpRequests,
+      perSyncRoundTrips: Number((mock.stats.httpRequests / count).toFixed(2)),
+      notModified: mock.stats.notModified,
+      cacheHitRate: cache.hitRate,
+      negativeHits: cache.negativeHits,
+      changesApplied: cache.changesApplied,
+      uploads: mock.stats.uploads,
+      wallMs: Number(elapsedMs.toFixed(0)),
+    });
+  };
+
+  await runRound('initial sync');
+
+  await restart({ persisted: false });
+  await runRound('restart, nothing cached');
+
+  await restart({ persisted: true });
+  await runRound('restart, cache + changes feed');
+
+  await restart({ persisted: true, cacheOptions: { freshMs: 0 }, changesFeed: false });
+  await runRound('restart, all stale, ETag revalidation');
+
+  // Behind the app's back: trash two recording folders and rename a month folder
+  await restart({ persisted: true });
+  const trashed = [ids[0], ids[1]].map(id => harness.recordings.get(id).googleDriveSync.folderId);
+  trashed.forEach(folderId => mock.modifyFile(folderId, { trashed: true }));
+  const month = [...mock.files.values()].find(file => file.name === 'August');
+  mock.modifyFile(month.id, { name: 'August (archive)' });
+  await runRound('external edits, cache + changes feed');
+  restoreConsole();
+
+  console.log(`${count} recordings (3 artifacts each) across 3 months, ${latencyMs} ms simulated latency per request`);
+  console.table(rows);
+  await harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,225 @@
+// Drive Operation Queue Benchmark
+// Exercises DriveOperationQueue (renames, moves, deletes and shares routed
+// through GoogleDriveService) against the local Drive stand-in:
+//   1. throughput of independent operations vs. awaiting each call in turn
+//   2. coalescing of an offline burst (repeated renames, move chains, shares,
+//      deletes) and how quickly it drains once the network is back
+//   3. crash replay: the process dies offline, or mid-drain, leaving a torn
+//      journal record; a new queue replays the journal and the final Drive
+//      state must match applying every operation in order
+// Run with: node scripts/benchmarkDriveQueue.js [fileCount] [latencyMs]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const path = require('path');
+const { setupDriveHarness } = require('./driveBenchHarness');
+
+// Small deterministic PRNG so the crash workload is the same on every run
+const mulberry32 = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+const main = async () => {
+  const fileCount = parseInt(process.argv[2], 10) || 200;
+  const latencyMs = parseInt(process.argv[3], 10) || 20;
+
+  const harness = await setupDriveHarness({ latencyMs });
+  const { driveService, mock } = harness;
+  const { default: DriveOperationQueue } = await import(path.join(__dirname, '../src/services/DriveOperationQueue.js'));
+  harness.reset();
+
+  const journalPath = path.join(harness.tmpDir, 'drive_operations.jsonl');
+  const newQueue = (options = {}) => {
+    const queue = new DriveOperationQueue(op => driveService.performOperation(op), { path: journalPath, ...options });
+    driveService.operationQueue = queue;
+    return queue;
+  };
+  const waitFor = async (predicate) => {
+    while (!predicate()) {
+      await new Promise(resolve => setTimeout(resolve, 5));
+    }
+  };
+
+  const client = driveService.batchClient;
+  const createFiles = (count, parentId, prefix) => Promise.all(Array.from({ length: count }, (_, i) =>
+    client.requestJson('POST', '/files', { name: `${prefix}-${i}.md`, parents: [parentId] })));
+  const [folderA, folderB, folderC] = await Promise.all(['A', 'B', 'C'].map(name =>
+    client.requestJson('POST', '/files', { name, mimeType: 'application/vnd.google-apps.folder' })));
+
+  const restoreConsole = harness.quiet();
+  const rows = [];
+
+  // 1. Independent renames: one awaited call at a time vs. the queue
+  {
+    const files = await createFiles(fileCount, folderA.id, 'throughput');
+    mock.resetStats();
+    let start = Date.now();
+    for (const file of files) {
+      await driveService.performOperation({ kind: 'rename', fileId: file.id, name: `${file.name}.direct` });
+    }
+    const directMs = Date.now() - start;
+    rows.push({ scenario: 'renames, one awaited call each', submitted: fileCount, executed: fileCount, roundTrips: mock.stats.httpRequests, ms: directMs, opsPerSec: Math.round(fileCount / (directMs / 1000)) });
+
+    fs.rmSync(journalPath, { force: true });
+    const queue = newQueue();
+    mock.resetStats();
+    start = Date.now();
+    for (const file of files) {
+      await driveService.renameFile(file.id, `${file.name}.queued`);
+    }
+    await queue.idle();
+    const queuedMs = Date.now() - start;
+    const stats = queue.getStats();
+    if (files.some(file => mock.files.get(file.id).name !== `${file.name}.queued`)) {
+      throw new Error('Queued renames did not all apply');
+    }
+    rows.push({ scenario: 'renames, through the queue', submitted: stats.submitted, executed: stats.executed, roundTrips: mock.stats.httpRequests, ms: queuedMs, opsPerSec: Math.round(fileCount / (queuedMs / 1000)) });
+  }
+
+  // 2. Offline burst: 10 renames, a move chain A -> B -> C and two shares per file;
+  //    every fifth file is deleted at the end
+  {
+    const files = await createFiles(50, folderA.id, 'burst');
+    fs.rmSync(journalPath, { force: true });
+    const queue = newQueue({ baseBackoffMs: 200 });
+    mock.setOffline(true);
+    mock.resetStats();
+    for (const [index, file] of files.entries()) {
+      for (let r = 0; r < 10; r++) {
+        await driveService.renameFile(file.id, `burst-${index}-v${r}.md`);
+      }
+      await driveService.moveFile(file.id, folderB.id);
+      await driveService.moveFile(file.id, folderC.id);
+      driveService.createShareableLink(file.id).catch(() => {});
+      driveService.createShareableLink(file.id).catch(() => {});
+    }
+    await Promise.all(files.filter((_, index) => index % 5 === 0).map(file => driveService.deleteFile(file.id)));
+
+    const reconnectedAt = Date.now();
+    mock.setOffline(false);
+    // No foreground event: the backoff timer alone has to notice the network is back
+    await waitFor(() => queue.pending.length === 0 && !queue.draining);
+    const drainMs = Date.now() - reconnectedAt;
+    const stats = queue.getStats();
+
+    files.forEach((file, index) => {
+      const current = mock.files.get(file.id);
+      if (index % 5 === 0) {
+        if (current) throw new Error(`burst-${index} should be deleted`);
+      } else if (current.name !== `burst-${index}-v9.md` || current.parents.join() !== folderC.id) {
+        throw new Error(`burst-${index} ended as ${current.name} in ${current.parents}`);
+      }
+    });
+    rows.push({
+      scenario: 'offline burst, drained after reconnect',
+      submitted: stats.submitted,
+      executed: stats.executed,
+      roundTrips: mock.stats.httpRequests,
+      ms: drainMs,
+      opsPerSec: null,
+      coalescingRatio: stats.coalescingRatio,
+    });
+  }
+
+  // 3. Crash replay: random operations, the process dies, a new queue replays the journal
+  const crashReplay = async (label, { crashAfterPerforms }) => {
+    const files = await createFiles(60, folderA.id, `crash-${label}`);
+    const folders = [folderA.id, folderB.id, folderC.id];
+    const random = mulberry32(label.length * 7919);
+
+    // Reference model: every operation applied in submission order
+    const expected = new Map(files.map(file => [file.id, { name: file.name, parents: [folderA.id], deleted: false }]));
+    const operations = [];
+    for (let i = 0; i < 300; i++) {
+      const file = files[Math.floor(random() * files.length)];
+      const model = expected.get(file.id);
+      const roll = random();
+      let op;
+      if (roll < 0.5) {
+        op = { kind: 'rename', fileId: file.id, name: `${file.name}-r${i}` };
+        if (!model.deleted) model.name = op.name;
+      } else if (roll < 0.85) {
+        const newParentId = folders[Math.floor(random() * folders.length)];
+        const removeFromCurrentParents = random() < 0.8;
+        op = { kind: 'move', fileId: file.id, newParentId, removeFromCurrentParents };
+        if (!model.deleted) {
+          model.parents = removeFromCurrentParents ? [newParentId] : [...new Set([...model.parents, newParentId])];
+        }
+      } else if (roll < 0.95) {
+        op = { kind: 'share', fileId: file.id, role: 'reader' };
+      } else {
+        op = { kind: 'delete', fileId: file.id };
+        model.deleted = true;
+      }
+      operations.push(op);
+    }
+
+    fs.rmSync(journalPath, { force: true });
+    let performs = 0;
+    const crashed = new DriveOperationQueue((op) => {
+      performs++;
+      // After the crash point the process is gone: nothing completes or gets journaled
+      return performs > crashAfterPerforms ? new Promise(() => {}) : driveService.performOperation(op);
+    }, { path: journalPath });
+    mock.setOffline(crashAfterPerforms === 0);
+    for (const op of operations) {
+      await crashed.enqueue(op);
+    }
+    if (crashAfterPerforms > 0) {
+      await waitFor(() => performs > crashAfterPerforms);
+    }
+    await crashed.journalWrite;
+    clearTimeout(crashed.backoffTimer);
+    // The last write was cut short by the crash
+    fs.appendFileSync(journalPath, '{"type":"enqueue","op":{"kind":"rena');
+
+    mock.setOffline(false);
+    mock.resetStats();
+    const start = Date.now();
+    const replayed = newQueue();
+    await replayed.ready();
+    await waitFor(() => replayed.pending.length === 0 && !replayed.draining);
+    const replayMs = Date.now() - start;
+
+    const mismatches = [...expected].filter(([fileId, model]) => {
+      const current = mock.files.get(fileId);
+      if (model.deleted) return Boolean(current);
+      return !current || current.name !== model.name ||
+        [...current.parents].sort().join() !== [...model.parents].sort().join();
+    });
+    if (mismatches.length > 0) {
+      throw new Error(`${label}: ${mismatches.length} files differ from the reference after replay`);
+    }
+    // Operations that completed before the crash count as executed too
+    const stats = replayed.getStats();
+    const executed = stats.executed + Math.min(performs, crashAfterPerforms);
+    rows.push({
+      scenario: `crash ${label}, replayed`,
+      submitted: operations.length,
+      executed,
+      roundTrips: mock.stats.httpRequests,
+      ms: replayMs,
+      opsPerSec: null,
+      coalescingRatio: Number((operations.length / executed).toFixed(2)),
+      replayed: stats.replayed,
+    });
+  };
+
+  try {
+    await crashReplay('while offline', { crashAfterPerforms: 0 });
+    await crashReplay('mid-drain', { crashAfterPerforms: 40 });
+  } finally {
+    restoreConsole();
+  }
+  console.log(`${latencyMs} ms simulated latency per request; crash runs check the final Drive state against a reference model`);
+  console.table(rows);
+  await harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,126 @@
+// Drive Sync Benchmark
+// Runs GoogleDriveService.syncRecording against the local Drive stand-in
+// (scripts/mockDriveServer.js) and reports HTTP round-trips and wall time per
+// sync, with metadata calls batched and with every call sent on its own.
+// Run with: node scripts/benchmarkDriveSync.js [recordingCount] [latencyMs]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const path = require('path');
+const { setupDriveHarness } = require('./driveBenchHarness');
+
+const TRANSCRIPT = 'Let us start with the Bach partita. Keep the bow close to the bridge in the opening bars. '.repeat(200);
+const SUMMARY = '# Lesson Overview\n\n- Bow distribution\n- Left-hand frames\n- Practice plan with metronome at 60\n'.repeat(20);
+
+const main = async () => {
+  const count = parseInt(process.argv[2], 10) || 10;
+  const latencyMs = parseInt(process.argv[3], 10) || 40;
+
+  const harness = await setupDriveHarness({ latencyMs });
+  const { driveService, mock } = harness;
+
+  const audioPath = path.join(harness.tmpDir, 'recording.m4a');
+  fs.writeFileSync(audioPath, Buffer.alloc(256 * 1024));
+
+  const restoreConsole = harness.quiet();
+  const average = (values) => values.reduce((a, b) => a + b, 0) / Math.max(values.length, 1);
+
+  const seedRecordings = (label) => Array.from({ length: count }, (_, i) => {
+    const id = `bench-${label}-${i}`;
+    harness.recordings.set(id, {
+      id,
+      title: `Lesson ${i + 1}`,
+      date: new Date(2025, 6, 1 + (i % 28), 14, i % 60).toISOString(),
+      filePath: audioPath,
+      transcript: TRANSCRIPT,
+      summary: SUMMARY,
+    });
+    return id;
+  });
+
+  // `batched: false` reproduces the old one-fetch-per-call behaviour: no batching,
+  // no sharing of identical GETs, no changes feed and no folder ID cache between syncs.
+  const configure = (batched) => {
+    harness.reset();
+    const client = driveService.batchClient;
+    delete client.sendBatch;
+    delete client.inFlightGets.has;
+    delete driveService.refreshMetadataCache;
+    if (!batched) {
+      client.sendBatch = (operations) => Promise.all(operations.map(op => client.sendSingle(op)));
+      client.inFlightGets.has = () => false;
+      driveService.refreshMetadataCache = async () => {};
+    }
+  };
+
+  const runSequential = async (label, batched) => {
+    configure(batched);
+    const perSync = [];
+    for (const id of seedRecordings(label)) {
+      if (!batched) {
+        // The old code did remember the app folder ID for the session
+        const appFolderId = driveService.appFolderId;
+        await driveService.clearFolderCache();
+        if (appFolderId) {
+          driveService.metadataCache.putFolder('root', 'ArcoScribe Recordings', { id: appFolderId });
+        }
+      }
+      mock.resetStats();
+      const start = process.hrtime.bigint();
+      const result = await driveService.syncRecording(id);
+      await harness.drainUploads();
+      const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+      if (result.errors.length > 0) {
+        throw new Error(`Sync ${id} failed: ${JSON.stringify(result.errors)}`);
+      }
+      perSync.push({ roundTrips: mock.stats.httpRequests, elapsedMs });
+    }
+
+    const [first, ...rest] = perSync;
+    return {
+      mode: `${label} (one at a time)`,
+      firstSyncRoundTrips: first.roundTrips,
+      firstSyncMs: Number(first.elapsedMs.toFixed(1)),
+      perSyncRoundTrips: Number(average(rest.map(r => r.roundTrips)).toFixed(1)),
+      perSyncMs: Number(average(rest.map(r => r.elapsedMs)).toFixed(1)),
+    };
+  };
+
+  // "Sync All" in settings: syncRecordings() with four in flight
+  const runSyncAll = async (label) => {
+    configure(true);
+    const ids = seedRecordings(label);
+    mock.resetStats();
+    const start = process.hrtime.bigint();
+    const { errors } = await driveService.syncRecordings(ids);
+    await harness.drainUploads();
+    const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+    if (errors.length > 0) {
+      throw new Error(`Sync all failed: ${JSON.stringify(errors)}`);
+    }
+    return {
+      mode: `${label} (sync all, 4 in flight)`,
+      firstSyncRoundTrips: null,
+      firstSyncMs: null,
+      perSyncRoundTrips: Number((mock.stats.httpRequests / count).toFixed(1)),
+      perSyncMs: Number((elapsedMs / count).toFixed(1)),
+    };
+  };
+
+  const results = [
+    await runSequential('unbatched', false),
+    await runSequential('batched', true),
+    await runSyncAll('batched'),
+  ];
+
+  restoreConsole();
+  console.log(`${count} syncs per mode, ${latencyMs} ms simulated latency per request`);
+  console.table(results);
+
+  await harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,95 @@
+// Markdown Render Benchmark
+// Measures throughput of src/utils/MarkdownRenderer.js on synthetic lesson
+// summaries of increasing size, and compares against markdown-it when it is
+// installed. Run with: node scripts/benchmarkMarkdown.js
+// (Node 20.10+ is needed to import the ES module source directly.)
+
+const path = require('path');
+
+// One lesson section in the shape the summarization prompt produces
+const SECTION = `
+## Bow Distribution
+
+The teacher emphasized maintaining **consistent bow speed** throughout each phrase, especially in *Rode 12*.
+
+- Use less bow at the beginning of phrases
+- Gradually increase bow speed toward the middle
+  - Keep the contact point steady
+  - Release weight on the up-bow
+- Ease off at phrase endings for natural tapering
+
+### Practice Plan
+
+1. Slow bows with a metronome at \`60\`
+2. Add the [Kreutzer 23](https://example.com/kreutzer) variation
+3. Record and compare
+
+> Listen for the sound, not the bow.
+
+| Exercise | Tempo |
+|:--|--:|
+| Scales | 72 |
+| Etude | 60 |
+`;
+
+const buildSummary = (targetBytes) => {
+  let summary = '# Lesson Summary\n';
+  while (summary.length < targetBytes) {
+    summary += SECTION;
+  }
+  return summary;
+};
+
+const timeIterations = (fn, minMs = 500) => {
+  // Warm up so the JIT has compiled the hot paths
+  for (let i = 0; i < 3; i++) fn();
+  let iterations = 0;
+  const start = process.hrtime.bigint();
+  let elapsedMs = 0;
+  while (elapsedMs < minMs) {
+    fn();
+    iterations++;
+    elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+  }
+  return elapsedMs / iterations;
+};
+
+const main = async () => {
+  const renderer = await import(path.join(__dirname, '../src/utils/MarkdownRenderer.js'));
+  let markdownIt = null;
+  try {
+    const MarkdownIt = require('markdown-it');
+    markdownIt = new MarkdownIt();
+  } catch (error) {
+    console.log('markdown-it not installed; skipping comparison');
+  }
+
+  const sizes = [10 * 1024, 100 * 1024, 1024 * 1024];
+  const results = [];
+
+  for (const size of sizes) {
+    const summary = buildSummary(size);
+    const mb = summary.length / (1024 * 1024);
+
+    const renderMs = timeIterations(() => renderer.renderMarkdown(summary));
+    renderer.renderMarkdownCached('bench', summary);
+    const cachedMs = timeIterations(() => renderer.renderMarkdownCached('bench', summary));
+    const markdownItMs = markdownIt ? timeIterations(() => markdownIt.render(summary)) : null;
+
+    results.push({
+      sizeKB: Math.round(summary.length / 1024),
+      renderMs: Number(renderMs.toFixed(3)),
+      renderMBps: Number((mb / (renderMs / 1000)).toFixed(1)),
+      cachedMs: Number(cachedMs.toFixed(4)),
+      markdownItMs: markdownItMs !== null ? Number(markdownItMs.toFixed(3)) : null,
+      markdownItMBps: markdownItMs !== null ? Number((mb / (markdownItMs / 1000)).toFixed(1)) : null,
+    });
+  }
+
+  console.table(results);
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,171 @@
+// Merge Commit Benchmark
+// Cost and crash safety of deleting segments after a verified merge.
+// 1. Verification: the native check hashes the AAC packet payload of the
+//    segments and of the merged file (AVAssetReader, no decoding). Under Node
+//    the equivalent work is a SHA-256 pass over the same bytes, timed here for
+//    a lesson of the given length; the decode fallback (frame counts and a
+//    per-block energy comparison through the AAC decoder) only runs on the
+//    device and records the merge.verifyMs histogram (getMetrics).
+// 2. Commit: the old listener (re-read recordings.json, point at the merged
+//    file) against commitMergedExport (journal, one write, unlink segments).
+// 3. Crash safety: the commit is interrupted before each of its file-system
+//    mutations in turn, then recoverMergeJournals runs as on the next launch.
+//    Every run must end with playable audio: the recording points at a merged
+//    file that exists, or at segments that all exist.
+// Run with: node scripts/benchmarkMergeCommit.js [lessonMinutes] [libraryRecordings]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+
+const BYTES_PER_MINUTE = (128000 / 8) * 60;
+const SEGMENT_MINUTES = 15;
+
+const timed = async (run) => {
+  const start = process.hrtime.bigint();
+  const value = await run();
+  return { value, ms: Number(process.hrtime.bigint() - start) / 1e6 };
+};
+
+const hashFiles = async (paths) => {
+  const hash = crypto.createHash('sha256');
+  for (const filePath of paths) {
+    await new Promise((resolve, reject) => {
+      fs.createReadStream(filePath, { highWaterMark: 1024 * 1024 })
+        .on('data', chunk => hash.update(chunk))
+        .on('end', resolve)
+        .on('error', reject);
+    });
+  }
+  return hash.digest('hex');
+};
+
+const main = async () => {
+  const lessonMinutes = parseInt(process.argv[2], 10) || 60;
+  const libraryCount = parseInt(process.argv[3], 10) || 500;
+
+  const harness = await setupRecordingsHarness();
+  const { tmpDir, recordingsPath, recordingsService } = harness;
+  const rnfs = globalThis.__recordingsBench.fs;
+  const documentsDir = path.join(tmpDir, 'Documents', 'recordings');
+  fs.mkdirSync(documentsDir, { recursive: true });
+
+  // A lesson's segments with real (random) audio-sized payloads, and their merge
+  const segmentCount = Math.ceil(lessonMinutes / SEGMENT_MINUTES);
+  const makeSegments = (id, fill) => Array.from({ length: segmentCount }, (_, n) => {
+    const minutes = Math.min(SEGMENT_MINUTES, lessonMinutes - n * SEGMENT_MINUTES);
+    const segmentPath = path.join(documentsDir, `rec_${id}_20240101T101500Z_segment${String(n + 1).padStart(3, '0')}.m4a`);
+    if (fill) fs.writeFileSync(segmentPath, crypto.randomBytes(Math.round(minutes * BYTES_PER_MINUTE)));
+    else fs.writeFileSync(segmentPath, `segment ${n + 1}`);
+    return segmentPath;
+  });
+  const merge = (segmentPaths, mergedPath) => {
+    fs.writeFileSync(mergedPath, '');
+    segmentPaths.forEach(segmentPath => fs.appendFileSync(mergedPath, fs.readFileSync(segmentPath)));
+    return mergedPath;
+  };
+
+  const rows = [];
+  const lessonPaths = makeSegments('LESSON', true);
+  const lessonMerged = merge(lessonPaths, path.join(path.dirname(recordingsPath), 'LESSON_merged.m4a'));
+  const lessonMB = lessonPaths.reduce((sum, segmentPath) => sum + fs.statSync(segmentPath).size, 0) / 1048576;
+  const segmentsHash = await timed(() => hashFiles(lessonPaths));
+  const mergedHash = await timed(() => hashFiles([lessonMerged]));
+  if (segmentsHash.value !== mergedHash.value) {
+    throw new Error('Merged payload hash differs from the segments');
+  }
+  const verifyMs = segmentsHash.ms + mergedHash.ms;
+  rows.push({ step: `verify (hash ${(lessonMB * 2).toFixed(0)} MB)`, ms: Number(verifyMs.toFixed(1)), note: `${(lessonMB * 2 / (verifyMs / 1000)).toFixed(0)} MB/s` });
+  lessonPaths.concat(lessonMerged).forEach(filePath => fs.unlinkSync(filePath));
+
+  // The native check itself is stubbed from here on; the payloads are tiny
+  globalThis.__recordingsBench.audioRecorder.verifyMergedExport = async () => ({ verified: true, method: 'packets', elapsedMs: verifyMs });
+
+  const library = harness.makeLibrary(libraryCount);
+  const resetRecording = (id) => {
+    const segmentPaths = makeSegments(id, false);
+    const mergedPath = merge(segmentPaths, path.join(path.dirname(recordingsPath), `${id}_merged.m4a`));
+    library[0] = { ...library[0], id, filePath: segmentPaths[0], segmentPaths, processingStatus: 'pending' };
+    harness.writeLibrary(library);
+    return { segmentPaths, mergedPath };
+  };
+
+  const restoreConsole = harness.quiet();
+  try {
+    // Old listener: point at the merged file, segments stay
+    let target = resetRecording('MERGED');
+    const legacy = await timed(async () => {
+      const recording = await recordingsService.getRecordingById('MERGED');
+      await recordingsService.updateRecording({ ...recording, filePath: target.mergedPath, processingStatus: 'pending' });
+    });
+    const legacyLeft = target.segmentPaths.filter(segmentPath => fs.existsSync(segmentPath)).length;
+    rows.push({ step: 'old: update filePath only', ms: Number(legacy.ms.toFixed(1)), note: `${legacyLeft} segments left on disk` });
+    target.segmentPaths.concat(target.mergedPath).forEach(filePath => fs.rmSync(filePath, { force: true }));
+
+    target = resetRecording('MERGED');
+    const commit = await timed(() => recordingsService.commitMergedExport('MERGED', target.segmentPaths, target.mergedPath, { processingStatus: 'pending' }));
+    const commitLeft = target.segmentPaths.filter(segmentPath => fs.existsSync(segmentPath)).length;
+    rows.push({ step: 'new: journaled commit (verify stubbed)', ms: Number(commit.ms.toFixed(1)), note: `${commitLeft} segments left on disk` });
+    fs.rmSync(target.mergedPath, { force: true });
+  } finally {
+    restoreConsole();
+  }
+
+  // Crash before the k-th file-system mutation of the commit, then recover
+  const realFs = { ...rnfs };
+  let mutationsLeft = Infinity;
+  const crashable = name => async (...args) => {
+    if (mutationsLeft-- <= 0) throw new Error('simulated crash');
+    return realFs[name](...args);
+  };
+  const outcomes = {};
+  let crashPoints = 0;
+  for (let k = 0; ; k++) {
+    const { segmentPaths, mergedPath } = resetRecording('CRASH');
+    Object.assign(rnfs, { writeFile: crashable('writeFile'), moveFile: crashable('moveFile'), unlink: crashable('unlink') });
+    mutationsLeft = k;
+    let crashed = false;
+    const restore = harness.quiet();
+    try {
+      await recordingsService.commitMergedExport('CRASH', segmentPaths, mergedPath);
+    } catch (error) {
+      crashed = true;
+    } finally {
+      Object.assign(rnfs, realFs);
+      restore();
+    }
+    if (!crashed) break;
+    crashPoints++;
+
+    const restoreRecovery = harness.quiet();
+    const summary = await recordingsService.recoverMergeJournals();
+    restoreRecovery();
+    const recording = JSON.parse(fs.readFileSync(recordingsPath, 'utf8')).find(r => r.id === 'CRASH');
+    const playable = recording.filePath === mergedPath
+      ? fs.existsSync(mergedPath)
+      : segmentPaths.every(segmentPath => fs.existsSync(segmentPath)) && recording.filePath === segmentPaths[0];
+    const journalLeft = fs.readdirSync(path.dirname(recordingsPath)).some(name => name.endsWith('_merge.json'));
+    if (!playable || journalLeft) {
+      throw new Error(`Crash before mutation ${k + 1} left ${playable ? 'a journal behind' : 'unplayable audio'}`);
+    }
+    const outcome = recording.filePath === mergedPath
+      ? `merged (${summary.completed ? 'completed' : summary.rolledForward ? 'rolled forward' : 'no journal'})`
+      : 'segments kept';
+    outcomes[outcome] = (outcomes[outcome] || 0) + 1;
+    segmentPaths.concat(mergedPath).forEach(filePath => fs.rmSync(filePath, { force: true }));
+  }
+
+  const fileMB = fs.statSync(recordingsPath).size / 1048576;
+  console.log(`${lessonMinutes}-minute lesson in ${segmentCount} segments (${lessonMB.toFixed(1)} MB); ${libraryCount} recordings in recordings.json (${fileMB.toFixed(1)} MB)`);
+  console.table(rows);
+  console.log(`Crash at each of ${crashPoints} points in the commit, then recovery: audio always playable, no journal left`);
+  console.table(Object.entries(outcomes).map(([outcome, runs]) => ({ outcome, runs })));
+  harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
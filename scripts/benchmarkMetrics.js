@@ -0,0 +1,70 @@
+// Metrics Overhead Benchmark (Linux)
+// Builds scripts/metricsBench.c against ios/ASMetrics.h (the registry behind
+// getMetrics()) and measures what recording costs the paths that update it:
+// a counter increment, a gauge move and a histogram sample, each through the
+// call-site macro as the app writes it, on one thread and on several threads
+// hitting the same metric. Costs are net of the bare loop, in thread CPU time.
+// Also checks the histograms' percentiles against the exact ones over a million
+// log-normal durations (they should be within 1/32), and times the snapshot
+// getMetrics() takes of the registry.
+// Run with: node scripts/benchmarkMetrics.js [ops] [threads]
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+const RUNS = 3;
+const MAX_ERROR = 1 / 32;
+
+const median = values => values.slice().sort((a, b) => a - b)[Math.floor(values.length / 2)];
+
+const main = () => {
+  if (process.platform !== 'linux') {
+    throw new Error('This benchmark builds with cc and pthreads and times thread CPU; run it on Linux');
+  }
+  const ops = parseInt(process.argv[2], 10) || 5000000;
+  const threads = parseInt(process.argv[3], 10) || 4;
+
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'metrics-'));
+  const binary = path.join(dir, 'metricsBench');
+  let runs;
+  try {
+    execFileSync('cc', ['-O2', '-std=c11', '-pthread', '-Wall', '-Werror',
+      '-I', path.join(__dirname, '../ios'), path.join(__dirname, 'metricsBench.c'), '-o', binary, '-lm']);
+    runs = Array.from({ length: RUNS }, () => JSON.parse(execFileSync(binary, [ops, threads].map(String), { encoding: 'utf8' })));
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+  const result = key => median(runs.map(run => run[key]));
+  const { percentiles } = runs[0];
+  const lost = runs.find(run => run.events !== run.expectedEvents);
+  if (lost) throw new Error(`Counter lost updates: ${lost.events} of ${lost.expectedEvents}`);
+  if (result('worstPercentileError') > MAX_ERROR) {
+    throw new Error(`Percentile error ${result('worstPercentileError')} above ${MAX_ERROR}`);
+  }
+
+  const net = key => Number(Math.max(0, result(key) - result('bareNs')).toFixed(1));
+  console.log(`${ops} updates per run, median of ${RUNS} runs, ${os.cpus().length} CPUs; `
+    + `${runs[0].buckets}-bucket histograms (${(runs[0].histogramBytes / 1024).toFixed(1)} KB each)`);
+  console.table([
+    { update: 'counter', ns: net('counterNs'), [`${threads} threads ns`]: net('contendedCounterNs') },
+    { update: 'gauge', ns: net('gaugeNs') },
+    { update: 'histogram', ns: net('histogramNs'), [`${threads} threads ns`]: net('contendedHistogramNs') },
+  ]);
+  console.table(percentiles.map(({ fraction, exact, reported }) => ({
+    percentile: `p${fraction * 100}`,
+    exactUs: exact,
+    reportedUs: reported,
+    errorPct: Number(((Math.abs(reported - exact) / exact) * 100).toFixed(2)),
+  })));
+  console.log(`snapshot of ${runs[0].histograms} histograms + ${runs[0].metrics - runs[0].histograms} other metrics: `
+    + `${result('snapshotUs').toFixed(1)} us (per histogram ${(result('snapshotUs') / runs[0].histograms).toFixed(1)} us); no lost counter updates`);
+};
+
+try {
+  main();
+} catch (error) {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+}
@@ -0,0 +1,112 @@
+// PDF Export Benchmark
+// Streams a combined export of N lesson summaries through src/utils/PDFWriter.js
+// into scripts/output/, reporting wall time, peak heap and output size, and
+// checks that every xref offset points at its object.
+// Run with: node scripts/benchmarkPDF.js [summaryCount]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+//
+// The WebView path (RNHTMLtoPDF) only runs on device; compare against the
+// pdf.webviewExportMs histogram ShareUtils records there (MetricsService).
+
+const fs = require('fs');
+const path = require('path');
+const { register } = require('module');
+
+// App sources import siblings without the .js extension (Metro resolves them);
+// teach Node's ESM resolver to do the same.
+register(`data:text/javascript,${encodeURIComponent(`
+export async function resolve(specifier, context, next) {
+  if (specifier.startsWith('.') && !/\\.[cm]?js$/.test(specifier)) {
+    return next(specifier + '.js', context);
+  }
+  return next(specifier, context);
+}`)}`);
+
+const SUMMARY = `
+# Lesson Overview
+
+Worked on **Bach Partita No. 3** (Preludio) and *Kreutzer 23*, with attention to bow distribution and left-hand frames.
+
+## Bow Distribution
+
+- Use less bow at the beginning of phrases
+- Gradually increase bow speed toward the middle — keep the contact point steady
+  - Release weight on the up-bow
+  - Keep the wrist flexible through string crossings
+- Ease off at phrase endings for natural tapering
+
+## Left Hand
+
+1. Prepare fingers in advance for faster passages
+2. Keep fingers curved and close to the fingerboard
+3. Check intonation against open strings
+
+> "Listen for the sound, not the bow."
+
+| Exercise | Tempo | Notes |
+|:--|--:|:--|
+| Scales in thirds | 72 | Slurred, 4 per bow |
+| Kreutzer 23 | 60 | Detaché, upper half |
+
+## Practice Plan
+
+Practice slowly with a metronome at \`60\`, then raise the tempo by 4 clicks each day once the passage is clean.
+`;
+
+const verifyXref = (buffer) => {
+  const text = buffer.toString('latin1');
+  const startxref = parseInt(text.slice(text.lastIndexOf('startxref') + 9).trim(), 10);
+  const lines = text.slice(startxref).split('\n');
+  const count = parseInt(lines[1].split(' ')[1], 10);
+  for (let i = 1; i < count; i++) {
+    const offset = parseInt(lines[2 + i].slice(0, 10), 10);
+    if (!text.startsWith(`${i} 0 obj`, offset)) {
+      throw new Error(`xref entry ${i} points at offset ${offset}, which is not "${i} 0 obj"`);
+    }
+  }
+  return count - 1;
+};
+
+const main = async () => {
+  const count = parseInt(process.argv[2], 10) || 100;
+  const { writeMarkdownPDF, createBufferedSink } = await import(path.join(__dirname, '../src/utils/PDFWriter.js'));
+
+  const outputDir = path.join(__dirname, 'output');
+  fs.mkdirSync(outputDir, { recursive: true });
+  const outputPath = path.join(outputDir, `benchmark_${count}_summaries.pdf`);
+  fs.writeFileSync(outputPath, '');
+
+  const sections = Array.from({ length: count }, (_, i) => ({
+    heading: `Summary for: Lesson ${i + 1}`,
+    markdown: SUMMARY,
+  }));
+
+  let peakHeap = process.memoryUsage().heapUsed;
+  const sink = createBufferedSink(async (chunk) => {
+    fs.appendFileSync(outputPath, chunk, 'latin1');
+    peakHeap = Math.max(peakHeap, process.memoryUsage().heapUsed);
+  });
+
+  const start = process.hrtime.bigint();
+  const { pageCount, bytes } = await writeMarkdownPDF(sink, 'Combined Recording Summaries', sections,
+    'Generated with ArcoScribe');
+  const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+
+  const objects = verifyXref(fs.readFileSync(outputPath));
+
+  console.table([{
+    summaries: count,
+    pages: pageCount,
+    objects,
+    sizeKB: Math.round(bytes / 1024),
+    totalMs: Number(elapsedMs.toFixed(1)),
+    msPerSummary: Number((elapsedMs / count).toFixed(2)),
+    peakHeapMB: Number((peakHeap / (1024 * 1024)).toFixed(1)),
+  }]);
+  console.log(`Wrote ${outputPath}`);
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
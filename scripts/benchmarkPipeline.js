@@ -0,0 +1,149 @@
+// Pipeline Benchmark (Linux)
+// Builds scripts/pipelineBench.c against ios/ASCaptureRing.h, ios/ASUploadBody.h
+// and ios/ASJSONBody.h, and takes lessons from capture to summary: synthetic
+// PCM through the capture ring and writer, segment rollover, merge, the
+// multipart transcription body, the upload to scripts/mockAIServer.js, the
+// summary request built from the transcript, and the replies parsed (natively
+// by the driver, and with JSON.parse as BackgroundTransferService does).
+// Per stage: wall time (p50 / p99 over the runs), CPU time across threads
+// (capture's includes generating the signal) and bytes written; latency histograms for tap callbacks, sink calls and rollover
+// gaps; peak RSS. stopToSummaryS is what the user waits for after tapping stop:
+// the local stages, the uploads at UPLINK_MBPS and the stand-in's modelled
+// server time (it runs at TIME_SCALE, so the real waits are short).
+// With --json the full result (histogram buckets included) is written to that
+// path (or stdout with -), with the commit and machine, to track over time.
+// Run with: node scripts/benchmarkPipeline.js [runs] [lessonMinutes] [segmentMinutes] [--json path]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { execFile, execFileSync } = require('child_process');
+const { promisify } = require('util');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+const { createMockAIServer } = require('./mockAIServer');
+
+const TIME_SCALE = 0.001;
+const UPLINK_MBPS = 10;
+const PARSE_RUNS = 5;
+
+const median = values => values.slice().sort((a, b) => a - b)[Math.floor(values.length / 2)];
+const ms = us => Number((us / 1000).toFixed(1));
+const mb = bytes => Number((bytes / 1048576).toFixed(1));
+
+// The app's side of the replies: JSON.parse and the fields it reads
+const timeParse = (filePath, read) => {
+  const text = fs.readFileSync(filePath, 'utf8');
+  return median(Array.from({ length: PARSE_RUNS }, () => {
+    const start = process.hrtime.bigint();
+    if (!read(JSON.parse(text))) throw new Error(`${path.basename(filePath)}: no text where the service reads it`);
+    return Number(process.hrtime.bigint() - start) / 1e6;
+  }));
+};
+
+const gitCommit = () => {
+  try {
+    return execFileSync('git', ['rev-parse', '--short', 'HEAD'], { cwd: __dirname, encoding: 'utf8' }).trim();
+  } catch (error) {
+    return null;
+  }
+};
+
+const main = async () => {
+  if (process.platform !== 'linux') {
+    throw new Error('This benchmark builds with cc, pthreads and -lz and reads /proc; run it on Linux');
+  }
+  const args = process.argv.slice(2);
+  const jsonIndex = args.indexOf('--json');
+  const jsonPath = jsonIndex >= 0 ? args.splice(jsonIndex, 2)[1] || '-' : null;
+  const runs = parseInt(args[0], 10) || 3;
+  const lessonMinutes = parseFloat(args[1]) || 20;
+  const segmentMinutes = parseFloat(args[2]) || 5;
+
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'pipeline-'));
+  const binary = path.join(dir, 'pipelineBench');
+  execFileSync('cc', ['-O2', '-std=c11', '-pthread', '-Wall', '-Werror',
+    '-I', path.join(__dirname, '../ios'), path.join(__dirname, 'pipelineBench.c'), '-o', binary, '-lz', '-lm']);
+
+  // The summary request's static fields, as the service sends them and ASJSONBodyPrefix keeps them
+  const harness = await setupRecordingsHarness();
+  const { default: transferService } = await import(path.join(__dirname, '../src/services/BackgroundTransferService.js'));
+  const { jsonBody } = transferService.responsesTask('summarization', 'summary', '');
+  const prefixPath = path.join(dir, 'prefix.json');
+  fs.writeFileSync(prefixPath, `${JSON.stringify(jsonBody.template).slice(0, -1)},`);
+  harness.close();
+
+  const mock = createMockAIServer({ timeScale: TIME_SCALE });
+  const port = await mock.listen();
+  let result;
+  let jsParseMs;
+  try {
+    // Not execFileSync: the stand-in runs on this process's event loop
+    const { stdout } = await promisify(execFile)(binary, [dir, port, runs, lessonMinutes * 60, segmentMinutes * 60, prefixPath, 0].map(String),
+      { encoding: 'utf8', maxBuffer: 16 * 1024 * 1024 });
+    result = JSON.parse(stdout);
+    jsParseMs = {
+      transcription: timeParse(path.join(dir, 'transcription.json'), data => typeof data.text === 'string' && Array.isArray(data.words)),
+      summary: timeParse(path.join(dir, 'summary.json'), data => data.output?.[0]?.content?.[0]?.text),
+    };
+  } finally {
+    await mock.close();
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+  if (result.capture.droppedFrames > 0) throw new Error(`Capture dropped ${result.capture.droppedFrames} frames`);
+  if (mock.stats.malformed > 0) throw new Error('The stand-in rejected a multipart body');
+
+  const uplinkMs = bytes => (bytes * 8) / (UPLINK_MBPS * 1000);
+  const uploadsMs = uplinkMs(result.transcribe.requestBytes) + uplinkMs(result.summarize.requestBytes);
+  const stopToSummaryS = (result.histograms.stopToSummaryUs.p50 / 1000 + uploadsMs + jsParseMs.transcription + jsParseMs.summary) / 1000;
+  const audioMinutes = result.lessonSeconds / 60;
+
+  const stageRows = Object.entries(result.stages).map(([stage, stats]) => ({
+    stage,
+    p50Ms: ms(stats.wallUs.p50),
+    p99Ms: ms(stats.wallUs.p99),
+    cpuMs: ms(stats.cpuUs),
+    writeMB: mb(stats.writeBytes),
+    storageMB: mb(stats.storageBytes),
+    ...(stage === 'transcribe' || stage === 'summarize' ? { modelledServerMs: result[stage].modelledMs, uplinkMs: Math.round(uplinkMs(result[stage].requestBytes)) } : {}),
+  }));
+  const histogramRows = ['pushUs', 'sinkUs', 'rolloverGapUs'].map(name => ({
+    histogram: name,
+    count: result.histograms[name].count,
+    p50: result.histograms[name].p50,
+    p90: result.histograms[name].p90,
+    p99: result.histograms[name].p99,
+    max: result.histograms[name].max,
+  }));
+
+  console.log(`${runs} x ${lessonMinutes}-minute lessons, ${segmentMinutes}-minute segments (${result.segments} each), ${result.sampleRate / 1000} kHz capture; `
+    + `stand-in at ${TIME_SCALE} time scale, ${UPLINK_MBPS} Mbit/s uplink`);
+  console.table(stageRows);
+  console.table(histogramRows);
+  console.log(`capture: ${Math.round((audioMinutes * 60e6) / result.stages.capture.wallUs.p50)}x real time, `
+    + `${(result.stages.capture.cpuUs / 1000 / audioMinutes).toFixed(0)} ms CPU per audio minute, ring high water `
+    + `${result.capture.highWaterFrames} of ${result.capture.capacityFrames} frames, ${result.capture.droppedFrames} dropped`);
+  console.log(`JSON.parse in JS: transcription ${jsParseMs.transcription.toFixed(1)} ms (${Math.round(result.transcriptBytes / 1024)} KB of text), summary ${jsParseMs.summary.toFixed(2)} ms`);
+  console.log(`stop -> summary: ${stopToSummaryS.toFixed(1)} s; peak RSS ${(result.peakRssKB / 1024).toFixed(1)} MB; CPU ${(result.cpuMs / 1000).toFixed(1)} s`);
+
+  if (jsonPath) {
+    const record = {
+      benchmark: 'pipeline',
+      date: new Date().toISOString(),
+      commit: gitCommit(),
+      machine: { platform: `${os.platform()} ${os.release()}`, cpu: os.cpus()[0]?.model, cpus: os.cpus().length, node: process.version },
+      config: { runs, lessonMinutes, segmentMinutes, timeScale: TIME_SCALE, uplinkMbps: UPLINK_MBPS },
+      stopToSummaryS: Number(stopToSummaryS.toFixed(2)),
+      jsParseMs,
+      result,
+    };
+    const text = `${JSON.stringify(record, null, 2)}\n`;
+    if (jsonPath === '-') process.stdout.write(text);
+    else fs.writeFileSync(jsonPath, text);
+  }
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
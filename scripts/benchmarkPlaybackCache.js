@@ -0,0 +1,197 @@
+// Playback Cache Benchmark (Linux)
+// Builds scripts/playbackCacheBench.c against ios/ASPlaybackCache.h (the LRU
+// AudioRecorderModule shares between playback items) and replays scripted
+// playback workloads twice: uncached, as createPlaybackItem worked before
+// (every item parses every segment and builds its composition), and through the
+// cache with the app's bounds and its prefetch on opening a lesson.
+// Segments are laid out like the app's 15-minute AAC segments: a moov box with
+// one sample size entry per 1024-frame packet, then a (sparse) mdat. A miss
+// parses the moov, as AVURLAsset does when loading duration and tracks; AVPlayer
+// decodes inside the item either way, so seeks within an item never reach the
+// cache and are not part of the traces.
+// Workloads:
+//   reopen      - lessons opened again and again, a few replays per visit
+//   two-players - each visit plays the lesson in two players (detail + mini-player)
+//   replay      - one long lesson restarted over and over, then exported
+//   browse      - more lessons than the cache holds, visited in a cycle (worst case)
+// Run with: node scripts/benchmarkPlaybackCache.js [lessonMinutes]
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+// AudioRecorderModule's bounds
+const ASSET_ENTRIES = 32;
+const COMPOSITION_ENTRIES = 6;
+const MAX_SECONDS = 4 * 60 * 60;
+
+const SAMPLE_RATE = 44100;
+const FRAMES_PER_PACKET = 1024;
+const BYTES_PER_SECOND = 128000 / 8;
+const SEGMENT_MINUTES = 15;
+const RUNS = 5;
+
+const median = values => values.slice().sort((a, b) => a - b)[Math.floor(values.length / 2)];
+
+// Deterministic traces across runs
+const makeRandom = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+const box = (type, ...payloads) => {
+  const body = Buffer.concat(payloads);
+  const header = Buffer.alloc(8);
+  header.writeUInt32BE(body.length + 8, 0);
+  header.write(type, 4, 'ascii');
+  return Buffer.concat([header, body]);
+};
+
+// ftyp, moov (trak/mdia/minf/stbl with stsz + stco), mdat sized to the packets
+const writeSegment = (filePath, seconds, random) => {
+  const packets = Math.round((seconds * SAMPLE_RATE) / FRAMES_PER_PACKET);
+  const meanPacket = (BYTES_PER_SECOND * FRAMES_PER_PACKET) / SAMPLE_RATE;
+  const sizes = Buffer.alloc(12 + packets * 4);
+  sizes.writeUInt32BE(packets, 8);
+  let payload = 0;
+  for (let i = 0; i < packets; i++) {
+    const size = Math.round(meanPacket * (0.8 + random() * 0.4));
+    sizes.writeUInt32BE(size, 12 + i * 4);
+    payload += size;
+  }
+  const ftyp = box('ftyp', Buffer.from('M4A \0\0\0\0M4A mp42isom', 'binary'));
+  const stco = Buffer.alloc(12);
+  stco.writeUInt32BE(1, 4);
+  const moovOf = chunkOffset => {
+    stco.writeUInt32BE(chunkOffset, 8);
+    return box('moov', box('trak', box('mdia', box('minf', box('stbl', box('stsz', sizes), box('stco', stco))))));
+  };
+  const headerBytes = ftyp.length + moovOf(0).length + 8;
+  const mdatHeader = Buffer.alloc(8);
+  mdatHeader.writeUInt32BE(payload + 8, 0);
+  mdatHeader.write('mdat', 4, 'ascii');
+  fs.writeFileSync(filePath, Buffer.concat([ftyp, moovOf(headerBytes), mdatHeader]));
+  fs.truncateSync(filePath, headerBytes + payload); // the audio itself is never read on load
+};
+
+const makeLessons = (dir, count, minutes, random) => Array.from({ length: count }, (_, lesson) => {
+  const segments = [];
+  for (let start = 0; start < minutes; start += SEGMENT_MINUTES) {
+    const segmentPath = path.join(dir, `rec_${lesson}_segment${String(segments.length + 1).padStart(3, '0')}.m4a`);
+    writeSegment(segmentPath, Math.min(SEGMENT_MINUTES, minutes - start) * 60, random);
+    segments.push(segmentPath);
+  }
+  return segments;
+});
+
+// A visit: the detail screen prefetches on open, then play (and replays) create items
+const visit = (lines, segments, items) => {
+  lines.push(`prefetch ${segments.join(' ')}`);
+  for (let i = 0; i < items; i++) lines.push(`item ${segments.join(' ')}`);
+};
+
+const workloads = {
+  reopen: (dir, minutes, random) => {
+    const lessons = makeLessons(dir, 6, minutes, random);
+    const lines = [];
+    const recent = [];
+    for (let n = 0; n < 40; n++) {
+      // Mostly back to one of the last two lessons, sometimes another one
+      const lesson = recent.length >= 2 && random() < 0.7
+        ? recent[Math.floor(random() * 2)]
+        : Math.floor(random() * lessons.length);
+      visit(lines, lessons[lesson], 1 + Math.floor(random() * 4));
+      recent.unshift(lesson);
+      recent.splice(2);
+    }
+    return lines;
+  },
+  'two-players': (dir, minutes, random) => {
+    const lessons = makeLessons(dir, 6, minutes, random);
+    const lines = [];
+    for (let n = 0; n < 30; n++) {
+      visit(lines, lessons[Math.floor(random() * lessons.length)], 2 * (1 + Math.floor(random() * 2)));
+    }
+    return lines;
+  },
+  replay: (dir, minutes, random) => {
+    const [segments] = makeLessons(dir, 1, minutes * 1.5, random);
+    const lines = [];
+    visit(lines, segments, 50);
+    lines.push(`export ${segments.join(' ')}`);
+    return lines;
+  },
+  browse: (dir, minutes, random) => {
+    const lessons = makeLessons(dir, 40, minutes, random);
+    const lines = [];
+    for (let pass = 0; pass < 2; pass++) lessons.forEach(segments => visit(lines, segments, 1));
+    return lines;
+  },
+};
+
+const main = () => {
+  if (process.platform !== 'linux') {
+    throw new Error('This benchmark builds with cc and reads Linux stat fields; run it on Linux');
+  }
+  const lessonMinutes = parseFloat(process.argv[2]) || 60;
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'playback-cache-'));
+  const binary = path.join(dir, 'playbackCacheBench');
+  execFileSync('cc', ['-O2', '-std=c11', '-pthread', '-Wall', '-Werror',
+    '-I', path.join(__dirname, '../ios'), path.join(__dirname, 'playbackCacheBench.c'), '-o', binary]);
+
+  // Packet tables are a few hundred KB, past glibc's mmap threshold: without
+  // this every free in the uncached runs is an munmap and the next parse page
+  // faults its table back in, which would flatter the cache
+  const env = { ...process.env, MALLOC_MMAP_THRESHOLD_: '268435456', MALLOC_TRIM_THRESHOLD_: '268435456' };
+  const run = (mode, tracePath) => JSON.parse(execFileSync(binary,
+    [mode, tracePath, ASSET_ENTRIES, COMPOSITION_ENTRIES, MAX_SECONDS].map(String), { encoding: 'utf8', env }));
+  const hitRate = ({ hits, misses }) => (hits + misses > 0 ? `${Math.round((hits / (hits + misses)) * 100)}%` : '-');
+
+  const rows = [];
+  try {
+    for (const [name, makeTrace] of Object.entries(workloads)) {
+      const workloadDir = path.join(dir, name);
+      fs.mkdirSync(workloadDir);
+      const tracePath = path.join(workloadDir, 'trace.txt');
+      fs.writeFileSync(tracePath, `${makeTrace(workloadDir, lessonMinutes, makeRandom(41)).join('\n')}\n`);
+
+      const uncached = Array.from({ length: RUNS }, () => run('uncached', tracePath));
+      const cached = Array.from({ length: RUNS }, () => run('cached', tracePath));
+      if (uncached[0].checksum !== cached[0].checksum) {
+        throw new Error(`${name}: cached playback built different compositions`);
+      }
+      const [last] = cached.slice(-1);
+      const uncachedCpu = median(uncached.map(result => result.cpuMs));
+      const cachedCpu = median(cached.map(result => result.cpuMs));
+      rows.push({
+        workload: name,
+        items: last.items,
+        parses: `${uncached[0].parses} -> ${last.parses}`,
+        builds: `${uncached[0].builds} -> ${last.builds}`,
+        compositionHits: hitRate(last.compositions),
+        assetHits: hitRate(last.assets),
+        prefetchHits: last.assets.prefetchHits + last.compositions.prefetchHits,
+        evictions: last.assets.evictions + last.compositions.evictions,
+        foregroundMs: `${median(uncached.map(r => r.foregroundMs)).toFixed(1)} -> ${median(cached.map(r => r.foregroundMs)).toFixed(1)}`,
+        backgroundMs: Number(median(cached.map(r => r.backgroundMs)).toFixed(1)),
+        cpuMs: `${uncachedCpu.toFixed(1)} -> ${cachedCpu.toFixed(1)}`,
+        cpuSaved: `${Math.round((1 - cachedCpu / uncachedCpu) * 100)}%`,
+      });
+    }
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+
+  console.log(`${lessonMinutes}-minute lessons in ${SEGMENT_MINUTES}-minute segments; cache of ${ASSET_ENTRIES} assets / ${COMPOSITION_ENTRIES} compositions, ${MAX_SECONDS / 3600} h each; medians of ${RUNS} runs (uncached -> cached)`);
+  console.table(rows);
+};
+
+try {
+  main();
+} catch (error) {
+  console.error('Benchmark failed:', error.message || error);
+  process.exit(1);
+}
@@ -0,0 +1,122 @@
+// Processing Load Benchmark
+// Several lessons finish recording at once and go through the whole processing
+// path offline: BackgroundTransferService uploads each audio file for
+// transcription, then summarizes and titles it, against scripts/mockAIServer.js
+// (the app's @env endpoint overrides point there). Upload tasks are the
+// harness's HTTP stand-in for BackgroundTransferManager: real multipart bodies
+// streamed from the files, real JSON bodies. The uplink is shared and
+// throttled, and each scenario injects a different fault mix.
+// Times are modelled seconds (the mock's latency and bandwidth model, run at
+// `TIME_SCALE` of real time) from "upload started" to "title saved".
+// Run with: node scripts/benchmarkProcessingLoad.js [lessons] [minutes]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const path = require('path');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+const { createMockAIServer, AUDIO_BYTES_PER_SECOND } = require('./mockAIServer');
+
+const TIME_SCALE = 0.02;
+const UPLINK_KBPS = 1250; // 10 Mbit/s
+
+const SCENARIOS = [
+  { name: 'clean', options: {} },
+  { name: '5% errors', options: { errorRate: 0.05 } },
+  { name: '5% resets', options: { dropRate: 0.05 } },
+  { name: 'first upload 503', options: {}, faults: [503] },
+];
+
+const percentile = (values, fraction) => {
+  if (values.length === 0) return NaN;
+  const sorted = values.slice().sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.floor(fraction * sorted.length))];
+};
+
+const main = async () => {
+  const lessons = parseInt(process.argv[2], 10) || 8;
+  const minutes = parseFloat(process.argv[3]) || 30;
+
+  // One stand-in per scenario, so each one's stats and fault mix start fresh
+  const mocks = SCENARIOS.map(({ options }) => createMockAIServer({ timeScale: TIME_SCALE, uploadKBps: UPLINK_KBPS, ...options }));
+  await Promise.all(mocks.map(mock => mock.listen()));
+  let current = 0;
+  const harness = await setupRecordingsHarness({ env: mocks[0].urls() });
+  const transfers = harness.useHttpTransfers();
+  const { default: transferService } = await import(path.join(__dirname, '../src/services/BackgroundTransferService.js'));
+  // The service reads its endpoints once (scenario 0's); send each task to the current scenario's stand-in
+  const { startUploadTask } = globalThis.__recordingsBench.transferManager;
+  globalThis.__recordingsBench.transferManager.startUploadTask = (task) => {
+    const urls = mocks[current].urls();
+    return startUploadTask({ ...task, apiUrl: /speech-to-text/.test(task.apiUrl) ? urls.ELEVENLABS_API_URL : urls.OPENAI_RESPONSES_API_URL });
+  };
+
+  // Sparse audio files of the lesson's length, each with its own first block so transcripts differ
+  const audioBytes = Math.round(minutes * 60 * AUDIO_BYTES_PER_SECOND);
+  const makeRecordings = scenario => Array.from({ length: lessons }, (_, i) => {
+    const filePath = path.join(harness.tmpDir, `load-${scenario}-${i}.m4a`);
+    const fd = fs.openSync(filePath, 'w');
+    fs.writeSync(fd, Buffer.from(`lesson ${scenario} ${i} `.repeat(256)));
+    fs.ftruncateSync(fd, audioBytes);
+    fs.closeSync(fd);
+    return {
+      id: `load-${scenario}-${i}`, title: `Lesson ${i + 1}`, filePath, date: 'Mon Jan 01 2024',
+      duration: '00:00', transcript: null, summary: null, processingStatus: 'pending',
+    };
+  });
+
+  const rows = [];
+  const restore = harness.quiet();
+  try {
+    for (let s = 0; s < SCENARIOS.length; s++) {
+      current = s;
+      const mock = mocks[s];
+      mock.failNext(...(SCENARIOS[s].faults || []));
+      const recordings = makeRecordings(s);
+      harness.writeLibrary(recordings);
+      const sent = transfers.bytesSent;
+      const start = process.hrtime.bigint();
+      const finished = new Map();
+      await Promise.all(recordings.map(recording => transferService.startTranscriptionUpload(recording).catch(() => {})));
+      while (finished.size < recordings.length) {
+        await new Promise(resolve => setTimeout(resolve, 10));
+        const seconds = Number(process.hrtime.bigint() - start) / 1e9 / TIME_SCALE;
+        for (const recording of recordings) {
+          if (finished.has(recording.id)) continue;
+          const saved = await harness.recordingsService.getRecordingById(recording.id);
+          // Complete means the title is in too (the pipeline's last step)
+          if (saved.processingStatus === 'error' || (saved.processingStatus === 'complete' && saved.title !== recording.title)) {
+            finished.set(recording.id, { status: saved.processingStatus, seconds, words: saved.transcript ? saved.transcript.split(' ').length : 0 });
+          }
+        }
+      }
+
+      const results = [...finished.values()];
+      const done = results.filter(result => result.status === 'complete');
+      rows.push({
+        scenario: SCENARIOS[s].name,
+        lessons,
+        complete: done.length,
+        failed: results.length - done.length,
+        requests: mock.stats.requests,
+        faults: mock.stats.injectedErrors + mock.stats.dropped,
+        uploadMB: Number(((transfers.bytesSent - sent) / 1048576).toFixed(1)),
+        wordsPerLesson: done.length ? Math.round(done.reduce((sum, result) => sum + result.words, 0) / done.length) : 0,
+        p50s: Math.round(percentile(done.map(result => result.seconds), 0.5)),
+        p95s: Math.round(percentile(done.map(result => result.seconds), 0.95)),
+        maxS: Math.round(Math.max(...results.map(result => result.seconds))),
+      });
+    }
+  } finally {
+    restore();
+    await Promise.all(mocks.map(mock => mock.close()));
+    harness.close();
+  }
+
+  console.log(`${lessons} x ${minutes}-minute lessons at once (${(audioBytes / 1048576).toFixed(1)} MB each), ${UPLINK_KBPS * 8 / 1000} Mbit/s shared uplink; modelled seconds to summary + title`);
+  console.table(rows);
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,102 @@
+// Recording List Benchmark
+// Time-to-first-row and memory for the home screen list with a large library.
+// Compares the old load (getRecordings parses all of recordings.json, transcripts
+// and summaries included) with getRecordingSummaries reading one page of rows
+// from recordings_index.json: on a cold start, on the first launch after an
+// upgrade (no index yet, so it is built once), on the 5-second refresh (index
+// held in memory) and after recordings.json was rewritten by something else.
+// Retained heap is what the list keeps alive after the load.
+// Run with: node scripts/benchmarkRecordingList.js [recordingCount] [transcriptKB]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const path = require('path');
+const v8 = require('v8');
+const vm = require('vm');
+const { pathToFileURL } = require('url');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+
+v8.setFlagsFromString('--expose-gc');
+const gc = vm.runInNewContext('gc');
+
+const PAGE_SIZE = 30; // Same as HomeScreen
+
+const heapMB = () => {
+  gc();
+  gc();
+  return process.memoryUsage().heapUsed / 1048576;
+};
+
+const main = async () => {
+  const count = parseInt(process.argv[2], 10) || 2000;
+  const transcriptKB = parseInt(process.argv[3], 10) || 30;
+
+  const harness = await setupRecordingsHarness();
+  const { recordingsPath, io } = harness;
+  const indexPath = path.join(path.dirname(recordingsPath), 'recordings_index.json');
+  const library = harness.makeLibrary(count, { transcriptBytes: transcriptKB * 1024, statuses: ['complete', 'complete', 'pending'] });
+  harness.writeLibrary(library);
+  library.length = 0;
+
+  // A fresh module instance is a fresh app process: nothing cached in memory
+  let launches = 0;
+  const launch = () => import(`${pathToFileURL(path.join(__dirname, '../src/services/AudioRecordingService.js')).href}?launch=${++launches}`);
+
+  const restoreConsole = harness.quiet();
+  const rows = [];
+  const measure = async (label, service, load) => {
+    harness.resetCounters();
+    const heapBefore = heapMB();
+    const start = process.hrtime.bigint();
+    const rowsShown = await load(service);
+    const firstRowMs = Number(process.hrtime.bigint() - start) / 1e6;
+    const retainedMB = heapMB() - heapBefore;
+    rows.push({
+      load: label,
+      firstRowMs: Number(firstRowMs.toFixed(1)),
+      rowsLoaded: rowsShown.length,
+      retainedMB: Number(Math.max(0, retainedMB).toFixed(2)),
+      recordingsJsonReads: io.reads['recordings.json'] || 0,
+      indexReads: io.reads['recordings_index.json'] || 0,
+    });
+    return rowsShown;
+  };
+  const firstPage = async service => (await service.getRecordingSummaries({ limit: PAGE_SIZE })).items;
+
+  // Old: everything, then FlatList renders the first rows
+  await measure('getRecordings (old)', await launch(), service => service.getRecordings());
+
+  // First launch after upgrading: no index yet
+  fs.rmSync(indexPath, { force: true });
+  await measure('first page, index built', await launch(), firstPage);
+
+  // Cold start with the index on disk
+  const app = await launch();
+  await measure('first page, cold start', app, firstPage);
+
+  // HomeScreen's 5-second refresh and scrolling further
+  await measure('refresh, index in memory', app, firstPage);
+  await measure('scrolled to 10 pages', app, async service => (await service.getRecordingSummaries({ limit: PAGE_SIZE * 10 })).items);
+
+  // Something else (e.g. native task recovery) rewrote recordings.json
+  const recordings = JSON.parse(fs.readFileSync(recordingsPath, 'utf8'));
+  recordings[0].processingStatus = 'processing';
+  harness.writeLibrary(recordings);
+  recordings.length = 0;
+  const updated = await measure('after external write', app, firstPage);
+  restoreConsole();
+
+  if (updated[0].processingStatus !== 'processing' || updated[0].transcript !== undefined) {
+    throw new Error('The index did not pick up the external write, or rows carry transcripts');
+  }
+  const fileMB = fs.statSync(recordingsPath).size / 1048576;
+  const indexMB = fs.statSync(indexPath).size / 1048576;
+  console.log(`${count} recordings: recordings.json ${fileMB.toFixed(1)} MB, recordings_index.json ${indexMB.toFixed(2)} MB; first page = ${PAGE_SIZE} rows`);
+  console.table(rows);
+  harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
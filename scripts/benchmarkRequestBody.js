@@ -0,0 +1,225 @@
+// Request Body Benchmark (Linux)
+// Builds scripts/requestBodyBench.c against ios/ASJSONBody.h and writes the
+// summary and title request bodies of lessons of increasing length the two
+// ways startUploadTask has built them, then POSTs every body to a local echo
+// server that inflates it (Content-Encoding: gzip), parses it and checks it is
+// the request the service meant to send.
+//   stringify - before: JSON.stringify of the whole request in JS, copied to
+//               UTF-8 and written atomically by the native module
+//   stream    - after: the template prefix cached natively, the text escaped
+//               straight into the body file (ASJSONBodyWriter)
+//   gzip N    - stream, gzipped at level N (1 is what the native module uses;
+//               the Responses API does not document gzipped requests, so it is
+//               only on for hosts in GZIP_REQUEST_HOSTS)
+// The requests come from BackgroundTransferService.responsesTask with the real
+// templates. buildMs is JS + native time to get the body file on disk (not the
+// bridge transfer of the string, which the stream path still makes once).
+// uplinkMs is the wire size at UPLINK_MBPS, a modest mobile uplink.
+// Run with: node scripts/benchmarkRequestBody.js [hours...]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const http = require('http');
+const os = require('os');
+const path = require('path');
+const zlib = require('zlib');
+const { execFileSync } = require('child_process');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+
+const WORDS_PER_MINUTE = 150;
+const UPLINK_MBPS = 10;
+const RUNS = 7;
+
+const VOCABULARY = ['the', 'bow', 'string', 'lighter', 'here', 'again', 'from', 'bar', 'twelve', 'slower',
+  'listen', 'intonation', 'shift', 'third', 'position', 'vibrato', 'relax', 'thumb', 'good', 'phrase',
+  'crescendo', 'down-bow', 'keep', 'contact', 'point', 'closer', 'bridge', 'try', 'that', 'once',
+  'you', 'and', 'it', 'to', 'a', 'is', 'so', 'when', 'your', 'sound', 'Kreutzer', 'détaché', 'fingerboard'];
+
+// Deterministic text across runs
+const makeRandom = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+// Speaker paragraphs of sentences, with the quotes and line breaks JSON has to escape
+const makeTranscript = (hours) => {
+  const random = makeRandom(45);
+  const totalWords = Math.round(hours * 60 * WORDS_PER_MINUTE);
+  const parts = [];
+  let words = 0;
+  while (words < totalWords) {
+    parts.push(`${parts.length ? '\n\n' : ''}Speaker ${1 + Math.floor(random() * 2)}: `);
+    for (let sentences = 1 + Math.floor(random() * 6); sentences > 0; sentences--) {
+      const length = 6 + Math.floor(random() * 15);
+      const quoted = random() < 0.1;
+      for (let i = 0; i < length; i++) {
+        let text = VOCABULARY[Math.floor(random() * VOCABULARY.length)];
+        if (i === 0) text = text[0].toUpperCase() + text.slice(1);
+        if (quoted && i === 1) text = `"${text}`;
+        if (i === length - 1) text += `${quoted ? '"' : ''}${random() < 0.8 ? '.' : '?'} `;
+        else text += random() < 0.08 ? ', ' : ' ';
+        parts.push(text);
+      }
+      words += length;
+    }
+  }
+  return parts.join('').trimEnd();
+};
+
+const makeSummary = (random) => {
+  const lines = ['```markdown', '# Kreutzer 23 and the Bach sarabande'];
+  for (let section = 1; section <= 14; section++) {
+    lines.push('', `## ${section}. Bow "contact point" and sound`, '');
+    for (let bullet = 0; bullet < 4; bullet++) {
+      lines.push(`- ${Array.from({ length: 30 }, () => VOCABULARY[Math.floor(random() * VOCABULARY.length)]).join(' ')}`);
+    }
+  }
+  lines.push('```');
+  return lines.join('\n');
+};
+
+const median = values => values.slice().sort((a, b) => a - b)[Math.floor(values.length / 2)];
+
+const timeRuns = (fn) => {
+  fn();
+  const times = [];
+  for (let i = 0; i < RUNS; i++) {
+    const start = process.hrtime.bigint();
+    fn();
+    times.push(Number(process.hrtime.bigint() - start) / 1e6);
+  }
+  return median(times);
+};
+
+// Inflates and parses whatever it is sent; replies with what arrived
+const createEchoServer = () => {
+  const server = http.createServer((req, res) => {
+    const chunks = [];
+    req.on('data', chunk => chunks.push(chunk));
+    req.on('end', () => {
+      const wire = Buffer.concat(chunks);
+      try {
+        const json = req.headers['content-encoding'] === 'gzip' ? zlib.gunzipSync(wire) : wire;
+        res.writeHead(200, { 'Content-Type': 'application/json' });
+        res.end(JSON.stringify({ wireBytes: wire.length, request: JSON.parse(json.toString('utf8')) }));
+      } catch (error) {
+        res.writeHead(400);
+        res.end(error.message);
+      }
+    });
+  });
+  return {
+    listen: () => new Promise(resolve => server.listen(0, '127.0.0.1', () => resolve(server.address().port))),
+    close: () => new Promise(resolve => server.close(resolve)),
+  };
+};
+
+// The body file as the upload task sends it
+const post = (port, bodyPath, gzip) => new Promise((resolve, reject) => {
+  const req = http.request({
+    host: '127.0.0.1',
+    port,
+    method: 'POST',
+    path: '/v1/responses',
+    headers: {
+      'Content-Type': 'application/json',
+      'Content-Length': fs.statSync(bodyPath).size,
+      ...(gzip ? { 'Content-Encoding': 'gzip' } : {}),
+    },
+  }, (res) => {
+    const chunks = [];
+    res.on('data', chunk => chunks.push(chunk));
+    res.on('end', () => {
+      const text = Buffer.concat(chunks).toString('utf8');
+      if (res.statusCode === 200) resolve(JSON.parse(text));
+      else reject(new Error(`Echo server: ${res.statusCode} ${text}`));
+    });
+  });
+  req.on('error', reject);
+  fs.createReadStream(bodyPath).pipe(req);
+});
+
+const main = async () => {
+  if (process.platform !== 'linux') {
+    throw new Error('This benchmark builds with cc and -lz; run it on Linux');
+  }
+  const hoursList = process.argv.slice(2).map(Number).filter(Boolean);
+  const harness = await setupRecordingsHarness();
+  const { default: transferService } = await import(path.join(__dirname, '../src/services/BackgroundTransferService.js'));
+
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'request-body-'));
+  const binary = path.join(dir, 'requestBodyBench');
+  execFileSync('cc', ['-O2', '-std=c11', '-pthread', '-Wall', '-Werror',
+    '-I', path.join(__dirname, '../ios'), path.join(__dirname, 'requestBodyBench.c'), '-o', binary, '-lz']);
+  const run = args => JSON.parse(execFileSync(binary, args.map(String), { encoding: 'utf8' }));
+  const echo = createEchoServer();
+  const port = await echo.listen();
+
+  const cases = (hoursList.length ? hoursList : [1, 3, 6, 14]).map(hours => ({
+    label: `summary, ${hours} h`,
+    taskType: 'summarization',
+    templateId: 'summary',
+    text: makeTranscript(hours),
+  }));
+  cases.push({ label: 'title', taskType: 'titleGeneration', templateId: 'title', text: makeSummary(makeRandom(46)) });
+
+  const rows = [];
+  try {
+    for (const { label, taskType, templateId, text } of cases) {
+      transferService.sentBodyTemplates.clear();
+      const { jsonBody } = transferService.responsesTask(taskType, templateId, text);
+      const expected = { ...jsonBody.template, [jsonBody.field]: jsonBody.value };
+      const prefixPath = path.join(dir, 'prefix.json');
+      const textPath = path.join(dir, 'text.txt');
+      const bodyPath = path.join(dir, 'body.json');
+      const outPath = path.join(dir, 'out.json');
+      // As ASJSONBodyPrefix keeps it: the fields without the closing brace, then a comma
+      fs.writeFileSync(prefixPath, `${JSON.stringify(jsonBody.template).slice(0, -1)},`);
+      fs.writeFileSync(textPath, text);
+
+      const ways = [
+        { name: 'stringify', jsMs: timeRuns(() => JSON.stringify(expected)), args: ['copy', bodyPath, outPath] },
+        { name: 'stream', args: ['stream', prefixPath, textPath, outPath, 0] },
+        { name: 'gzip 1', gzip: true, args: ['stream', prefixPath, textPath, outPath, 1] },
+        { name: 'gzip 6', gzip: true, args: ['stream', prefixPath, textPath, outPath, 6] },
+      ];
+      fs.writeFileSync(bodyPath, JSON.stringify(expected));
+      let baseline = null;
+      for (const way of ways) {
+        const results = Array.from({ length: RUNS }, () => run(way.args));
+        const echoed = await post(port, outPath, way.gzip);
+        if (JSON.stringify(echoed.request) !== JSON.stringify(expected)) {
+          throw new Error(`${label}, ${way.name}: the server received a different request`);
+        }
+        const buildMs = (way.jsMs || 0) + median(results.map(result => result.ms));
+        const wireBytes = echoed.wireBytes;
+        const uplinkMs = (wireBytes * 8) / (UPLINK_MBPS * 1000);
+        if (!baseline) baseline = { buildMs, wireBytes, uplinkMs };
+        rows.push({
+          request: label,
+          body: way.name,
+          jsonKB: Number((results[0].rawBytes / 1024).toFixed(1)),
+          wireKB: Number((wireBytes / 1024).toFixed(1)),
+          wire: `${Math.round((wireBytes / baseline.wireBytes) * 100)}%`,
+          buildMs: Number(buildMs.toFixed(2)),
+          uplinkMs: Math.round(uplinkMs),
+          totalMs: `${Math.round(baseline.buildMs + baseline.uplinkMs)} -> ${Math.round(buildMs + uplinkMs)}`,
+        });
+      }
+    }
+  } finally {
+    await echo.close();
+    fs.rmSync(dir, { recursive: true, force: true });
+    harness.close();
+  }
+
+  console.log(`Bodies verified by a local echo server; medians of ${RUNS} runs; uplinkMs at ${UPLINK_MBPS} Mbit/s; totalMs = build + upload (stringify -> this body)`);
+  console.table(rows);
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,166 @@
+// Result Cache Benchmark (Linux)
+// Builds scripts/resultCacheBench.c against ios/ASResultCache.h and replays a
+// year of AI requests through the on-disk result cache at several size bounds.
+// The workload is modelled on how requests repeat in the app:
+//   - every lesson: a summary (or, past the one-request limit, parts + merge)
+//     and a title
+//   - retry: the pipeline failed after the summary (title error, app killed)
+//     and the lesson is processed again: the same summary request, then a title
+//   - duplicate: the same recording shared into the app again a few lessons
+//     later: the same summary and title requests
+//   - re-transcribed: the transcript changed, so a new revision request and a
+//     new title (a cache can not help; they count as misses)
+// The app is relaunched every few lessons (the index is rebuilt from the file),
+// and once it dies in the middle of an insert, leaving a torn record.
+// Keys are SHA-256 of the request as the native module hashes it (endpoint and
+// body). Every hit is checked byte for byte. savedS is the modelled time of the
+// requests that were not sent, with the latency model of scripts/mockAIServer.js.
+// Run with: node scripts/benchmarkResultCache.js [lessons]
+
+const crypto = require('crypto');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+const RETRY_RATE = 0.08;
+const DUPLICATE_RATE = 0.04;
+const RETRANSCRIBE_RATE = 0.06;
+const LESSONS_PER_LAUNCH = 6;
+const BOUNDS_MB = [0.25, 2, 8, 64]; // the app uses 8
+
+// mockAIServer.js defaults
+const TTFT_MS = 600;
+const PREFILL_TOKENS_PER_SEC = 4000;
+const DECODE_TOKENS_PER_SEC = 70;
+
+// SummaryChunks.js limits, in tokens at the ~1.43 tokens/word of a lesson
+const TOKENS_PER_MINUTE = 150 * 1.43;
+const SINGLE_REQUEST_TOKENS = 90000;
+const PART_TOKENS = 30000;
+
+// Deterministic traces across runs
+const makeRandom = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+const keyOf = request => crypto.createHash('sha256').update(`https://api.openai.com/v1/responses\n${request}`).digest('hex');
+
+// A request: its cache key, the response size (JSON around the text) and the time it takes when sent
+const request = (name, inputTokens, outputTokens) => ({
+  key: keyOf(name),
+  responseBytes: 600 + outputTokens * 4,
+  inputTokens,
+  modelledMs: TTFT_MS + (inputTokens / PREFILL_TOKENS_PER_SEC) * 1000 + (outputTokens / DECODE_TOKENS_PER_SEC) * 1000,
+});
+
+const summaryRequests = (lesson, tokens, revision) => {
+  if (revision) return [request(`revision ${lesson} ${revision}`, Math.round(tokens * 0.1), 1500)];
+  const summaryTokens = Math.round(300 + tokens * 0.12);
+  if (tokens <= SINGLE_REQUEST_TOKENS) return [request(`summary ${lesson}`, tokens, summaryTokens)];
+  const parts = Math.ceil(tokens / PART_TOKENS);
+  return [
+    ...Array.from({ length: parts }, (_, part) => request(`part ${lesson} ${part}`, tokens / parts, Math.round(300 + (tokens / parts) * 0.12))),
+    request(`merge ${lesson}`, summaryTokens, Math.round(summaryTokens * 0.8)),
+  ];
+};
+
+const makeTrace = (lessonCount, random) => {
+  const ops = [];
+  const pending = []; // duplicates, due at a later lesson
+  const pipeline = (lesson, tokens, revision = 0) => {
+    ops.push(...summaryRequests(lesson, tokens, revision));
+    ops.push(request(`title ${lesson} ${revision}`, 3000, 12));
+  };
+  for (let lesson = 0; lesson < lessonCount; lesson++) {
+    if (lesson > 0 && lesson % LESSONS_PER_LAUNCH === 0) {
+      const torn = lesson >= lessonCount / 2 && !ops.includes('tear');
+      ops.push(torn ? 'tear' : 'reopen');
+    }
+    // Mostly hour-long lessons; now and then a whole day of masterclasses
+    const minutes = random() < 0.05 ? 360 + random() * 300 : 45 + random() * 45;
+    const tokens = Math.round(minutes * TOKENS_PER_MINUTE);
+    pipeline(lesson, tokens);
+    if (random() < RETRY_RATE) pipeline(lesson, tokens);
+    if (random() < RETRANSCRIBE_RATE) pipeline(lesson, tokens, 1);
+    if (random() < DUPLICATE_RATE) pending.push({ due: lesson + 1 + Math.floor(random() * 20), lesson, tokens });
+    for (let i = pending.length - 1; i >= 0; i--) {
+      if (pending[i].due === lesson) {
+        const [duplicate] = pending.splice(i, 1);
+        pipeline(duplicate.lesson, duplicate.tokens);
+      }
+    }
+  }
+  return ops;
+};
+
+const main = () => {
+  if (process.platform !== 'linux') {
+    throw new Error('This benchmark builds with cc and -lz; run it on Linux');
+  }
+  const lessonCount = parseInt(process.argv[2], 10) || 400;
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'result-cache-'));
+  const binary = path.join(dir, 'resultCacheBench');
+  execFileSync('cc', ['-O2', '-std=c11', '-pthread', '-Wall', '-Werror',
+    '-I', path.join(__dirname, '../ios'), path.join(__dirname, 'resultCacheBench.c'), '-o', binary, '-lz']);
+
+  const ops = makeTrace(lessonCount, makeRandom(46));
+  const requests = ops.filter(op => typeof op !== 'string');
+  const tracePath = path.join(dir, 'trace.txt');
+  fs.writeFileSync(tracePath, `${ops.map(op => (typeof op === 'string' ? op : `get ${op.key} ${op.responseBytes}`)).join('\n')}\n`);
+  // The best any cache could do: every request seen before is a hit
+  const seen = new Set();
+  const repeats = requests.filter(({ key }) => seen.has(key) || !seen.add(key));
+  const totalMs = requests.reduce((sum, op) => sum + op.modelledMs, 0);
+
+  const rows = [];
+  try {
+    for (const mb of BOUNDS_MB) {
+      const cachePath = path.join(dir, `results-${mb}.cache`);
+      const result = JSON.parse(execFileSync(binary, [cachePath, tracePath, String(Math.round(mb * 1048576))], { encoding: 'utf8' }));
+      if (result.mismatches > 0) throw new Error(`${mb} MB: ${result.mismatches} hits returned the wrong response`);
+      if (result.requests !== requests.length) throw new Error(`${mb} MB: replayed ${result.requests} of ${requests.length} requests`);
+
+      let savedMs = 0;
+      let sentTokens = 0;
+      requests.forEach((op, i) => {
+        if (result.hitMask[i] === '1') savedMs += op.modelledMs;
+        else sentTokens += op.inputTokens;
+      });
+
+      rows.push({
+        boundMB: mb,
+        requests: result.requests,
+        hits: result.hits,
+        hitRate: `${((result.hits / result.requests) * 100).toFixed(1)}%`,
+        ofRepeats: `${Math.round((result.hits / repeats.length) * 100)}%`,
+        entries: result.entries,
+        fileKB: Math.round(result.fileBytes / 1024),
+        evictions: result.evictions,
+        compactions: result.compactions,
+        hitUs: `${result.hitP50Us.toFixed(1)} / ${result.hitP99Us.toFixed(1)}`,
+        missUs: `${result.missP50Us.toFixed(1)} / ${result.missP99Us.toFixed(1)}`,
+        insertUs: `${result.insertP50Us.toFixed(1)} / ${result.insertP99Us.toFixed(1)}`,
+        openMaxMs: Number((result.openMaxUs / 1000).toFixed(2)),
+        savedS: Math.round(savedMs / 1000),
+        sentMTokens: Number((sentTokens / 1e6).toFixed(2)),
+      });
+    }
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+
+  console.log(`${lessonCount} lessons, ${requests.length} requests (${repeats.length} repeats); relaunch every ${LESSONS_PER_LAUNCH} lessons, one torn insert; `
+    + `latencies p50 / p99; savedS of ${Math.round(totalMs / 1000)} modelled s; sentMTokens without a cache: ${(requests.reduce((sum, op) => sum + op.inputTokens, 0) / 1e6).toFixed(2)}`);
+  console.table(rows);
+};
+
+try {
+  main();
+} catch (error) {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+}
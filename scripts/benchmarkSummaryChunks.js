@@ -0,0 +1,198 @@
+// Summary Chunks Benchmark
+// Token estimation throughput of src/utils/SummaryChunks.js, and the time from
+// "transcript ready" to "summary and title saved" for lessons of increasing
+// length, against scripts/mockAIServer.js. The real BackgroundTransferService
+// runs the pipeline, configured with the mock's URLs; the native transfer
+// manager is replaced by the harness's HTTP upload tasks, which report back
+// through the same completion events. Before = the
+// whole transcript in one request (part planning switched off), after = the
+// service as it is: one request while the transcript fits, else parts in
+// parallel, then the merge request (or a local join when a merged reply would
+// be cut off), then the title.
+// Transcripts are synthetic ElevenLabs output (text, word timings, two
+// speakers), stored with their alignment index and speaker timeline so parts
+// are cut at speaker turns as in the app. Times are modelled seconds: the mock's
+// latency model, run at `TIME_SCALE` of real time.
+// Run with: node scripts/benchmarkSummaryChunks.js [hours...]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const path = require('path');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+const { createMockAIServer, countTokens } = require('./mockAIServer');
+
+const WORDS_PER_MINUTE = 150;
+const TIME_SCALE = 0.01;
+
+const VOCABULARY = ['the', 'bow', 'string', 'lighter', 'here', 'again', 'from', 'bar', 'twelve', 'slower',
+  'listen', 'intonation', 'shift', 'third', 'position', 'vibrato', 'relax', 'thumb', 'good', 'phrase',
+  'crescendo', 'down-bow', 'keep', 'contact', 'point', 'closer', 'bridge', 'try', 'that', 'once',
+  'you', 'and', 'it', 'to', 'a', 'is', 'so', 'when', 'your', 'sound', 'Kreutzer', 'détaché', 'fingerboard'];
+
+// Deterministic text across runs
+const makeRandom = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+// Sentences of 6-20 words with commas; the speaker changes every 1-6 sentences
+const makeTranscript = (hours) => {
+  const random = makeRandom(45);
+  const totalWords = Math.round(hours * 60 * WORDS_PER_MINUTE);
+  const msPerWord = 60000 / WORDS_PER_MINUTE;
+  const words = [];
+  const parts = [];
+  let speaker = 0;
+  let sentencesLeft = 1;
+  let offsetMs = 0;
+  while (words.length < totalWords) {
+    const length = 6 + Math.floor(random() * 15);
+    for (let i = 0; i < length; i++) {
+      let text = VOCABULARY[Math.floor(random() * VOCABULARY.length)];
+      if (i === 0) text = text[0].toUpperCase() + text.slice(1);
+      if (i === length - 1) text += random() < 0.8 ? '.' : '?';
+      else if (random() < 0.08) text += ',';
+      parts.push(text);
+      words.push({ text, type: 'word', start: offsetMs / 1000, end: (offsetMs + msPerWord * 0.8) / 1000, speaker_id: `speaker_${speaker}` });
+      offsetMs += msPerWord;
+    }
+    if (--sentencesLeft === 0) {
+      speaker = 1 - speaker;
+      sentencesLeft = 1 + Math.floor(random() * 6);
+      offsetMs += 2000;
+    }
+  }
+  return { transcript: parts.join(' '), words };
+};
+
+const timeIterations = (fn, minMs = 300) => {
+  for (let i = 0; i < 2; i++) fn();
+  let iterations = 0;
+  let elapsedMs = 0;
+  const start = process.hrtime.bigint();
+  while (elapsedMs < minMs) {
+    fn();
+    iterations++;
+    elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+  }
+  return elapsedMs / iterations;
+};
+
+// Parts must cover the text in order, each new span right after the previous part's end
+const checkParts = (transcript, plan, overlapTokens, estimateTokens) => {
+  let covered = 0;
+  plan.parts.forEach((part, i) => {
+    if (transcript.substring(covered, part.newStart).trim() !== '') throw new Error(`Part ${i} skips text`);
+    if (i > 0 && (part.start > plan.parts[i - 1].end || estimateTokens(transcript, part.start, part.newStart) > overlapTokens)) {
+      throw new Error(`Part ${i} overlaps the previous part wrongly`);
+    }
+    covered = part.end;
+  });
+  if (transcript.substring(covered).trim() !== '') throw new Error('Parts do not cover the transcript');
+};
+
+const main = async () => {
+  const hoursList = process.argv.slice(2).map(Number).filter(Boolean);
+  const mock = createMockAIServer({ timeScale: TIME_SCALE });
+  await mock.listen();
+  const harness = await setupRecordingsHarness({ env: mock.urls() });
+  harness.useHttpTransfers();
+  const src = path.join(__dirname, '../src');
+  const { estimateTokens, planSummaryParts, OVERLAP_TOKENS } = await import(path.join(src, 'utils/SummaryChunks.js'));
+  const { buildAlignmentIndex, saveAlignmentIndex } = await import(path.join(src, 'utils/TranscriptAlignment.js'));
+  const { buildSpeakerTimeline, saveSpeakerTimeline } = await import(path.join(src, 'utils/SpeakerTimeline.js'));
+  const { default: transferService } = await import(path.join(src, 'services/BackgroundTransferService.js'));
+
+  // Summary + title for one recording; resolves once it is complete or failed
+  const runPipeline = async (recording) => {
+    harness.writeLibrary([recording]);
+    mock.resetStats();
+    const start = process.hrtime.bigint();
+    await transferService.startSummarizationUpload(recording).catch(() => {});
+    let saved;
+    do {
+      await new Promise(resolve => setTimeout(resolve, 5));
+      saved = await harness.recordingsService.getRecordingById(recording.id);
+    } while (saved.processingStatus !== 'complete' && saved.processingStatus !== 'error');
+    const seconds = Number(process.hrtime.bigint() - start) / 1e9 / TIME_SCALE;
+    return { seconds, status: saved.processingStatus, stats: { ...mock.stats } };
+  };
+
+  const restore = harness.quiet();
+  // Warm up the services and the mock's sockets before timing anything
+  await runPipeline({ id: 'warm-up', title: 'Warm-up', filePath: path.join(harness.tmpDir, 'warm-up.m4a'), transcript: makeTranscript(0.1).transcript });
+
+  const tokenRows = [];
+  const pipelineRows = [];
+  try {
+    for (const hours of hoursList.length ? hoursList : [1, 3, 6, 8, 10, 14]) {
+      const { transcript, words } = makeTranscript(hours);
+      const index = buildAlignmentIndex(transcript, words);
+      const timeline = buildSpeakerTimeline(words);
+      const mb = transcript.length / 1048576;
+
+      const tokens = estimateTokens(transcript);
+      const estimateMs = timeIterations(() => estimateTokens(transcript));
+      const planMs = timeIterations(() => planSummaryParts(transcript, { alignmentIndex: index, timeline }));
+      const plan = planSummaryParts(transcript, { alignmentIndex: index, timeline });
+      if (plan) checkParts(transcript, plan, OVERLAP_TOKENS, estimateTokens);
+      tokenRows.push({
+        hours,
+        KB: Math.round(transcript.length / 1024),
+        words: words.length,
+        tokens,
+        tokensPerWord: Number((tokens / words.length).toFixed(2)),
+        charsDiv4: countTokens(transcript),
+        estimateMs: Number(estimateMs.toFixed(2)),
+        MBps: Number((mb / (estimateMs / 1000)).toFixed(0)),
+        planMs: Number(planMs.toFixed(2)),
+        parts: plan ? plan.parts.length : 1,
+        largestPart: plan ? Math.max(...plan.parts.map(part => part.tokens)) : tokens,
+      });
+
+      const alignmentPath = path.join(harness.tmpDir, `rec-${hours}_alignment.bin`);
+      const speakerTimelinePath = path.join(harness.tmpDir, `rec-${hours}_speakers.json`);
+      await saveAlignmentIndex(index, alignmentPath);
+      await saveSpeakerTimeline(timeline, speakerTimelinePath);
+      const recording = {
+        id: `rec-${hours}`, title: 'Lesson', filePath: path.join(harness.tmpDir, `rec-${hours}.m4a`), date: 'Mon Jan 01 2024',
+        duration: '00:00', transcript, summary: null, processingStatus: 'processing', alignmentPath, speakerTimelinePath,
+      };
+
+      const planParts = transferService.planSummaryParts;
+      transferService.planSummaryParts = async () => null; // one request, as before
+      const before = await runPipeline(recording);
+      transferService.planSummaryParts = planParts;
+      const after = await runPipeline(recording);
+
+      const outcome = ({ status, stats }) => {
+        if (status !== 'complete') return stats.rejected ? 'over context' : status;
+        return stats.truncated ? 'truncated' : 'complete';
+      };
+      pipelineRows.push({
+        hours,
+        requests: `${before.stats.requests} -> ${after.stats.requests}`,
+        peakConcurrent: after.stats.peakConcurrent,
+        inputTokens: `${before.stats.inputTokens} -> ${after.stats.inputTokens}`,
+        outputTokens: `${before.stats.outputTokens} -> ${after.stats.outputTokens}`,
+        seconds: `${before.seconds.toFixed(0)} -> ${after.seconds.toFixed(0)}`,
+        result: `${outcome(before)} -> ${outcome(after)}`,
+      });
+    }
+  } finally {
+    restore();
+    await mock.close();
+    harness.close();
+  }
+
+  console.log(`Token estimate (charsDiv4 = the mock's 4-characters-per-token count), synthetic lessons at ${WORDS_PER_MINUTE} words/min`);
+  console.table(tokenRows);
+  console.log('Transcript -> summary + title against the mock Responses API (one request -> parts + merge), modelled seconds');
+  console.table(pipelineRows);
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,95 @@
+// Task Recovery Benchmark
+// Cold-start reconciliation of persisted background tasks against a library of
+// recordings. Compares the old per-task loop (getRecordingById re-reads and
+// re-parses recordings.json for every task, updateRecording rewrites it) with
+// the single-pass join in TaskRecoveryService. The native reconcileTasks pass
+// (Objective-C) cannot run here; the JS pass is its fallback and does the same
+// join, with one recordings.json write for all status fixes. Both must leave the
+// same recordings and task store behind.
+// Run with: node scripts/benchmarkTaskRecovery.js [recordingCount] [staleTaskCount]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const path = require('path');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+
+// Old TaskRecoveryService.recoverTasks loop, kept here as the baseline (reading the
+// task's top-level recordingId, which the old code looked for under `metadata`)
+const legacyRecoverTasks = async ({ getRecordingById, updateRecording }, transferManager) => {
+  const persistedTasks = await transferManager.getActiveTasks();
+  for (const taskId of Object.keys(persistedTasks)) {
+    const recordingId = persistedTasks[taskId].recordingId;
+    const recording = await getRecordingById(recordingId);
+    if (!recording || recording.processingStatus === 'complete' || recording.processingStatus === 'error') {
+      await transferManager.clearTask(taskId);
+    } else if (recording.processingStatus !== 'processing') {
+      await updateRecording({ ...recording, processingStatus: 'processing' });
+    }
+  }
+};
+
+const main = async () => {
+  const recordingCount = parseInt(process.argv[2], 10) || 1000;
+  const staleCount = parseInt(process.argv[3], 10) || 100;
+
+  const harness = await setupRecordingsHarness();
+  const { recordingsService, recordingsPath, bridge, io } = harness;
+  const { recoverTasks } = await import(path.join(__dirname, '../src/services/TaskRecoveryService.js'));
+  const transferManager = globalThis.__recordingsBench.transferManager;
+
+  const library = harness.makeLibrary(recordingCount, { statuses: ['complete', 'complete', 'complete', 'pending', 'error'] });
+
+  // Stale tasks: orphans, zombies on finished recordings, interrupted ones and live ones
+  const tasks = {};
+  for (let i = 0; i < staleCount; i++) {
+    const taskId = `task-${i}`;
+    let recordingId;
+    if (i % 10 < 4) recordingId = `deleted-${i}`;
+    else if (i % 10 < 7) recordingId = `rec-${(i * 15) % recordingCount}`; // complete
+    else if (i % 10 < 9) recordingId = `rec-${(i * 5 + 3) % recordingCount}`; // pending
+    else recordingId = i % 20 === 9 ? '' : `rec-${(i * 5 + 4) % recordingCount}`;
+    tasks[taskId] = { taskId, taskType: 'transcription', recordingId, status: 'pending' };
+  }
+
+  const restoreConsole = harness.quiet();
+  const runs = [
+    { mode: 'per-task loop (old)', run: () => legacyRecoverTasks(recordingsService, transferManager) },
+    { mode: 'single pass', run: () => recoverTasks() },
+  ];
+  const rows = [];
+  const outcomes = [];
+  for (const { mode, run } of runs) {
+    harness.writeLibrary(library);
+    bridge.taskStore = JSON.parse(JSON.stringify(tasks));
+    harness.resetCounters();
+
+    const start = process.hrtime.bigint();
+    await run();
+    const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+
+    const statusById = Object.fromEntries(JSON.parse(fs.readFileSync(recordingsPath, 'utf8')).map(r => [r.id, r.processingStatus]));
+    outcomes.push(JSON.stringify({ statusById, remainingTasks: Object.keys(bridge.taskStore).sort() }));
+    rows.push({
+      mode,
+      ms: Number(elapsedMs.toFixed(1)),
+      recordingsReads: io.reads['recordings.json'] || 0,
+      recordingsWrites: io.writes['recordings.json'] || 0,
+      bridgeCalls: bridge.calls,
+      tasksLeft: Object.keys(bridge.taskStore).length,
+    });
+  }
+  restoreConsole();
+
+  if (outcomes[0] !== outcomes[1]) {
+    throw new Error('The single pass left different recordings or tasks than the per-task loop');
+  }
+  const fileMB = fs.statSync(recordingsPath).size / 1048576;
+  console.log(`${recordingCount} recordings (${fileMB.toFixed(1)} MB recordings.json), ${staleCount} persisted tasks; both modes end in the same state`);
+  console.table(rows);
+  harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,119 @@
+// Trace Overhead Benchmark (Linux)
+// Builds scripts/traceBench.c against ios/ASTrace.h twice, at AS_TRACE_LEVEL 2
+// (every span compiled in) and 0 (compiled out), and measures what a span costs
+// the code it wraps: recording off (the one relaxed load), recording on one
+// thread, labelled the way event emission labels its spans, and on several
+// threads at once, with and without a dump racing the writers.
+// The budget check (withinBudget) is on spanNs: everything a span adds to the
+// code it wraps - the recording check, both tick-counter reads, the ring write
+// and the label copy - in thread CPU time, net of the bare loop, best of the
+// runs. tracerNs is that less the two counter reads, and `level` is the
+// AS_TRACE_LEVEL a variant's spans need: release builds compile level 1, the
+// labelled event-emission spans are level 2 (debug builds only).
+// The racing run's last dump is checked: it must parse, and every span in it
+// must carry its own label and value (no torn event) in order per thread.
+// Run with: node scripts/benchmarkTrace.js [spans] [threads]
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+const BUDGET_NS = 50;
+const RUNS = 3;
+const EVENT_NAMES = [
+  'onRecordingProgress', 'onRecordingUpdate', 'onRecordingStateChange', 'onRecordingFinished',
+  'onRecordingError', 'onTransferProgress', 'onTransferComplete', 'onTransferError',
+];
+
+const median = values => values.slice().sort((a, b) => a - b)[Math.floor(values.length / 2)];
+
+// Parses the dump and returns how many spans it holds, or throws on a torn one
+const checkDump = (dumpPath, ringEvents) => {
+  const { traceEvents } = JSON.parse(fs.readFileSync(dumpPath, 'utf8'));
+  const names = new Map(traceEvents.filter(event => event.ph === 'M').map(event => [event.tid, event.args.name]));
+  const lastValue = new Map();
+  const perThread = new Map();
+  let spans = 0;
+  for (const event of traceEvents) {
+    if (event.ph !== 'X') continue;
+    const { value, label } = event.args || {};
+    if (event.name !== 'bench.emit' || event.cat !== 'bench' || label !== EVENT_NAMES[value & 7] || !(event.dur >= 0)) {
+      throw new Error(`Torn event in the dump: ${JSON.stringify(event)}`);
+    }
+    if (lastValue.has(event.tid) && value <= lastValue.get(event.tid)) {
+      throw new Error(`Out of order on ${names.get(event.tid)}: ${value} after ${lastValue.get(event.tid)}`);
+    }
+    lastValue.set(event.tid, value);
+    perThread.set(event.tid, (perThread.get(event.tid) || 0) + 1);
+    spans++;
+  }
+  for (const [tid, count] of perThread) {
+    if (count > ringEvents) throw new Error(`${names.get(tid)}: ${count} spans from a ${ringEvents}-event ring`);
+  }
+  return { spans, threads: perThread.size };
+};
+
+const main = () => {
+  if (process.platform !== 'linux') {
+    throw new Error('This benchmark builds with cc and pthreads and times thread CPU; run it on Linux');
+  }
+  const spans = parseInt(process.argv[2], 10) || 2000000;
+  const threads = parseInt(process.argv[3], 10) || 4;
+
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'trace-'));
+  const results = {};
+  let dump;
+  try {
+    for (const level of [2, 0]) {
+      const binary = path.join(dir, `traceBench${level}`);
+      execFileSync('cc', ['-O2', '-std=c11', '-pthread', '-Wall', '-Werror', `-DAS_TRACE_LEVEL=${level}`,
+        '-I', path.join(__dirname, '../ios'), path.join(__dirname, 'traceBench.c'), '-o', binary]);
+      const runs = Array.from({ length: RUNS }, (_, run) => {
+        const dumpPath = path.join(dir, `trace${level}-${run}.json`);
+        const result = JSON.parse(execFileSync(binary, [spans, threads, dumpPath].map(String), { encoding: 'utf8' }));
+        if (level === 2) dump = { ...checkDump(dumpPath, result.ringEvents), dumps: result.dumps, bytes: fs.statSync(dumpPath).size };
+        return result;
+      });
+      results[level] = Object.fromEntries(Object.keys(runs[0]).map(key => [key, median(runs.map(run => run[key]))]));
+    }
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+
+  const traced = results[2];
+  const counterNs = traced.ticksNs;
+  const row = (variant, level, ns, compiledOutNs) => {
+    const spanNs = ns - traced.baseNs;
+    return {
+      variant,
+      level,
+      spanNs: Number(spanNs.toFixed(1)),
+      tracerNs: Number(Math.max(0, spanNs - 2 * counterNs).toFixed(1)),
+      compiledOutNs: Number(Math.max(0, compiledOutNs - results[0].baseNs).toFixed(1)),
+      withinBudget: spanNs <= BUDGET_NS,
+    };
+  };
+  const rows = [
+    row('recording off', 1, traced.offNs, results[0].offNs),
+    row('recording on', 1, traced.onNs, results[0].onNs),
+    row('labelled', 2, traced.labelledNs, results[0].labelledNs),
+    row(`${threads} threads`, 1, traced.threadedNs, results[0].threadedNs),
+    row(`${threads} threads + dumps`, 2, traced.racingNs, results[0].racingNs),
+  ];
+
+  console.log(`${spans} spans per run, median of ${RUNS} runs, ${os.cpus().length} CPUs; ${traced.ringEvents}-event rings of `
+    + `${traced.eventBytes}-byte events (${(traced.ringEvents * traced.eventBytes) / 1024} KB per thread)`);
+  console.log(`tick counter ${counterNs.toFixed(1)} ns per read, clock_gettime ${traced.clockNs.toFixed(1)} ns; `
+    + `budget ${BUDGET_NS} ns per whole span (spanNs, both counter reads included)`);
+  console.table(rows);
+  console.log(`racing dump: ${dump.spans} spans from ${dump.threads} threads, ${(dump.bytes / 1024).toFixed(0)} KB, `
+    + `no torn events after ${dump.dumps} dumps`);
+};
+
+try {
+  main();
+} catch (error) {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+}
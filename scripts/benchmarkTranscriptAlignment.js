@@ -0,0 +1,135 @@
+// Transcript Alignment Benchmark
+// Tap-to-seek and playback highlighting in src/utils/TranscriptAlignment.js on
+// lessons of increasing length (50k words is about five and a half hours at
+// 150 words/min): building the index from ElevenLabs word timings, the binary
+// file round trip the detail screen loads, and offset -> word and time -> word
+// lookups at random positions, against a linear scan over the same arrays.
+// The first thousand lookups each way are checked against the scan.
+// Run with: node scripts/benchmarkTranscriptAlignment.js [words...]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const path = require('path');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+
+const WORDS_PER_MINUTE = 150;
+const QUERIES = 1 << 16;
+
+const VOCABULARY = ['the', 'bow', 'string', 'lighter', 'here', 'again', 'from', 'bar', 'twelve', 'slower',
+  'listen', 'intonation', 'shift', 'third', 'position', 'vibrato', 'relax', 'thumb', 'good', 'phrase'];
+
+// Deterministic text across runs
+const makeRandom = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+// ElevenLabs-shaped output: words with spacing entries between them
+const makeTranscript = (wordCount, random) => {
+  const msPerWord = 60000 / WORDS_PER_MINUTE;
+  const parts = [];
+  const words = [];
+  for (let i = 0; i < wordCount; i++) {
+    const text = VOCABULARY[Math.floor(random() * VOCABULARY.length)] + (random() < 0.08 ? '.' : '');
+    const start = (i * msPerWord) / 1000;
+    if (i > 0) words.push({ text: ' ', type: 'spacing', start, end: start });
+    words.push({ text, type: 'word', start, end: start + (msPerWord * 0.8) / 1000 });
+    parts.push(text);
+  }
+  return { transcript: parts.join(' '), words };
+};
+
+const timeIterations = (fn, minMs = 300) => {
+  for (let i = 0; i < 2; i++) fn();
+  let iterations = 0;
+  let elapsedMs = 0;
+  const start = process.hrtime.bigint();
+  while (elapsedMs < minMs) {
+    fn();
+    iterations++;
+    elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+  }
+  return elapsedMs / iterations;
+};
+
+// What a lookup without the index costs: walk the words until one starts past the target
+const linearScan = (array, count, value) => {
+  let i = 0;
+  while (i < count && array[i] <= value) i++;
+  return i - 1;
+};
+
+const main = async () => {
+  const wordCounts = process.argv.slice(2).map(Number).filter(Boolean);
+  const harness = await setupRecordingsHarness();
+  const {
+    buildAlignmentIndex, wordIndexAtOffset, wordIndexAtTime, saveAlignmentIndex, loadAlignmentIndex,
+  } = await import(path.join(__dirname, '../src/utils/TranscriptAlignment.js'));
+  const dir = globalThis.__recordingsBench.fs.CachesDirectoryPath;
+
+  const rows = [];
+  for (const wordCount of wordCounts.length ? wordCounts : [10000, 50000, 200000]) {
+    const random = makeRandom(wordCount);
+    const { transcript, words } = makeTranscript(wordCount, random);
+    const index = buildAlignmentIndex(transcript, words);
+    if (!index || index.count !== wordCount) throw new Error(`Aligned ${index?.count} of ${wordCount} words`);
+
+    const buildMs = timeIterations(() => buildAlignmentIndex(transcript, words));
+    const filePath = path.join(dir, `alignment-${wordCount}.bin`);
+    await saveAlignmentIndex(index, filePath);
+    const loaded = await loadAlignmentIndex(filePath);
+    if (!loaded || loaded.count !== index.count || loaded.startMs[index.count - 1] !== index.startMs[index.count - 1]) {
+      throw new Error('Index did not survive the file round trip');
+    }
+    let loadMs = 0;
+    for (let i = 0; i < 5; i++) {
+      const start = process.hrtime.bigint();
+      await loadAlignmentIndex(filePath);
+      loadMs += Number(process.hrtime.bigint() - start) / 1e6 / 5;
+    }
+
+    const offsets = Uint32Array.from({ length: QUERIES }, () => Math.floor(random() * index.transcriptLength));
+    const times = Uint32Array.from({ length: QUERIES }, () => Math.floor(random() * index.endMs[index.count - 1]));
+    for (let q = 0; q < 1000; q++) {
+      if (wordIndexAtOffset(loaded, offsets[q]) !== linearScan(index.charStart, index.count, offsets[q])
+        || wordIndexAtTime(loaded, times[q]) !== linearScan(index.startMs, index.count, times[q])) {
+        throw new Error(`Lookup ${q} disagrees with the linear scan`);
+      }
+    }
+
+    let sink = 0;
+    const offsetNs = timeIterations(() => {
+      for (let q = 0; q < QUERIES; q++) sink += wordIndexAtOffset(loaded, offsets[q]);
+    }) * 1e6 / QUERIES;
+    const timeNs = timeIterations(() => {
+      for (let q = 0; q < QUERIES; q++) sink += wordIndexAtTime(loaded, times[q]);
+    }) * 1e6 / QUERIES;
+    const scanQueries = 256;
+    const scanUs = timeIterations(() => {
+      for (let q = 0; q < scanQueries; q++) sink += linearScan(index.charStart, index.count, offsets[q]);
+    }) * 1e3 / scanQueries;
+    if (sink === 0.5) console.log(sink); // keep the loops observable
+
+    rows.push({
+      words: wordCount,
+      hours: Number((wordCount / WORDS_PER_MINUTE / 60).toFixed(1)),
+      buildMs: Number(buildMs.toFixed(1)),
+      fileKB: Math.round(fs.statSync(filePath).size / 1024),
+      loadMs: Number(loadMs.toFixed(1)),
+      offsetLookupNs: Number(offsetNs.toFixed(0)),
+      timeLookupNs: Number(timeNs.toFixed(0)),
+      linearScanUs: Number(scanUs.toFixed(1)),
+    });
+  }
+
+  console.log(`Random lookups (${QUERIES} per direction) on a loaded index; the first 1000 each way checked against a linear scan`);
+  console.table(rows);
+  harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,171 @@
+// Transcript Chunks Benchmark
+// Chunking throughput of src/utils/TranscriptChunks.js and the work before the
+// first transcript render on the detail screen, for lessons of increasing
+// length. Transcripts are synthetic ElevenLabs output: one line of text, word
+// timings and two alternating speakers, run through the app's own alignment
+// index and speaker timeline builders.
+// First render, old: every gap/word piece of the whole transcript built and
+// handed to one Text node. New: chunk, then pieces for the blocks the list
+// renders first (initialNumToRender). Native text layout cannot run under Node,
+// so the characters and pieces handed to it are reported instead.
+// Run with: node scripts/benchmarkTranscriptChunks.js [hours...]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const path = require('path');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+
+const WORDS_PER_MINUTE = 150;
+const INITIAL_BLOCKS = 6; // RecordingDetailScreen's initialNumToRender
+
+const VOCABULARY = ['the', 'bow', 'string', 'lighter', 'here', 'again', 'from', 'bar', 'twelve', 'slower',
+  'listen', 'intonation', 'shift', 'third', 'position', 'vibrato', 'relax', 'thumb', 'good', 'phrase',
+  'crescendo', 'down-bow', 'keep', 'contact', 'point', 'closer', 'bridge', 'try', 'that', 'once'];
+
+// Deterministic text across runs
+const makeRandom = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+// Sentences of 6-20 words; the speaker changes every 1-6 sentences
+const makeTranscript = (hours) => {
+  const random = makeRandom(42);
+  const totalWords = Math.round(hours * 60 * WORDS_PER_MINUTE);
+  const msPerWord = 60000 / WORDS_PER_MINUTE;
+  const words = [];
+  const parts = [];
+  let speaker = 0;
+  let sentencesLeft = 1;
+  let offsetMs = 0;
+  while (words.length < totalWords) {
+    const length = 6 + Math.floor(random() * 15);
+    for (let i = 0; i < length; i++) {
+      let text = VOCABULARY[Math.floor(random() * VOCABULARY.length)];
+      if (i === 0) text = text[0].toUpperCase() + text.slice(1);
+      if (i === length - 1) text += random() < 0.8 ? '.' : '?';
+      parts.push(text);
+      words.push({ text, type: 'word', start: offsetMs / 1000, end: (offsetMs + msPerWord * 0.8) / 1000, speaker_id: `speaker_${speaker}` });
+      offsetMs += msPerWord;
+    }
+    if (--sentencesLeft === 0) {
+      speaker = 1 - speaker;
+      sentencesLeft = 1 + Math.floor(random() * 6);
+      offsetMs += 2000; // a pause at the change of speaker
+    }
+  }
+  return { transcript: parts.join(' '), words };
+};
+
+const timeIterations = (fn, minMs = 300) => {
+  for (let i = 0; i < 2; i++) fn();
+  let iterations = 0;
+  let elapsedMs = 0;
+  const start = process.hrtime.bigint();
+  while (elapsedMs < minMs) {
+    fn();
+    iterations++;
+    elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+  }
+  return elapsedMs / iterations;
+};
+
+// The gap/word pieces for words [firstWord, wordEnd) of [start, end), as the screen builds them
+const buildPieces = (transcript, index, start, end, firstWord, wordEnd) => {
+  const pieces = [];
+  let cursor = start;
+  for (let i = firstWord; i < wordEnd; i++) {
+    if (index.charStart[i] > cursor) pieces.push(transcript.substring(cursor, index.charStart[i]));
+    pieces.push(transcript.substring(index.charStart[i], index.charEnd[i]));
+    cursor = index.charEnd[i];
+  }
+  if (cursor < end) pieces.push(transcript.substring(cursor, end));
+  return pieces;
+};
+
+const checkChunks = (transcript, index, turnStarts, chunks) => {
+  let cursor = 0;
+  let word = 0;
+  for (const block of chunks.blocks) {
+    if (transcript.substring(cursor, block.start).trim() !== '' || block.end <= block.start) {
+      throw new Error(`Block at ${block.start} leaves text out or is empty`);
+    }
+    if (block.firstWord !== word) throw new Error(`Block at ${block.start} skips words`);
+    word = block.wordEnd;
+    cursor = block.end;
+  }
+  if (transcript.substring(cursor).trim() !== '' || word !== index.count) {
+    throw new Error('Blocks do not cover the transcript');
+  }
+  const starts = new Set(chunks.blocks.map(block => block.start));
+  if (turnStarts.some(offset => !starts.has(offset))) {
+    throw new Error('A speaker turn starts inside a block');
+  }
+};
+
+const main = async () => {
+  const hoursList = process.argv.slice(2).map(Number).filter(Boolean);
+  const harness = await setupRecordingsHarness();
+  const src = path.join(__dirname, '../src/utils');
+  const { buildAlignmentIndex } = await import(path.join(src, 'TranscriptAlignment.js'));
+  const { buildSpeakerTimeline } = await import(path.join(src, 'SpeakerTimeline.js'));
+  const { chunkTranscript, blockIndexForWord } = await import(path.join(src, 'TranscriptChunks.js'));
+
+  const rows = [];
+  for (const hours of hoursList.length ? hoursList : [1, 3, 6]) {
+    const { transcript, words } = makeTranscript(hours);
+    const index = buildAlignmentIndex(transcript, words);
+    const timeline = buildSpeakerTimeline(words);
+    const mb = transcript.length / 1048576;
+
+    const plainMs = timeIterations(() => chunkTranscript(transcript));
+    const chunkMs = timeIterations(() => chunkTranscript(transcript, { alignmentIndex: index, timeline }));
+    const chunks = chunkTranscript(transcript, { alignmentIndex: index, timeline });
+
+    // Where each speaker turn starts in the text
+    const turnStarts = [];
+    let word = 0;
+    for (let t = 1; t < timeline.turns.length; t++) {
+      while (index.startMs[word] < timeline.turns[t].startMs) word++;
+      turnStarts.push(index.charStart[word]);
+    }
+    checkChunks(transcript, index, turnStarts, chunks);
+    const sizes = chunks.blocks.map(block => block.end - block.start);
+    if (blockIndexForWord(chunks, index.count - 1) !== chunks.count - 1) {
+      throw new Error('Last word does not map to the last block');
+    }
+
+    const oldMs = timeIterations(() => buildPieces(transcript, index, 0, transcript.length, 0, index.count));
+    const oldPieces = buildPieces(transcript, index, 0, transcript.length, 0, index.count).length;
+    const firstBlocks = () => chunks.blocks.slice(0, INITIAL_BLOCKS)
+      .map(block => buildPieces(transcript, index, block.start, block.end, block.firstWord, block.wordEnd));
+    const newMs = chunkMs + timeIterations(firstBlocks);
+    const newPieces = firstBlocks().reduce((sum, pieces) => sum + pieces.length, 0);
+    const newChars = chunks.blocks.slice(0, INITIAL_BLOCKS).reduce((sum, block) => sum + block.end - block.start, 0);
+
+    rows.push({
+      hours,
+      KB: Math.round(transcript.length / 1024),
+      words: index.count,
+      turns: timeline.turns.length,
+      blocks: chunks.count,
+      blockChars: `${Math.min(...sizes)}-${Math.max(...sizes)}`,
+      chunkMs: Number(chunkMs.toFixed(2)),
+      chunkMBps: Number((mb / (chunkMs / 1000)).toFixed(0)),
+      plainMBps: Number((mb / (plainMs / 1000)).toFixed(0)),
+      firstRenderMs: `${oldMs.toFixed(1)} -> ${newMs.toFixed(2)}`,
+      firstRenderPieces: `${oldPieces} -> ${newPieces}`,
+      firstRenderChars: `${transcript.length} -> ${newChars}`,
+    });
+  }
+
+  console.log(`Synthetic lessons at ${WORDS_PER_MINUTE} words/min, two speakers; first render = list's first ${INITIAL_BLOCKS} blocks (old -> new)`);
+  console.table(rows);
+  harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
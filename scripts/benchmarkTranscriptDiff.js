@@ -0,0 +1,212 @@
+// Transcript Diff Benchmark
+// Diff throughput of src/utils/TranscriptDiff.js on long transcripts, and how
+// much smaller the request of an incremental re-summarization
+// (planSummaryRevision in SummarizationService) is than sending the whole
+// transcript again. Transcripts are synthetic 50k-word lessons; each scenario
+// edits them the way a correction or a re-transcription would. Every diff is
+// checked by replaying its hunks onto the old words, and its size against the
+// edits that were made (Myers finds a shortest edit script, so it may not be
+// larger).
+// Request sizes are the JSON bodies startSummarizationUpload would send.
+// Run with: node scripts/benchmarkTranscriptDiff.js [words]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const path = require('path');
+const { setupRecordingsHarness } = require('./recordingsBenchHarness');
+
+const SUMMARY_SECTIONS = 14;
+const RUNS = 7;
+
+const VOCABULARY = ['the', 'bow', 'string', 'lighter', 'here', 'again', 'from', 'bar', 'twelve', 'slower',
+  'listen', 'intonation', 'shift', 'third', 'position', 'vibrato', 'relax', 'thumb', 'good', 'phrase',
+  'crescendo', 'down-bow', 'keep', 'contact', 'point', 'closer', 'bridge', 'try', 'that', 'once',
+  'Kreutzer', 'Bach', 'sarabande', 'spiccato', 'martelé', 'détaché', 'fingerboard', 'sound', 'pulse', 'weight'];
+const CORRECTIONS = ['Tchaikovsky', 'Sibelius', 'sautillé', 'ricochet', 'collé', 'portato'];
+
+// Deterministic text across runs
+const makeRandom = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+const pick = (random, list) => list[Math.floor(random() * list.length)];
+
+const makeWords = (count, random) => {
+  const words = [];
+  while (words.length < count) {
+    const length = 6 + Math.floor(random() * 15);
+    for (let i = 0; i < length && words.length < count; i++) {
+      let word = pick(random, VOCABULARY);
+      if (i === 0) word = word[0].toUpperCase() + word.slice(1);
+      if (i === length - 1) word += '.';
+      words.push(word);
+    }
+  }
+  return words;
+};
+
+// Each scenario returns the new words and the number of word insertions + deletions it made
+const scenarios = {
+  'typo fixes (0.1%)': (words, random) => substitute(words, random, 0.001),
+  'typo fixes (1%)': (words, random) => substitute(words, random, 0.01),
+  'typo fixes (5%)': (words, random) => substitute(words, random, 0.05),
+  'passage re-transcribed': (words, random) => {
+    // Two minutes of the lesson come back worded differently
+    const start = Math.floor(words.length * 0.4);
+    const replaced = makeWords(300, random);
+    return { words: [...words.slice(0, start), ...replaced, ...words.slice(start + 300)], edits: 600 };
+  },
+  'passage inserted': (words, random) => {
+    // A gap in the first transcription (e.g. a dropped segment) is filled in
+    const start = Math.floor(words.length * 0.7);
+    return { words: [...words.slice(0, start), ...makeWords(450, random), ...words.slice(start)], edits: 450 };
+  },
+  're-transcription (2%)': (words, random) => {
+    // Scattered changes of every kind: substituted, dropped and added words
+    const next = [];
+    let edits = 0;
+    for (const word of words) {
+      const roll = random();
+      if (roll < 0.008) {
+        next.push(pick(random, CORRECTIONS));
+        edits += 2;
+      } else if (roll < 0.014) {
+        edits += 1;
+      } else if (roll < 0.02) {
+        next.push(word, pick(random, VOCABULARY));
+        edits += 1;
+      } else {
+        next.push(word);
+      }
+    }
+    return { words: next, edits };
+  },
+  unchanged: (words) => ({ words: words.slice(), edits: 0 }),
+};
+
+function substitute(words, random, rate) {
+  const next = words.slice();
+  let edits = 0;
+  for (let i = 0; i < next.length; i++) {
+    if (random() < rate) {
+      next[i] = pick(random, CORRECTIONS);
+      edits += 2;
+    }
+  }
+  return { words: next, edits };
+}
+
+// A summary shaped like SUMMARY_INSTRUCTIONS asks for: a title, then ## sections
+const makeSummary = (random) => {
+  const parts = ['# Lesson on Kreutzer 23 and the Bach sarabande'];
+  for (let s = 0; s < SUMMARY_SECTIONS; s++) {
+    parts.push(`## Section ${s + 1}: ${pick(random, VOCABULARY)} and ${pick(random, VOCABULARY)}`);
+    for (let b = 0; b < 4; b++) parts.push(`- ${makeWords(30, random).join(' ')}`);
+  }
+  return parts.join('\n\n');
+};
+
+const median = values => values.slice().sort((a, b) => a - b)[Math.floor(values.length / 2)];
+
+const timeRuns = (fn) => {
+  fn();
+  const times = [];
+  for (let i = 0; i < RUNS; i++) {
+    const start = process.hrtime.bigint();
+    fn();
+    times.push(Number(process.hrtime.bigint() - start) / 1e6);
+  }
+  return median(times);
+};
+
+const checkDiff = (name, oldWords, newWords, diff, maxEdits) => {
+  const rebuilt = [];
+  let cursor = 0;
+  for (const hunk of diff.hunks) {
+    if (hunk.oldStart < cursor || hunk.oldEnd < hunk.oldStart) throw new Error(`${name}: hunks out of order`);
+    rebuilt.push(...oldWords.slice(cursor, hunk.oldStart), ...newWords.slice(hunk.newStart, hunk.newEnd));
+    if (rebuilt.length !== hunk.newEnd) throw new Error(`${name}: hunk offsets disagree`);
+    cursor = hunk.oldEnd;
+  }
+  rebuilt.push(...oldWords.slice(cursor));
+  if (rebuilt.join(' ') !== newWords.join(' ')) throw new Error(`${name}: hunks do not rebuild the new transcript`);
+  if (diff.editedWords > maxEdits) throw new Error(`${name}: ${diff.editedWords} edits for ${maxEdits} made`);
+};
+
+const checkMerge = (mergeSummaryRevision, splitSummarySections, summary) => {
+  const sections = splitSummarySections(summary);
+  const reply = [`${sections[3].heading}\n\n- revised`, '## Spiccato at the balance point\n\n- new', `${sections[8].heading}\n\n- revised`].join('\n\n');
+  const merged = splitSummarySections(mergeSummaryRevision(summary, reply));
+  const expected = sections.map(section => section.key);
+  expected.splice(4, 0, 'spiccato at the balance point');
+  if (merged.map(section => section.key).join('|') !== expected.join('|')
+    || merged[3].text.indexOf('revised') === -1 || merged[9].text.indexOf('revised') === -1) {
+    throw new Error('Merged summary has the wrong sections');
+  }
+  if (mergeSummaryRevision(summary, 'NO_CHANGES') !== summary) throw new Error('NO_CHANGES altered the summary');
+};
+
+const main = async () => {
+  const wordCount = parseInt(process.argv[2], 10) || 50000;
+  const harness = await setupRecordingsHarness();
+  const { diffTranscripts } = await import(path.join(__dirname, '../src/utils/TranscriptDiff.js'));
+  const { planSummaryRevision, mergeSummaryRevision, splitSummarySections } =
+    await import(path.join(__dirname, '../src/services/SummarizationService.js'));
+
+  const random = makeRandom(43);
+  const oldWords = makeWords(wordCount, random);
+  const previousTranscript = oldWords.join(' ');
+  const summary = makeSummary(random);
+  checkMerge(mergeSummaryRevision, splitSummarySections, summary);
+
+  // Keep the service's logging out of the timings
+  const log = console.log;
+  const rows = [];
+  for (const [name, edit] of Object.entries(scenarios)) {
+    const { words: newWords, edits } = edit(oldWords, makeRandom(44));
+    const transcript = newWords.join(' ');
+    const mb = (previousTranscript.length + transcript.length) / 1048576;
+
+    const diffMs = timeRuns(() => diffTranscripts(previousTranscript, transcript));
+    const diff = diffTranscripts(previousTranscript, transcript);
+    checkDiff(name, oldWords, newWords, diff, edits);
+
+    console.log = () => {};
+    const planMs = timeRuns(() => planSummaryRevision({ summary, transcript }, previousTranscript));
+    const plan = planSummaryRevision({ summary, transcript }, previousTranscript);
+    console.log = log;
+
+    const fullBytes = JSON.stringify({ model: 'gpt-4o', input: transcript, temperature: 0.25, store: false }).length;
+    const revisionBytes = plan?.input
+      ? JSON.stringify({ model: 'gpt-4o', input: plan.input, temperature: 0.25, store: false }).length
+      : 0;
+    let request = 'full';
+    if (plan?.unchanged) request = 'none';
+    else if (plan) request = 'revision';
+
+    rows.push({
+      scenario: name,
+      words: newWords.length,
+      edited: diff.editedWords,
+      hunks: diff.hunks.length,
+      diffMs: Number(diffMs.toFixed(1)),
+      wordsPerSec: `${((oldWords.length + newWords.length) / (diffMs / 1000) / 1e6).toFixed(1)}M`,
+      MBps: Number((mb / (diffMs / 1000)).toFixed(0)),
+      planMs: Number(planMs.toFixed(1)),
+      request,
+      inputKB: `${(fullBytes / 1024).toFixed(0)} -> ${(request === 'revision' ? revisionBytes / 1024 : request === 'none' ? 0 : fullBytes / 1024).toFixed(1)}`,
+      saved: request === 'full' ? '0%' : `${Math.round((1 - revisionBytes / fullBytes) * 100)}%`,
+    });
+  }
+
+  console.log(`${wordCount}-word transcripts, ${summary.length}-char summary in ${SUMMARY_SECTIONS + 1} sections; medians of ${RUNS} runs; input = request body (full -> incremental)`);
+  console.table(rows);
+  harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
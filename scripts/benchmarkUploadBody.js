@@ -0,0 +1,216 @@
+// Upload Body Benchmark (Linux)
+// Write amplification of the files the app writes itself. Segments are written
+// by AVAudioRecorder, which truncates its file on open, so the preallocation
+// lives in the upload body writer (BackgroundTransferManager): the multipart
+// body for a segment-sized file, whose expected size is bitrate x
+// maxSegmentDuration, plus the 60-minute merged upload.
+// Strategies, each written while a second file grows alongside it (a recording
+// in progress), so the allocator has to interleave the two:
+//   append       - encoder-sized writes as the file grows (what a growing segment sees)
+//   atomic       - old body path: head + file + tail in memory, one write to a
+//                  temp file, rename (NSDataWritingAtomic)
+//   preallocated - new path: reserve the final size (fallocate --keep-size, the
+//                  Linux counterpart of F_PREALLOCATE), 1 MiB aligned writes,
+//                  truncate to what was written
+// Write syscalls come from /proc/self/io (syscw, minus the sibling's own
+// writes), extents from filefrag.
+// fsyncMs is the time spent flushing the body: the periodic flushes plus the
+// final fsync. The reservation goes through the fallocate(1) CLI before the
+// clock starts (the native call is a single fcntl).
+// Run with: node scripts/benchmarkUploadBody.js [segmentMinutes] [lessonMinutes]
+
+const crypto = require('crypto');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+const BITRATE = 128000; // AudioRecorderModule's AAC settings
+const PACKET_BYTES = 2048;
+const BLOCK_BYTES = 1024 * 1024;
+const WRITEBACK_BYTES = 256 * 1024;
+const RUNS = 5;
+
+const writeSyscalls = () => {
+  const match = /syscw:\s*(\d+)/.exec(fs.readFileSync('/proc/self/io', 'utf8'));
+  return match ? Number(match[1]) : NaN;
+};
+
+const extents = (filePath) => {
+  const match = /(\d+) extents? found/.exec(execFileSync('filefrag', [filePath], { encoding: 'utf8' }));
+  return match ? Number(match[1]) : NaN;
+};
+
+const elapsedMs = start => Number(process.hrtime.bigint() - start) / 1e6;
+
+const median = values => values.slice().sort((a, b) => a - b)[Math.floor(values.length / 2)];
+
+// A recording in progress next to the body: grows by a quarter of what the body
+// writes, and both files are flushed every WRITEBACK_BYTES of it, as periodic
+// writeback does during a long session (otherwise delayed allocation hides any
+// interleaving until the final fsync)
+const makeSibling = (dir, target) => {
+  const fd = fs.openSync(path.join(dir, 'sibling.m4a'), 'w');
+  const packet = crypto.randomBytes(PACKET_BYTES);
+  let pending = 0;
+  let unflushed = 0;
+  const sibling = {
+    writes: 0,
+    flushMs: 0,
+    grow: (bytes) => {
+      pending += bytes / 4;
+      for (; pending >= PACKET_BYTES; pending -= PACKET_BYTES) {
+        fs.writeSync(fd, packet);
+        sibling.writes++;
+        unflushed += PACKET_BYTES;
+        if (unflushed >= WRITEBACK_BYTES) {
+          const start = process.hrtime.bigint();
+          fs.fdatasyncSync(target);
+          sibling.flushMs += elapsedMs(start);
+          fs.fdatasyncSync(fd);
+          unflushed = 0;
+        }
+      }
+    },
+    close: () => fs.closeSync(fd),
+  };
+  return sibling;
+};
+
+const strategies = {
+  append: (fd, { head, source, tail }, sibling) => {
+    const data = fs.readFileSync(source);
+    fs.writeSync(fd, head);
+    for (let offset = 0; offset < data.length; offset += PACKET_BYTES) {
+      sibling.grow(fs.writeSync(fd, data, offset, Math.min(PACKET_BYTES, data.length - offset)));
+    }
+    fs.writeSync(fd, tail);
+  },
+  // (the rename of the temp file into place is left out; it writes no data)
+  atomic: (fd, { head, source, tail }, sibling) => {
+    const body = Buffer.concat([head, fs.readFileSync(source), tail]);
+    for (let offset = 0; offset < body.length;) {
+      const count = fs.writeSync(fd, body, offset);
+      offset += count;
+      sibling.grow(count);
+    }
+  },
+  preallocated: (fd, { head, source, tail }, sibling) => {
+    const in_ = fs.openSync(source, 'r');
+    const block = Buffer.allocUnsafe(BLOCK_BYTES);
+    let fill = 0;
+    let written = 0;
+    const flush = () => {
+      for (let offset = 0; offset < fill;) offset += fs.writeSync(fd, block, offset, fill - offset);
+      written += fill;
+      sibling.grow(fill);
+      fill = 0;
+    };
+    const append = (bytes) => {
+      for (let offset = 0; offset < bytes.length;) {
+        const count = bytes.copy(block, fill, offset, Math.min(bytes.length, offset + BLOCK_BYTES - fill));
+        fill += count;
+        offset += count;
+        if (fill === BLOCK_BYTES) flush();
+      }
+    };
+    append(head);
+    for (;;) {
+      const count = fs.readSync(in_, block, fill, BLOCK_BYTES - fill, null);
+      if (count === 0) break;
+      fill += count;
+      if (fill === BLOCK_BYTES) flush();
+    }
+    fs.closeSync(in_);
+    append(tail);
+    if (fill > 0) flush();
+    fs.ftruncateSync(fd, written);
+  },
+};
+
+const measure = (dir, name, body) => {
+  const results = [];
+  for (let run = 0; run < RUNS; run++) {
+    const target = path.join(dir, `upload_body_${name}.tmp`);
+    fs.rmSync(target, { force: true });
+    const fd = fs.openSync(target, 'w');
+    if (name === 'preallocated') {
+      execFileSync('fallocate', ['--keep-size', '-l', String(body.expected), target]);
+    }
+    const sibling = makeSibling(dir, fd);
+    const syscalls = writeSyscalls();
+    const start = process.hrtime.bigint();
+    strategies[name](fd, body, sibling);
+    const writeMs = elapsedMs(start);
+    const writes = writeSyscalls() - syscalls - sibling.writes;
+    const fsyncStart = process.hrtime.bigint();
+    fs.fsyncSync(fd);
+    const fsyncMs = elapsedMs(fsyncStart) + sibling.flushMs;
+    fs.closeSync(fd);
+    sibling.close();
+
+    const { size, blocks } = fs.statSync(target);
+    results.push({ writeMs, fsyncMs, writes, extents: extents(target), size, allocated: blocks * 512 });
+    fs.rmSync(target, { force: true });
+  }
+  return results;
+};
+
+const main = () => {
+  if (process.platform !== 'linux') {
+    throw new Error('This benchmark reads /proc/self/io and uses filefrag/fallocate; run it on Linux');
+  }
+  const segmentMinutes = parseFloat(process.argv[2]) || 15; // AudioRecorderModule's maxSegmentDuration
+  const lessonMinutes = parseFloat(process.argv[3]) || 60;
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'upload-body-'));
+
+  const boundary = `Boundary-${crypto.randomUUID()}`;
+  const head = Buffer.from(`--${boundary}\r\nContent-Type: application/json; charset=UTF-8\r\n\r\n{"name":"Lesson.m4a"}\r\n--${boundary}\r\nContent-Type: audio/m4a\r\n\r\n`);
+  const tail = Buffer.from(`\r\n--${boundary}--\r\n`);
+  const cases = [
+    { label: `${segmentMinutes}-min segment`, minutes: segmentMinutes },
+    { label: `${lessonMinutes}-min merged`, minutes: lessonMinutes },
+  ];
+
+  const rows = [];
+  try {
+    for (const { label, minutes } of cases) {
+      const source = path.join(dir, `${minutes}min.m4a`);
+      const audioBytes = Math.round((BITRATE / 8) * minutes * 60);
+      fs.writeFileSync(source, crypto.randomBytes(audioBytes));
+      const expected = head.length + audioBytes + tail.length;
+      const body = { head, source, tail, expected };
+
+      for (const name of Object.keys(strategies)) {
+        const results = measure(dir, name, body);
+        const sizes = new Set(results.map(result => result.size));
+        if (sizes.size !== 1 || !sizes.has(expected)) {
+          throw new Error(`${name} wrote ${[...sizes].join('/')} bytes for a ${expected}-byte body`);
+        }
+        rows.push({
+          body: label,
+          strategy: name,
+          MB: Number((expected / 1048576).toFixed(1)),
+          writeMs: Number(median(results.map(r => r.writeMs)).toFixed(1)),
+          fsyncMs: Number(median(results.map(r => r.fsyncMs)).toFixed(1)),
+          writeSyscalls: median(results.map(r => r.writes)),
+          extents: median(results.map(r => r.extents)),
+          slackKB: Math.round(median(results.map(r => r.allocated - r.size)) / 1024),
+        });
+      }
+      fs.rmSync(source, { force: true });
+    }
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+
+  console.log(`Bodies written next to a growing file; medians of ${RUNS} runs; filesystem: ${execFileSync('findmnt', ['-no', 'FSTYPE', '-T', os.tmpdir()], { encoding: 'utf8' }).trim()}`);
+  console.table(rows);
+};
+
+try {
+  main();
+} catch (error) {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+}
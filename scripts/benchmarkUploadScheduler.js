@@ -0,0 +1,115 @@
+// Upload Scheduler Benchmark
+// Uploads a mixed batch (lesson transcripts/summaries plus audio) through
+// GoogleDriveService.uploadMultipleFiles against a throttled Drive stand-in, and
+// compares one-at-a-time, fixed windows and the AIMD controller on aggregate
+// throughput, how quickly the small text files land, and completion-time
+// fairness (Jain's index over each file's slowdown vs. uploading it alone).
+// Run with: node scripts/benchmarkUploadScheduler.js [bandwidthKBps] [perConnectionKBps]
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const { setupDriveHarness } = require('./driveBenchHarness');
+
+const LATENCY_MS = 80;
+
+const percentile = (values, p) => {
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+};
+
+const jainIndex = (values) => {
+  const sum = values.reduce((a, b) => a + b, 0);
+  const sumSquares = values.reduce((a, b) => a + b * b, 0);
+  return (sum * sum) / (values.length * sumSquares);
+};
+
+const main = async () => {
+  const bandwidthKBps = parseInt(process.argv[2], 10) || 4096;
+  const perConnectionKBps = parseInt(process.argv[3], 10) || 1024;
+  const congestionThreshold = 4;
+
+  const harness = await setupDriveHarness({ latencyMs: LATENCY_MS, bandwidthKBps, perConnectionKBps, congestionThreshold });
+  const { driveService } = harness;
+  const { default: UploadScheduler } = await import(path.join(__dirname, '../src/services/UploadScheduler.js'));
+
+  // 24 text artifacts (20-60 KB) and 12 recordings (1-4 MB), listed audio-first
+  // as a naive queue would see them after a Sync All
+  const uploads = [];
+  for (let i = 0; i < 12; i++) {
+    const filePath = path.join(harness.tmpDir, `lesson_${i}.m4a`);
+    fs.writeFileSync(filePath, crypto.randomBytes((1 + (i % 4)) * 1024 * 1024));
+    uploads.push({ filePath, fileName: `Lesson ${i + 1}.m4a`, fileType: 'audio' });
+  }
+  for (let i = 0; i < 24; i++) {
+    const filePath = path.join(harness.tmpDir, `lesson_${i}_summary.md`);
+    fs.writeFileSync(filePath, '- Slow bows with a metronome at 60\n'.repeat(600 + 300 * (i % 5)));
+    uploads.push({ filePath, fileName: `Lesson ${i + 1}_Summary.md`, fileType: 'file' });
+  }
+  const sizes = uploads.map(upload => fs.statSync(upload.filePath).size);
+  const totalBytes = sizes.reduce((a, b) => a + b, 0);
+
+  const completedAt = new Map();
+  harness.events.on('onTransferComplete', event => completedAt.set(event.taskId, Date.now()));
+
+  const restoreConsole = harness.quiet();
+  const modes = [
+    { mode: 'one at a time', options: { initialWindow: 1, maxWindow: 1, perHostLimit: 1 } },
+    { mode: 'fixed window 4', options: { initialWindow: 4, minWindow: 4, maxWindow: 4 } },
+    { mode: 'fixed window 10', options: { initialWindow: 10, minWindow: 10, maxWindow: 10, perHostLimit: 10 } },
+    { mode: 'AIMD (default)', options: {} },
+    // Without the host cap the controller alone has to find the congestion knee
+    { mode: 'AIMD, host cap 10', options: { maxWindow: 10, perHostLimit: 10 } },
+  ];
+
+  const rows = [];
+  for (const { mode, options } of modes) {
+    harness.reset();
+    const folderId = await driveService.createRecordingFolder('Scheduler Bench', new Date(2025, 6, 1));
+    driveService.uploadScheduler = new UploadScheduler(options);
+    completedAt.clear();
+
+    const start = Date.now();
+    const { results, errors } = await driveService.uploadMultipleFiles(
+      uploads.map(upload => ({ ...upload, parentFolderId: folderId }))
+    );
+    await harness.drainUploads();
+    const wallMs = Date.now() - start;
+    if (errors.length > 0) {
+      throw new Error(`${mode}: ${errors.length} uploads failed: ${errors[0].error}`);
+    }
+
+    const finish = results.map(result => completedAt.get(result.taskId) - start);
+    const slowdown = results.map((result, index) => {
+      const alone = LATENCY_MS + (sizes[index] / (perConnectionKBps * 1024)) * 1000;
+      return finish[index] / alone;
+    });
+    const textFinish = finish.filter((_, index) => uploads[index].fileType !== 'audio');
+    const audioFinish = finish.filter((_, index) => uploads[index].fileType === 'audio');
+    const stats = driveService.uploadScheduler.getStats();
+
+    rows.push({
+      mode,
+      wallMs,
+      throughputKBps: Math.round(totalBytes / 1024 / (wallMs / 1000)),
+      textMeanMs: Math.round(textFinish.reduce((a, b) => a + b, 0) / textFinish.length),
+      textP95Ms: percentile(textFinish, 0.95),
+      audioP95Ms: percentile(audioFinish, 0.95),
+      fairness: Number(jainIndex(slowdown).toFixed(3)),
+      peakWindow: stats.peakWindow,
+      peakConnections: harness.mock.stats.peakConcurrentUploads,
+    });
+  }
+  restoreConsole();
+
+  console.log(`${uploads.length} uploads, ${(totalBytes / 1048576).toFixed(1)} MB; link ${bandwidthKBps} KB/s, ` +
+    `${perConnectionKBps} KB/s per connection, congestion above ${congestionThreshold} connections, ${LATENCY_MS} ms latency`);
+  console.table(rows);
+  await harness.close();
+};
+
+main().catch((error) => {
+  console.error('Benchmark failed:', error);
+  process.exit(1);
+});
@@ -0,0 +1,160 @@
+// Stress test for ios/ASCaptureRing.h, built and driven by scripts/stressCaptureRing.js.
+// A producer thread stands in for the audio input callback: it pushes
+// callbackFrames of a running frame counter on a fixed real-time schedule. The
+// writer's sink writes them to a file, fsyncs once per second of audio, and
+// stalls for stallMs every stallEverySeconds of audio (a blocked disk). The sink
+// checks the counter, so any lost or reordered frame shows up as a gap.
+// Prints one line of JSON with the ring and writer stats.
+//
+// Usage: captureRingStress <outPath> <sampleRate> <callbackFrames> <budgetSeconds>
+//                          <stallMs> <stallEverySeconds> <durationSeconds>
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "ASCaptureRing.h"
+
+typedef struct {
+    int fd;
+    double sampleRate;
+    uint64_t stallEveryFrames;
+    uint64_t stallNanos;
+    uint64_t frames;
+    uint64_t nextStall;
+    uint64_t nextSync;
+    uint64_t expected;
+    uint64_t gaps;
+    uint64_t stalls;
+} StressSink;
+
+static void sleepNanos(uint64_t nanos) {
+    struct timespec duration = { (time_t)(nanos / 1000000000ull), (long)(nanos % 1000000000ull) };
+    while (nanosleep(&duration, &duration) != 0) {}
+}
+
+static int stressSink(void *context, const float *frames, size_t count) {
+    StressSink *sink = context;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t value = (uint64_t)frames[i];
+        if (value != (sink->expected & 0xffffff)) sink->gaps++;
+        sink->expected = value + 1;
+    }
+    for (size_t offset = 0; offset < count;) {
+        ssize_t written = write(sink->fd, frames + offset, (count - offset) * sizeof(float));
+        if (written < 0) return -1;
+        offset += (size_t)written / sizeof(float);
+    }
+    sink->frames += count;
+    if (sink->frames >= sink->nextSync) {
+        fdatasync(sink->fd);
+        sink->nextSync += (uint64_t)sink->sampleRate;
+    }
+    if (sink->stallNanos > 0 && sink->frames >= sink->nextStall) {
+        sleepNanos(sink->stallNanos);
+        sink->stalls++;
+        sink->nextStall += sink->stallEveryFrames;
+    }
+    return 0;
+}
+
+typedef struct {
+    ASCaptureRing *ring;
+    double sampleRate;
+    size_t callbackFrames;
+    uint64_t totalFrames;
+    uint64_t maxPushNanos;
+    uint64_t lateCallbacks;
+} Producer;
+
+static void *producerMain(void *argument) {
+    Producer *producer = argument;
+    float *buffer = malloc(producer->callbackFrames * sizeof(float));
+    uint64_t periodNanos = (uint64_t)(1e9 * producer->callbackFrames / producer->sampleRate);
+    uint64_t counter = 0;
+    uint64_t deadline = ASCaptureNowNanos();
+
+    for (uint64_t pushed = 0; pushed < producer->totalFrames; pushed += producer->callbackFrames) {
+        for (size_t i = 0; i < producer->callbackFrames; i++) {
+            buffer[i] = (float)(counter++ & 0xffffff); // exact in a float
+        }
+        uint64_t start = ASCaptureNowNanos();
+        ASCaptureRingPush(producer->ring, buffer, producer->callbackFrames);
+        uint64_t elapsed = ASCaptureNowNanos() - start;
+        if (elapsed > producer->maxPushNanos) producer->maxPushNanos = elapsed;
+
+        deadline += periodNanos;
+        uint64_t now = ASCaptureNowNanos();
+        if (now > deadline) {
+            producer->lateCallbacks++;
+        } else {
+            struct timespec until = { (time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull) };
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL);
+        }
+    }
+    free(buffer);
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 8) {
+        fprintf(stderr, "usage: %s outPath sampleRate callbackFrames budgetSeconds stallMs stallEverySeconds durationSeconds\n", argv[0]);
+        return 2;
+    }
+    double sampleRate = atof(argv[2]);
+    size_t callbackFrames = (size_t)atol(argv[3]);
+    double budgetSeconds = atof(argv[4]);
+    double stallMs = atof(argv[5]);
+    double stallEverySeconds = atof(argv[6]);
+    double durationSeconds = atof(argv[7]);
+
+    ASCaptureRing ring;
+    if (!ASCaptureRingInit(&ring, ASCaptureRingCapacityForBudget(sampleRate, budgetSeconds, callbackFrames))) {
+        fprintf(stderr, "ring allocation failed\n");
+        return 1;
+    }
+    StressSink sink = {
+        .fd = open(argv[1], O_WRONLY | O_CREAT | O_TRUNC, 0600),
+        .sampleRate = sampleRate,
+        .stallEveryFrames = (uint64_t)(stallEverySeconds * sampleRate),
+        .stallNanos = (uint64_t)(stallMs * 1e6),
+        .nextStall = (uint64_t)(stallEverySeconds * sampleRate),
+        .nextSync = (uint64_t)sampleRate,
+    };
+    if (sink.fd < 0) {
+        perror("open");
+        return 1;
+    }
+
+    ASCaptureWriter writer;
+    if (ASCaptureWriterStart(&writer, &ring, stressSink, &sink, 10000) != 0) {
+        fprintf(stderr, "writer thread failed to start\n");
+        return 1;
+    }
+    Producer producer = {
+        .ring = &ring,
+        .sampleRate = sampleRate,
+        .callbackFrames = callbackFrames,
+        .totalFrames = (uint64_t)(durationSeconds * sampleRate),
+    };
+    pthread_t producerThread;
+    pthread_create(&producerThread, NULL, producerMain, &producer);
+    pthread_join(producerThread, NULL);
+    ASCaptureWriterStop(&writer);
+    close(sink.fd);
+
+    ASCaptureStats stats = ASCaptureStatsRead(&ring, &writer);
+    printf("{\"capacityFrames\":%llu,\"stallBudgetSeconds\":%.3f,\"highWaterFrames\":%llu,"
+           "\"pushedFrames\":%llu,\"droppedFrames\":%llu,\"overruns\":%llu,\"writtenFrames\":%llu,"
+           "\"maxSinkMs\":%.1f,\"sinkError\":%d,\"gaps\":%llu,\"stalls\":%llu,"
+           "\"maxPushMicros\":%.1f,\"lateCallbacks\":%llu}\n",
+           (unsigned long long)stats.capacityFrames, ASCaptureRingStallBudget(&ring, sampleRate, callbackFrames),
+           (unsigned long long)stats.highWaterFrames, (unsigned long long)stats.pushedFrames,
+           (unsigned long long)stats.droppedFrames, (unsigned long long)stats.overruns,
+           (unsigned long long)stats.writtenFrames, stats.maxSinkNanos / 1e6, stats.sinkError,
+           (unsigned long long)sink.gaps, (unsigned long long)sink.stalls,
+           producer.maxPushNanos / 1e3, (unsigned long long)producer.lateCallbacks);
+    ASCaptureRingDestroy(&ring);
+    return 0;
+}
@@ -0,0 +1,208 @@
+// Shared setup for the Drive benchmarks
+// Loads GoogleDriveService under Node against the local Drive stand-in
+// (scripts/mockDriveServer.js). React Native modules are replaced with small
+// stubs: sign-in returns a fixed token, RNFS uses the local disk (with the
+// harness temp dir as the documents directory), recordings live in a Map, and
+// the native background uploader posts the file to the stand-in server and
+// emits the same transfer events. computeChunkManifest runs the JS chunker,
+// which uses the same algorithm as the native one.
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { register } = require('module');
+const { EventEmitter } = require('events');
+const { createMockDriveServer } = require('./mockDriveServer');
+
+const stubModule = (source) => `data:text/javascript,${encodeURIComponent(source)}`;
+
+const STUBS = {
+  '@react-native-google-signin/google-signin': stubModule(`
+export const GoogleSignin = { getTokens: async () => ({ accessToken: 'bench-token' }) };`),
+  'react-native-keychain': stubModule(`
+export const getInternetCredentials = async () => null;
+export const setInternetCredentials = async () => {};
+export const resetInternetCredentials = async () => {};`),
+  'react-native': stubModule(`
+export const NativeModules = { BackgroundTransferManager: globalThis.__driveBench.transferManager };
+export const AppState = { addEventListener: () => ({ remove: () => {} }) };
+export const Platform = { OS: 'ios' };
+export class NativeEventEmitter {
+  addListener(name, listener) {
+    globalThis.__driveBench.events.on(name, listener);
+    return { remove: () => globalThis.__driveBench.events.off(name, listener) };
+  }
+}`),
+  '@env': stubModule(`
+export const PERSIST_METRICS = undefined;`),
+  'react-native-fs': stubModule(`
+export default globalThis.__driveBench.fs;`),
+  './AudioRecordingService': stubModule(`
+export const getRecordingById = async (id) => globalThis.__driveBench.recordings.get(id) || null;
+export const updateRecording = async (recording) => { globalThis.__driveBench.recordings.set(recording.id, recording); return true; };
+export const updateRecordingFields = async (id, fields) => {
+  const recording = globalThis.__driveBench.recordings.get(id);
+  if (!recording) return false;
+  globalThis.__driveBench.recordings.set(id, { ...recording, ...fields });
+  return true;
+};`),
+};
+
+let hooksRegistered = false;
+
+// App sources import siblings without the .js extension (Metro resolves them);
+// teach Node's ESM resolver to do the same, and swap native modules for stubs.
+const registerHooks = () => {
+  if (hooksRegistered) return;
+  hooksRegistered = true;
+  register(`data:text/javascript,${encodeURIComponent(`
+const STUBS = ${JSON.stringify(STUBS)};
+export async function resolve(specifier, context, next) {
+  if (STUBS[specifier]) {
+    return { url: STUBS[specifier], shortCircuit: true };
+  }
+  if (specifier.startsWith('.') && !/\\.[cm]?js$/.test(specifier)) {
+    return next(specifier + '.js', context);
+  }
+  return next(specifier, context);
+}`)}`);
+};
+
+const stubFs = {
+  exists: async (filePath) => fs.existsSync(filePath),
+  stat: async (filePath) => {
+    const stats = fs.statSync(filePath);
+    return { size: stats.size, mtime: stats.mtime, isFile: () => stats.isFile() };
+  },
+  readFile: async (filePath) => fs.readFileSync(filePath, 'utf8'),
+  writeFile: async (filePath, contents) => fs.writeFileSync(filePath, contents),
+  appendFile: async (filePath, contents) => fs.appendFileSync(filePath, contents),
+  unlink: async (filePath) => fs.unlinkSync(filePath),
+};
+
+/**
+ * Start the stand-in server and load GoogleDriveService pointed at it.
+ * @param {Object} serverOptions - Passed to createMockDriveServer (latencyMs, bandwidth limits)
+ * @returns {Promise<Object>} - Harness (see fields below)
+ */
+const setupDriveHarness = async (serverOptions = {}) => {
+  registerHooks();
+
+  const mock = createMockDriveServer(serverOptions);
+  const port = await mock.listen();
+  const base = `http://127.0.0.1:${port}`;
+  const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'drive-bench-'));
+  stubFs.DocumentDirectoryPath = tmpDir; // Where DriveMetadataCache persists
+
+  const pendingUploads = [];
+  const hashing = { bytes: 0, ms: 0 };
+  let nextTaskId = 1;
+  const tasks = {}; // the native task store, as getActiveTasks returns it
+  let computeManifest = null;
+
+  const events = new EventEmitter();
+  globalThis.__driveBench = {
+    events,
+    recordings: new Map(),
+    fs: stubFs,
+    transferManager: {
+      // Mirrors the native uploader: resolves with a task ID, uploads in the
+      // background and reports back through onTransferComplete / onTransferError
+      startUploadTask: async ({ filePath, apiUrl, headers, body, taskType }) => {
+        const taskId = `task-${nextTaskId++}`;
+        tasks[taskId] = { taskType, status: 'pending' };
+        const payload = Buffer.concat([
+          Buffer.from(`--bench\r\nContent-Type: application/json\r\n\r\n${body}\r\n--bench\r\nContent-Type: audio/m4a\r\n\r\n`),
+          fs.readFileSync(filePath),
+          Buffer.from('\r\n--bench--\r\n'),
+        ]);
+        const upload = fetch(apiUrl.replace('https://www.googleapis.com', base), {
+          method: 'POST',
+          headers: { ...headers, 'Content-Type': 'multipart/related; boundary=bench' },
+          body: payload,
+        }).then(async (response) => {
+          const text = await response.text();
+          tasks[taskId].status = response.ok ? 'complete' : 'error';
+          if (response.ok) {
+            events.emit('onTransferComplete', { taskId, taskType, recordingId: '', response: text, bytesSent: payload.length });
+          } else {
+            events.emit('onTransferError', { taskId, taskType, recordingId: '', error: `HTTP Error: ${response.status} - ${text}` });
+          }
+        });
+        pendingUploads.push(upload);
+        return taskId;
+      },
+      computeChunkManifest: async (filePath, options) => {
+        const bytes = new Uint8Array(fs.readFileSync(filePath));
+        const start = process.hrtime.bigint();
+        const manifest = computeManifest(bytes, options);
+        const elapsedMs = Number(process.hrtime.bigint() - start) / 1e6;
+        hashing.bytes += bytes.length;
+        hashing.ms += elapsedMs;
+        return { ...manifest, elapsedMs };
+      },
+      getActiveTasks: async () => JSON.parse(JSON.stringify(tasks)),
+    },
+  };
+  globalThis.require = (name) => {
+    if (name !== 'react-native-fs') throw new Error(`Unexpected require: ${name}`);
+    return stubFs;
+  };
+
+  ({ computeManifest } = await import(path.join(__dirname, '../src/utils/ChunkManifest.js')));
+  const { default: driveService } = await import(path.join(__dirname, '../src/services/GoogleDriveService.js'));
+
+  const harness = {
+    base,
+    mock,
+    events,
+    tmpDir,
+    driveService,
+    hashing,
+    pendingUploads,
+    recordings: globalThis.__driveBench.recordings,
+
+    // Point the service at the stand-in and start from an empty Drive
+    reset() {
+      driveService.configureEndpoints({
+        apiBase: `${base}/drive/v3`,
+        uploadBase: `${base}/upload/drive/v3`,
+        batchUrl: `${base}/batch/drive/v3`,
+      });
+      mock.reset();
+      mock.resetStats();
+      pendingUploads.length = 0;
+    },
+
+    // Wait for background (audio) uploads started since the last call
+    async drainUploads() {
+      await Promise.all(pendingUploads);
+      pendingUploads.length = 0;
+    },
+
+    // Silence the service's per-call logging so result tables are readable
+    quiet() {
+      const log = console.log;
+      const error = console.error;
+      const warn = console.warn;
+      console.log = () => {};
+      console.error = () => {};
+      console.warn = () => {};
+      return () => {
+        console.log = log;
+        console.error = error;
+        console.warn = warn;
+      };
+    },
+
+    async close() {
+      await driveService.metadataCache.save();
+      await mock.close();
+      fs.rmSync(tmpDir, { recursive: true, force: true });
+    },
+  };
+  return harness;
+};
+
+module.exports = { setupDriveHarness };
@@ -0,0 +1,173 @@
+// Overhead and accuracy runner for ios/ASMetrics.h, built and driven by
+// scripts/benchmarkMetrics.js.
+// Times each kind of update through the call-site macros the app uses (handle
+// lookup included), on one thread and on `threads` threads updating the same
+// metrics at once, in thread CPU time. Then records log-normal durations (the
+// shape of rollover gaps and export times) and compares the histogram's
+// percentiles with the exact ones from the sorted values, and times a full
+// snapshot of the registry as getMetrics() takes it.
+// Prints one line of JSON.
+//
+// Usage: metricsBench <ops> <threads>
+
+#define _GNU_SOURCE
+#define AS_METRICS_IMPLEMENTATION
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "ASMetrics.h"
+
+#define RUNS 5
+#define SAMPLES (1 << 20)
+
+static long ops;
+static uint64_t *samples; // log-normal, median 20 ms in µs
+static _Atomic int startLine;
+static volatile uint64_t sink;
+
+static uint64_t threadNanos(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static __attribute__((noinline)) void bare(long i) {
+    sink += samples[i & (SAMPLES - 1)];
+}
+
+static __attribute__((noinline)) void count(long i) {
+    AS_METRIC_COUNT("bench.events", 1);
+    sink += samples[i & (SAMPLES - 1)];
+}
+
+static __attribute__((noinline)) void gauge(long i) {
+    AS_METRIC_GAUGE_ADD("bench.depth", (i & 1) ? -1 : 1);
+    sink += samples[i & (SAMPLES - 1)];
+}
+
+static __attribute__((noinline)) void record(long i) {
+    AS_METRIC_RECORD("bench.durationUs", "us", samples[i & (SAMPLES - 1)]);
+}
+
+static double loopNs(void (*body)(long)) {
+    double best = 0;
+    for (int run = 0; run < RUNS; run++) {
+        uint64_t start = threadNanos();
+        for (long i = 0; i < ops; i++) body(i);
+        double ns = (double)(threadNanos() - start) / (double)ops;
+        if (run == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+typedef struct {
+    pthread_t thread;
+    void (*body)(long);
+    double ns;
+} Worker;
+
+static void *workerMain(void *argument) {
+    Worker *worker = argument;
+    while (!atomic_load(&startLine)) sched_yield();
+    uint64_t start = threadNanos();
+    for (long i = 0; i < ops; i++) worker->body(i);
+    worker->ns = (double)(threadNanos() - start) / (double)ops;
+    return NULL;
+}
+
+static double contendedNs(void (*body)(long), int threads) {
+    Worker *workers = calloc((size_t)threads, sizeof(Worker));
+    atomic_store(&startLine, 0);
+    for (int t = 0; t < threads; t++) {
+        workers[t].body = body;
+        pthread_create(&workers[t].thread, NULL, workerMain, &workers[t]);
+    }
+    atomic_store(&startLine, 1);
+    double worst = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        if (workers[t].ns > worst) worst = workers[t].ns;
+    }
+    free(workers);
+    return worst;
+}
+
+static int compareU64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s ops threads\n", argv[0]);
+        return 2;
+    }
+    ops = atol(argv[1]);
+    int threads = atoi(argv[2]);
+
+    // Box-Muller over a fixed xorshift stream, so every run records the same values
+    samples = malloc(SAMPLES * sizeof(uint64_t));
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    for (int i = 0; i < SAMPLES; i++) {
+        double u[2];
+        for (int j = 0; j < 2; j++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            u[j] = ((state >> 11) + 1.0) / 9007199254740993.0;
+        }
+        double normal = sqrt(-2 * log(u[0])) * cos(2 * M_PI * u[1]);
+        samples[i] = (uint64_t)(20000 * exp(1.2 * normal));
+    }
+
+    double bareNs = loopNs(bare);
+    double counterNs = loopNs(count);
+    double gaugeNs = loopNs(gauge);
+    double histogramNs = loopNs(record);
+    double contendedCounterNs = contendedNs(count, threads);
+    double contendedHistogramNs = contendedNs(record, threads);
+
+    // Accuracy: a fresh histogram holding exactly one pass over the samples
+    ASMetric *accuracy = ASMetricsRegister("bench.accuracyUs", ASMetricHistogram, "us");
+    for (int i = 0; i < SAMPLES; i++) ASMetricRecord(accuracy, samples[i]);
+    static ASMetricsHistogramSnapshot snapshot;
+    ASMetricsHistogramRead(accuracy, &snapshot);
+    qsort(samples, SAMPLES, sizeof(uint64_t), compareU64);
+    const double fractions[] = { 0.5, 0.9, 0.99, 0.999 };
+    double worstError = 0;
+    printf("{\"percentiles\":[");
+    for (int i = 0; i < 4; i++) {
+        uint64_t exact = samples[(size_t)(fractions[i] * SAMPLES)];
+        uint64_t reported = ASMetricsPercentile(&snapshot, fractions[i]);
+        double error = fabs((double)reported - (double)exact) / (double)exact;
+        if (error > worstError) worstError = error;
+        printf("%s{\"fraction\":%g,\"exact\":%llu,\"reported\":%llu}", i ? "," : "", fractions[i],
+               (unsigned long long)exact, (unsigned long long)reported);
+    }
+
+    // getMetrics(): every histogram's buckets copied, percentiles walked
+    uint64_t readStart = threadNanos();
+    int metrics = atomic_load(&ASMetricsCount);
+    for (int run = 0; run < 100; run++) {
+        for (int i = 0; i < metrics; i++) {
+            if (ASMetricsRegistry[i].kind != ASMetricHistogram) continue;
+            ASMetricsHistogramRead(&ASMetricsRegistry[i], &snapshot);
+            for (int f = 0; f < 4; f++) sink += ASMetricsPercentile(&snapshot, fractions[f]);
+        }
+    }
+    double snapshotUs = (double)(threadNanos() - readStart) / 100 / 1000;
+
+    int histograms = 0;
+    for (int i = 0; i < metrics; i++) histograms += ASMetricsRegistry[i].kind == ASMetricHistogram;
+    printf("],\"ops\":%ld,\"threads\":%d,\"buckets\":%d,\"histogramBytes\":%zu,\"metrics\":%d,\"histograms\":%d,"
+           "\"bareNs\":%.2f,\"counterNs\":%.2f,\"gaugeNs\":%.2f,\"histogramNs\":%.2f,"
+           "\"contendedCounterNs\":%.2f,\"contendedHistogramNs\":%.2f,\"worstPercentileError\":%.4f,\"snapshotUs\":%.1f,"
+           "\"events\":%llu,\"expectedEvents\":%llu}\n",
+           ops, threads, AS_METRICS_BUCKETS, AS_METRICS_BUCKETS * sizeof(uint64_t), metrics, histograms,
+           bareNs, counterNs, gaugeNs, histogramNs, contendedCounterNs, contendedHistogramNs, worstError, snapshotUs,
+           (unsigned long long)atomic_load(&AS_METRIC("bench.events", ASMetricCounter, NULL)->count),
+           (unsigned long long)ops * (RUNS + threads));
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,400 @@
+// Local ElevenLabs + OpenAI stand-in
+// Speaks the two APIs the processing pipeline calls, so the whole upload path
+// can be load-tested offline: point ELEVENLABS_API_URL and
+// OPENAI_RESPONSES_API_URL in .env at it (the app reads them through @env), or
+// hand the URLs from `urls()` to a benchmark.
+//
+//   POST /v1/speech-to-text  ElevenLabs speech-to-text. Takes the multipart body
+//     BackgroundTransferManager builds (form fields, then the file part last)
+//     and checks its framing: a malformed body gets a 400. The reply is a
+//     transcript sized like the lesson (WORDS_PER_MINUTE of the audio's length,
+//     taken from the file size at the recorder's bitrate): text, then word and
+//     spacing entries with timings and two speakers, like scribe_v1 with
+//     diarize. It is generated from a hash of the audio, so the same file always
+//     gets the same transcript.
+//   POST /v1/responses  OpenAI Responses API, read the way
+//     BackgroundTransferService reads it (output[0].content[0].text). How long a
+//     reply is depends on the request: a title is a few tokens, a summary is a
+//     fraction of its transcript, and merging part summaries keeps most of them.
+//     Inputs past the context window get a 400 like the real API, and outputs
+//     past max output tokens come back truncated (status "incomplete"). Bodies
+//     sent with Content-Encoding: gzip are inflated.
+//
+// Latency is modelled, not fixed: transcription takes a base time plus a
+// fraction of the audio's duration; a response takes time to first token,
+// prefill of the input, then decoding of the output at a steady rate. Requests
+// run concurrently, as they do on the services. Token counts are a plain
+// 4-characters-per-token rule, independent of the app's own estimate.
+// Network: uploads share an uplink of `uploadKBps` (0 = unlimited), replies a
+// downlink of `downloadKBps`. Faults: `errorRate` answers that fraction of
+// requests with one of `errorStatuses` (429s carry Retry-After), `dropRate`
+// resets the connection once the body is in, and failNext() queues faults for
+// the next requests; the fault sequence is seeded, so runs repeat.
+// Requests without the API key header are refused (401).
+// `timeScale` shrinks every delay so benchmarks run in seconds; stats are kept
+// in unscaled (modelled) milliseconds, and each reply's modelled time is in its
+// X-Modelled-Ms header.
+// Run standalone with: node scripts/mockAIServer.js [port] [timeScale]
+
+const crypto = require('crypto');
+const http = require('http');
+const zlib = require('zlib');
+
+const CHARS_PER_TOKEN = 4;
+const WORDS_PER_MINUTE = 150;
+const AUDIO_BYTES_PER_SECOND = 128000 / 8; // AudioRecorderModule's AAC bitrate
+const MULTIPART_HEAD_LIMIT = 64 * 1024; // form fields + the file part's headers
+
+const VOCABULARY = ['the', 'bow', 'string', 'lighter', 'here', 'again', 'from', 'bar', 'twelve', 'slower',
+  'listen', 'intonation', 'shift', 'third', 'position', 'vibrato', 'relax', 'thumb', 'good', 'phrase',
+  'crescendo', 'down-bow', 'keep', 'contact', 'point', 'closer', 'bridge', 'try', 'that', 'once',
+  'you', 'and', 'it', 'to', 'a', 'is', 'so', 'when', 'your', 'sound', 'Kreutzer', 'détaché', 'fingerboard'];
+
+const countTokens = text => Math.ceil((text || '').length / CHARS_PER_TOKEN);
+
+const makeRandom = (seed) => () => {
+  seed = (seed + 0x6d2b79f5) | 0;
+  let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+  t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+  return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+};
+
+// A Markdown summary of about `tokens` tokens (one token per word), in a code block like the model's
+const summaryText = (tokens, seed) => {
+  const lines = ['```markdown', `# Lesson ${seed}`];
+  let written = 0;
+  for (let section = 1; written < tokens; section++) {
+    lines.push('', `## Section ${section}`, '');
+    for (let bullet = 0; bullet < 4 && written < tokens; bullet++) {
+      const words = Math.min(30, tokens - written);
+      lines.push(`- ${Array.from({ length: words }, (_, i) => (i === 0 ? 'Keep' : 'bow')).join(' ')}`);
+      written += words;
+    }
+  }
+  lines.push('```');
+  return lines.join('\n');
+};
+
+// scribe_v1-shaped transcript of `seconds` of speech: sentences of 6-20 words, the
+// speaker changing every 1-6 sentences with a pause between turns
+const transcriptFor = (seconds, seed) => {
+  const random = makeRandom(seed);
+  const secondsPerWord = 60 / WORDS_PER_MINUTE;
+  const words = [];
+  const parts = [];
+  let speaker = 0;
+  let sentencesLeft = 1;
+  let at = 0;
+  while (at + secondsPerWord <= seconds || words.length === 0) {
+    const length = 6 + Math.floor(random() * 15);
+    for (let i = 0; i < length; i++) {
+      let text = VOCABULARY[Math.floor(random() * VOCABULARY.length)];
+      if (i === 0) text = text[0].toUpperCase() + text.slice(1);
+      if (i === length - 1) text += random() < 0.8 ? '.' : '?';
+      else if (random() < 0.08) text += ',';
+      if (words.length > 0) {
+        words.push({ text: ' ', type: 'spacing', start: at - secondsPerWord * 0.2, end: at, speaker_id: `speaker_${speaker}` });
+      }
+      const start = Number(at.toFixed(3));
+      words.push({ text, type: 'word', start, end: Number((at + secondsPerWord * 0.8).toFixed(3)), speaker_id: `speaker_${speaker}` });
+      parts.push(text);
+      at += secondsPerWord;
+    }
+    if (--sentencesLeft === 0) {
+      speaker = 1 - speaker;
+      sentencesLeft = 1 + Math.floor(random() * 6);
+      at += 2;
+    }
+  }
+  return { language_code: 'eng', language_probability: 0.98, text: parts.join(' '), words };
+};
+
+const createMockAIServer = ({
+  // ElevenLabs
+  transcribeBaseMs = 1500,
+  transcribeRealtimeFactor = 0.015, // processing seconds per second of audio
+  // OpenAI
+  ttftMs = 600,
+  prefillTokensPerSec = 4000,
+  decodeTokensPerSec = 70,
+  contextTokens = 128000,
+  maxOutputTokens = 16384,
+  summaryRatio = 0.12, // summary tokens per transcript token
+  mergeRatio = 0.8, // merged summary tokens per part-summary token
+  // Network and faults
+  uploadKBps = 0,
+  downloadKBps = 0,
+  errorRate = 0,
+  errorStatuses = [500, 503, 429],
+  dropRate = 0,
+  seed = 47,
+  timeScale = 1,
+} = {}) => {
+  const stats = {
+    requests: 0,
+    transcriptions: 0,
+    responses: 0,
+    uploadBytes: 0,
+    downloadBytes: 0,
+    audioSeconds: 0,
+    inputTokens: 0,
+    outputTokens: 0,
+    modelledMs: 0,
+    peakConcurrent: 0,
+    truncated: 0,
+    rejected: 0,
+    malformed: 0,
+    unauthorized: 0,
+    injectedErrors: 0,
+    dropped: 0,
+  };
+  const faultRandom = makeRandom(seed);
+  const queuedFaults = [];
+  let active = 0;
+  let nextId = 1;
+  let uplinkFreeAt = 0;
+  let downlinkFreeAt = 0;
+
+  const outputTokensFor = (instructions, inputTokens) => {
+    if (/output ONE concise line/.test(instructions)) return 12;
+    if (/Merge the part summaries/.test(instructions)) return Math.round(inputTokens * mergeRatio);
+    return Math.round(300 + inputTokens * summaryRatio);
+  };
+
+  const respondToResponses = (body) => {
+    const request = JSON.parse(body);
+    const inputTokens = countTokens(request.instructions) + countTokens(request.input);
+    if (inputTokens > contextTokens) {
+      stats.rejected++;
+      return {
+        status: 400,
+        modelledMs: ttftMs,
+        body: { error: { type: 'invalid_request_error', code: 'context_length_exceeded', message: `Input of ${inputTokens} tokens exceeds the context window of ${contextTokens}` } },
+      };
+    }
+    const wanted = outputTokensFor(request.instructions || '', countTokens(request.input));
+    const outputTokens = Math.min(wanted, maxOutputTokens);
+    if (wanted > maxOutputTokens) stats.truncated++;
+    stats.inputTokens += inputTokens;
+    stats.outputTokens += outputTokens;
+
+    const id = nextId++;
+    const text = /output ONE concise line/.test(request.instructions || '') ? 'Kreutzer 23, Bach sarabande' : summaryText(outputTokens, id);
+    return {
+      status: 200,
+      modelledMs: ttftMs + (inputTokens / prefillTokensPerSec) * 1000 + (outputTokens / decodeTokensPerSec) * 1000,
+      body: {
+        id: `resp_${id}`,
+        object: 'response',
+        status: wanted > maxOutputTokens ? 'incomplete' : 'completed',
+        ...(wanted > maxOutputTokens ? { incomplete_details: { reason: 'max_output_tokens' } } : {}),
+        model: request.model,
+        output: [{ type: 'message', role: 'assistant', content: [{ type: 'output_text', text }] }],
+        usage: { input_tokens: inputTokens, output_tokens: outputTokens },
+      },
+    };
+  };
+
+  // Form fields, then the file part, then the closing boundary: as the native module writes it
+  const respondToSpeechToText = ({ head, tail, fileBytes, digest }, boundary) => {
+    const malformed = message => ({ status: 400, modelledMs: 0, body: { detail: { status: 'invalid_request', message } } });
+    if (!boundary) return malformed('Expected multipart/form-data with a boundary');
+    const headText = head.toString('latin1');
+    const fields = {};
+    const fieldPattern = new RegExp(`--${boundary}\\r\\nContent-Disposition: form-data; name="([^"]+)"\\r\\n\\r\\n([^\\r]*)\\r\\n`, 'g');
+    for (let match; (match = fieldPattern.exec(headText));) fields[match[1]] = match[2];
+    if (!/Content-Disposition: form-data; name="file"; filename="[^"]+"\r\nContent-Type: audio\/[\w-]+\r\n\r\n$/.test(headText)) {
+      return malformed('The file part must come last, with a filename and an audio content type');
+    }
+    if (tail.toString('latin1') !== `\r\n--${boundary}--\r\n`) return malformed('Body does not end with the closing boundary');
+    if (!fields.model_id) return malformed('model_id is required');
+
+    const seconds = fileBytes / AUDIO_BYTES_PER_SECOND;
+    stats.audioSeconds += seconds;
+    return {
+      status: 200,
+      modelledMs: transcribeBaseMs + seconds * 1000 * transcribeRealtimeFactor,
+      body: transcriptFor(seconds, digest.readInt32LE(0)),
+    };
+  };
+
+  // Reads the body as it arrives: whole for JSON, framing + a running hash for multipart audio
+  const readBody = (req, multipart, done) => {
+    const chunks = [];
+    const hash = crypto.createHash('sha1');
+    let head = null;
+    let pending = Buffer.alloc(0);
+    let fileBytes = 0;
+    let tail = Buffer.alloc(0);
+    req.on('data', (chunk) => {
+      stats.uploadBytes += chunk.length;
+      if (uploadKBps > 0) {
+        // One shared uplink: each chunk waits for the ones before it
+        const now = Date.now();
+        uplinkFreeAt = Math.max(uplinkFreeAt, now) + (chunk.length / (uploadKBps * 1024)) * 1000 * timeScale;
+        if (uplinkFreeAt - now > 2) {
+          req.pause();
+          setTimeout(() => req.resume(), uplinkFreeAt - now);
+        }
+      }
+      if (!multipart) {
+        chunks.push(chunk);
+        return;
+      }
+      if (!head) {
+        pending = Buffer.concat([pending, chunk]);
+        const fileStart = pending.indexOf('filename=');
+        const headEnd = fileStart >= 0 ? pending.indexOf('\r\n\r\n', fileStart) : -1;
+        if (headEnd < 0) {
+          if (pending.length > MULTIPART_HEAD_LIMIT) head = pending; // never found; fails the framing check
+          return;
+        }
+        head = pending.subarray(0, headEnd + 4);
+        chunk = pending.subarray(headEnd + 4);
+      }
+      // The closing boundary is the last few bytes; everything before it is the file
+      const joined = Buffer.concat([tail, chunk]);
+      const keep = Math.min(joined.length, 128);
+      hash.update(joined.subarray(0, joined.length - keep));
+      fileBytes += joined.length - keep;
+      tail = joined.subarray(joined.length - keep);
+    });
+    req.on('end', () => {
+      if (!multipart) {
+        done(Buffer.concat(chunks));
+        return;
+      }
+      // Split the kept bytes into the end of the file and the closing boundary
+      const close = tail.lastIndexOf('\r\n--');
+      const fileEnd = close >= 0 ? close : tail.length;
+      hash.update(tail.subarray(0, fileEnd));
+      done({ head: head || pending, tail: tail.subarray(fileEnd), fileBytes: fileBytes + fileEnd, digest: hash.digest() });
+    });
+  };
+
+  const nextFault = () => {
+    if (queuedFaults.length) return queuedFaults.shift();
+    const roll = faultRandom();
+    if (roll < dropRate) return 'drop';
+    if (roll < dropRate + errorRate) return errorStatuses[Math.floor(faultRandom() * errorStatuses.length)];
+    return null;
+  };
+
+  const faultResponse = (status, route) => {
+    stats.injectedErrors++;
+    const message = status === 429 ? 'Rate limit reached' : 'The server had an error while processing your request';
+    return {
+      status,
+      modelledMs: 200,
+      headers: status === 429 ? { 'Retry-After': '1' } : {},
+      body: route === 'speech-to-text' ? { detail: { status: 'server_error', message } } : { error: { type: 'server_error', message } },
+    };
+  };
+
+  const send = (res, result) => {
+    const payload = JSON.stringify(result.body);
+    let delayMs = result.modelledMs;
+    if (downloadKBps > 0) {
+      const transferMs = (Buffer.byteLength(payload) / (downloadKBps * 1024)) * 1000;
+      const now = Date.now() / timeScale;
+      downlinkFreeAt = Math.max(downlinkFreeAt, now + delayMs) + transferMs;
+      delayMs = downlinkFreeAt - now;
+    }
+    active++;
+    stats.peakConcurrent = Math.max(stats.peakConcurrent, active);
+    stats.modelledMs += delayMs;
+    setTimeout(() => {
+      active--;
+      stats.downloadBytes += Buffer.byteLength(payload);
+      res.writeHead(result.status, { 'Content-Type': 'application/json', 'X-Modelled-Ms': Math.round(delayMs), ...(result.headers || {}) });
+      res.end(payload);
+    }, delayMs * timeScale);
+  };
+
+  const server = http.createServer((req, res) => {
+    const route = req.method === 'POST' && /^\/v1\/(speech-to-text|responses)(\?|$)/.exec(req.url)?.[1];
+    const contentType = req.headers['content-type'] || '';
+    const boundary = /^multipart\/form-data;\s*boundary=(.+)$/.exec(contentType)?.[1];
+    readBody(req, route === 'speech-to-text' && Boolean(boundary), (body) => {
+      stats.requests++;
+      if (!route) {
+        send(res, { status: 404, modelledMs: 0, body: { error: { message: `No route for ${req.method} ${req.url}` } } });
+        return;
+      }
+      const authorized = route === 'speech-to-text' ? Boolean(req.headers['xi-api-key']) : /^Bearer \S+/.test(req.headers.authorization || '');
+      if (!authorized) {
+        stats.unauthorized++;
+        send(res, { status: 401, modelledMs: 0, body: { error: { message: 'Missing API key' } } });
+        return;
+      }
+      const fault = nextFault();
+      if (fault === 'drop') {
+        stats.dropped++;
+        req.socket.destroy();
+        return;
+      }
+      if (fault) {
+        send(res, faultResponse(fault, route));
+        return;
+      }
+
+      let result;
+      try {
+        if (route === 'speech-to-text') {
+          stats.transcriptions++;
+          result = respondToSpeechToText(Buffer.isBuffer(body) ? { head: body, tail: Buffer.alloc(0), fileBytes: 0 } : body, boundary);
+        } else {
+          stats.responses++;
+          const json = req.headers['content-encoding'] === 'gzip' ? zlib.gunzipSync(body) : body;
+          result = respondToResponses(json.toString('utf8'));
+        }
+      } catch (error) {
+        result = { status: 400, modelledMs: 0, body: { error: { message: error.message } } };
+      }
+      if (result.status === 400 && route === 'speech-to-text') stats.malformed++;
+      send(res, result);
+    });
+  });
+
+  let origin = null;
+  return {
+    stats,
+    timeScale,
+    resetStats() {
+      Object.keys(stats).forEach(key => { stats[key] = 0; });
+    },
+    // Fault for each of the next requests: an HTTP status, or 'drop' to reset the connection
+    failNext(...faults) {
+      queuedFaults.push(...faults);
+    },
+    // The endpoint URLs to use in place of the real ones
+    urls() {
+      return {
+        ELEVENLABS_API_URL: `${origin}/v1/speech-to-text`,
+        OPENAI_RESPONSES_API_URL: `${origin}/v1/responses`,
+      };
+    },
+    listen(port = 0, host = '127.0.0.1') {
+      return new Promise(resolve => server.listen(port, host, () => {
+        origin = `http://${host}:${server.address().port}`;
+        resolve(server.address().port);
+      }));
+    },
+    close() {
+      return new Promise(resolve => server.close(resolve));
+    },
+  };
+};
+
+module.exports = { createMockAIServer, countTokens, transcriptFor, AUDIO_BYTES_PER_SECOND };
+
+if (require.main === module) {
+  const port = parseInt(process.argv[2], 10) || 8788;
+  const timeScale = parseFloat(process.argv[3]) || 1;
+  // 0.0.0.0 so a device on the same network can reach it (set the LAN address in .env)
+  const mock = createMockAIServer({ timeScale });
+  mock.listen(port, '0.0.0.0').then(() => {
+    const { ELEVENLABS_API_URL, OPENAI_RESPONSES_API_URL } = mock.urls();
+    console.log(`Mock AI APIs (time scale ${timeScale}):\n  ELEVENLABS_API_URL=${ELEVENLABS_API_URL}\n  OPENAI_RESPONSES_API_URL=${OPENAI_RESPONSES_API_URL}`);
+  });
+}
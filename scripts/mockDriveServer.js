@@ -0,0 +1,328 @@
+// Local Google Drive stand-in
+// Implements the slice of the Drive v3 API that GoogleDriveService uses (file
+// search/create/get/patch/delete, permissions, multipart uploads and the
+// multipart/mixed batch endpoint) against an in-memory file tree, with a fixed
+// per-request latency to model mobile round-trips. Every HTTP request is
+// counted so benchmarks can report round-trips. Files carry ETags (If-None-Match
+// gets a 304) and every write is logged for changes.list / startPageToken.
+// setOffline(true) drops every connection to simulate losing the network.
+//
+// Upload bodies can also be throttled: active uploads share `bandwidthKBps`
+// equally, each is capped at `perConnectionKBps` (one TCP flow rarely fills a
+// link), and every upload beyond `congestionThreshold` wastes 10% of the link to
+// model loss and retransmits when the client opens too many connections.
+// Run standalone with: node scripts/mockDriveServer.js [port] [latencyMs]
+
+const http = require('http');
+
+const FOLDER_MIME_TYPE = 'application/vnd.google-apps.folder';
+
+const THROTTLE_TICK_MS = 10;
+
+const createMockDriveServer = ({
+  latencyMs = 40,
+  bandwidthKBps = 0,
+  perConnectionKBps = 0,
+  congestionThreshold = Infinity,
+} = {}) => {
+  const files = new Map();
+  let nextId = 1;
+  const stats = {
+    httpRequests: 0,
+    batchRequests: 0,
+    batchParts: 0,
+    uploads: 0,
+    uploadBytes: 0,
+    peakConcurrentUploads: 0,
+    notModified: 0,
+    changesPolls: 0,
+    refused: 0,
+  };
+  let offline = false;
+  const changeLog = []; // file IDs in the order they were written; page tokens index into it
+
+  const etagOf = (file) => `"${file.id}-v${file.version}"`;
+
+  // Bump the file's version (new ETag) and add it to the changes feed
+  const recordChange = (file) => {
+    file.version = (file.version || 0) + 1;
+    changeLog.push(file.id);
+  };
+
+  const json = (status, body) => ({ status, body: body === null ? '' : JSON.stringify(body) });
+
+  // Supports the query shapes the app sends: name='x', 'parent' in parents, mimeType='y', trashed=false
+  const search = (q) => {
+    const name = /name='([^']*)'/.exec(q);
+    const parent = /'([^']+)' in parents/.exec(q);
+    const mime = /mimeType\s*=\s*'([^']*)'/.exec(q);
+    return [...files.values()].filter(file =>
+      !file.trashed &&
+      (!name || file.name === name[1]) &&
+      (!parent || (file.parents || []).includes(parent[1])) &&
+      (!mime || file.mimeType === mime[1]));
+  };
+
+  const createFile = (metadata, size = 0) => {
+    const file = {
+      id: `mock${nextId++}`,
+      name: metadata.name,
+      mimeType: metadata.mimeType || 'application/octet-stream',
+      parents: metadata.parents || [],
+      size,
+      trashed: false,
+      createdTime: new Date().toISOString(),
+    };
+    files.set(file.id, file);
+    recordChange(file);
+    return file;
+  };
+
+  // Changes since `pageToken`, one entry per file, paged by pageSize
+  const listChanges = (pageToken, pageSize) => {
+    stats.changesPolls++;
+    const start = parseInt(pageToken, 10) || 0;
+    const end = Math.min(changeLog.length, start + pageSize);
+    const fileIds = [...new Set(changeLog.slice(start, end))];
+    const changes = fileIds.map((fileId) => {
+      const file = files.get(fileId);
+      return file ? { fileId, removed: false, file } : { fileId, removed: true };
+    });
+    return end < changeLog.length
+      ? { changes, nextPageToken: String(end) }
+      : { changes, newStartPageToken: String(end) };
+  };
+
+  // Dispatch one Drive v3 call; `path` starts at /drive/v3
+  const handleApi = (method, path, rawBody, headers = {}) => {
+    const url = new URL(path, 'http://mock');
+    const route = url.pathname.replace(/^\/drive\/v3/, '');
+    const body = rawBody ? JSON.parse(rawBody) : {};
+
+    if (route === '/files' && method === 'GET') {
+      return json(200, { files: search(url.searchParams.get('q') || '') });
+    }
+    if (route === '/files' && method === 'POST') {
+      return json(200, createFile(body));
+    }
+    if (route === '/changes/startPageToken') {
+      return json(200, { startPageToken: String(changeLog.length) });
+    }
+    if (route === '/changes') {
+      return json(200, listChanges(url.searchParams.get('pageToken'), parseInt(url.searchParams.get('pageSize'), 10) || 100));
+    }
+
+    const permissionMatch = /^\/files\/([^/]+)\/permissions$/.exec(route);
+    if (permissionMatch && method === 'POST') {
+      return files.has(permissionMatch[1]) ? json(200, { id: 'anyoneWithLink', ...body }) : json(404, { error: 'notFound' });
+    }
+
+    const fileMatch = /^\/files\/([^/]+)$/.exec(route);
+    if (fileMatch) {
+      const file = files.get(fileMatch[1]);
+      if (!file) return json(404, { error: { code: 404, message: 'File not found' } });
+
+      if (method === 'GET') {
+        if (headers['if-none-match'] === etagOf(file)) {
+          stats.notModified++;
+          return { status: 304, body: '', etag: etagOf(file) };
+        }
+        const result = json(200, { ...file, webViewLink: `https://drive.mock/${file.id}/view`, webContentLink: `https://drive.mock/${file.id}` });
+        return { ...result, etag: etagOf(file) };
+      }
+      if (method === 'DELETE') {
+        files.delete(file.id);
+        changeLog.push(file.id);
+        return json(204, null);
+      }
+      if (method === 'PATCH') {
+        const add = url.searchParams.get('addParents');
+        const remove = url.searchParams.get('removeParents');
+        if (remove) file.parents = file.parents.filter(id => !remove.split(',').includes(id));
+        if (add) file.parents = [...new Set([...file.parents, ...add.split(',')])];
+        Object.assign(file, body);
+        recordChange(file);
+        return json(200, file);
+      }
+    }
+
+    if (route === '/about') {
+      return json(200, { user: { emailAddress: 'bench@example.com' }, storageQuota: { limit: '0', usage: '0' } });
+    }
+    return json(404, { error: `No mock route for ${method} ${route}` });
+  };
+
+  // Multipart create (POST) or media-only content update (PATCH /files/:id)
+  const handleUpload = (method, url, headers, rawBody) => {
+    stats.uploads++;
+    stats.uploadBytes += rawBody.length;
+
+    const updateMatch = /^\/upload\/drive\/v3\/files\/([^/?]+)/.exec(url);
+    if (method === 'PATCH' && updateMatch) {
+      const file = files.get(updateMatch[1]);
+      if (!file) return json(404, { error: { code: 404, message: 'File not found' } });
+      file.size = rawBody.length;
+      recordChange(file);
+      return json(200, file);
+    }
+
+    const boundary = /boundary="?([^";]+)"?/.exec(headers['content-type'] || '');
+    let metadata = {};
+    let size = rawBody.length;
+    if (boundary) {
+      const [, metadataPart = '', mediaPart = ''] = rawBody.split(`--${boundary[1]}`);
+      const jsonStart = metadataPart.indexOf('{');
+      metadata = JSON.parse(metadataPart.slice(jsonStart, metadataPart.lastIndexOf('}') + 1));
+      // Media part: headers, blank line, content, trailing CRLF
+      const contentStart = mediaPart.indexOf('\r\n\r\n');
+      size = contentStart === -1 ? 0 : Buffer.byteLength(mediaPart.slice(contentStart + 4, -2), 'latin1');
+    }
+    return json(200, createFile(metadata, size));
+  };
+
+  const handleBatch = (headers, rawBody) => {
+    const boundary = /boundary="?([^";]+)"?/.exec(headers['content-type'] || '')[1];
+    const responseBoundary = `batch_mock_${Date.now()}`;
+    let out = '';
+
+    for (const part of rawBody.split(`--${boundary}`)) {
+      const idMatch = /Content-ID:\s*<([^>]+)>/i.exec(part);
+      const requestLine = /^(GET|POST|PATCH|PUT|DELETE) (\S+) HTTP\/1\.1/m.exec(part);
+      if (!idMatch || !requestLine) continue;
+
+      const afterLine = part.slice(requestLine.index + requestLine[0].length);
+      const bodyStart = afterLine.search(/\r\n\r\n/);
+      const body = bodyStart === -1 ? '' : afterLine.slice(bodyStart + 4).trim();
+      const partHeaders = {};
+      (bodyStart === -1 ? afterLine : afterLine.slice(0, bodyStart)).split('\r\n').forEach((line) => {
+        const colon = line.indexOf(':');
+        if (colon > 0) partHeaders[line.slice(0, colon).trim().toLowerCase()] = line.slice(colon + 1).trim();
+      });
+      const result = handleApi(requestLine[1], requestLine[2], body, partHeaders);
+      stats.batchParts++;
+
+      out += `--${responseBoundary}\r\n`;
+      out += 'Content-Type: application/http\r\n';
+      out += `Content-ID: <response-${idMatch[1]}>\r\n\r\n`;
+      out += `HTTP/1.1 ${result.status} ${result.status < 300 ? 'OK' : result.status === 304 ? 'Not Modified' : 'Error'}\r\n`;
+      if (result.etag) out += `ETag: ${result.etag}\r\n`;
+      out += 'Content-Type: application/json; charset=UTF-8\r\n\r\n';
+      out += `${result.body}\r\n`;
+    }
+    out += `--${responseBoundary}--\r\n`;
+    stats.batchRequests++;
+    return { status: 200, body: out, contentType: `multipart/mixed; boundary=${responseBoundary}` };
+  };
+
+  // Uploads in flight on the throttled link: { remaining, done }
+  const transfers = new Set();
+  let throttleTimer = null;
+
+  const tickThrottle = () => {
+    const active = transfers.size;
+    const overload = Math.max(0, active - congestionThreshold);
+    const efficiency = Math.max(0.3, 1 - 0.1 * overload);
+    const linkShare = bandwidthKBps ? (bandwidthKBps * 1024 * efficiency) / active : Infinity;
+    const perFlow = Math.min(linkShare, perConnectionKBps ? perConnectionKBps * 1024 : Infinity);
+    const budget = perFlow * (THROTTLE_TICK_MS / 1000);
+
+    for (const transfer of transfers) {
+      transfer.remaining -= budget;
+      if (transfer.remaining <= 0) {
+        transfers.delete(transfer);
+        transfer.done();
+      }
+    }
+    if (transfers.size === 0) {
+      clearInterval(throttleTimer);
+      throttleTimer = null;
+    }
+  };
+
+  const throttleUpload = (bytes) => new Promise(resolve => {
+    if (!bandwidthKBps && !perConnectionKBps) {
+      resolve();
+      return;
+    }
+    transfers.add({ remaining: bytes, done: resolve });
+    stats.peakConcurrentUploads = Math.max(stats.peakConcurrentUploads, transfers.size);
+    if (!throttleTimer) {
+      throttleTimer = setInterval(tickThrottle, THROTTLE_TICK_MS);
+    }
+  });
+
+  const server = http.createServer((req, res) => {
+    if (offline) {
+      // Drop the connection the way a dead network does; fetch rejects with a TypeError
+      stats.refused++;
+      req.socket.destroy();
+      return;
+    }
+    const chunks = [];
+    req.on('data', chunk => chunks.push(chunk));
+    req.on('end', async () => {
+      stats.httpRequests++;
+      // latin1 keeps one character per byte so upload sizes match the file sizes
+      const rawBody = Buffer.concat(chunks).toString('latin1');
+      if (req.url.startsWith('/upload/drive/v3')) {
+        await throttleUpload(rawBody.length);
+      }
+      let result;
+      try {
+        if (req.url.startsWith('/batch/drive/v3')) {
+          result = handleBatch(req.headers, rawBody);
+        } else if (req.url.startsWith('/upload/drive/v3')) {
+          result = handleUpload(req.method, req.url, req.headers, rawBody);
+        } else {
+          result = handleApi(req.method, req.url, rawBody, req.headers);
+        }
+      } catch (error) {
+        result = json(500, { error: error.message });
+      }
+      setTimeout(() => {
+        res.writeHead(result.status, {
+          'Content-Type': result.contentType || 'application/json',
+          ...(result.etag ? { ETag: result.etag } : {}),
+        });
+        res.end(result.status === 204 || result.status === 304 ? undefined : result.body);
+      }, latencyMs);
+    });
+  });
+
+  return {
+    files,
+    stats,
+    // Simulate an edit made outside the app (another device, the Drive web UI)
+    modifyFile(fileId, changes) {
+      const file = files.get(fileId);
+      Object.assign(file, changes);
+      recordChange(file);
+    },
+    reset() {
+      files.clear();
+      changeLog.length = 0;
+    },
+    setOffline(value) {
+      offline = value;
+    },
+    resetStats() {
+      Object.keys(stats).forEach(key => { stats[key] = 0; });
+    },
+    listen(port = 0) {
+      return new Promise(resolve => server.listen(port, '127.0.0.1', () => resolve(server.address().port)));
+    },
+    close() {
+      return new Promise(resolve => server.close(resolve));
+    },
+  };
+};
+
+module.exports = { createMockDriveServer, FOLDER_MIME_TYPE };
+
+if (require.main === module) {
+  const port = parseInt(process.argv[2], 10) || 8787;
+  const latencyMs = parseInt(process.argv[3], 10) || 40;
+  createMockDriveServer({ latencyMs }).listen(port).then(actualPort => {
+    console.log(`Mock Drive server on http://127.0.0.1:${actualPort} (${latencyMs} ms per request)`);
+  });
+}
@@ -0,0 +1,712 @@
+// End-to-end pipeline runner, built and driven by scripts/benchmarkPipeline.js.
+// Takes lessons from "tap record" to a summary with the app's native code on
+// the hot path, against the local AI stand-in (scripts/mockAIServer.js):
+//   capture    synthetic PCM pushed in tap-sized callbacks through
+//              ASCaptureRing.h; the writer thread's sink encodes it (a stand-in
+//              for AAC: 3:1 decimation to 8-bit mu-law, the same 16 kB/s as the
+//              app's 128 kbps) into segment files
+//   rollover   every segmentSeconds the segment ends and the next one starts
+//              with a new ring and writer, as ASRingCaptureRecorder does; the
+//              gap is the time no callback can be taken (engine restart aside)
+//   stop       the last segment's final drain and close (after "tap stop")
+//   merge      the segments joined into one file, every sample decoded and
+//              encoded again (a stand-in for the export session's transcode)
+//   multipart  the transcription body, built by ASUploadBody.h
+//   transcribe the body POSTed to /v1/speech-to-text
+//   parseTranscript, summaryBody, summarize, parseSummary
+//              the transcript text taken from the reply, the summary request
+//              written by ASJSONBody.h, POSTed to /v1/responses and its text
+//              taken out again
+// Capture runs as fast as the writer drains (the producer waits for room
+// instead of dropping), so it doubles as a throughput test of the encode path.
+// Every stage records wall time, CPU time (all threads) and bytes written
+// (write calls and storage, from /proc/self/io); callbacks, sink calls and
+// rollover gaps get latency histograms too. Replies carry their modelled server
+// time (X-Modelled-Ms); stopToSummaryUs is the local stages after capture plus
+// that time.
+// Prints one line of JSON.
+//
+// Usage: pipelineBench <workDir> <port> <runs> <lessonSeconds> <segmentSeconds>
+//                      <summaryPrefixPath> <gzip>
+
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#include "ASCaptureRing.h"
+#include "ASJSONBody.h"
+#include "ASUploadBody.h"
+
+// AudioRecorderModule's capture settings
+#define SAMPLE_RATE 48000
+#define CALLBACK_FRAMES 1024
+#define STALL_BUDGET_SECONDS 2.0
+#define WRITER_PERIOD_MICROS 20000
+#define DECIMATION 3 // 48 kHz -> 16 kB/s of 8-bit samples
+
+// --- Samples and histograms ---
+
+typedef struct {
+    double *values;
+    size_t count;
+    size_t capacity;
+} Samples;
+
+static void addSample(Samples *samples, double value) {
+    if (samples->count == samples->capacity) {
+        samples->capacity = samples->capacity ? samples->capacity * 2 : 256;
+        samples->values = realloc(samples->values, samples->capacity * sizeof(double));
+    }
+    samples->values[samples->count++] = value;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double left = *(const double *)a, right = *(const double *)b;
+    return left < right ? -1 : left > right;
+}
+
+static double percentile(Samples *samples, double fraction) {
+    if (samples->count == 0) return 0;
+    qsort(samples->values, samples->count, sizeof(double), compareDoubles);
+    size_t index = (size_t)(fraction * (samples->count - 1) + 0.5);
+    return samples->values[index];
+}
+
+static double mean(const Samples *samples) {
+    double sum = 0;
+    for (size_t i = 0; i < samples->count; i++) sum += samples->values[i];
+    return samples->count ? sum / samples->count : 0;
+}
+
+// Percentiles, then power-of-two buckets: [upper bound, count] for each non-empty one
+static void printHistogram(const char *name, Samples *samples, bool comma) {
+    printf("\"%s\":{\"count\":%zu,\"p50\":%.2f,\"p90\":%.2f,\"p99\":%.2f,\"max\":%.2f,\"buckets\":[",
+           name, samples->count, percentile(samples, 0.5), percentile(samples, 0.9), percentile(samples, 0.99),
+           percentile(samples, 1.0));
+    size_t index = 0;
+    bool first = true;
+    for (double bound = 1; index < samples->count; bound *= 2) {
+        size_t count = 0;
+        while (index < samples->count && samples->values[index] <= bound) {
+            index++;
+            count++;
+        }
+        if (count == 0) continue;
+        printf("%s[%.0f,%zu]", first ? "" : ",", bound, count);
+        first = false;
+    }
+    printf("]}%s", comma ? "," : "");
+}
+
+// --- Stage accounting ---
+
+typedef struct {
+    double wallUs;
+    double cpuUs;
+    uint64_t writeBytes;   // wchar: every write call, sockets included
+    uint64_t storageBytes; // write_bytes: what reached the block layer
+} Mark;
+
+typedef enum {
+    StageCapture, StageStop, StageMerge, StageMultipart, StageTranscribe,
+    StageParseTranscript, StageSummaryBody, StageSummarize, StageParseSummary, StageCount
+} Stage;
+
+static const char *StageNames[StageCount] = {
+    "capture", "stop", "merge", "multipart", "transcribe", "parseTranscript", "summaryBody", "summarize", "parseSummary",
+};
+
+typedef struct {
+    Samples wallUs;
+    Samples cpuUs;
+    Samples writeBytes;
+    Samples storageBytes;
+} StageStats;
+
+static double nowUs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+static uint64_t ioField(const char *text, const char *field) {
+    const char *at = strstr(text, field);
+    return at ? strtoull(at + strlen(field), NULL, 10) : 0;
+}
+
+static Mark mark(void) {
+    Mark result = { .wallUs = nowUs() };
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.cpuUs = usage.ru_utime.tv_sec * 1e6 + usage.ru_utime.tv_usec + usage.ru_stime.tv_sec * 1e6 + usage.ru_stime.tv_usec;
+    FILE *io = fopen("/proc/self/io", "r");
+    if (io) {
+        char text[512];
+        size_t length = fread(text, 1, sizeof(text) - 1, io);
+        text[length] = '\0';
+        fclose(io);
+        result.writeBytes = ioField(text, "wchar:");
+        result.storageBytes = ioField(text, "write_bytes:");
+    }
+    return result;
+}
+
+static void stageEnd(StageStats *stage, Mark start) {
+    Mark end = mark();
+    addSample(&stage->wallUs, end.wallUs - start.wallUs);
+    addSample(&stage->cpuUs, end.cpuUs - start.cpuUs);
+    addSample(&stage->writeBytes, (double)(end.writeBytes - start.writeBytes));
+    addSample(&stage->storageBytes, (double)(end.storageBytes - start.storageBytes));
+}
+
+// --- Encoder sink (writer thread) ---
+
+static uint8_t muLawEncode(int16_t sample) {
+    const int bias = 0x84, clip = 32635;
+    int sign = (sample >> 8) & 0x80;
+    int magnitude = sign ? -(int)sample : sample;
+    if (magnitude > clip) magnitude = clip;
+    magnitude += bias;
+    int exponent = 7;
+    for (int mask = 0x4000; (magnitude & mask) == 0 && exponent > 0; mask >>= 1) exponent--;
+    int mantissa = (magnitude >> (exponent + 3)) & 0x0f;
+    return (uint8_t)~(sign | (exponent << 4) | mantissa);
+}
+
+static int16_t muLawDecode(uint8_t byte) {
+    byte = (uint8_t)~byte;
+    int magnitude = ((((byte & 0x0f) << 3) + 0x84) << ((byte >> 4) & 0x07)) - 0x84;
+    return (int16_t)((byte & 0x80) ? -magnitude : magnitude);
+}
+
+typedef struct {
+    int fd;
+    float group;
+    int groupCount;
+    uint8_t encoded[CALLBACK_FRAMES * 4];
+    uint64_t bytes;
+    Samples sinkUs;
+} EncoderSink;
+
+static int encoderSink(void *context, const float *frames, size_t count) {
+    EncoderSink *sink = context;
+    double start = nowUs();
+    while (count > 0) {
+        size_t encoded = 0;
+        size_t take = count < sizeof(sink->encoded) * DECIMATION ? count : sizeof(sink->encoded) * DECIMATION;
+        for (size_t i = 0; i < take; i++) {
+            sink->group += frames[i];
+            if (++sink->groupCount == DECIMATION) {
+                float value = sink->group / DECIMATION;
+                value = value > 1 ? 1 : value < -1 ? -1 : value;
+                sink->encoded[encoded++] = muLawEncode((int16_t)(value * 32767));
+                sink->group = 0;
+                sink->groupCount = 0;
+            }
+        }
+        if (!ASUploadBodyWriteFully(sink->fd, sink->encoded, encoded)) return errno ? errno : EIO;
+        sink->bytes += encoded;
+        frames += take;
+        count -= take;
+    }
+    addSample(&sink->sinkUs, nowUs() - start);
+    return 0;
+}
+
+// Speech-like test signal: two partials under a syllable-rate envelope, plus noise
+typedef struct {
+    double phase;
+    double time;
+    uint32_t noise;
+} Synth;
+
+static void synthesize(Synth *synth, float *frames, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        double envelope = 0.5 + 0.5 * sin(2 * M_PI * 4.0 * synth->time);
+        synth->noise = synth->noise * 1664525u + 1013904223u;
+        double noise = ((synth->noise >> 8) / 16777216.0 - 0.5) * 0.02;
+        frames[i] = (float)(0.3 * envelope * (sin(synth->phase) + 0.4 * sin(2.7 * synth->phase)) + noise);
+        synth->phase += 2 * M_PI * 180.0 / SAMPLE_RATE;
+        if (synth->phase > 2 * M_PI * 1000) synth->phase -= 2 * M_PI * 1000;
+        synth->time += 1.0 / SAMPLE_RATE;
+    }
+}
+
+// --- HTTP ---
+
+typedef struct {
+    int status;
+    double sendUs;    // connect + headers + body
+    double ttfbUs;    // body sent -> first reply byte
+    double receiveUs; // first reply byte -> end
+    double modelledMs;
+    uint64_t requestBytes;
+    char *body;
+    size_t bodyLength;
+} HttpReply;
+
+static bool sendAll(int socketFd, const void *bytes, size_t length) {
+    const uint8_t *at = bytes;
+    while (length > 0) {
+        ssize_t sent = send(socketFd, at, length, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        at += sent;
+        length -= (size_t)sent;
+    }
+    return true;
+}
+
+// Chunked transfer coding, decoded in place
+static size_t dechunk(char *body, size_t length) {
+    size_t in = 0, out = 0;
+    while (in < length) {
+        char *end;
+        unsigned long size = strtoul(body + in, &end, 16);
+        char *lineEnd = memmem(body + in, length - in, "\r\n", 2);
+        if (!lineEnd || size == 0) break;
+        in = (size_t)(lineEnd - body) + 2;
+        if (in + size > length) size = length - in;
+        memmove(body + out, body + in, size);
+        out += size;
+        in += size + 2;
+    }
+    return out;
+}
+
+// POSTs the body file over a fresh connection and reads the whole reply
+static bool httpPost(int port, const char *path, const char *headers, int bodyFd, HttpReply *reply) {
+    memset(reply, 0, sizeof(*reply));
+    double start = nowUs();
+    struct stat info;
+    if (fstat(bodyFd, &info) != 0 || lseek(bodyFd, 0, SEEK_SET) != 0) return false;
+    int socketFd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = { .sin_family = AF_INET, .sin_port = htons((uint16_t)port) };
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (socketFd < 0 || connect(socketFd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        if (socketFd >= 0) close(socketFd);
+        return false;
+    }
+    char head[1024];
+    int headLength = snprintf(head, sizeof(head),
+                              "POST %s HTTP/1.1\r\nHost: 127.0.0.1:%d\r\n%sContent-Length: %lld\r\nConnection: close\r\n\r\n",
+                              path, port, headers, (long long)info.st_size);
+    bool ok = sendAll(socketFd, head, (size_t)headLength);
+    uint8_t *block = malloc(AS_UPLOAD_BLOCK_SIZE);
+    while (ok) {
+        ssize_t count = read(bodyFd, block, AS_UPLOAD_BLOCK_SIZE);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            ok = count == 0;
+            break;
+        }
+        ok = sendAll(socketFd, block, (size_t)count);
+    }
+    free(block);
+    reply->requestBytes = (uint64_t)headLength + (uint64_t)info.st_size;
+    double sent = nowUs();
+    reply->sendUs = sent - start;
+
+    size_t capacity = 64 * 1024, length = 0;
+    char *text = malloc(capacity + 1);
+    double firstByte = 0;
+    while (ok) {
+        if (length == capacity) {
+            capacity *= 2;
+            text = realloc(text, capacity + 1);
+        }
+        ssize_t count = recv(socketFd, text + length, capacity - length, 0);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) {
+            ok = count == 0 && length > 0;
+            break;
+        }
+        if (length == 0) firstByte = nowUs();
+        length += (size_t)count;
+    }
+    close(socketFd);
+    text[length] = '\0';
+    char *bodyStart = ok ? strstr(text, "\r\n\r\n") : NULL;
+    if (!bodyStart || sscanf(text, "HTTP/1.1 %d", &reply->status) != 1) {
+        free(text);
+        return false;
+    }
+    *bodyStart = '\0';
+    const char *modelled = strcasestr(text, "\r\nX-Modelled-Ms:");
+    if (modelled) reply->modelledMs = atof(modelled + strlen("\r\nX-Modelled-Ms:"));
+    bool chunked = strcasestr(text, "\r\nTransfer-Encoding: chunked") != NULL;
+    reply->ttfbUs = firstByte - sent;
+    reply->receiveUs = nowUs() - firstByte;
+    bodyStart += 4;
+    reply->bodyLength = length - (size_t)(bodyStart - text);
+    memmove(text, bodyStart, reply->bodyLength);
+    if (chunked) reply->bodyLength = dechunk(text, reply->bodyLength);
+    text[reply->bodyLength] = '\0';
+    reply->body = text;
+    return true;
+}
+
+// --- Reply parsing ---
+
+static size_t putUTF8(char *out, uint32_t code) {
+    if (code < 0x80) {
+        out[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char)(0xc0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3f));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char)(0xe0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3f));
+        out[2] = (char)(0x80 | (code & 0x3f));
+        return 3;
+    }
+    out[0] = (char)(0xf0 | (code >> 18));
+    out[1] = (char)(0x80 | ((code >> 12) & 0x3f));
+    out[2] = (char)(0x80 | ((code >> 6) & 0x3f));
+    out[3] = (char)(0x80 | (code & 0x3f));
+    return 4;
+}
+
+// The first string value of `key` in the reply, unescaped (malloc'd). Both
+// replies put the text the app reads first: the transcript's top-level "text"
+// comes before its words, and a response has no "text" outside its output.
+static char *jsonStringValue(const char *json, const char *key, size_t *length) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *at = strstr(json, pattern);
+    if (!at) return NULL;
+    at += strlen(pattern);
+    while (*at == ' ') at++;
+    if (*at++ != '"') return NULL;
+    const char *end = at;
+    while (*end && *end != '"') end += *end == '\\' && end[1] ? 2 : 1;
+    if (*end != '"') return NULL;
+    char *out = malloc((size_t)(end - at) + 1);
+    size_t written = 0;
+    while (at < end) {
+        if (*at != '\\') {
+            out[written++] = *at++;
+            continue;
+        }
+        char escape = at[1];
+        at += 2;
+        switch (escape) {
+            case 'n': out[written++] = '\n'; break;
+            case 't': out[written++] = '\t'; break;
+            case 'r': out[written++] = '\r'; break;
+            case 'b': out[written++] = '\b'; break;
+            case 'f': out[written++] = '\f'; break;
+            case 'u': {
+                uint32_t code = (uint32_t)strtoul((char[]){ at[0], at[1], at[2], at[3], 0 }, NULL, 16);
+                at += 4;
+                if (code >= 0xd800 && code < 0xdc00 && at[0] == '\\' && at[1] == 'u') {
+                    uint32_t low = (uint32_t)strtoul((char[]){ at[2], at[3], at[4], at[5], 0 }, NULL, 16);
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                    at += 6;
+                }
+                written += putUTF8(out + written, code);
+                break;
+            }
+            default: out[written++] = escape; break;
+        }
+    }
+    out[written] = '\0';
+    *length = written;
+    return out;
+}
+
+static char *readFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *bytes = malloc((size_t)size + 1);
+    *length = fread(bytes, 1, (size_t)size, file);
+    bytes[*length] = '\0';
+    fclose(file);
+    return bytes;
+}
+
+static bool writeFile(const char *path, const char *bytes, size_t length) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    bool ok = fd >= 0 && ASUploadBodyWriteFully(fd, (const uint8_t *)bytes, length);
+    if (fd >= 0) close(fd);
+    return ok;
+}
+
+static int fail(const char *what) {
+    fprintf(stderr, "pipelineBench: %s failed: %s\n", what, strerror(errno));
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 8) {
+        fprintf(stderr, "usage: %s workDir port runs lessonSeconds segmentSeconds summaryPrefixPath gzip\n", argv[0]);
+        return 2;
+    }
+    const char *workDir = argv[1];
+    int port = atoi(argv[2]);
+    int runs = atoi(argv[3]);
+    double lessonSeconds = atof(argv[4]);
+    double segmentSeconds = atof(argv[5]);
+    bool gzip = atoi(argv[7]) != 0;
+    size_t prefixLength = 0;
+    char *prefix = readFile(argv[6], &prefixLength);
+    if (!prefix) return fail("reading the summary prefix");
+
+    StageStats stages[StageCount] = {0};
+    Samples pushUs = {0}, rolloverGapUs = {0}, stopToSummaryUs = {0};
+    Samples transcribeModelledMs = {0}, summarizeModelledMs = {0}, transcribeRequestBytes = {0}, summarizeRequestBytes = {0};
+    EncoderSink sink = {0};
+    uint64_t lessonFrames = (uint64_t)(lessonSeconds * SAMPLE_RATE);
+    uint64_t segmentFrames = (uint64_t)(segmentSeconds * SAMPLE_RATE);
+    uint64_t pushedFrames = 0, droppedFrames = 0, highWaterFrames = 0, capacityFrames = 0, waits = 0, encodedBytes = 0;
+    uint64_t transcriptBytes = 0, summaryBytes = 0;
+    int segments = 0;
+    char path[4096], segmentPaths[64][4096];
+    float callback[CALLBACK_FRAMES];
+
+    for (int run = 0; run < runs; run++) {
+        Synth synth = { .noise = 48u + (uint32_t)run };
+
+        // Capture with rollover
+        Mark captureStart = mark();
+        Mark stopStart = captureStart;
+        double lastPush = 0;
+        segments = 0;
+        for (uint64_t captured = 0; captured < lessonFrames; segments++) {
+            if (segments == 64) {
+                errno = E2BIG;
+                return fail("capture (more than 64 segments)");
+            }
+            uint64_t frames = lessonFrames - captured < segmentFrames ? lessonFrames - captured : segmentFrames;
+            snprintf(segmentPaths[segments], sizeof(segmentPaths[segments]), "%s/segment-%d.m4a", workDir, segments);
+            ASCaptureRing ring;
+            ASCaptureWriter writer;
+            sink.fd = open(segmentPaths[segments], O_WRONLY | O_CREAT | O_TRUNC, 0600);
+            sink.group = 0;
+            sink.groupCount = 0;
+            if (sink.fd < 0) return fail("opening a segment");
+            if (!ASCaptureRingInit(&ring, ASCaptureRingCapacityForBudget(SAMPLE_RATE, STALL_BUDGET_SECONDS, CALLBACK_FRAMES))
+                || ASCaptureWriterStart(&writer, &ring, encoderSink, &sink, WRITER_PERIOD_MICROS) != 0) {
+                return fail("starting capture");
+            }
+            if (segments > 0) addSample(&rolloverGapUs, nowUs() - lastPush);
+
+            for (uint64_t pushed = 0; pushed < frames;) {
+                size_t count = frames - pushed < CALLBACK_FRAMES ? (size_t)(frames - pushed) : CALLBACK_FRAMES;
+                synthesize(&synth, callback, count);
+                // Faster than real time: wait for the writer instead of dropping
+                while (ring.capacity - (size_t)(atomic_load(&ring.writeIndex) - atomic_load(&ring.readIndex)) < count) {
+                    waits++;
+                    nanosleep(&(struct timespec){ 0, 1000000 }, NULL);
+                }
+                double start = nowUs();
+                ASCaptureRingPush(&ring, callback, count);
+                lastPush = nowUs();
+                addSample(&pushUs, lastPush - start);
+                pushed += count;
+            }
+            captured += frames;
+            if (captured == lessonFrames) {
+                stageEnd(&stages[StageCapture], captureStart);
+                stopStart = mark();
+            }
+            ASCaptureWriterStop(&writer);
+            ASCaptureStats stats = ASCaptureStatsRead(&ring, &writer);
+            if (close(sink.fd) != 0 || stats.sinkError != 0) return fail("writing a segment");
+            pushedFrames += stats.pushedFrames;
+            droppedFrames += stats.droppedFrames;
+            capacityFrames = stats.capacityFrames;
+            if (stats.highWaterFrames > highWaterFrames) highWaterFrames = stats.highWaterFrames;
+            ASCaptureRingDestroy(&ring);
+        }
+        stageEnd(&stages[StageStop], stopStart);
+        encodedBytes += sink.bytes;
+        sink.bytes = 0;
+
+        // Merge
+        Mark start = mark();
+        char mergedPath[4096];
+        snprintf(mergedPath, sizeof(mergedPath), "%s/merged.m4a", workDir);
+        int merged = open(mergedPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        if (merged < 0) return fail("opening the merged file");
+        off_t total = 0;
+        for (int i = 0; i < segments; i++) {
+            struct stat info;
+            if (stat(segmentPaths[i], &info) == 0) total += info.st_size;
+        }
+        ASUploadBodyPreallocate(merged, total);
+        uint8_t *block = malloc(AS_UPLOAD_BLOCK_SIZE);
+        for (int i = 0; i < segments; i++) {
+            int in = open(segmentPaths[i], O_RDONLY);
+            ssize_t count;
+            while (in >= 0 && (count = read(in, block, AS_UPLOAD_BLOCK_SIZE)) > 0) {
+                for (ssize_t j = 0; j < count; j++) block[j] = muLawEncode(muLawDecode(block[j]));
+                if (!ASUploadBodyWriteFully(merged, block, (size_t)count)) return fail("writing the merged file");
+            }
+            if (in < 0) return fail("reading a segment");
+            close(in);
+            unlink(segmentPaths[i]);
+        }
+        free(block);
+        close(merged);
+        stageEnd(&stages[StageMerge], start);
+
+        // Multipart body, fields as BackgroundTransferService sends them
+        start = mark();
+        const char *boundary = "Boundary-7D3E1F0A-2B4C-4D5E-8F60-718293A4B5C6";
+        char head[2048], tail[128];
+        int headLength = snprintf(head, sizeof(head),
+            "--%1$s\r\nContent-Disposition: form-data; name=\"model_id\"\r\n\r\nscribe_v1\r\n"
+            "--%1$s\r\nContent-Disposition: form-data; name=\"language_detection\"\r\n\r\n1\r\n"
+            "--%1$s\r\nContent-Disposition: form-data; name=\"timestamps_granularity\"\r\n\r\nword\r\n"
+            "--%1$s\r\nContent-Disposition: form-data; name=\"diarize\"\r\n\r\n1\r\n"
+            "--%1$s\r\nContent-Disposition: form-data; name=\"file\"; filename=\"merged.m4a\"\r\nContent-Type: audio/m4a\r\n\r\n",
+            boundary);
+        int tailLength = snprintf(tail, sizeof(tail), "\r\n--%s--\r\n", boundary);
+        snprintf(path, sizeof(path), "%s/upload_body_transcription.tmp", workDir);
+        int in = open(mergedPath, O_RDONLY);
+        int body = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        ASUploadBodyResult result;
+        if (in < 0 || body < 0 || !ASUploadBodyWrite(body, (const uint8_t *)head, (size_t)headLength, in,
+                                                     (const uint8_t *)tail, (size_t)tailLength, &result)) {
+            return fail("building the multipart body");
+        }
+        close(in);
+        stageEnd(&stages[StageMultipart], start);
+
+        // Transcribe
+        start = mark();
+        char headers[256];
+        snprintf(headers, sizeof(headers), "xi-api-key: bench\r\nContent-Type: multipart/form-data; boundary=%s\r\n", boundary);
+        HttpReply reply;
+        if (!httpPost(port, "/v1/speech-to-text", headers, body, &reply)) return fail("the transcription request");
+        close(body);
+        stageEnd(&stages[StageTranscribe], start);
+        if (reply.status != 200) {
+            fprintf(stderr, "pipelineBench: transcription returned %d: %s\n", reply.status, reply.body);
+            return 1;
+        }
+        addSample(&transcribeModelledMs, reply.modelledMs);
+        addSample(&transcribeRequestBytes, (double)reply.requestBytes);
+        snprintf(path, sizeof(path), "%s/transcription.json", workDir);
+        writeFile(path, reply.body, reply.bodyLength);
+
+        start = mark();
+        size_t transcriptLength = 0;
+        char *transcript = jsonStringValue(reply.body, "text", &transcriptLength);
+        stageEnd(&stages[StageParseTranscript], start);
+        free(reply.body);
+        if (!transcript) {
+            errno = EPROTO;
+            return fail("finding the transcript text");
+        }
+        transcriptBytes = transcriptLength;
+
+        // Summary request body, then the request
+        start = mark();
+        snprintf(path, sizeof(path), "%s/upload_body_summary.tmp", workDir);
+        body = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        ASJSONBodyWriter writer;
+        bool ok = body >= 0 && ASJSONBodyWriterOpen(&writer, body, gzip, 1);
+        ok = ok && ASJSONBodyAppend(&writer, prefix, prefixLength) && ASJSONBodyAppend(&writer, "\"input\":\"", 9)
+             && ASJSONBodyAppendEscaped(&writer, (const uint8_t *)transcript, transcriptLength)
+             && ASJSONBodyAppend(&writer, "\"}", 2);
+        ok = ASJSONBodyWriterClose(&writer) && ok;
+        free(transcript);
+        if (!ok) return fail("writing the summary body");
+        stageEnd(&stages[StageSummaryBody], start);
+
+        start = mark();
+        if (!httpPost(port, "/v1/responses", gzip ? "Authorization: Bearer bench\r\nContent-Type: application/json\r\nContent-Encoding: gzip\r\n"
+                                                  : "Authorization: Bearer bench\r\nContent-Type: application/json\r\n",
+                      body, &reply)) {
+            return fail("the summary request");
+        }
+        close(body);
+        stageEnd(&stages[StageSummarize], start);
+        if (reply.status != 200) {
+            fprintf(stderr, "pipelineBench: summary returned %d: %s\n", reply.status, reply.body);
+            return 1;
+        }
+        addSample(&summarizeModelledMs, reply.modelledMs);
+        addSample(&summarizeRequestBytes, (double)reply.requestBytes);
+        snprintf(path, sizeof(path), "%s/summary.json", workDir);
+        writeFile(path, reply.body, reply.bodyLength);
+
+        start = mark();
+        size_t summaryLength = 0;
+        char *summary = jsonStringValue(reply.body, "text", &summaryLength);
+        stageEnd(&stages[StageParseSummary], start);
+        free(reply.body);
+        if (!summary) {
+            errno = EPROTO;
+            return fail("finding the summary text");
+        }
+        summaryBytes = summaryLength;
+        free(summary);
+
+        // What the user waits for after tapping stop: local work plus the modelled server
+        // time. Not the uploads, which depend on the link (benchmarkPipeline.js adds them).
+        double localUs = 0;
+        for (int stage = StageStop; stage < StageCount; stage++) {
+            if (stage == StageTranscribe || stage == StageSummarize) continue;
+            localUs += stages[stage].wallUs.values[stages[stage].wallUs.count - 1];
+        }
+        addSample(&stopToSummaryUs, localUs + (transcribeModelledMs.values[run] + summarizeModelledMs.values[run]) * 1000);
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("{\"runs\":%d,\"lessonSeconds\":%.0f,\"segmentSeconds\":%.0f,\"segments\":%d,\"sampleRate\":%d,\"gzip\":%s,",
+           runs, lessonSeconds, segmentSeconds, segments, SAMPLE_RATE, gzip ? "true" : "false");
+    printf("\"capture\":{\"pushedFrames\":%llu,\"droppedFrames\":%llu,\"capacityFrames\":%llu,\"highWaterFrames\":%llu,"
+           "\"waits\":%llu,\"encodedBytes\":%llu},",
+           (unsigned long long)pushedFrames, (unsigned long long)droppedFrames, (unsigned long long)capacityFrames,
+           (unsigned long long)highWaterFrames, (unsigned long long)waits, (unsigned long long)encodedBytes);
+    printf("\"transcribe\":{\"requestBytes\":%.0f,\"modelledMs\":%.0f},\"summarize\":{\"requestBytes\":%.0f,\"modelledMs\":%.0f},",
+           mean(&transcribeRequestBytes), mean(&transcribeModelledMs), mean(&summarizeRequestBytes), mean(&summarizeModelledMs));
+    printf("\"transcriptBytes\":%llu,\"summaryBytes\":%llu,\"peakRssKB\":%ld,\"cpuMs\":%.0f,\"stages\":{",
+           (unsigned long long)transcriptBytes, (unsigned long long)summaryBytes, usage.ru_maxrss,
+           (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e3 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e3);
+    for (int stage = 0; stage < StageCount; stage++) {
+        printf("\"%s\":{\"cpuUs\":%.0f,\"writeBytes\":%.0f,\"storageBytes\":%.0f,", StageNames[stage],
+               mean(&stages[stage].cpuUs), mean(&stages[stage].writeBytes), mean(&stages[stage].storageBytes));
+        printHistogram("wallUs", &stages[stage].wallUs, false);
+        printf("}%s", stage + 1 < StageCount ? "," : "},\"histograms\":{");
+    }
+    printHistogram("pushUs", &pushUs, true);
+    printHistogram("sinkUs", &sink.sinkUs, true);
+    printHistogram("rolloverGapUs", &rolloverGapUs, true);
+    printHistogram("stopToSummaryUs", &stopToSummaryUs, false);
+    printf("}}\n");
+
+    for (int stage = 0; stage < StageCount; stage++) {
+        free(stages[stage].wallUs.values);
+        free(stages[stage].cpuUs.values);
+        free(stages[stage].writeBytes.values);
+        free(stages[stage].storageBytes.values);
+    }
+    free(pushUs.values);
+    free(sink.sinkUs.values);
+    free(rolloverGapUs.values);
+    free(stopToSummaryUs.values);
+    free(transcribeModelledMs.values);
+    free(summarizeModelledMs.values);
+    free(transcribeRequestBytes.values);
+    free(summarizeRequestBytes.values);
+    free(prefix);
+    return 0;
+}
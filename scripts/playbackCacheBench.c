@@ -0,0 +1,287 @@
+// Workload runner for ios/ASPlaybackCache.h, built and driven by
+// scripts/benchmarkPlaybackCache.js.
+// Replays a trace of playback operations against segment files laid out like
+// the app's AAC .m4a segments (ftyp, moov with the sample tables, mdat). What a
+// cache miss costs stands in for AVURLAsset loading duration + tracks: read
+// the moov box and turn the sample size table into packet offsets. Building a
+// composition concatenates the segments' packet tables.
+// Trace lines:
+//   item <paths...>      createPlaybackItem (composition, then segment assets)
+//   prefetch <paths...>  prefetchPlayback, in the background on the device
+//   export <paths...>    exportCompositionToFile (segment assets only)
+// Prints one line of JSON with the work done and the cache stats.
+//
+// Usage: playbackCacheBench <cached|uncached> <tracePath> <assetEntries>
+//                           <compositionEntries> <maxSeconds>
+
+#define _GNU_SOURCE
+#include <stdatomic.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "ASPlaybackCache.h"
+
+#define SAMPLE_RATE 44100.0
+#define FRAMES_PER_PACKET 1024
+#define MAX_PATHS 64
+
+typedef struct {
+    _Atomic int references;
+    uint64_t *offsets;
+    uint64_t packets;
+    double seconds;
+} Parsed; // a segment asset or a composition
+
+static uint64_t parses;
+static uint64_t builds;
+
+static void *retainParsed(void *value) {
+    atomic_fetch_add(&((Parsed *)value)->references, 1);
+    return value;
+}
+
+static void releaseParsed(void *value) {
+    Parsed *parsed = value;
+    if (atomic_fetch_sub(&parsed->references, 1) == 1) {
+        free(parsed->offsets);
+        free(parsed);
+    }
+}
+
+static uint32_t readU32(const uint8_t *bytes) {
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+// Depth-first search for a leaf box inside the moov container boxes
+static const uint8_t *findBox(const uint8_t *start, const uint8_t *end, const char *type, uint32_t *size) {
+    static const char *containers[] = { "trak", "mdia", "minf", "stbl" };
+    while (end - start >= 8) {
+        uint32_t boxSize = readU32(start);
+        if (boxSize < 8 || boxSize > (uint64_t)(end - start)) return NULL;
+        if (memcmp(start + 4, type, 4) == 0) {
+            *size = boxSize;
+            return start;
+        }
+        for (size_t i = 0; i < sizeof(containers) / sizeof(*containers); i++) {
+            if (memcmp(start + 4, containers[i], 4) == 0) {
+                const uint8_t *found = findBox(start + 8, start + boxSize, type, size);
+                if (found) return found;
+            }
+        }
+        start += boxSize;
+    }
+    return NULL;
+}
+
+static Parsed *parseSegment(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    struct stat info;
+    fstat(fileno(file), &info);
+    Parsed *parsed = NULL;
+    uint8_t *moov = NULL;
+    uint8_t header[8];
+    while (fread(header, 1, 8, file) == 8) {
+        uint32_t boxSize = readU32(header);
+        if (boxSize < 8) break;
+        if (memcmp(header + 4, "moov", 4) != 0) {
+            fseeko(file, boxSize - 8, SEEK_CUR);
+            continue;
+        }
+        moov = malloc(boxSize - 8);
+        if (!moov || fread(moov, 1, boxSize - 8, file) != boxSize - 8) break;
+        uint32_t stszSize = 0, stcoSize = 0;
+        const uint8_t *stsz = findBox(moov, moov + boxSize - 8, "stsz", &stszSize);
+        const uint8_t *stco = findBox(moov, moov + boxSize - 8, "stco", &stcoSize);
+        if (!stsz || !stco || stszSize < 20 || stcoSize < 20) break;
+        uint32_t count = readU32(stsz + 16);
+        if (20 + (uint64_t)count * 4 > stszSize) break;
+
+        parsed = calloc(1, sizeof(Parsed));
+        parsed->offsets = malloc((count + 1) * sizeof(uint64_t));
+        parsed->packets = count;
+        uint64_t offset = readU32(stco + 16);
+        for (uint32_t i = 0; i < count; i++) {
+            parsed->offsets[i] = offset;
+            offset += readU32(stsz + 20 + (size_t)i * 4);
+        }
+        parsed->offsets[count] = offset;
+        parsed->seconds = count * (double)FRAMES_PER_PACKET / SAMPLE_RATE;
+        if (offset > (uint64_t)info.st_size) { // sample table runs past the file
+            free(parsed->offsets);
+            free(parsed);
+            parsed = NULL;
+        }
+        break;
+    }
+    free(moov);
+    fclose(file);
+    if (parsed) {
+        parsed->references = 1;
+        parses++;
+    }
+    return parsed;
+}
+
+static Parsed *buildComposition(Parsed **segments, size_t count) {
+    Parsed *composition = calloc(1, sizeof(Parsed));
+    composition->references = 1;
+    for (size_t i = 0; i < count; i++) composition->packets += segments[i]->packets;
+    composition->offsets = malloc((composition->packets + 1) * sizeof(uint64_t));
+    uint64_t cursor = 0, base = 0;
+    for (size_t i = 0; i < count; i++) {
+        // Each segment's packets continue where the previous segment's bytes ended
+        uint64_t start = segments[i]->offsets[0];
+        for (uint64_t p = 0; p < segments[i]->packets; p++) {
+            composition->offsets[cursor++] = base + segments[i]->offsets[p] - start;
+        }
+        base += segments[i]->offsets[segments[i]->packets] - start;
+        composition->seconds += segments[i]->seconds;
+    }
+    composition->offsets[cursor] = base;
+    builds++;
+    return composition;
+}
+
+static void assetKey(const char *path, char *key, size_t size) {
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        key[0] = '\0';
+        return;
+    }
+    snprintf(key, size, "%s|%lld|%lld.%09ld", path, (long long)info.st_size,
+             (long long)info.st_mtim.tv_sec, info.st_mtim.tv_nsec);
+}
+
+static double nowMs(clockid_t clock) {
+    struct timespec now;
+    clock_gettime(clock, &now);
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+static ASPlaybackCache assetCache;
+static ASPlaybackCache compositionCache;
+static bool cached;
+
+// Loaded segments for the paths, retained; NULL where a file could not be parsed
+static void segmentAssets(char **paths, size_t count, bool prefetch, Parsed **assets) {
+    char key[4096];
+    for (size_t i = 0; i < count; i++) {
+        assetKey(paths[i], key, sizeof(key));
+        assets[i] = cached && key[0] ? ASPlaybackCacheLookup(&assetCache, key) : NULL;
+        if (assets[i]) continue;
+        assets[i] = parseSegment(paths[i]);
+        if (cached && assets[i] && key[0]) {
+            ASPlaybackCacheInsert(&assetCache, key, assets[i], (uint64_t)(assets[i]->seconds + 0.999), prefetch);
+        }
+    }
+}
+
+static Parsed *composition(char **paths, size_t count, bool prefetch) {
+    char compositionKey[MAX_PATHS * 512] = "";
+    char key[4096];
+    if (cached) {
+        for (size_t i = 0; i < count; i++) {
+            assetKey(paths[i], key, sizeof(key));
+            strncat(compositionKey, key, sizeof(compositionKey) - strlen(compositionKey) - 2);
+            strcat(compositionKey, "\n");
+        }
+        Parsed *hit = ASPlaybackCacheLookup(&compositionCache, compositionKey);
+        if (hit) return hit;
+    }
+    Parsed *assets[MAX_PATHS];
+    segmentAssets(paths, count, prefetch, assets);
+    size_t loaded = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (assets[i]) assets[loaded++] = assets[i];
+    }
+    Parsed *built = buildComposition(assets, loaded);
+    for (size_t i = 0; i < loaded; i++) releaseParsed(assets[i]);
+    if (cached && loaded == count) {
+        ASPlaybackCacheInsert(&compositionCache, compositionKey, built, (uint64_t)(built->seconds + 0.999), prefetch);
+    }
+    return built;
+}
+
+static void printStats(const char *name, ASPlaybackCache *cache) {
+    ASPlaybackCacheStats stats = cached ? ASPlaybackCacheStatsRead(cache) : (ASPlaybackCacheStats){0};
+    printf("\"%s\":{\"entries\":%llu,\"seconds\":%llu,\"hits\":%llu,\"misses\":%llu,\"evictions\":%llu,"
+           "\"prefetches\":%llu,\"prefetchHits\":%llu}",
+           name, (unsigned long long)stats.entries, (unsigned long long)stats.cost,
+           (unsigned long long)stats.hits, (unsigned long long)stats.misses,
+           (unsigned long long)stats.evictions, (unsigned long long)stats.prefetches,
+           (unsigned long long)stats.prefetchHits);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 6) {
+        fprintf(stderr, "usage: %s cached|uncached tracePath assetEntries compositionEntries maxSeconds\n", argv[0]);
+        return 2;
+    }
+    cached = strcmp(argv[1], "cached") == 0;
+    FILE *trace = fopen(argv[2], "r");
+    if (!trace) {
+        perror("trace");
+        return 1;
+    }
+    ASPlaybackCacheInit(&assetCache, (size_t)atol(argv[3]), (uint64_t)atoll(argv[5]), retainParsed, releaseParsed);
+    ASPlaybackCacheInit(&compositionCache, (size_t)atol(argv[4]), (uint64_t)atoll(argv[5]), retainParsed, releaseParsed);
+
+    uint64_t items = 0, prefetches = 0, exports = 0, checksum = 0;
+    double foregroundMs = 0, backgroundMs = 0, maxItemMs = 0;
+    double cpuStart = nowMs(CLOCK_PROCESS_CPUTIME_ID);
+    char *line = NULL;
+    size_t capacity = 0;
+    while (getline(&line, &capacity, trace) > 0) {
+        char *paths[MAX_PATHS];
+        size_t count = 0;
+        char *op = strtok(line, " \n");
+        if (!op) continue;
+        for (char *path; count < MAX_PATHS && (path = strtok(NULL, " \n"));) paths[count++] = path;
+
+        bool prefetch = strcmp(op, "prefetch") == 0;
+        if (prefetch && !cached) continue; // the uncached baseline has nothing to warm
+        double start = nowMs(CLOCK_MONOTONIC);
+        if (strcmp(op, "export") == 0) {
+            Parsed *assets[MAX_PATHS];
+            segmentAssets(paths, count, false, assets);
+            for (size_t i = 0; i < count; i++) {
+                if (assets[i]) {
+                    checksum += assets[i]->offsets[assets[i]->packets];
+                    releaseParsed(assets[i]);
+                }
+            }
+            exports++;
+        } else {
+            Parsed *built = composition(paths, count, prefetch);
+            if (!prefetch) checksum += built->offsets[built->packets] + built->packets;
+            releaseParsed(built);
+        }
+        double elapsed = nowMs(CLOCK_MONOTONIC) - start;
+        if (prefetch) {
+            backgroundMs += elapsed;
+            prefetches++;
+        } else {
+            foregroundMs += elapsed;
+            if (strcmp(op, "item") == 0) items++;
+            if (elapsed > maxItemMs) maxItemMs = elapsed;
+        }
+    }
+    free(line);
+    fclose(trace);
+    double cpuMs = nowMs(CLOCK_PROCESS_CPUTIME_ID) - cpuStart;
+
+    printf("{\"items\":%llu,\"prefetches\":%llu,\"exports\":%llu,\"parses\":%llu,\"builds\":%llu,"
+           "\"foregroundMs\":%.2f,\"maxItemMs\":%.2f,\"backgroundMs\":%.2f,\"cpuMs\":%.2f,\"checksum\":%llu,",
+           (unsigned long long)items, (unsigned long long)prefetches, (unsigned long long)exports,
+           (unsigned long long)parses, (unsigned long long)builds, foregroundMs, maxItemMs, backgroundMs,
+           cpuMs, (unsigned long long)checksum);
+    printStats("assets", &assetCache);
+    printf(",");
+    printStats("compositions", &compositionCache);
+    printf("}\n");
+    ASPlaybackCacheDestroy(&compositionCache);
+    ASPlaybackCacheDestroy(&assetCache);
+    return 0;
+}
@@ -0,0 +1,294 @@
+// Shared setup for the recordings-store benchmarks
+// Loads AudioRecordingService (and the services built on it) under Node.
+// React Native modules are replaced with small stubs: RNFS uses the local disk
+// with a temp dir as the caches directory, counts reads and writes per file
+// name and counts the file-system calls that would cross the bridge; the native
+// BackgroundTransferManager task store is a plain object that crosses the
+// "bridge" as a serialized copy, like the real module. Native events go to the
+// listeners services register, through harness.emit. useHttpTransfers() swaps
+// in upload tasks that send the requests the native module would build over
+// HTTP (to a stand-in such as scripts/mockAIServer.js, via the `env` URLs).
+// (Node 20.10+ is needed to import the ES module sources directly.)
+
+const crypto = require('crypto');
+const fs = require('fs');
+const http = require('http');
+const os = require('os');
+const path = require('path');
+const zlib = require('zlib');
+const { register } = require('module');
+
+const stubModule = (source) => `data:text/javascript,${encodeURIComponent(source)}`;
+
+const STUBS = {
+  'react-native': stubModule(`
+export const NativeModules = { AudioRecorderModule: globalThis.__recordingsBench.audioRecorder, BackgroundTransferManager: globalThis.__recordingsBench.transferManager };
+export const Platform = { OS: 'ios' };
+export const AppState = { addEventListener: () => ({ remove() {} }) };
+export const PermissionsAndroid = {};
+export class NativeEventEmitter {
+  addListener(name, listener) {
+    const listeners = globalThis.__recordingsBench.listeners;
+    (listeners[name] = listeners[name] || []).push(listener);
+    return { remove: () => listeners[name].splice(listeners[name].indexOf(listener), 1) };
+  }
+}`),
+  '@env': stubModule(`
+export const ELEVENLABS_API_KEY = 'bench-elevenlabs-key';
+export const OPENAI_API_KEY = 'bench-openai-key';
+export const ELEVENLABS_API_URL = globalThis.__recordingsBench.env.ELEVENLABS_API_URL;
+export const OPENAI_RESPONSES_API_URL = globalThis.__recordingsBench.env.OPENAI_RESPONSES_API_URL;
+export const PERSIST_METRICS = undefined;`),
+  'react-native-fs': stubModule(`
+export default globalThis.__recordingsBench.fs;`),
+  'react-native-audio-recorder-player': stubModule(`
+export default class AudioRecorderPlayer {}`),
+  // The real service pulls in API keys and the transfer listeners; recovery only needs the task store
+  './BackgroundTransferService': stubModule(`
+const native = globalThis.__recordingsBench.transferManager;
+export default {
+  getActiveTasks: () => native.getActiveTasks(),
+  clearTask: (taskId) => native.clearTask(taskId),
+  reconcileTasks: async () => null,
+};`),
+};
+
+let hooksRegistered = false;
+
+// App sources import siblings without the .js extension (Metro resolves them);
+// teach Node's ESM resolver to do the same, and swap native modules for stubs.
+const registerHooks = () => {
+  if (hooksRegistered) return;
+  hooksRegistered = true;
+  register(`data:text/javascript,${encodeURIComponent(`
+const STUBS = ${JSON.stringify(STUBS)};
+export async function resolve(specifier, context, next) {
+  if (STUBS[specifier]) {
+    return { url: STUBS[specifier], shortCircuit: true };
+  }
+  if (specifier.startsWith('.') && !/\\.[cm]?js$/.test(specifier)) {
+    return next(specifier + '.js', context);
+  }
+  return next(specifier, context);
+}`)}`);
+};
+
+// JSON form fields, then the file part last, as BackgroundTransferManager frames a multipart upload
+const multipartParts = (fields, filePath) => {
+  const boundary = `Boundary-${crypto.randomUUID()}`;
+  let head = '';
+  Object.entries(fields).forEach(([key, value]) => {
+    const text = typeof value === 'string' ? value : JSON.stringify(value ?? '');
+    head += `--${boundary}\r\nContent-Disposition: form-data; name="${key}"\r\n\r\n${text}\r\n`;
+  });
+  head += `--${boundary}\r\nContent-Disposition: form-data; name="file"; filename="${path.basename(filePath)}"\r\nContent-Type: audio/m4a\r\n\r\n`;
+  return { boundary, head: Buffer.from(head), tail: Buffer.from(`\r\n--${boundary}--\r\n`) };
+};
+
+/**
+ * Create the temp recordings directory and load AudioRecordingService against it.
+ * @param {Object} options - { env }: values for the @env module (API endpoint overrides)
+ * @returns {Promise<Object>} - Harness (see fields below)
+ */
+const setupRecordingsHarness = async ({ env = {} } = {}) => {
+  registerHooks();
+
+  const tmpDir = fs.mkdtempSync(path.join(os.tmpdir(), 'recordings-bench-'));
+  const io = { reads: {}, writes: {}, fsCalls: 0 };
+  const count = (bucket, filePath) => {
+    const name = path.basename(filePath);
+    bucket[name] = (bucket[name] || 0) + 1;
+  };
+  const bridge = { calls: 0, taskStore: {} };
+  const serialize = (value) => {
+    bridge.calls++;
+    return JSON.parse(JSON.stringify(value));
+  };
+
+  globalThis.__recordingsBench = {
+    env,
+    fs: {
+      CachesDirectoryPath: tmpDir,
+      TemporaryDirectoryPath: tmpDir,
+      DocumentDirectoryPath: path.join(tmpDir, 'Documents'),
+      exists: async (filePath) => {
+        io.fsCalls++;
+        return fs.existsSync(filePath);
+      },
+      mkdir: async (dirPath) => fs.mkdirSync(dirPath, { recursive: true }),
+      stat: async (filePath) => {
+        io.fsCalls++;
+        const stats = fs.statSync(filePath);
+        return { size: stats.size, mtime: stats.mtime, isFile: () => stats.isFile() };
+      },
+      // Like RNFS.readDir: one call returns every entry with its size and mtime
+      readDir: async (dirPath) => {
+        io.fsCalls++;
+        return fs.readdirSync(dirPath).map((name) => {
+          const entryPath = path.join(dirPath, name);
+          const stats = fs.statSync(entryPath);
+          return { name, path: entryPath, size: stats.size, mtime: stats.mtime, isFile: () => stats.isFile() };
+        });
+      },
+      getFSInfo: async () => ({ freeSpace: globalThis.__recordingsBench.freeSpace ?? Number.MAX_SAFE_INTEGER, totalSpace: Number.MAX_SAFE_INTEGER }),
+      readFile: async (filePath, encoding = 'utf8') => {
+        count(io.reads, filePath);
+        return fs.readFileSync(filePath, encoding === 'base64' ? 'base64' : 'utf8');
+      },
+      writeFile: async (filePath, contents, encoding = 'utf8') => {
+        count(io.writes, filePath);
+        fs.writeFileSync(filePath, contents, encoding === 'base64' ? 'base64' : 'utf8');
+      },
+      moveFile: async (fromPath, toPath) => {
+        io.fsCalls++;
+        fs.renameSync(fromPath, toPath);
+      },
+      unlink: async (filePath) => {
+        io.fsCalls++;
+        fs.unlinkSync(filePath);
+      },
+    },
+    listeners: {},
+    // Benchmarks fill in the native methods they exercise
+    audioRecorder: {},
+    transferManager: {
+      getActiveTasks: async () => serialize(bridge.taskStore),
+      clearTask: async (taskId) => {
+        const existed = Boolean(bridge.taskStore[taskId]);
+        delete bridge.taskStore[taskId];
+        return serialize(existed);
+      },
+    },
+  };
+
+  const recordingsService = await import(path.join(__dirname, '../src/services/AudioRecordingService.js'));
+  const recordingsPath = await recordingsService.getRecordingsFilePath();
+
+  return {
+    tmpDir,
+    io,
+    bridge,
+    recordingsService,
+    recordingsPath,
+
+    // A library of `count` recordings with transcripts and summaries stored inline, as the app keeps them
+    makeLibrary(count, { transcriptBytes = 3000, statuses = ['complete'] } = {}) {
+      const sentence = 'Keep the bow in the same lane and let the weight of the arm do the work. ';
+      const transcript = sentence.repeat(Math.ceil(transcriptBytes / sentence.length));
+      return Array.from({ length: count }, (_, i) => ({
+        id: `rec-${i}`,
+        title: `Lesson ${i + 1}`,
+        filePath: `${tmpDir}/rec-${i}.m4a`,
+        date: new Date(2020, 0, 1 + i).toDateString(),
+        duration: '58:12',
+        transcript,
+        summary: '# Lesson\n\n- Open strings with a metronome\n'.repeat(10),
+        processingStatus: statuses[i % statuses.length],
+      }));
+    },
+
+    // Replace recordings.json directly, as an older build or a native writer would
+    writeLibrary(recordings) {
+      fs.writeFileSync(recordingsPath, JSON.stringify(recordings, null, 2));
+    },
+
+    // Deliver a native event to every listener registered for it
+    async emit(name, body) {
+      const listeners = globalThis.__recordingsBench.listeners[name] || [];
+      await Promise.all(listeners.map(listener => listener(serialize(body))));
+    },
+
+    // startUploadTask as real HTTP: the body the native module would build (multipart
+    // form + file, templated JSON, or the body string) is sent to task.apiUrl and the
+    // outcome comes back as onTransferComplete / onTransferError. The native result
+    // cache is not modelled. Returns counters of what was sent.
+    useHttpTransfers() {
+      const transfers = { started: 0, completed: 0, failed: 0, bytesSent: 0 };
+      const bodyTemplates = new Map();
+      let nextTask = 1;
+      const harness = this;
+      Object.assign(globalThis.__recordingsBench.transferManager, {
+        startUploadTask: async (task) => {
+          const taskId = `task-${nextTask++}`;
+          const recordingId = task.metadata?.recordingId || '';
+          const headers = { ...task.headers };
+          let parts;
+          if (/^multipart\/form-data/.test(headers['Content-Type'] || '') && task.filePath) {
+            const { boundary, head, tail } = multipartParts(JSON.parse(task.body || '{}'), task.filePath);
+            headers['Content-Type'] = `multipart/form-data; boundary=${boundary}`;
+            parts = [head, task.filePath, tail];
+          } else if (task.jsonBody) {
+            const { templateId, template, field, value, contentEncoding } = task.jsonBody;
+            if (template) bodyTemplates.set(templateId, template);
+            if (!bodyTemplates.has(templateId)) throw new Error('JSON body template missing or invalid');
+            let body = Buffer.from(JSON.stringify({ ...bodyTemplates.get(templateId), [field]: value }));
+            if (contentEncoding === 'gzip') {
+              body = zlib.gzipSync(body, { level: 1 });
+              headers['Content-Encoding'] = 'gzip';
+            }
+            parts = [body];
+          } else {
+            parts = [Buffer.from(task.body || '')];
+          }
+          headers['Content-Length'] = parts.reduce((sum, part) => sum + (typeof part === 'string' ? fs.statSync(part).size : part.length), 0);
+          bridge.taskStore[taskId] = { taskId, taskType: task.taskType, recordingId, status: 'pending' };
+          transfers.started++;
+          transfers.bytesSent += headers['Content-Length'];
+
+          const event = { taskId, taskType: task.taskType, recordingId };
+          const finish = async (name, body) => {
+            if (bridge.taskStore[taskId]) bridge.taskStore[taskId].status = name === 'onTransferComplete' ? 'complete' : 'error';
+            transfers[name === 'onTransferComplete' ? 'completed' : 'failed']++;
+            await harness.emit(name, { ...event, ...body });
+          };
+          const req = http.request(task.apiUrl, { method: 'POST', headers }, (res) => {
+            const chunks = [];
+            res.on('data', chunk => chunks.push(chunk));
+            res.on('end', () => {
+              const text = Buffer.concat(chunks).toString('utf8');
+              if (res.statusCode >= 200 && res.statusCode < 300) finish('onTransferComplete', { response: text });
+              else finish('onTransferError', { error: `HTTP Error: ${res.statusCode} - ${text}` });
+            });
+          });
+          req.on('error', error => finish('onTransferError', { error: error.message }));
+          (async () => {
+            for (const part of parts) {
+              if (typeof part !== 'string') {
+                if (!req.write(part)) await new Promise(resolve => req.once('drain', resolve));
+                continue;
+              }
+              for await (const chunk of fs.createReadStream(part, { highWaterMark: 1024 * 1024 })) {
+                if (!req.write(chunk)) await new Promise(resolve => req.once('drain', resolve));
+              }
+            }
+            req.end();
+          })().catch(error => req.destroy(error));
+          return taskId;
+        },
+      });
+      return transfers;
+    },
+
+    resetCounters() {
+      io.reads = {};
+      io.writes = {};
+      io.fsCalls = 0;
+      bridge.calls = 0;
+    },
+
+    // Silence the services' per-call logging so result tables are readable
+    quiet() {
+      const { log, warn, error } = console;
+      console.log = () => {};
+      console.warn = () => {};
+      console.error = () => {};
+      return () => Object.assign(console, { log, warn, error });
+    },
+
+    close() {
+      fs.rmSync(tmpDir, { recursive: true, force: true });
+    },
+  };
+};
+
+module.exports = { setupRecordingsHarness };
@@ -0,0 +1,102 @@
+// Request body writer for ios/ASJSONBody.h, built and driven by
+// scripts/benchmarkRequestBody.js.
+// Writes one summary/title request body to a file the two ways
+// BackgroundTransferManager has done it:
+//   copy   - the body arrives as a JSON string from JS; it is copied to UTF-8
+//            data (dataUsingEncoding:) and written atomically (a temp file,
+//            then a rename)
+//   stream - the cached template prefix, then the text escaped into the file
+//            through ASJSONBodyWriter, gzipped at <level> when it is above 0
+// Prints one line of JSON: the time taken, JSON bytes and bytes on the wire.
+//
+// Usage: requestBodyBench copy <bodyPath> <outPath>
+//        requestBodyBench stream <prefixPath> <textPath> <outPath> <level>
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "ASJSONBody.h"
+
+static double nowMs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+static uint8_t *readFile(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    struct stat info;
+    fstat(fileno(file), &info);
+    uint8_t *bytes = malloc((size_t)info.st_size + 1);
+    *length = bytes ? fread(bytes, 1, (size_t)info.st_size, file) : 0;
+    fclose(file);
+    return bytes;
+}
+
+static int copyBody(const char *bodyPath, const char *outPath) {
+    size_t length;
+    uint8_t *body = readFile(bodyPath, &length);
+    if (!body) return 1;
+
+    double start = nowMs();
+    uint8_t *data = malloc(length); // NSString -> NSData
+    memcpy(data, body, length);
+    char tempPath[4096];
+    snprintf(tempPath, sizeof(tempPath), "%s.atomic", outPath);
+    int fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    ASJSONBodyWriter writer = { .fd = fd };
+    bool ok = fd >= 0 && ASJSONBodyWriteFully(&writer, data, length);
+    if (fd >= 0) close(fd);
+    ok = ok && rename(tempPath, outPath) == 0;
+    double elapsed = nowMs() - start;
+
+    free(data);
+    free(body);
+    if (!ok) return 1;
+    printf("{\"ms\":%.3f,\"rawBytes\":%zu,\"wireBytes\":%llu}\n", elapsed, length, (unsigned long long)writer.wireBytes);
+    return 0;
+}
+
+static int streamBody(const char *prefixPath, const char *textPath, const char *outPath, int level) {
+    size_t prefixLength, textLength;
+    uint8_t *prefix = readFile(prefixPath, &prefixLength);
+    uint8_t *text = readFile(textPath, &textLength);
+    if (!prefix || !text) return 1;
+
+    double start = nowMs();
+    int fd = open(outPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    ASJSONBodyWriter writer;
+    bool ok = fd >= 0 && ASJSONBodyWriterOpen(&writer, fd, level > 0, level);
+    ok = ok
+        && ASJSONBodyAppend(&writer, prefix, prefixLength)
+        && ASJSONBodyAppend(&writer, "\"input\":\"", 9);
+    // In blocks, as the native side converts the NSString to UTF-8
+    for (size_t offset = 0; ok && offset < textLength; offset += 16 * 1024) {
+        size_t count = textLength - offset < 16 * 1024 ? textLength - offset : 16 * 1024;
+        ok = ASJSONBodyAppendEscaped(&writer, text + offset, count);
+    }
+    ok = ok && ASJSONBodyAppend(&writer, "\"}", 2);
+    if (fd >= 0) {
+        ok = ASJSONBodyWriterClose(&writer) && ok;
+        close(fd);
+    }
+    double elapsed = nowMs() - start;
+
+    free(prefix);
+    free(text);
+    if (!ok) return 1;
+    printf("{\"ms\":%.3f,\"rawBytes\":%llu,\"wireBytes\":%llu}\n", elapsed,
+           (unsigned long long)writer.rawBytes, (unsigned long long)writer.wireBytes);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 4 && strcmp(argv[1], "copy") == 0) return copyBody(argv[2], argv[3]);
+    if (argc == 6 && strcmp(argv[1], "stream") == 0) return streamBody(argv[2], argv[3], argv[4], atoi(argv[5]));
+    fprintf(stderr, "usage: %s copy bodyPath outPath | stream prefixPath textPath outPath level\n", argv[0]);
+    return 2;
+}
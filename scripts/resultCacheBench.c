@@ -0,0 +1,192 @@
+// Workload runner for ios/ASResultCache.h, built and driven by
+// scripts/benchmarkResultCache.js.
+// Replays a trace of AI requests against the on-disk result cache the way
+// BackgroundTransferManager uses it: look the request up; on a miss the
+// response arrives later and is inserted. Responses are generated from their
+// key, so every hit can be checked byte for byte.
+// Trace lines:
+//   get <hexKey> <responseBytes>  a request (lookup, insert on a miss)
+//   reopen                        the app is relaunched (close, open)
+//   tear                          the app dies mid-insert (a partial record at
+//                                 the end of the file), then is relaunched
+// Prints one line of JSON with the hit counts, latencies, cache stats and a
+// mask of which requests hit (one 0/1 character per get).
+//
+// Usage: resultCacheBench <cachePath> <tracePath> <maxBytes>
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <time.h>
+
+#include "ASResultCache.h"
+
+typedef struct {
+    double *values;
+    size_t count;
+    size_t capacity;
+} Samples;
+
+static void addSample(Samples *samples, double value) {
+    if (samples->count == samples->capacity) {
+        samples->capacity = samples->capacity ? samples->capacity * 2 : 256;
+        samples->values = realloc(samples->values, samples->capacity * sizeof(double));
+    }
+    samples->values[samples->count++] = value;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double left = *(const double *)a, right = *(const double *)b;
+    return left < right ? -1 : left > right;
+}
+
+static double percentile(Samples *samples, double fraction) {
+    if (samples->count == 0) return 0;
+    qsort(samples->values, samples->count, sizeof(double), compareDoubles);
+    size_t index = (size_t)(fraction * (samples->count - 1) + 0.5);
+    return samples->values[index];
+}
+
+static double nowUs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+// A response-like JSON blob derived from the key
+static void fillResponse(uint8_t *bytes, size_t length, const uint8_t *key) {
+    static const char words[] = "Keep the bow close to the bridge and let the arm lead. ";
+    uint32_t state = ((uint32_t)key[0] << 24) | ((uint32_t)key[1] << 16) | ((uint32_t)key[2] << 8) | key[3];
+    for (size_t i = 0; i < length; i++) {
+        state = state * 1664525u + 1013904223u;
+        bytes[i] = (state >> 28) == 0 ? (uint8_t)('a' + (state >> 20) % 26) : (uint8_t)words[i % (sizeof(words) - 1)];
+    }
+}
+
+static bool parseKey(const char *hex, uint8_t *key) {
+    if (strlen(hex) != AS_RESULT_CACHE_KEY_BYTES * 2) return false;
+    for (int i = 0; i < AS_RESULT_CACHE_KEY_BYTES; i++) {
+        unsigned byte;
+        if (sscanf(hex + i * 2, "%2x", &byte) != 1) return false;
+        key[i] = (uint8_t)byte;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s cachePath tracePath maxBytes\n", argv[0]);
+        return 2;
+    }
+    const char *cachePath = argv[1];
+    uint64_t maxBytes = (uint64_t)atoll(argv[3]);
+    FILE *trace = fopen(argv[2], "r");
+    if (!trace) {
+        perror("trace");
+        return 1;
+    }
+    ASResultCache cache;
+    double start = nowUs();
+    if (!ASResultCacheOpen(&cache, cachePath, maxBytes)) {
+        perror("open");
+        return 1;
+    }
+    Samples hitUs = {0}, missUs = {0}, insertUs = {0}, openUs = {0};
+    addSample(&openUs, nowUs() - start);
+
+    uint64_t requests = 0, hits = 0, mismatches = 0, hitBytes = 0, reopens = 0, tears = 0;
+    ASResultCacheStats totals = {0};
+    char *line = NULL;
+    size_t capacity = 0;
+    uint8_t *expected = NULL;
+    size_t expectedCapacity = 0;
+    char *hitMask = NULL;
+    size_t hitMaskCapacity = 0;
+    while (getline(&line, &capacity, trace) > 0) {
+        char *op = strtok(line, " \n");
+        if (!op) continue;
+        if (strcmp(op, "reopen") == 0 || strcmp(op, "tear") == 0) {
+            ASResultCacheStats stats = ASResultCacheStatsRead(&cache);
+            totals.evictions += stats.evictions;
+            totals.compactions += stats.compactions;
+            ASResultCacheClose(&cache);
+            if (op[0] == 't') {
+                // Half a put record: a header promising more bytes than follow
+                int fd = open(cachePath, O_WRONLY | O_APPEND);
+                ASResultCacheRecord record = { .magic = AS_RESULT_CACHE_PUT, .length = 4096 };
+                if (fd < 0 || write(fd, &record, sizeof(record)) != (ssize_t)sizeof(record) || write(fd, "{\"id\":", 6) != 6) {
+                    perror("tear");
+                    return 1;
+                }
+                close(fd);
+                tears++;
+            }
+            start = nowUs();
+            if (!ASResultCacheOpen(&cache, cachePath, maxBytes)) {
+                perror("reopen");
+                return 1;
+            }
+            addSample(&openUs, nowUs() - start);
+            reopens++;
+            continue;
+        }
+        uint8_t key[AS_RESULT_CACHE_KEY_BYTES];
+        char *hex = strtok(NULL, " \n");
+        char *bytes = strtok(NULL, " \n");
+        if (strcmp(op, "get") != 0 || !hex || !bytes || !parseKey(hex, key)) {
+            fprintf(stderr, "bad trace line: %s\n", op);
+            return 1;
+        }
+        size_t responseLength = (size_t)atol(bytes);
+        if (responseLength > expectedCapacity) {
+            expectedCapacity = responseLength;
+            expected = realloc(expected, expectedCapacity);
+        }
+        fillResponse(expected, responseLength, key);
+        if (requests + 1 >= hitMaskCapacity) {
+            hitMaskCapacity = hitMaskCapacity ? hitMaskCapacity * 2 : 1024;
+            hitMask = realloc(hitMask, hitMaskCapacity);
+        }
+        hitMask[requests++] = '0';
+
+        size_t length = 0;
+        start = nowUs();
+        uint8_t *value = ASResultCacheLookup(&cache, key, &length);
+        double elapsed = nowUs() - start;
+        if (value) {
+            addSample(&hitUs, elapsed);
+            hits++;
+            hitBytes += length;
+            hitMask[requests - 1] = '1';
+            if (length != responseLength || memcmp(value, expected, length) != 0) mismatches++;
+            free(value);
+        } else {
+            addSample(&missUs, elapsed);
+            start = nowUs();
+            ASResultCacheInsert(&cache, key, expected, responseLength);
+            addSample(&insertUs, nowUs() - start);
+        }
+    }
+    free(line);
+    free(expected);
+    fclose(trace);
+
+    ASResultCacheStats stats = ASResultCacheStatsRead(&cache);
+    printf("{\"requests\":%llu,\"hits\":%llu,\"mismatches\":%llu,\"hitBytes\":%llu,\"reopens\":%llu,\"tears\":%llu,"
+           "\"hitP50Us\":%.2f,\"hitP99Us\":%.2f,\"missP50Us\":%.2f,\"missP99Us\":%.2f,\"insertP50Us\":%.2f,"
+           "\"insertP99Us\":%.2f,\"openMaxUs\":%.2f,\"entries\":%llu,\"bytes\":%llu,\"fileBytes\":%llu,"
+           "\"evictions\":%llu,\"compactions\":%llu,\"hitMask\":\"%.*s\"}\n",
+           (unsigned long long)requests, (unsigned long long)hits, (unsigned long long)mismatches,
+           (unsigned long long)hitBytes, (unsigned long long)reopens, (unsigned long long)tears,
+           percentile(&hitUs, 0.5), percentile(&hitUs, 0.99), percentile(&missUs, 0.5), percentile(&missUs, 0.99),
+           percentile(&insertUs, 0.5), percentile(&insertUs, 0.99), percentile(&openUs, 1.0),
+           (unsigned long long)stats.entries, (unsigned long long)stats.bytes, (unsigned long long)stats.fileBytes,
+           (unsigned long long)(totals.evictions + stats.evictions),
+           (unsigned long long)(totals.compactions + stats.compactions), (int)requests, hitMask ? hitMask : "");
+    ASResultCacheClose(&cache);
+    free(hitMask);
+    free(hitUs.values);
+    free(missUs.values);
+    free(insertUs.values);
+    free(openUs.values);
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Capture Ring Stress Test (Linux)
+// Builds scripts/captureRingStress.c against ios/ASCaptureRing.h (the ring and
+// writer thread the ring capture engine in AudioRecorderModule uses) and runs it
+// with disk stalls injected into the writer's sink. The producer pushes on the
+// real-time schedule of a 44.1 kHz input callback. Stalls up to the ring's
+// stall budget must lose nothing: no dropped frames and no gaps in the frame
+// counter the sink checks. A stall past the budget must show up as counted
+// overruns rather than silent loss.
+// Run with: node scripts/stressCaptureRing.js [budgetSeconds] [durationSeconds]
+
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { execFileSync } = require('child_process');
+
+const SAMPLE_RATE = 44100;
+const CALLBACK_FRAMES = 1024; // AudioRecorderModule's input tap buffer size
+const STALL_EVERY_SECONDS = 2;
+
+const main = () => {
+  if (process.platform !== 'linux') {
+    throw new Error('This stress test builds with cc and pthreads; run it on Linux');
+  }
+  const budgetSeconds = parseFloat(process.argv[2]) || 1;
+  const durationSeconds = parseFloat(process.argv[3]) || 5;
+  const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'capture-ring-'));
+  const binary = path.join(dir, 'captureRingStress');
+  execFileSync('cc', ['-O2', '-std=c11', '-pthread', '-Wall', '-Werror',
+    '-I', path.join(__dirname, '../ios'), path.join(__dirname, 'captureRingStress.c'), '-o', binary]);
+
+  const run = stallMs => JSON.parse(execFileSync(binary, [path.join(dir, 'capture.raw'), SAMPLE_RATE, CALLBACK_FRAMES,
+    budgetSeconds, stallMs, STALL_EVERY_SECONDS, durationSeconds].map(String), { encoding: 'utf8' }));
+
+  const rows = [];
+  try {
+    // The ring rounds up to a power of two, so the real budget is at least the requested one
+    const { stallBudgetSeconds, capacityFrames } = run(0);
+    for (const fraction of [0, 0.25, 0.5, 0.9, 1.5]) {
+      const stallMs = Math.round(stallBudgetSeconds * 1000 * fraction);
+      const result = run(stallMs);
+      const withinBudget = fraction < 1;
+      if (withinBudget && (result.droppedFrames > 0 || result.gaps > 0 || result.sinkError !== 0)) {
+        throw new Error(`A ${stallMs} ms stall within the ${stallBudgetSeconds.toFixed(2)} s budget lost audio: ${JSON.stringify(result)}`);
+      }
+      if (!withinBudget && result.overruns === 0) {
+        throw new Error(`A ${stallMs} ms stall past the budget was not reported as an overrun`);
+      }
+      rows.push({
+        stallMs,
+        ofBudget: `${Math.round(fraction * 100)}%`,
+        stalls: result.stalls,
+        maxSinkMs: result.maxSinkMs,
+        highWaterFrames: result.highWaterFrames,
+        highWaterPct: Math.round((result.highWaterFrames / result.capacityFrames) * 100),
+        droppedFrames: result.droppedFrames,
+        overruns: result.overruns,
+        gaps: result.gaps,
+        maxPushMicros: result.maxPushMicros,
+      });
+    }
+    console.log(`Ring of ${capacityFrames} frames at ${SAMPLE_RATE} Hz (requested budget ${budgetSeconds} s, real ${stallBudgetSeconds.toFixed(2)} s); ${durationSeconds} s of audio per run, a stall every ${STALL_EVERY_SECONDS} s`);
+    console.table(rows);
+  } finally {
+    fs.rmSync(dir, { recursive: true, force: true });
+  }
+};
+
+try {
+  main();
+} catch (error) {
+  console.error('Stress test failed:', error.message || error);
+  process.exit(1);
+}
@@ -0,0 +1,169 @@
+// Overhead runner for ios/ASTrace.h, built and driven by
+// scripts/benchmarkTrace.js (once at AS_TRACE_LEVEL 2, once at 0).
+// Times a loop of tiny functions, each wrapped in a span, four ways: without
+// the macro (the loop's own cost), with recording off, recording on one
+// thread, and recording on `threads` threads at once. Then records on all
+// threads while the main thread dumps repeatedly, so the dump races the
+// writers as it does on the device, and leaves the last dump at `dumpPath`.
+// The racing run's spans carry their loop index as the value and one of the
+// app's event names, picked by that index, as the label, so the driver can
+// check that no torn event made it into the dump. Per-thread times are thread
+// CPU time, so they hold on a machine with fewer cores than threads; every
+// variant is the best of RUNS (the slowest thread of each threaded run).
+// Prints one line of JSON.
+//
+// Usage: traceBench <spans> <threads> <dumpPath>
+
+#define _GNU_SOURCE
+#define AS_TRACE_IMPLEMENTATION
+#include <sched.h>
+#include <stdio.h>
+
+#include "ASTrace.h"
+
+#define RUNS 5
+
+// Labels as the bridge's sendEventWithName: span carries them
+static const char *const eventNames[8] __attribute__((unused)) = {
+    "onRecordingProgress", "onRecordingUpdate", "onRecordingStateChange", "onRecordingFinished",
+    "onRecordingError", "onTransferProgress", "onTransferComplete", "onTransferError",
+};
+
+static long spans;
+static _Atomic int startLine;
+static volatile uint64_t sink;
+
+static __attribute__((noinline)) void work(uint64_t index) {
+    sink += index;
+}
+
+static __attribute__((noinline)) void tracedWork(uint64_t index) {
+    AS_TRACE_SPAN_VALUE("bench.work", index);
+    sink += index;
+}
+
+static __attribute__((noinline)) void labelledWork(uint64_t index) {
+    AS_TRACE_DETAIL_SPAN_LABEL_VALUE("bench.emit", eventNames[index & 7], index);
+    sink += index;
+}
+
+static uint64_t threadNanos(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static double loopNs(void (*body)(uint64_t)) {
+    double best = 0;
+    for (int run = 0; run < RUNS; run++) {
+        uint64_t start = threadNanos();
+        for (long i = 0; i < spans; i++) body((uint64_t)i);
+        double ns = (double)(threadNanos() - start) / (double)spans;
+        if (run == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+typedef struct {
+    pthread_t thread;
+    int index;
+    double ns;
+    bool labelled;
+} Worker;
+
+static void *workerMain(void *argument) {
+    Worker *worker = argument;
+    char name[16];
+    snprintf(name, sizeof(name), "worker-%d", worker->index);
+    pthread_setname_np(pthread_self(), name);
+    while (!atomic_load(&startLine)) sched_yield();
+    uint64_t start = threadNanos();
+    for (long i = 0; i < spans; i++) {
+        if (worker->labelled) labelledWork((uint64_t)i);
+        else tracedWork((uint64_t)i);
+    }
+    worker->ns = (double)(threadNanos() - start) / (double)spans;
+    return NULL;
+}
+
+static double runWorkers(Worker *workers, int threads, bool labelled, const char *dumpPath, long *dumps, long *dumpEvents) {
+    atomic_store(&startLine, 0);
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (Worker){ .index = t, .labelled = labelled };
+        pthread_create(&workers[t].thread, NULL, workerMain, &workers[t]);
+    }
+    atomic_store(&startLine, 1);
+    if (dumpPath) {
+        // Dump while they write, until the last one finishes
+        for (int t = 0; t < threads; t++) {
+            while (pthread_tryjoin_np(workers[t].thread, NULL) != 0) {
+                long written = ASTraceDump(dumpPath);
+                if (written < 0) {
+                    perror(dumpPath);
+                    exit(1);
+                }
+                (*dumps)++;
+                *dumpEvents = written;
+            }
+        }
+        *dumpEvents = ASTraceDump(dumpPath);
+    } else {
+        for (int t = 0; t < threads; t++) pthread_join(workers[t].thread, NULL);
+    }
+    double worst = 0;
+    for (int t = 0; t < threads; t++) {
+        if (workers[t].ns > worst) worst = workers[t].ns;
+    }
+    return worst;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s spans threads dumpPath\n", argv[0]);
+        return 2;
+    }
+    spans = atol(argv[1]);
+    int threads = atoi(argv[2]);
+    const char *dumpPath = argv[3];
+    Worker *workers = calloc((size_t)threads, sizeof(Worker));
+
+    // What one span would cost in clock reads alone without the tick counter
+    uint64_t clockStart = threadNanos();
+    for (long i = 0; i < spans; i++) sink += ASTraceNanos();
+    double clockNs = (double)(threadNanos() - clockStart) / (double)spans;
+    uint64_t ticksStart = threadNanos();
+    for (long i = 0; i < spans; i++) sink += ASTraceTicks();
+    double ticksNs = (double)(threadNanos() - ticksStart) / (double)spans;
+    uint64_t sinkStart = threadNanos();
+    for (long i = 0; i < spans; i++) sink += (uint64_t)i;
+    double sinkNs = (double)(threadNanos() - sinkStart) / (double)spans;
+    // One read of the counter, without the loop around it
+    clockNs -= sinkNs;
+    ticksNs -= sinkNs;
+    double baseNs = loopNs(work);
+    double offNs = loopNs(tracedWork);
+    ASTraceStart();
+    double onNs = loopNs(tracedWork);
+    double labelledNs = loopNs(labelledWork);
+    double threadedNs = 0, racingNs = 0;
+    for (int run = 0; run < RUNS; run++) {
+        double ns = runWorkers(workers, threads, false, NULL, NULL, NULL);
+        if (run == 0 || ns < threadedNs) threadedNs = ns;
+    }
+    long dumps = 0, dumpEvents = 0;
+    for (int run = 0; run < RUNS; run++) {
+        // Fresh epoch, so the last dump holds the last racing run's labelled spans only
+        ASTraceStart();
+        double ns = runWorkers(workers, threads, true, dumpPath, &dumps, &dumpEvents);
+        if (run == 0 || ns < racingNs) racingNs = ns;
+    }
+    ASTraceStop();
+
+    printf("{\"level\":%d,\"spans\":%ld,\"threads\":%d,\"ringEvents\":%d,\"eventBytes\":%zu,"
+           "\"clockNs\":%.2f,\"ticksNs\":%.2f,\"baseNs\":%.2f,\"offNs\":%.2f,\"onNs\":%.2f,\"labelledNs\":%.2f,"
+           "\"threadedNs\":%.2f,\"racingNs\":%.2f,\"dumps\":%ld,\"dumpEvents\":%ld}\n",
+           AS_TRACE_LEVEL, spans, threads, AS_TRACE_RING_EVENTS, sizeof(ASTraceEvent),
+           clockNs, ticksNs, baseNs, offNs, onNs, labelledNs, threadedNs, racingNs, dumps, dumpEvents);
+    free(workers);
+    return 0;
+}
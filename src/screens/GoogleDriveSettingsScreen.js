@@ -154,18 +154,14 @@ const GoogleDriveSettingsScreen = ({ navigation }) => {
           {
             text: 'Sync All',
             onPress: async () => {
-              let successCount = 0;
-              let errorCount = 0;
-
-              for (const recording of unsyncedRecordings) {
-                try {
-                  await GoogleDriveService.syncRecording(recording.id, settings.folderOrganization);
-                  successCount++;
-                } catch (error) {
-                  console.error(`Failed to sync recording ${recording.id}:`, error);
-                  errorCount++;
-                }
-              }
+              const { results, errors } = await GoogleDriveService.syncRecordings(
+                unsyncedRecordings.map(recording => recording.id)
+              );
+              errors.forEach(({ recordingId, error }) => {
+                console.error(`Failed to sync recording ${recordingId}:`, error);
+              });
+              const successCount = results.length;
+              const errorCount = errors.length;
 
               // Update sync statistics
               if (successCount > 0) {
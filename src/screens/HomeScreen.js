@@ -15,7 +15,7 @@ import {
 } from 'react-native';
 import Icon from 'react-native-vector-icons/Ionicons';
 import { useIsFocused } from '@react-navigation/native';
-import { getRecordings, updateRecording, deleteRecording, handleNotebookLMShareDetected, getRecordingById } from '../services/AudioRecordingService';
+import { getRecordings, getRecordingSummaries, updateRecording, deleteRecording, handleNotebookLMShareDetected, getRecordingById } from '../services/AudioRecordingService';
 import { transcribeRecording } from '../services/TranscriptionService';
 import { Swipeable } from 'react-native-gesture-handler';
 import { 
@@ -23,8 +23,7 @@ import {
   generateCombinedSummaryContent, 
   showFormatSelectionAndShare, 
   cleanSummaryMarkdown,
-  generateHTMLFromMarkdown,
-  createPDFFromHTML,
+  createSummaryPDF,
   shareBulkTranscriptsToNotebookLM,
   shareTranscriptToNotebookLM
 } from '../utils/ShareUtils';
@@ -32,6 +31,9 @@ import ActionIndicator from '../components/ActionIndicator';
 import RNFS from 'react-native-fs';
 import Share from 'react-native-share';
 
+// List rows are loaded from the recordings index a page at a time
+const PAGE_SIZE = 30;
+
 const HomeScreen = ({ navigation }) => {
   const [recordings, setRecordings] = useState([]);
   const [searchQuery, setSearchQuery] = useState('');
@@ -41,6 +43,11 @@ const HomeScreen = ({ navigation }) => {
   // Keep track of open swipeables so we can close them when needed
   const swipeableRefs = useRef({});
   const [filteredRecordings, setFilteredRecordings] = useState([]);
+  const [totalRecordings, setTotalRecordings] = useState(0);
+  const pageLimitRef = useRef(PAGE_SIZE);
+  const listVersionRef = useRef(null);
+  // Full recordings (with transcripts and summaries), loaded only when searching
+  const searchRecordingsRef = useRef(null);
 
   // State for Edit Mode
   const [isEditing, setIsEditing] = useState(false);
@@ -51,13 +58,19 @@ const HomeScreen = ({ navigation }) => {
     
     console.log('Loading recordings...');
     try {
-      const recordingsList = await getRecordings();
+      // Only the rows loaded so far; transcripts and summaries stay on disk
+      const { items, total, version } = await getRecordingSummaries({ limit: pageLimitRef.current });
+      if (version !== listVersionRef.current) {
+        listVersionRef.current = version;
+        searchRecordingsRef.current = null;
+      }
       
       // Ensure all recordings have valid IDs to use as keys
-      const validRecordings = recordingsList.filter(r => r && r.id);
+      const validRecordings = items.filter(r => r && r.id);
       
       // Update recordings state with new array
       setRecordings(validRecordings);
+      setTotalRecordings(total);
       
       const stillProcessing = validRecordings.find(r => r.id === processingId && r.processingStatus === 'processing');
       if (processingId && !stillProcessing) {
@@ -70,14 +83,30 @@ const HomeScreen = ({ navigation }) => {
     }
   }, [processingId]);
 
+  // Load the next page of rows when the list nears its end
+  const loadMoreRecordings = useCallback(() => {
+    if (searchQuery !== '' || recordings.length >= totalRecordings) return;
+    pageLimitRef.current = recordings.length + PAGE_SIZE;
+    loadRecordings(true);
+  }, [searchQuery, recordings.length, totalRecordings, loadRecordings]);
+
   // Filter recordings based on search query
   useEffect(() => {
     if (searchQuery === '') {
       // Make sure we create a new array to avoid reference issues
       setFilteredRecordings([...recordings]);
-    } else {
+      return undefined;
+    }
+
+    // Searching covers transcripts and summaries, so it needs the full recordings (loaded once per change)
+    let cancelled = false;
+    const filterRecordings = async () => {
+      if (!searchRecordingsRef.current) {
+        searchRecordingsRef.current = await getRecordings();
+      }
+      if (cancelled) return;
       const lowerCaseQuery = searchQuery.toLowerCase();
-      const filtered = recordings.filter(recording => 
+      const filtered = searchRecordingsRef.current.filter(recording => 
         recording && (
           (recording.title && recording.title.toLowerCase().includes(lowerCaseQuery)) ||
           (recording.date && recording.date.toLowerCase().includes(lowerCaseQuery)) ||
@@ -86,7 +115,9 @@ const HomeScreen = ({ navigation }) => {
         )
       );
       setFilteredRecordings(filtered);
-    }
+    };
+    filterRecordings();
+    return () => { cancelled = true; };
   }, [searchQuery, recordings]); // Re-run filter when query or recordings change
 
   useEffect(() => {
@@ -115,13 +146,19 @@ const HomeScreen = ({ navigation }) => {
     }
   }, [isFocused, loadRecordings]);
 
-  const handleStartProcessing = async (recording) => {
+  const handleStartProcessing = async (row) => {
     if (processingId) return;
     
-    setProcessingId(recording.id);
+    setProcessingId(row.id);
+    let recording = null;
     try {
-      setRecordings(prev => prev.map(r => r.id === recording.id ? { ...r, processingStatus: 'processing' } : r)); 
+      setRecordings(prev => prev.map(r => r.id === row.id ? { ...r, processingStatus: 'processing' } : r)); 
       
+      // List rows carry no transcript or summary; update the full recording
+      recording = await getRecordingById(row.id);
+      if (!recording) {
+        throw new Error('Recording not found');
+      }
       await updateRecording({ ...recording, processingStatus: 'processing' });
       
       transcribeRecording(recording); 
@@ -130,11 +167,13 @@ const HomeScreen = ({ navigation }) => {
       
     } catch (error) {
       console.error('Failed to start processing:', error);
-      setRecordings(prev => prev.map(r => r.id === recording.id ? { ...r, processingStatus: 'error' } : r));
-      try {
-          await updateRecording({ ...recording, processingStatus: 'error' });
-      } catch (updateError) {
-          console.error('Failed to update recording to error state:', updateError);
+      setRecordings(prev => prev.map(r => r.id === row.id ? { ...r, processingStatus: 'error' } : r));
+      if (recording) {
+        try {
+            await updateRecording({ ...recording, processingStatus: 'error' });
+        } catch (updateError) {
+            console.error('Failed to update recording to error state:', updateError);
+        }
       }
       setProcessingId(null); 
     }
@@ -188,8 +227,8 @@ const HomeScreen = ({ navigation }) => {
         }
       });
       
-      // Find the recording by id
-      const recordingToShare = recordings.find(r => r.id === recordingId);
+      // Load the full recording (list rows carry no summary)
+      const recordingToShare = await getRecordingById(recordingId);
       
       if (!recordingToShare) {
         throw new Error('Recording not found');
@@ -528,10 +567,9 @@ const HomeScreen = ({ navigation }) => {
         const sanitizedTitle = recording.title.replace(/[^a-z0-9]/gi, '_').toLowerCase();
 
         if (chosenFormat === 'pdf') {
-          const htmlContent = generateHTMLFromMarkdown(recording.title, cleanedSummary);
           console.log(`[HomeScreen] Generating PDF for: ${recording.title}`);
           try {
-            const pdfPath = await createPDFFromHTML(recording.title, htmlContent);
+            const pdfPath = await createSummaryPDF(recording.title, cleanedSummary, recording.id);
             console.log(`[HomeScreen] PDF generated at path: ${pdfPath}`);
             const pdfExists = await RNFS.exists(pdfPath);
             console.log(`[HomeScreen] PDF file exists at path? ${pdfExists ? 'YES' : 'NO'}`);
@@ -725,6 +763,9 @@ const HomeScreen = ({ navigation }) => {
         keyExtractor={item => item.id || `temp-${Math.random()}`} // Fallback key if id is missing
         contentContainerStyle={styles.listContent}
         extraData={[isEditing, selectedRecordingIds, processingId]} // Re-render when these change
+        onEndReached={loadMoreRecordings}
+        onEndReachedThreshold={0.5}
+        initialNumToRender={15}
         ListEmptyComponent={
           <View style={styles.emptyContainer}>
             <Text style={styles.emptyText}>No recordings yet</Text>
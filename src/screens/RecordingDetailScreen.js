@@ -4,7 +4,7 @@ import {
   Text,
   StyleSheet,
   TouchableOpacity,
-  ScrollView,
+  FlatList,
   ActivityIndicator,
   Alert,
   SafeAreaView,
@@ -20,12 +20,15 @@ import {
   getRecordingById,
   deleteRecording,
   playRecording,
+  prefetchPlayback,
   pausePlayback,
   resumePlayback,
   stopPlayback,
   seekPlayback,
   updateRecording,
 } from '../services/AudioRecordingService';
+import StorageManager from '../services/StorageManager';
+import MetricsService from '../services/MetricsService';
 import { formatTime } from '../utils/TimeUtils';
 import MarkdownIt from 'markdown-it';
 import { useIsFocused } from '@react-navigation/native';
@@ -33,9 +36,73 @@ import RenderHtml from 'react-native-render-html';
 import { shareRecordingSummary } from '../utils/ShareUtils';
 import Slider from '@react-native-community/slider';
 import LinearGradient from 'react-native-linear-gradient';
+import {
+  loadAlignmentIndex,
+  wordIndexAtTime,
+} from '../utils/TranscriptAlignment';
+import { chunkTranscript } from '../utils/TranscriptChunks';
+import { loadSpeakerTimeline } from '../utils/SpeakerTimeline';
 
 const md = new MarkdownIt();
 
+// The files a recording plays from, in order: its segments until they are merged
+const playbackPaths = recording => (recording.segmentPaths?.length ? recording.segmentPaths : [recording.filePath]);
+
+// A single tappable transcript word; memoized so a playback tick only re-renders
+// the words whose highlight state actually changed
+const TranscriptWord = React.memo(({ text, wordIndex, active, onPressWord }) => (
+  <Text
+    style={active ? styles.transcriptWordActive : null}
+    onPress={() => onPressWord(wordIndex)}
+  >
+    {text}
+  </Text>
+));
+
+// One transcript block: plain text, or tappable words when the transcript is aligned.
+// activeWordIndex is -1 for every block but the one being played, so a playback
+// tick re-renders at most two blocks.
+const TranscriptBlock = React.memo(({ transcript, block, alignmentIndex, activeWordIndex, onPressWord }) => {
+  const pieces = useMemo(() => {
+    if (block.wordEnd === block.firstWord) return null;
+    const result = [];
+    let cursor = block.start;
+    for (let i = block.firstWord; i < block.wordEnd; i++) {
+      const start = alignmentIndex.charStart[i];
+      const end = alignmentIndex.charEnd[i];
+      if (start > cursor) {
+        result.push({ key: `g${i}`, text: transcript.substring(cursor, start), wordIndex: -1 });
+      }
+      result.push({ key: `w${i}`, text: transcript.substring(start, end), wordIndex: i });
+      cursor = end;
+    }
+    if (cursor < block.end) {
+      result.push({ key: 'tail', text: transcript.substring(cursor, block.end), wordIndex: -1 });
+    }
+    return result;
+  }, [transcript, block, alignmentIndex]);
+
+  return (
+    <View style={styles.transcriptBlock}>
+      <Text style={styles.transcriptText}>
+        {pieces ? pieces.map(piece => (
+          piece.wordIndex === -1 ? piece.text : (
+            <TranscriptWord
+              key={piece.key}
+              text={piece.text}
+              wordIndex={piece.wordIndex}
+              active={piece.wordIndex === activeWordIndex}
+              onPressWord={onPressWord}
+            />
+          )
+        )) : transcript.substring(block.start, block.end)}
+      </Text>
+    </View>
+  );
+});
+
+const NO_BLOCKS = [];
+
 const RecordingDetailScreen = ({ route, navigation }) => {
   const { recordingId } = route.params;
   const [recording, setRecording] = useState(null);
@@ -48,6 +115,8 @@ const RecordingDetailScreen = ({ route, navigation }) => {
   const [transcriptExpanded, setTranscriptExpanded] = useState(false);
   const [isEditingTitle, setIsEditingTitle] = useState(false);
   const [editableTitle, setEditableTitle] = useState('');
+  const [alignmentIndex, setAlignmentIndex] = useState(null);
+  const [speakerTimeline, setSpeakerTimeline] = useState(null);
   const appState = useRef(AppState.currentState);
   const isFocused = useIsFocused();
   const { width } = useWindowDimensions();
@@ -76,6 +145,52 @@ const RecordingDetailScreen = ({ route, navigation }) => {
     };
   }, [recording?.summary]);
 
+  // Load the word-timing index built when the transcript arrived
+  useEffect(() => {
+    let cancelled = false;
+    const alignmentPath = recording?.alignmentPath;
+    if (!alignmentPath) {
+      setAlignmentIndex(null);
+      return;
+    }
+    loadAlignmentIndex(alignmentPath).then(index => {
+      if (!cancelled) setAlignmentIndex(index);
+    });
+    return () => {
+      cancelled = true;
+    };
+  }, [recording?.alignmentPath]);
+
+  // Speaker turns, so transcript blocks break where the speaker changes
+  useEffect(() => {
+    let cancelled = false;
+    const timelinePath = recording?.speakerTimelinePath;
+    if (!timelinePath) {
+      setSpeakerTimeline(null);
+      return;
+    }
+    loadSpeakerTimeline(timelinePath).then(timeline => {
+      if (!cancelled) setSpeakerTimeline(timeline);
+    });
+    return () => {
+      cancelled = true;
+    };
+  }, [recording?.speakerTimelinePath]);
+
+  // Paragraph blocks for the virtualized transcript, once per transcript
+  const transcriptChunks = useMemo(() => {
+    const transcript = recording?.transcript;
+    if (!transcript) return null;
+    const chunkStart = Date.now();
+    const chunks = chunkTranscript(transcript, { alignmentIndex, timeline: speakerTimeline });
+    MetricsService.record('transcript.chunkMs', 'ms', Date.now() - chunkStart);
+    return chunks;
+  }, [recording?.transcript, alignmentIndex, speakerTimeline]);
+
+  const activeWordIndex = useMemo(() => (
+    isPlayerActive ? wordIndexAtTime(alignmentIndex, currentPosition) : -1
+  ), [alignmentIndex, currentPosition, isPlayerActive]);
+
   const loadRecording = useCallback(async () => {
     console.log(`Loading recording details for ID: ${recordingId}`);
     try {
@@ -98,6 +213,12 @@ const RecordingDetailScreen = ({ route, navigation }) => {
       console.log('Processing status:', recordingData?.processingStatus);
       
       setRecording(recordingData);
+      if (recordingData) {
+        StorageManager.touch(recordingId);
+        if (recordingData.audioStorage !== 'drive') {
+          prefetchPlayback(playbackPaths(recordingData));
+        }
+      }
       if (recordingData?.duration) {
         const parts = recordingData.duration.split(':');
         if (parts.length === 2) {
@@ -191,6 +312,19 @@ const RecordingDetailScreen = ({ route, navigation }) => {
     setIsPlayerActive(false);
   };
 
+  // Audio evicted to Drive is downloaded back before it can play
+  const ensureLocalAudio = async () => {
+    if (recording.audioStorage !== 'drive') return recording;
+    const restored = await StorageManager.restoreAudio(recording.id);
+    setRecording(restored);
+    return restored;
+  };
+
+  const startPlayback = async () => {
+    const local = await ensureLocalAudio();
+    await playRecording(local.filePath, onPlaybackProgress, onPlaybackFinished, playbackPaths(local));
+  };
+
   const handlePlayPause = async () => {
     if (!recording?.filePath) return;
 
@@ -207,11 +341,7 @@ const RecordingDetailScreen = ({ route, navigation }) => {
         if (isPlayerActive && currentPosition > 0) {
           await resumePlayback();
         } else {
-          await playRecording(
-            recording.filePath,
-            onPlaybackProgress,
-            onPlaybackFinished
-          );
+          await startPlayback();
           setIsPlayerActive(true);
         }
         setIsPlaying(true);
@@ -240,6 +370,38 @@ const RecordingDetailScreen = ({ route, navigation }) => {
     }
   };
 
+  // Seek playback to the start of a tapped transcript word
+  const handleWordPress = async (wordIndex) => {
+    if (!alignmentIndex || !recording?.filePath) return;
+    const timeMs = alignmentIndex.startMs[wordIndex];
+    try {
+      if (!isPlayerActive) {
+        await startPlayback();
+        setIsPlayerActive(true);
+        setIsPlaying(true);
+      }
+      await seekPlayback(timeMs);
+      setCurrentPosition(timeMs);
+    } catch (error) {
+      console.error('Error seeking to transcript word:', error);
+    }
+  };
+
+  // Stable callback for the memoized word components
+  const handleWordPressRef = useRef(handleWordPress);
+  handleWordPressRef.current = handleWordPress;
+  const onPressWord = useCallback((wordIndex) => handleWordPressRef.current(wordIndex), []);
+
+  const renderTranscriptBlock = useCallback(({ item }) => (
+    <TranscriptBlock
+      transcript={recording.transcript}
+      block={item}
+      alignmentIndex={alignmentIndex}
+      activeWordIndex={activeWordIndex >= item.firstWord && activeWordIndex < item.wordEnd ? activeWordIndex : -1}
+      onPressWord={onPressWord}
+    />
+  ), [recording?.transcript, alignmentIndex, activeWordIndex, onPressWord]);
+
   const handleDeleteRecording = () => {
     Alert.alert(
       'Delete Recording',
@@ -372,164 +534,172 @@ const RecordingDetailScreen = ({ route, navigation }) => {
     <View style={styles.container}>
       <StatusBar barStyle="dark-content" />
       <SafeAreaView style={styles.safeArea}>
-        <ScrollView contentContainerStyle={styles.scrollContent} keyboardShouldPersistTaps="handled">
-        <View style={styles.headerContainer}>
-          <View style={styles.titleRow}>
-            {isEditingTitle ? (
-              <TextInput
-                style={styles.titleInput}
-                value={editableTitle}
-                onChangeText={setEditableTitle}
-                autoFocus
-                selectTextOnFocus
-                maxLength={100}
-                multiline={true}
-                numberOfLines={3}
-                blurOnSubmit={true}
-              />
-            ) : (
-              <Text style={styles.titleText}>{recording.title}</Text>
-            )}
-            {isEditingTitle ? (
-              <View style={{flexDirection: 'row'}}>
-                <TouchableOpacity
-                  style={{ padding: 5, marginRight: 10 }}
-                  onPress={() => handleToggleEditTitle(true)}
-                >
-                  <Icon name="checkmark-circle-outline" size={28} color="#4CAF50" />
-                </TouchableOpacity>
-                <TouchableOpacity
-                  style={{ padding: 5 }}
-                  onPress={() => handleToggleEditTitle(false)}
-                >
-                  <Icon name="close-circle-outline" size={28} color="#F44336" />
-                </TouchableOpacity>
+        {/* Everything above the transcript is the list header; only the transcript blocks on screen are laid out */}
+        <FlatList
+          data={transcriptExpanded && transcriptChunks ? transcriptChunks.blocks : NO_BLOCKS}
+          renderItem={renderTranscriptBlock}
+          keyExtractor={block => block.key}
+          extraData={activeWordIndex}
+          initialNumToRender={6}
+          maxToRenderPerBatch={6}
+          windowSize={7}
+          contentContainerStyle={styles.scrollContent}
+          keyboardShouldPersistTaps="handled"
+          ListFooterComponent={transcriptExpanded && transcriptChunks ? <View style={styles.transcriptFooter} /> : null}
+          ListHeaderComponent={<>
+            <View style={styles.headerContainer}>
+              <View style={styles.titleRow}>
+                {isEditingTitle ? (
+                  <TextInput
+                    style={styles.titleInput}
+                    value={editableTitle}
+                    onChangeText={setEditableTitle}
+                    autoFocus
+                    selectTextOnFocus
+                    maxLength={100}
+                    multiline={true}
+                    numberOfLines={3}
+                    blurOnSubmit={true}
+                  />
+                ) : (
+                  <Text style={styles.titleText}>{recording.title}</Text>
+                )}
+                {isEditingTitle ? (
+                  <View style={{flexDirection: 'row'}}>
+                    <TouchableOpacity
+                      style={{ padding: 5, marginRight: 10 }}
+                      onPress={() => handleToggleEditTitle(true)}
+                    >
+                      <Icon name="checkmark-circle-outline" size={28} color="#4CAF50" />
+                    </TouchableOpacity>
+                    <TouchableOpacity
+                      style={{ padding: 5 }}
+                      onPress={() => handleToggleEditTitle(false)}
+                    >
+                      <Icon name="close-circle-outline" size={28} color="#F44336" />
+                    </TouchableOpacity>
+                  </View>
+                ) : (
+                  <TouchableOpacity
+                    style={styles.editButton}
+                    onPress={() => handleToggleEditTitle()}
+                  >
+                    <Icon name="pencil" size={18} color="#8E8E93" />
+                  </TouchableOpacity>
+                )}
               </View>
-            ) : (
-              <TouchableOpacity
-                style={styles.editButton}
-                onPress={() => handleToggleEditTitle()}
-              >
-                <Icon name="pencil" size={18} color="#8E8E93" />
-              </TouchableOpacity>
-            )}
-          </View>
-          {!isEditingTitle && (
-            <Text style={styles.dateText}>{recording.date} · {recording.duration}</Text>
-          )}
-        </View>
-
-        <View style={styles.playerContainer}>
-          <Text style={styles.timeDisplayText}>
-            {formatTime(Math.floor(currentPosition / 1000))}
-          </Text>
-          
-          <View style={styles.progressContainer}>
-            <Slider
-              style={styles.progressBar}
-              minimumValue={0}
-              maximumValue={duration || 1}
-              value={currentPosition}
-              minimumTrackTintColor="#007AFF"
-              maximumTrackTintColor="#e0e0e0"
-              thumbTintColor="#007AFF"
-              onSlidingComplete={async (value) => {
-                try {
-                  await seekPlayback(value);
-                  setCurrentPosition(value);
-                } catch (error) {
-                  console.error('Error seeking:', error);
-                }
-              }}
-            />
-          </View>
+              {!isEditingTitle && (
+                <Text style={styles.dateText}>{recording.date} · {recording.duration}</Text>
+              )}
+            </View>
+
+            <View style={styles.playerContainer}>
+              <Text style={styles.timeDisplayText}>
+                {formatTime(Math.floor(currentPosition / 1000))}
+              </Text>
           
-          <View style={styles.controlsContainer}>
-            <TouchableOpacity 
-              style={styles.circularButton}
-              onPress={() => handleSeek('backward')}
-              disabled={!isPlayerActive}
-              activeOpacity={0.7}
-            >
-              <Image 
-                source={require('../icons/15-back.png')}
-                style={[styles.skipIcon, !isPlayerActive && styles.disabledIcon]}
-              />
-            </TouchableOpacity>
-            
-            <TouchableOpacity 
-              style={styles.playButton}
-              onPress={handlePlayPause}
-              activeOpacity={0.8}
-            >
-              <View style={styles.playButtonInner}>
-                <Icon 
-                  name={isPlaying ? "pause" : "play"} 
-                  size={28} 
-                  color="#777" 
+              <View style={styles.progressContainer}>
+                <Slider
+                  style={styles.progressBar}
+                  minimumValue={0}
+                  maximumValue={duration || 1}
+                  value={currentPosition}
+                  minimumTrackTintColor="#007AFF"
+                  maximumTrackTintColor="#e0e0e0"
+                  thumbTintColor="#007AFF"
+                  onSlidingComplete={async (value) => {
+                    try {
+                      await seekPlayback(value);
+                      setCurrentPosition(value);
+                    } catch (error) {
+                      console.error('Error seeking:', error);
+                    }
+                  }}
                 />
               </View>
-            </TouchableOpacity>
+          
+              <View style={styles.controlsContainer}>
+                <TouchableOpacity 
+                  style={styles.circularButton}
+                  onPress={() => handleSeek('backward')}
+                  disabled={!isPlayerActive}
+                  activeOpacity={0.7}
+                >
+                  <Image 
+                    source={require('../icons/15-back.png')}
+                    style={[styles.skipIcon, !isPlayerActive && styles.disabledIcon]}
+                  />
+                </TouchableOpacity>
             
-            <TouchableOpacity 
-              style={styles.circularButton}
-              onPress={() => handleSeek('forward')}
-              disabled={!isPlayerActive}
-              activeOpacity={0.7}
-            >
-              <Image 
-                source={require('../icons/15-forward.png')}
-                style={[styles.skipIcon, !isPlayerActive && styles.disabledIcon]}
-              />
-            </TouchableOpacity>
-          </View>
-        </View>
-
-        {renderProcessingStatus()}
-
-        {recording.summary && (
-          <View style={styles.sectionContainer}>
-            <TouchableOpacity style={styles.sectionHeader} onPress={toggleSummary}>
-              <Text style={styles.sectionTitle}>Summary</Text>
-              <View style={styles.sectionHeaderRight}>
-                <TouchableOpacity onPress={handleCopySummary} style={styles.iconButton}>
-                  <Icon name="copy-outline" size={20} color="#007AFF" />
+                <TouchableOpacity 
+                  style={styles.playButton}
+                  onPress={handlePlayPause}
+                  activeOpacity={0.8}
+                >
+                  <View style={styles.playButtonInner}>
+                    <Icon 
+                      name={isPlaying ? "pause" : "play"} 
+                      size={28} 
+                      color="#777" 
+                    />
+                  </View>
+                </TouchableOpacity>
+            
+                <TouchableOpacity 
+                  style={styles.circularButton}
+                  onPress={() => handleSeek('forward')}
+                  disabled={!isPlayerActive}
+                  activeOpacity={0.7}
+                >
+                  <Image 
+                    source={require('../icons/15-forward.png')}
+                    style={[styles.skipIcon, !isPlayerActive && styles.disabledIcon]}
+                  />
                 </TouchableOpacity>
-                <Icon name={summaryExpanded ? "chevron-up" : "chevron-down"} size={20} color="#8E8E93" />
               </View>
-            </TouchableOpacity>
-            {summaryExpanded && (
-              <View style={styles.summaryContainer}>
-                <RenderHtml 
-                  contentWidth={width}
-                  source={processedHtmlSource}
-                  tagsStyles={htmlTagsStyles}
-                  enableExperimentalMarginCollapsing={true}
-                />
+            </View>
+
+            {renderProcessingStatus()}
+
+            {recording.summary && (
+              <View style={styles.sectionContainer}>
+                <TouchableOpacity style={styles.sectionHeader} onPress={toggleSummary}>
+                  <Text style={styles.sectionTitle}>Summary</Text>
+                  <View style={styles.sectionHeaderRight}>
+                    <TouchableOpacity onPress={handleCopySummary} style={styles.iconButton}>
+                      <Icon name="copy-outline" size={20} color="#007AFF" />
+                    </TouchableOpacity>
+                    <Icon name={summaryExpanded ? "chevron-up" : "chevron-down"} size={20} color="#8E8E93" />
+                  </View>
+                </TouchableOpacity>
+                {summaryExpanded && (
+                  <View style={styles.summaryContainer}>
+                    <RenderHtml 
+                      contentWidth={width}
+                      source={processedHtmlSource}
+                      tagsStyles={htmlTagsStyles}
+                      enableExperimentalMarginCollapsing={true}
+                    />
+                  </View>
+                )}
               </View>
             )}
-          </View>
-        )}
-
-        {recording.transcript && (
-          <View style={styles.sectionContainer}>
-            <TouchableOpacity style={styles.sectionHeader} onPress={toggleTranscript}>
-              <Text style={styles.sectionTitle}>Transcript</Text>
-              <View style={styles.sectionHeaderRight}>
-                <TouchableOpacity onPress={handleCopyTranscript} style={styles.iconButton}>
-                  <Icon name="copy-outline" size={20} color="#007AFF" />
+
+            {recording.transcript && (
+              <View style={[styles.sectionContainer, transcriptExpanded && styles.sectionContainerOpen]}>
+                <TouchableOpacity style={styles.sectionHeader} onPress={toggleTranscript}>
+                  <Text style={styles.sectionTitle}>Transcript</Text>
+                  <View style={styles.sectionHeaderRight}>
+                    <TouchableOpacity onPress={handleCopyTranscript} style={styles.iconButton}>
+                      <Icon name="copy-outline" size={20} color="#007AFF" />
+                    </TouchableOpacity>
+                    <Icon name={transcriptExpanded ? "chevron-up" : "chevron-down"} size={20} color="#8E8E93" />
+                  </View>
                 </TouchableOpacity>
-                <Icon name={transcriptExpanded ? "chevron-up" : "chevron-down"} size={20} color="#8E8E93" />
-              </View>
-            </TouchableOpacity>
-            {transcriptExpanded && (
-              <View style={styles.transcriptContainer}>
-                <Text style={styles.transcriptText}>{recording.transcript}</Text>
               </View>
             )}
-          </View>
-        )}
-      </ScrollView>
+          </>}
+        />
       </SafeAreaView>
     </View>
   );
@@ -706,13 +876,31 @@ const styles = StyleSheet.create({
     fontSize: 18,
     fontWeight: '600',
   },
-  transcriptContainer: {
-    padding: 12,
+  sectionContainerOpen: {
+    marginBottom: 0,
+    borderBottomLeftRadius: 0,
+    borderBottomRightRadius: 0,
+  },
+  transcriptBlock: {
+    paddingHorizontal: 12,
+    paddingTop: 12,
+    backgroundColor: '#F2F2F7',
+  },
+  transcriptFooter: {
+    height: 12,
+    marginBottom: 20,
+    borderBottomLeftRadius: 8,
+    borderBottomRightRadius: 8,
+    backgroundColor: '#F2F2F7',
   },
   transcriptText: {
     fontSize: 16,
     lineHeight: 24,
   },
+  transcriptWordActive: {
+    backgroundColor: '#CCE4FF',
+    color: '#007AFF',
+  },
   summaryContainer: {
     padding: 12,
   },
@@ -11,6 +11,7 @@ import {
 } from 'react-native';
 import Icon from 'react-native-vector-icons/Ionicons';
 import { startRecording, stopRecording, pauseRecording, resumeRecording, setProgressCallback } from '../services/AudioRecordingService';
+import StorageManager from '../services/StorageManager';
 import { formatTime } from '../utils/TimeUtils';
 
 const RecordingScreen = ({ navigation }) => {
@@ -131,6 +132,15 @@ const RecordingScreen = ({ navigation }) => {
 
   const handleStartRecording = async () => {
     try {
+      // Make room first (old synced audio, leftover segments) rather than letting the recorder refuse to start
+      try {
+        const { satisfied, freeBytes } = await StorageManager.ensureFreeSpace();
+        if (!satisfied) {
+          console.warn(`[RecordingScreen] Only ${(freeBytes / 1048576).toFixed(0)} MB free after eviction`);
+        }
+      } catch (storageError) {
+        console.warn('[RecordingScreen] Could not check free space:', storageError);
+      }
       const id = await startRecording();
       setRecordingId(id);
       setIsRecording(true);
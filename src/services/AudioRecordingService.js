@@ -2,6 +2,8 @@ import { NativeModules, NativeEventEmitter, Platform, PermissionsAndroid } from
 import RNFS from 'react-native-fs';
 import { Recording } from '../utils/DataModels';
 import { formatTime } from '../utils/TimeUtils';
+import { loadSpeakerTimeline, rangesForSpeaker } from '../utils/SpeakerTimeline';
+import MetricsService from './MetricsService';
 
 
 const { AudioRecorderModule } = NativeModules;
@@ -22,6 +24,10 @@ let progressCallback = null;
 // Flag to enable mock recording mode for testing
 const USE_MOCK_RECORDING = false;
 
+// Native capture path: 'recorder' (AVAudioRecorder) or 'ring' (input tap -> ring
+// buffer -> writer thread; see getCaptureStats for its overrun counters)
+const CAPTURE_ENGINE = 'recorder';
+
 // Seamless playback/composition is now always enabled (feature flag removed)
 
 // Playback callback storage (only for composition path)
@@ -37,9 +43,8 @@ function getNowMs() {
   }
   return Date.now();
 }
-const logTimeToFirstAudio = (label, ms) => {
-  console.log(`[Metrics] ${label}: ${ms.toFixed(1)} ms`);
-  // TODO: send to analytics backend when available
+const recordTimeToFirstAudio = (ms) => {
+  MetricsService.record('playback.timeToFirstAudioMs', 'ms', ms);
 };
 
 // Initialize event listeners
@@ -81,19 +86,15 @@ const setupEventListeners = () => {
           const recordingsDir = await getRecordingsDirectory();
           const mergedPath = `${recordingsDir}/${data.recordingId || Date.now()}_merged.m4a`;
           console.log('[AudioRecordingService] Starting background export to', mergedPath);
-          AudioRecorderModule.exportCompositionToFile(currentSegmentPaths, mergedPath)
+          const segmentPaths = [...currentSegmentPaths];
+          AudioRecorderModule.exportCompositionToFile(segmentPaths, mergedPath)
             .then(async (outPath) => {
               console.log('[AudioRecordingService] Export completed:', outPath);
               try {
-                const recording = await getRecordingById(data.recordingId);
-                if (recording) {
-                  const updated = {
-                    ...recording,
-                    filePath: outPath,
-                    processingStatus: 'pending', // trigger downstream upload logic
-                  };
-                  await updateRecording(updated);
-                }
+                // Verifies the merge, points the recording at it and removes the segments
+                await commitMergedExport(data.recordingId, segmentPaths, outPath, {
+                  processingStatus: 'pending', // trigger downstream upload logic
+                });
               } catch (dbErr) {
                 console.error('[AudioRecordingService] Failed to persist merged path:', dbErr);
               }
@@ -246,7 +247,7 @@ const requestAndroidPermission = async () => {
 };
 
 // Save recording metadata initially when recording starts
-const saveInitialRecordingMetadata = async (recordingId, filePath, startTime) => {
+const saveInitialRecordingMetadata = (recordingId, filePath, startTime) => withRecordingsWriteLock(async () => {
   try {
     const recordings = await getRecordings();
     const newRecording = new Recording({
@@ -260,9 +261,7 @@ const saveInitialRecordingMetadata = async (recordingId, filePath, startTime) =>
     
     recordings.unshift(newRecording); // Add to the beginning
 
-    const recordingsJson = JSON.stringify(recordings, null, 2);
-    const recordingsDir = await getRecordingsDirectory();
-    await RNFS.writeFile(`${recordingsDir}/recordings.json`, recordingsJson, 'utf8');
+    await saveRecordings(recordings);
     console.log(`[AudioRecordingService] Saved initial metadata for recording_active ID: ${recordingId}`);
     return true;
   } catch (error) {
@@ -270,7 +269,7 @@ const saveInitialRecordingMetadata = async (recordingId, filePath, startTime) =>
     // Don't throw here, allow recording to potentially continue
     return false; 
   }
-};
+});
 
 // Set progress callback
 export const setProgressCallback = (callback) => {
@@ -328,7 +327,7 @@ export const startRecording = async () => {
     
     // Start recording using native module
     recordingStartTime = Date.now();
-    const result = await AudioRecorderModule.startRecording({});
+    const result = await AudioRecorderModule.startRecording({ captureEngine: CAPTURE_ENGINE });
     
     // Store the recording info
     currentRecordingId = result.recordingId;
@@ -404,6 +403,34 @@ export const resumeRecording = async () => {
   }
 };
 
+/**
+ * Ring capture engine stats for the segment being recorded (or the last one):
+ * ring capacity and high-water mark in frames, stall budget, overruns and
+ * dropped frames. Null with the AVAudioRecorder engine.
+ * @returns {Promise<Object|null>} - Stats from the native writer
+ */
+export const getCaptureStats = async () => {
+  if (USE_MOCK_RECORDING || !AudioRecorderModule.getCaptureStats) return null;
+  return AudioRecorderModule.getCaptureStats();
+};
+
+/**
+ * Starts native hot-path tracing (recorder, exports, transfers; see ios/ASTrace.h).
+ */
+export const startTrace = () => {
+  if (USE_MOCK_RECORDING || !AudioRecorderModule.startTrace) return;
+  AudioRecorderModule.startTrace();
+};
+
+/**
+ * Stops tracing and writes the trace as Chrome trace JSON, for Perfetto.
+ * @returns {Promise<string|null>} - Path of the trace file
+ */
+export const stopTrace = async () => {
+  if (USE_MOCK_RECORDING || !AudioRecorderModule.stopTrace) return null;
+  return AudioRecorderModule.stopTrace();
+};
+
 // Stop recording
 export const stopRecording = async () => {
   // Use local variables for the specific recording being stopped
@@ -506,6 +533,120 @@ export const stopRecording = async () => {
   }
 };
 
+// --- Recordings list index ---
+// recordings_index.json holds just the fields a list row needs, so the home
+// screen can show the library without parsing every transcript and summary in
+// recordings.json. It records the size and mtime of the recordings.json it was
+// built from; if that file was written by something else (e.g. native task
+// recovery), the index is rebuilt on the next read.
+const RECORDINGS_INDEX_VERSION = 1;
+let recordingsIndexCache = null; // { stamp, rows } of the last index read or written
+
+const toListRow = (recording) => ({
+  id: recording.id,
+  title: recording.title,
+  date: recording.date,
+  duration: recording.duration,
+  processingStatus: recording.processingStatus,
+  notebookLMStatus: recording.notebookLMStatus,
+  hasTranscript: Boolean(recording.transcript),
+  hasSummary: Boolean(recording.summary),
+});
+
+const statStamp = async (filePath) => {
+  const stats = await RNFS.stat(filePath);
+  return `${stats.size}:${new Date(stats.mtime).getTime()}`;
+};
+
+// `stamp` must be recordings.json's stamp for exactly these recordings: take it
+// under the write lock, after the write or before the read that produced them
+const writeRecordingsIndex = async (recordingsDir, recordings, stamp) => {
+  const rows = recordings.map(toListRow);
+  recordingsIndexCache = { stamp, rows };
+  await RNFS.writeFile(`${recordingsDir}/recordings_index.json`,
+    JSON.stringify({ version: RECORDINGS_INDEX_VERSION, stamp, rows }), 'utf8');
+  return recordingsIndexCache;
+};
+
+// recordings.json is read, changed and rewritten whole, so every such update
+// runs through this queue; otherwise two at once (parallel Drive syncs, a sync
+// finishing while processing saves a summary) each write back their own copy
+// and the later one silently drops the other's change. Writers outside this
+// module (the native task reconciliation) run through it too; an update must
+// not call another locked function, or it waits on itself
+let recordingsWriteQueue = Promise.resolve();
+export const withRecordingsWriteLock = (update) => {
+  const run = recordingsWriteQueue.then(update, update);
+  recordingsWriteQueue = run.catch(() => {});
+  return run;
+};
+
+// Write recordings.json and the list index that mirrors it
+const saveRecordings = async (recordings) => {
+  const recordingsDir = await getRecordingsDirectory();
+  const recordingsFile = `${recordingsDir}/recordings.json`;
+  await RNFS.writeFile(recordingsFile, JSON.stringify(recordings, null, 2), 'utf8');
+  try {
+    await writeRecordingsIndex(recordingsDir, recordings, await statStamp(recordingsFile));
+  } catch (error) {
+    // A missing or stale index is rebuilt on the next read
+    console.error('[AudioRecordingService] Failed to write recordings index:', error);
+    recordingsIndexCache = null;
+  }
+};
+
+const loadRecordingsIndex = async () => {
+  const recordingsDir = await getRecordingsDirectory();
+  const recordingsFile = `${recordingsDir}/recordings.json`;
+  if (!(await RNFS.exists(recordingsFile))) {
+    return { stamp: null, rows: [] };
+  }
+  const stamp = await statStamp(recordingsFile);
+  if (recordingsIndexCache?.stamp === stamp) {
+    return recordingsIndexCache;
+  }
+
+  const indexFile = `${recordingsDir}/recordings_index.json`;
+  try {
+    if (await RNFS.exists(indexFile)) {
+      const saved = JSON.parse(await RNFS.readFile(indexFile, 'utf8'));
+      if (saved.version === RECORDINGS_INDEX_VERSION && saved.stamp === stamp) {
+        recordingsIndexCache = { stamp, rows: saved.rows };
+        return recordingsIndexCache;
+      }
+    }
+  } catch (error) {
+    console.warn('[AudioRecordingService] Unreadable recordings index, rebuilding:', error);
+  }
+
+  // Under the write lock, so no save lands between reading the rows and
+  // stamping them; a save made while this waited leaves a current index behind
+  return withRecordingsWriteLock(async () => {
+    const current = await statStamp(recordingsFile);
+    if (recordingsIndexCache?.stamp === current) {
+      return recordingsIndexCache;
+    }
+    console.log('[AudioRecordingService] Rebuilding recordings index');
+    return writeRecordingsIndex(recordingsDir, await getRecordings(), current);
+  });
+};
+
+/**
+ * Get one page of list rows (id, title, date, duration, status) without loading
+ * transcripts or summaries; use getRecordingById for the full recording.
+ * @param {Object} options - { offset, limit }
+ * @returns {Promise<Object>} - { items, total, version } where version changes whenever recordings.json does
+ */
+export const getRecordingSummaries = async ({ offset = 0, limit = Infinity } = {}) => {
+  try {
+    const { stamp, rows } = await loadRecordingsIndex();
+    return { items: rows.slice(offset, offset + limit), total: rows.length, version: stamp };
+  } catch (error) {
+    console.error('Error getting recording summaries:', error);
+    return { items: [], total: 0, version: null };
+  }
+};
+
 // Get all recordings
 export const getRecordings = async () => {
   try {
@@ -560,7 +701,7 @@ export const getRecordingById = async (id) => {
 };
 
 // Update recording data
-export const updateRecording = async (updatedRecording) => {
+export const updateRecording = (updatedRecording) => withRecordingsWriteLock(async () => {
   try {
     console.log(`[AudioRecordingService] Attempting to update recording ID: ${updatedRecording.id} with data:`, JSON.stringify(updatedRecording, null, 2)); // Log data being saved
     
@@ -583,11 +724,8 @@ export const updateRecording = async (updatedRecording) => {
     }
     
     // Save to storage
-    const recordingsJson = JSON.stringify(updatedRecordings, null, 2); // Pretty print JSON for readability
-    const recordingsDir = await getRecordingsDirectory();
-    const filePath = `${recordingsDir}/recordings.json`;
-    console.log(`[AudioRecordingService] Writing updated recordings list to: ${filePath}`);
-    await RNFS.writeFile(filePath, recordingsJson, 'utf8');
+    console.log('[AudioRecordingService] Writing updated recordings list');
+    await saveRecordings(updatedRecordings);
     console.log(`[AudioRecordingService] Successfully updated recordings.json for ID: ${updatedRecording.id}`);
     
     // Add logging to check summary data
@@ -601,10 +739,59 @@ export const updateRecording = async (updatedRecording) => {
     console.error(`[AudioRecordingService] Error updating recording ID: ${updatedRecording?.id}:`, error);
     throw error;
   }
+});
+
+/**
+ * Set some fields of a recording on its current stored copy, leaving every
+ * other field as it is now (not as it was when the caller read it). Use this
+ * when the change was worked out over a long operation such as an upload.
+ * @param {string} id - Recording id
+ * @param {Object} fields - Fields to set
+ * @returns {Promise<boolean>} - False if the recording no longer exists
+ */
+export const updateRecordingFields = (id, fields) => withRecordingsWriteLock(async () => {
+  const recordings = await getRecordings();
+  const index = recordings.findIndex(recording => recording.id === id);
+  if (index === -1) {
+    console.warn(`[AudioRecordingService] Recording ${id} was deleted; not saving its fields`);
+    return false;
+  }
+  recordings[index] = { ...recordings[index], ...fields };
+  await saveRecordings(recordings);
+  return true;
+});
+
+// Path of the recordings store (native code reads and rewrites it during task recovery)
+export const getRecordingsFilePath = async () => {
+  const recordingsDir = await getRecordingsDirectory();
+  return `${recordingsDir}/recordings.json`;
 };
 
+// Update several recordings with a single read and write of recordings.json;
+// each change (with its id) is merged into the stored recording, so it may
+// carry only the fields it sets
+export const updateRecordings = (changedRecordings) => withRecordingsWriteLock(async () => {
+  if (changedRecordings.length === 0) {
+    return true;
+  }
+  try {
+    const changesById = new Map(changedRecordings.map(recording => [recording.id, recording]));
+    const recordings = await getRecordings();
+    const updatedRecordings = recordings.map(recording => (
+      changesById.has(recording.id) ? { ...recording, ...changesById.get(recording.id) } : recording
+    ));
+
+    await saveRecordings(updatedRecordings);
+    console.log(`[AudioRecordingService] Updated ${changesById.size} recordings in one write`);
+    return true;
+  } catch (error) {
+    console.error('[AudioRecordingService] Error updating recordings:', error);
+    throw error;
+  }
+});
+
 // Delete recording
-export const deleteRecording = async (id) => {
+export const deleteRecording = (id) => withRecordingsWriteLock(async () => {
   try {
     // Get existing recordings
     const recordings = await getRecordings();
@@ -635,19 +822,291 @@ export const deleteRecording = async (id) => {
       }
     }
     
+    // Delete sidecar files (alignment index, speaker timeline, Drive chunk manifests)
+    const sidecarPaths = [
+      recordingToDelete.alignmentPath,
+      recordingToDelete.speakerTimelinePath,
+      recordingToDelete.googleDriveSync?.manifestPath,
+    ];
+    for (const sidecarPath of sidecarPaths) {
+      if (sidecarPath) {
+        const exists = await RNFS.exists(sidecarPath);
+        if (exists) {
+          await RNFS.unlink(sidecarPath);
+        }
+      }
+    }
+    
+    // Delete per-speaker extracts; the recording does not list them, so find them by name
+    const recordingsDir = await getRecordingsDirectory();
+    const extractPrefix = `${id}_speaker_`;
+    const entries = await RNFS.readDir(recordingsDir);
+    for (const entry of entries) {
+      if (entry.name.startsWith(extractPrefix) && entry.name.endsWith('.m4a')) {
+        await RNFS.unlink(entry.path);
+      }
+    }
+    
     // Remove from list
     const updatedRecordings = recordings.filter(recording => recording.id !== id);
     
     // Save to storage
-    const recordingsJson = JSON.stringify(updatedRecordings);
-    const recordingsDir = await getRecordingsDirectory();
-    await RNFS.writeFile(`${recordingsDir}/recordings.json`, recordingsJson, 'utf8');
+    await saveRecordings(updatedRecordings);
     
     return true;
   } catch (error) {
     console.error('Error deleting recording:', error);
     throw error;
   }
+});
+
+// --- Verified merge commit ---
+// Once the segments are merged, they are deleted only after the native side has
+// confirmed the merged file holds the same audio (matching packet hash, or
+// matching decoded frame count for a re-encoded merge). A journal file written
+// before anything changes makes the commit crash-safe: pointing the recording at
+// the merged file is the commit point, the segments go after it, and the
+// journal last. recoverMergeJournals() finishes or abandons a commit that was
+// interrupted, so a crash can leave extra files behind but never lose audio.
+const MERGE_JOURNAL_SUFFIX = '_merge.json';
+
+const writeMergeJournal = async (journalPath, entry) => {
+  // Written beside the final name and moved into place, so a journal is never half-written
+  const tempPath = `${journalPath}.tmp`;
+  await RNFS.writeFile(tempPath, JSON.stringify(entry), 'utf8');
+  if (await RNFS.exists(journalPath)) {
+    await RNFS.unlink(journalPath);
+  }
+  await RNFS.moveFile(tempPath, journalPath);
+};
+
+const removeFiles = async (paths) => {
+  for (const filePath of paths) {
+    if (filePath && await RNFS.exists(filePath)) {
+      await RNFS.unlink(filePath);
+    }
+  }
+};
+
+// Commit point and cleanup for a set of journaled merges: one recordings.json
+// write points every recording at its merged file, then segments and journals go.
+// Each merge is decided against the stored recording under the write lock and
+// only the audio fields are written, so changes saved since the journals were
+// written are kept. A recording deleted meanwhile, or no longer on these
+// segments (archived, say), is left alone and its journal dropped; a merged file
+// nothing points at is reclaimed by StorageManager.
+// @returns {Promise<Array<Object>>} - The journaled merges that were applied
+const applyMergeJournals = async (journaled, extraFields = {}) => {
+  const applied = await withRecordingsWriteLock(async () => {
+    const recordings = await getRecordings();
+    const indexById = new Map(recordings.map((recording, index) => [recording.id, index]));
+    const current = [];
+    let changed = false;
+    for (const item of journaled) {
+      const { entry } = item;
+      const index = indexById.get(entry.recordingId);
+      const stored = index === undefined ? null : recordings[index];
+      if (!stored || (stored.filePath !== entry.mergedPath && !entry.segmentPaths.includes(stored.filePath))) {
+        continue;
+      }
+      if (stored.filePath !== entry.mergedPath) {
+        recordings[index] = { ...stored, filePath: entry.mergedPath, segmentPaths: [entry.mergedPath], ...extraFields };
+        changed = true;
+      }
+      current.push(item);
+    }
+    if (changed) {
+      await saveRecordings(recordings);
+    }
+    return current;
+  });
+  for (const item of journaled) {
+    const { journalPath, entry } = item;
+    if (applied.includes(item)) {
+      await removeFiles(entry.segmentPaths.filter(segmentPath => segmentPath !== entry.mergedPath));
+    } else {
+      console.warn(`[AudioRecordingService] Recording ${entry.recordingId} changed before its merge was committed; leaving its files`);
+    }
+    await RNFS.unlink(journalPath);
+  }
+  return applied;
+};
+
+/**
+ * Replace recordings' segments with their merged exports, for each merge that
+ * checks out. A merge that does not is left alone: the recording keeps its segments.
+ * @param {Array<Object>} merges - { recordingId, segmentPaths (in order), mergedPath }
+ * @param {Object} fields - Other recording fields to set in the same write
+ * @returns {Promise<Array<Object>>} - Per merge: { recordingId, committed, method, verifyMs, freedBytes }
+ */
+export const commitMergedExports = async (merges, fields = {}) => {
+  const results = [];
+  const verifiedMerges = [];
+  for (const merge of merges) {
+    const verification = await AudioRecorderModule.verifyMergedExport(merge.segmentPaths, merge.mergedPath);
+    const result = { recordingId: merge.recordingId, committed: false, method: verification.method, verifyMs: verification.elapsedMs, freedBytes: 0 };
+    results.push(result);
+    if (verification.verified) {
+      verifiedMerges.push({ merge, result });
+    } else {
+      console.error(`[AudioRecordingService] Merged file for ${merge.recordingId} does not match its segments (${verification.mergedFrames}/${verification.segmentFrames} frames, ${verification.method} similarity ${verification.similarity ?? 'n/a'}); keeping the segments`);
+    }
+  }
+  if (verifiedMerges.length === 0) {
+    return results;
+  }
+
+  const recordingsById = new Map((await getRecordings()).map(recording => [recording.id, recording]));
+  const recordingsDir = await getRecordingsDirectory();
+  const journaled = [];
+  for (const { merge, result } of verifiedMerges) {
+    const { recordingId, segmentPaths, mergedPath } = merge;
+    if (!recordingsById.has(recordingId)) {
+      // Deleted while the export ran
+      await removeFiles([mergedPath, ...segmentPaths]);
+      continue;
+    }
+    let freedBytes = 0;
+    for (const segmentPath of segmentPaths) {
+      if (segmentPath !== mergedPath && await RNFS.exists(segmentPath)) {
+        freedBytes += Number((await RNFS.stat(segmentPath)).size) || 0;
+      }
+    }
+    const journalPath = `${recordingsDir}/${recordingId}${MERGE_JOURNAL_SUFFIX}`;
+    const entry = {
+      recordingId,
+      mergedPath,
+      mergedSize: Number((await RNFS.stat(mergedPath)).size),
+      segmentPaths,
+      method: result.method,
+      verifiedAt: new Date().toISOString(),
+    };
+    await writeMergeJournal(journalPath, entry);
+    journaled.push({ journalPath, entry, result, freedBytes });
+  }
+  const applied = await applyMergeJournals(journaled, fields);
+  applied.forEach(({ result, freedBytes }) => {
+    result.committed = true;
+    result.freedBytes = freedBytes;
+  });
+
+  // Playback of this session's recording must not reach for the deleted segments
+  if (applied.some(({ entry }) => entry.segmentPaths.some(segmentPath => currentSegmentPaths.includes(segmentPath)))) {
+    currentSegmentPaths = [];
+  }
+  results.filter(result => result.committed).forEach((result) => {
+    MetricsService.record('merge.commitVerifyMs', 'ms', result.verifyMs);
+    MetricsService.count(`merge.commits.${result.method}`);
+    MetricsService.count('merge.freedBytes', result.freedBytes);
+  });
+  return results;
+};
+
+// A single merge, as the export listener does it
+export const commitMergedExport = async (recordingId, segmentPaths, mergedPath, fields = {}) => {
+  const [result] = await commitMergedExports([{ recordingId, segmentPaths, mergedPath }], fields);
+  return result;
+};
+
+/**
+ * Finish or abandon merge commits interrupted by a crash (run once at startup).
+ * Committed ones (recording already points at the merged file) finish deleting
+ * their segments; uncommitted ones roll forward if the verified merged file is
+ * intact, and otherwise are dropped with the segments left in place.
+ * @returns {Promise<Object>} - { journals, completed, rolledForward, abandoned }
+ */
+export const recoverMergeJournals = async () => {
+  const summary = { journals: 0, completed: 0, rolledForward: 0, abandoned: 0 };
+  try {
+    const recordingsDir = await getRecordingsDirectory();
+    const journals = (await RNFS.readDir(recordingsDir)).filter(item => item.name.endsWith(MERGE_JOURNAL_SUFFIX));
+    summary.journals = journals.length;
+    if (journals.length === 0) {
+      return summary;
+    }
+    const recordingsById = new Map((await getRecordings()).map(recording => [recording.id, recording]));
+
+    const journaled = [];
+    for (const journal of journals) {
+      try {
+        const entry = JSON.parse(await RNFS.readFile(journal.path, 'utf8'));
+        const recording = recordingsById.get(entry.recordingId);
+        const mergedIntact = await RNFS.exists(entry.mergedPath)
+          && Number((await RNFS.stat(entry.mergedPath)).size) === entry.mergedSize;
+
+        if (recording && mergedIntact) {
+          if (recording.filePath === entry.mergedPath) {
+            summary.completed++;
+          } else {
+            summary.rolledForward++;
+          }
+          journaled.push({ journalPath: journal.path, entry });
+          continue;
+        }
+        // Recording deleted, or the merged file is not the one that was verified
+        if (recording?.filePath === entry.mergedPath) {
+          const segmentsLeft = await Promise.all(entry.segmentPaths.map(segmentPath => RNFS.exists(segmentPath)));
+          if (segmentsLeft.every(Boolean)) {
+            // Nothing was deleted yet: point the recording back at its segments
+            await updateRecordingFields(recording.id, { filePath: entry.segmentPaths[0], segmentPaths: entry.segmentPaths });
+          } else {
+            console.error(`[AudioRecordingService] Merged file for ${entry.recordingId} changed after its commit`);
+          }
+        }
+        summary.abandoned++;
+        await RNFS.unlink(journal.path);
+      } catch (error) {
+        console.error(`[AudioRecordingService] Failed to recover merge journal ${journal.name}:`, error);
+      }
+    }
+    await applyMergeJournals(journaled);
+    console.log(`[AudioRecordingService] Merge journals: ${summary.completed} completed, ${summary.rolledForward} rolled forward, ${summary.abandoned} abandoned`);
+  } catch (error) {
+    console.error('[AudioRecordingService] Error recovering merge journals:', error);
+  }
+  return summary;
+};
+
+/**
+ * Write an audio file containing only one speaker's turns (e.g. teacher-only).
+ * Uses passthrough export on the native side, so AAC frames are copied rather
+ * than re-encoded.
+ * @param {string} id - Recording id
+ * @param {string} speakerId - Speaker to keep; defaults to the speaker with the most talk time
+ * @returns {Promise<Object>} - { outputPath, duration, speakerId }
+ */
+export const extractSpeakerAudio = async (id, speakerId = null) => {
+  const recording = await getRecordingById(id);
+  if (!recording?.filePath) {
+    throw new Error('Recording not found');
+  }
+  const timeline = await loadSpeakerTimeline(recording.speakerTimelinePath);
+  if (!timeline) {
+    throw new Error('No speaker timeline available for this recording');
+  }
+
+  const targetSpeaker = speakerId || timeline.speakers[0]?.speakerId;
+  const ranges = rangesForSpeaker(timeline, targetSpeaker);
+  if (ranges.length === 0) {
+    throw new Error(`No audio found for speaker ${targetSpeaker}`);
+  }
+
+  // Until the merge commits, filePath is only the first segment; cut from all of them
+  const segmentPaths = recording.segmentPaths || [];
+  const sourcePaths = segmentPaths.length > 1 && segmentPaths.includes(recording.filePath)
+    ? segmentPaths
+    : [recording.filePath];
+  const recordingsDir = await getRecordingsDirectory();
+  // Named `<id>_speaker_<n>.m4a` so deleteRecording and StorageManager find it
+  const extractName = targetSpeaker.startsWith('speaker_') ? targetSpeaker : `speaker_${targetSpeaker}`;
+  const outputPath = `${recordingsDir}/${id}_${extractName}.m4a`;
+  const result = await AudioRecorderModule.extractTimeRanges(
+    sourcePaths,
+    ranges.map(range => ({ start: range.startMs / 1000, end: range.endMs / 1000 })),
+    outputPath
+  );
+  console.log(`[AudioRecordingService] Extracted ${ranges.length} ranges for ${targetSpeaker}:`, result);
+  return { ...result, speakerId: targetSpeaker };
 };
 
 // --- PLAYBACK FUNCTIONS ---
@@ -668,8 +1127,30 @@ const playbackState = {
   usingComposition: false,
 };
 
-// Play recording
-export const playRecording = async (filePath, onProgress, onFinished) => {
+/**
+ * Warms the native playback cache for a recording about to be played: parses
+ * its segments and builds their composition in the background, so the play
+ * that follows skips that work.
+ * @param {string[]} segmentPaths - The recording's audio files, in order
+ */
+export const prefetchPlayback = (segmentPaths) => {
+  if (USE_MOCK_RECORDING || !segmentPaths?.length || !AudioRecorderModule.prefetchPlayback) return;
+  AudioRecorderModule.prefetchPlayback(segmentPaths);
+};
+
+/**
+ * Hit, miss and eviction counts of the native playback cache, for the segment
+ * assets and for the compositions built from them.
+ * @returns {Promise<Object|null>} - { assets, compositions }
+ */
+export const getPlaybackCacheStats = async () => {
+  if (USE_MOCK_RECORDING || !AudioRecorderModule.getPlaybackCacheStats) return null;
+  return AudioRecorderModule.getPlaybackCacheStats();
+};
+
+// Play recording. segmentPaths (the recording's files in order) plays through
+// the native composition player, which shares parsed segments between players.
+export const playRecording = async (filePath, onProgress, onFinished, segmentPaths = null) => {
   if (!filePath) {
     console.error('[AudioRecordingService] playRecording called with null or undefined filePath.');
     if (onFinished) onFinished('Error: Invalid file path');
@@ -697,8 +1178,9 @@ export const playRecording = async (filePath, onProgress, onFinished) => {
 
   playbackStartTs = getNowMs(); // mark start for TTF-audio
 
-  // Handle new composition playback
-  if (currentSegmentPaths && currentSegmentPaths.length > 0) {
+  // Handle new composition playback: the session just recorded, else the recording's own files
+  const compositionPaths = currentSegmentPaths.length > 0 ? currentSegmentPaths : segmentPaths;
+  if (compositionPaths && compositionPaths.length > 0) {
     try {
       // Ensure any existing playback stopped
       if (playbackState.isPlaying || playbackState.isPaused) {
@@ -708,7 +1190,7 @@ export const playRecording = async (filePath, onProgress, onFinished) => {
       // Configure native session
       await AudioRecorderModule.configureSessionForPlayback();
 
-      const playerId = await AudioRecorderModule.createPlaybackItem(currentSegmentPaths);
+      const playerId = await AudioRecorderModule.createPlaybackItem(compositionPaths);
 
       playbackState.playerId = playerId;
       playbackState.usingComposition = true;
@@ -773,7 +1255,7 @@ export const playRecording = async (filePath, onProgress, onFinished) => {
   audioRecorderPlayer.addPlayBackListener((e) => {
     if (playbackStartTs != null) {
       const ttf = getNowMs() - playbackStartTs;
-      logTimeToFirstAudio('time_to_first_audio', ttf);
+      recordTimeToFirstAudio(ttf);
       playbackStartTs = null; // ensure only logged once
     }
     if (onProgress) {
@@ -1,18 +1,27 @@
 import { NativeModules, NativeEventEmitter } from 'react-native';
 import { getRecordingById, updateRecording } from './AudioRecordingService'; // Ensure getRecordingById is exported/imported
 // Remove unused import: import { startSummarizationProcess } from './SummarizationService'; 
-import { cleanMarkdownText } from './SummarizationService'; // Import cleaner function
-import { ELEVENLABS_API_KEY, OPENAI_API_KEY } from '@env';
+import { cleanMarkdownText, joinPartSummaries, mergeSummaryRevision, planSummaryRevision, NO_SUMMARY_CHANGES } from './SummarizationService'; // Import cleaner function
+import { buildAlignmentIndex, saveAlignmentIndex, loadAlignmentIndex } from '../utils/TranscriptAlignment';
+import { buildSpeakerTimeline, saveSpeakerTimeline, loadSpeakerTimeline } from '../utils/SpeakerTimeline';
+import { estimateTokens, planSummaryParts, MERGE_INPUT_TOKENS } from '../utils/SummaryChunks';
+import {
+  ELEVENLABS_API_KEY,
+  OPENAI_API_KEY,
+  ELEVENLABS_API_URL as ENV_ELEVENLABS_API_URL,
+  OPENAI_RESPONSES_API_URL as ENV_OPENAI_RESPONSES_API_URL,
+} from '@env';
 import RNFS from 'react-native-fs'; // Import RNFS for file system operations
+import MetricsService from './MetricsService';
 
 const { BackgroundTransferManager, AudioRecorderModule } = NativeModules;
 const transferEmitter = new NativeEventEmitter(BackgroundTransferManager);
 
 // --- Constants for OpenAI & ElevenLabs ---
-// API endpoints
-const ELEVENLABS_API_URL = 'https://api.elevenlabs.io/v1/speech-to-text'; // ElevenLabs Speech-to-Text API
+// API endpoints; either can be set in .env to point at a local stand-in (scripts/mockAIServer.js)
+const ELEVENLABS_API_URL = ENV_ELEVENLABS_API_URL || 'https://api.elevenlabs.io/v1/speech-to-text'; // ElevenLabs Speech-to-Text API
 // Shared Responses API endpoint for both summary and title generation
-const OPENAI_RESPONSES_API_URL = 'https://api.openai.com/v1/responses';
+const OPENAI_RESPONSES_API_URL = ENV_OPENAI_RESPONSES_API_URL || 'https://api.openai.com/v1/responses';
 
 // --- Title Generation Constants ---
 // Instructions to produce a concise, single-line recording title from a recording summary
@@ -58,11 +67,63 @@ const SUMMARY_INSTRUCTIONS = `You are a renowned expert in violin pedagogy. Your
 
 # Here is the transcript:`; // Your detailed instructions
 
+// Revision pass after parts of the transcript changed (see planSummaryRevision)
+const SUMMARY_REVISION_INSTRUCTIONS = `You are a renowned expert in violin pedagogy. You wrote the summary below from a transcript of a violin lesson. Parts of that transcript have since been corrected; you are given the corrected passages, each with the wording it replaced.
+
+- Output ONLY the sections of the summary that must change because of the corrections, each one complete and starting with its exact heading line from the current summary.
+- If a correction adds material that no section covers, add a new section with a new heading.
+- Leave out every section that does not change; they are kept as they are.
+- Keep the style, structure and Markdown heading syntax of the current summary. Do not bold the headings.
+- If no section needs to change, output exactly ${NO_SUMMARY_CHANGES}.
+
+**Present your final output entirely within a properly formatted Markdown code block.**`;
+
+// Long lessons are summarized in parallel parts (see planSummaryParts), then merged
+const SUMMARY_PART_NOTE = `This transcript is one part of a longer violin lesson; its first sentences may repeat the end of the previous part. Summarize only this part. The summaries of all parts will be merged afterwards, so do not add an introduction or a conclusion.`;
+
+const SUMMARY_REDUCE_INSTRUCTIONS = `You are a renowned expert in violin pedagogy. A long violin lesson was split into consecutive parts, and each part was summarized on its own; neighbouring parts overlap by a few sentences. Merge the part summaries below into one meticulously structured and detailed guide to the whole lesson:
+
+- Keep every piece of advice, exercise, metaphor, quote and specific reference (e.g., "Bar 50") from the parts. Drop only repetitions, including those caused by the overlap.
+- Bring material on the same piece or topic together under one section, even when it came up in several parts, in the order the lesson first reached it.
+- Title: Plain, clear title that states the main topic/piece which worked on.
+- Use Markdown heading syntax (# for the title, ## for primary sections, ### for subsections). Do not bold the headings.
+- Do not mention the parts or the merge.
+
+**Present your final output entirely within a properly formatted Markdown code block.**`;
+
+// Static fields of each Responses API request. The native module keeps them
+// serialized after the first request of a launch; later requests carry only the
+// template id and their input, which is streamed into the body (see ASJSONBody.h).
+const RESPONSES_TEMPLATES = {
+  summary: { model: 'gpt-4o', instructions: SUMMARY_INSTRUCTIONS, temperature: 0.25, store: false },
+  summaryRevision: { model: 'gpt-4o', instructions: SUMMARY_REVISION_INSTRUCTIONS, temperature: 0.25, store: false },
+  summaryPart: { model: 'gpt-4o', instructions: `${SUMMARY_PART_NOTE}\n\n${SUMMARY_INSTRUCTIONS}`, temperature: 0.25, store: false },
+  summaryMerge: { model: 'gpt-4o', instructions: SUMMARY_REDUCE_INSTRUCTIONS, temperature: 0.25, store: false },
+  title: { model: 'gpt-4.1-mini', instructions: TITLE_INSTRUCTIONS, temperature: 0.2, store: false },
+};
+
+// Hosts that accept gzipped request bodies (Content-Encoding: gzip). The
+// Responses API does not document it, so api.openai.com is not listed; a
+// proxy in front of it that inflates requests can be.
+const GZIP_REQUEST_HOSTS = [];
+
+const hostOf = url => (/^https?:\/\/([^/?#]+)/.exec(url) || [])[1];
+
 class BackgroundTransferService {
   constructor() {
+    this.sentBodyTemplates = new Set();
+    // Part bookkeeping on the recording is read-modify-write; completions can arrive together
+    this.summaryPartChain = Promise.resolve();
     this.setupEventListeners();
   }
 
+  // Run fn after every earlier call has settled
+  serializeSummaryParts(fn) {
+    const run = this.summaryPartChain.then(fn);
+    this.summaryPartChain = run.catch(() => {});
+    return run;
+  }
+
   setupEventListeners() {
     transferEmitter.addListener('onTransferComplete', async (event) => {
       console.log('[DEBUG] onTransferComplete raw event:', JSON.stringify(event));
@@ -73,7 +134,7 @@ class BackgroundTransferService {
         if (taskType === 'transcription') {
           await this.handleTranscriptionComplete(recordingId, response);
         } else if (taskType === 'summarization') {
-          await this.handleSummarizationComplete(recordingId, response);
+          await this.handleSummarizationComplete(recordingId, response, taskId);
         } else if (taskType === 'titleGeneration') {
           await this.handleTitleGenerationComplete(recordingId, response);
         }
@@ -149,39 +210,39 @@ class BackgroundTransferService {
     }
   }
 
-  async startSummarizationUpload(recording) {
+  // previousTranscript: the transcript the current summary was written from, when
+  // re-transcribing; a small change is then re-summarized from the changed passages only
+  async startSummarizationUpload(recording, { previousTranscript = null } = {}) {
     if (!recording.transcript) {
         await this.handleTransferError(null, 'summarization', recording.id, 'Missing transcript');
         throw new Error('Missing transcript for summarization');
     }
 
     try {
-      const processingRecording = { ...recording, processingStatus: 'processing' };
-      await updateRecording(processingRecording);
+      const revision = previousTranscript ? planSummaryRevision(recording, previousTranscript) : null;
+      if (revision?.unchanged) {
+        // Same words as before: the summary and title still hold
+        console.log(`[BackgroundTransferService] Transcript unchanged for ${recording.id}, keeping summary`);
+        await updateRecording({ ...recording, summaryRevisionPending: false, summaryParts: null, processingStatus: 'complete' });
+        return null;
+      }
 
-      // Prepare request body for OpenAI Chat Completions
-      const requestBody = {
-        model: "gpt-4o", // User confirmed model
-        instructions: SUMMARY_INSTRUCTIONS, // Use instructions field
-        input: recording.transcript, // Use input field for the transcript
-        temperature: 0.25, // Reinstate temperature
-        store: false, // Optionally disable storage
-        // max_output_tokens: 6000, // Optional, leave out for now
-      };
+      if (!revision) {
+        const plan = await this.planSummaryParts(recording);
+        if (plan) {
+          return await this.startSummaryPartUploads(recording, plan);
+        }
+      }
 
-      const taskId = await BackgroundTransferManager.startUploadTask({ 
-        apiUrl: OPENAI_RESPONSES_API_URL, // Use Responses API endpoint
-        headers: {
-          'Authorization': `Bearer ${OPENAI_API_KEY}`, 
-          'Content-Type': 'application/json', 
-        },
-        body: JSON.stringify(requestBody), 
-        taskType: 'summarization',
-        metadata: { recordingId: recording.id }, 
-        filePath: null 
+      const processingRecording = { ...recording, summaryRevisionPending: !!revision, summaryParts: null, processingStatus: 'processing' };
+      await updateRecording(processingRecording);
+
+      const taskId = await BackgroundTransferManager.startUploadTask({
+        ...this.responsesTask('summarization', revision ? 'summaryRevision' : 'summary', revision ? revision.input : recording.transcript),
+        metadata: { recordingId: recording.id },
       });
 
-      console.log('Started summarization (Responses API) upload task:', taskId, 'for recording:', recording.id);
+      console.log(`Started ${revision ? 'summary revision' : 'summarization'} (Responses API) upload task:`, taskId, 'for recording:', recording.id);
       return taskId;
     } catch (error) {
       console.error('Error starting summarization (Responses API) upload:', error);
@@ -190,6 +251,91 @@ class BackgroundTransferService {
     }
   }
 
+  // Parts for a transcript too long for one request, cut at speaker turns when the timings are on disk
+  async planSummaryParts(recording) {
+    const [alignmentIndex, timeline] = await Promise.all([
+      recording.alignmentPath ? loadAlignmentIndex(recording.alignmentPath) : null,
+      recording.speakerTimelinePath ? loadSpeakerTimeline(recording.speakerTimelinePath) : null,
+    ]);
+    const plan = planSummaryParts(recording.transcript, { alignmentIndex, timeline });
+    if (plan) {
+      MetricsService.record('summary.parts', 'parts', plan.parts.length);
+      MetricsService.record('summary.largestPartTokens', 'tokens', Math.max(...plan.parts.map(part => part.tokens)));
+    }
+    return plan;
+  }
+
+  // A Responses API upload task; the template's fields are sent only the first time this launch
+  responsesTask(taskType, templateId, input) {
+    // cache: the same request answered before is served from the native result cache
+    const jsonBody = { templateId, field: 'input', value: input, cache: true };
+    if (!this.sentBodyTemplates.has(templateId)) {
+      // Native calls run in order, so later tasks in the same tick find the template cached
+      jsonBody.template = RESPONSES_TEMPLATES[templateId];
+      this.sentBodyTemplates.add(templateId);
+    }
+    if (GZIP_REQUEST_HOSTS.includes(hostOf(OPENAI_RESPONSES_API_URL))) {
+      jsonBody.contentEncoding = 'gzip';
+    }
+    return {
+      apiUrl: OPENAI_RESPONSES_API_URL,
+      headers: {
+        'Authorization': `Bearer ${OPENAI_API_KEY}`,
+        'Content-Type': 'application/json',
+      },
+      jsonBody,
+      taskType, // the native module only relays known task types
+      filePath: null,
+    };
+  }
+
+  // Map step: every part is its own background task, all in flight at once
+  async startSummaryPartUploads(recording, plan) {
+    return this.serializeSummaryParts(async () => {
+      const summaryParts = { taskIds: [], summaries: plan.parts.map(() => null), reduceTaskId: null };
+      await updateRecording({ ...recording, summaryRevisionPending: false, summaryParts, processingStatus: 'processing' });
+
+      const taskIds = await Promise.all(plan.parts.map(part => BackgroundTransferManager.startUploadTask({
+        ...this.responsesTask('summarization', 'summaryPart', recording.transcript.substring(part.start, part.end)),
+        metadata: { recordingId: recording.id },
+      })));
+      // Completions wait on this chain, so none can look for its task before the ids are saved
+      const latest = await getRecordingById(recording.id);
+      await updateRecording({ ...(latest || recording), summaryParts: { ...summaryParts, taskIds } });
+      console.log(`Started ${taskIds.length} summary part tasks for recording:`, recording.id);
+      return taskIds;
+    });
+  }
+
+  // A part finished: keep its summary, and once all are in, merge them
+  async handleSummaryPartComplete(recording, taskId, summary) {
+    const index = recording.summaryParts.taskIds.indexOf(taskId);
+    const summaries = recording.summaryParts.summaries.slice();
+    summaries[index] = cleanMarkdownText(summary);
+    const done = summaries.filter(text => text !== null).length;
+    console.log(`Summary part ${index + 1}/${summaries.length} complete for ${recording.id}`);
+
+    if (done < summaries.length) {
+      await updateRecording({ ...recording, summaryParts: { ...recording.summaryParts, summaries } });
+      return;
+    }
+    const input = summaries.map((text, i) => `# Part ${i + 1} of ${summaries.length}\n\n${text}`).join('\n\n');
+    if (estimateTokens(input) > MERGE_INPUT_TOKENS) {
+      // A merged reply this long would be cut off at the output limit; keep every part instead
+      const joined = { ...recording, summary: joinPartSummaries(summaries), summaryParts: null, processingStatus: 'processing' };
+      await updateRecording(joined);
+      console.log(`Joined ${summaries.length} summary parts for ${recording.id}, starting title generation...`);
+      await this.startTitleGenerationUpload(joined);
+      return;
+    }
+    const reduceTaskId = await BackgroundTransferManager.startUploadTask({
+      ...this.responsesTask('summarization', 'summaryMerge', input),
+      metadata: { recordingId: recording.id },
+    });
+    await updateRecording({ ...recording, summaryParts: { ...recording.summaryParts, summaries, reduceTaskId } });
+    console.log(`Started summary merge task ${reduceTaskId} for recording:`, recording.id);
+  }
+
   async startTitleGenerationUpload(recording) {
     console.log('[DEBUG] startTitleGenerationUpload called for', recording.id, 'summary length:', (recording.summary||'').length);
     if (!recording.summary) {
@@ -201,24 +347,9 @@ class BackgroundTransferService {
       const processingRecording = { ...recording, processingStatus: 'processing' };
       await updateRecording(processingRecording);
 
-      const requestBody = {
-        model: 'gpt-4.1-mini',
-        instructions: TITLE_INSTRUCTIONS,
-        input: recording.summary,
-        temperature: 0.2,
-        store: false,
-      };
-
       const taskId = await BackgroundTransferManager.startUploadTask({
-        apiUrl: OPENAI_RESPONSES_API_URL,
-        headers: {
-          Authorization: `Bearer ${OPENAI_API_KEY}`,
-          'Content-Type': 'application/json',
-        },
-        body: JSON.stringify(requestBody),
-        taskType: 'titleGeneration',
+        ...this.responsesTask('titleGeneration', 'title', recording.summary),
         metadata: { recordingId: recording.id },
-        filePath: null,
       });
       console.log('[DEBUG] startTitleGenerationUpload created task', taskId);
 
@@ -231,6 +362,41 @@ class BackgroundTransferService {
     }
   }
 
+  async saveTranscriptAlignment(recording, transcript, words) {
+    try {
+      const index = buildAlignmentIndex(transcript, words);
+      if (!index || !recording.filePath) {
+        return null;
+      }
+      const directory = recording.filePath.substring(0, recording.filePath.lastIndexOf('/'));
+      const alignmentPath = `${directory}/${recording.id}_alignment.bin`;
+      await saveAlignmentIndex(index, alignmentPath);
+      console.log(`[BackgroundTransferService] Saved alignment index (${index.count} words) for ${recording.id}`);
+      return alignmentPath;
+    } catch (error) {
+      // Alignment is an enhancement; never fail the transcription over it
+      console.warn(`[BackgroundTransferService] Could not save alignment index for ${recording.id}:`, error);
+      return null;
+    }
+  }
+
+  async saveSpeakerTimeline(recording, words) {
+    try {
+      const timeline = buildSpeakerTimeline(words);
+      if (!timeline || !recording.filePath) {
+        return null;
+      }
+      const directory = recording.filePath.substring(0, recording.filePath.lastIndexOf('/'));
+      const timelinePath = `${directory}/${recording.id}_speakers.json`;
+      await saveSpeakerTimeline(timeline, timelinePath);
+      console.log(`[BackgroundTransferService] Saved speaker timeline (${timeline.turns.length} turns, ${timeline.speakers.length} speakers) for ${recording.id}`);
+      return timelinePath;
+    } catch (error) {
+      console.warn(`[BackgroundTransferService] Could not save speaker timeline for ${recording.id}:`, error);
+      return null;
+    }
+  }
+
   async handleTranscriptionComplete(recordingId, response) {
      try {
         console.log(`Raw transcription response for ${recordingId}:`, response);
@@ -245,23 +411,30 @@ class BackgroundTransferService {
 
         const recording = await getRecordingById(recordingId); // Fetch again to ensure latest state
         if (!recording) throw new Error(`Recording ${recordingId} not found`);
+        const previousTranscript = recording.summary ? recording.transcript : null;
+
+        // Keep the word timings as a compact index for tap-to-seek / playback highlighting
+        const alignmentPath = await this.saveTranscriptAlignment(recording, transcript, responseData.words);
+        const speakerTimelinePath = await this.saveSpeakerTimeline(recording, responseData.words);
 
         const updatedRecording = {
             ...recording,
             transcript,
+            alignmentPath: alignmentPath || recording.alignmentPath || null,
+            speakerTimelinePath: speakerTimelinePath || recording.speakerTimelinePath || null,
             processingStatus: 'processing', 
         };
         await updateRecording(updatedRecording);
         console.log(`Transcription complete for ${recordingId}, starting summarization...`);
 
-        await this.startSummarizationUpload(updatedRecording);
+        await this.startSummarizationUpload(updatedRecording, { previousTranscript });
     } catch (error) {
         console.error(`Error handling transcription completion for ${recordingId}:`, error);
         await this.handleTransferError(null, 'transcription', recordingId, `Processing failed: ${error.message}`);
     }
   }
 
-  async handleSummarizationComplete(recordingId, response) {
+  async handleSummarizationComplete(recordingId, response, taskId = null) {
     try {
         const responseData = JSON.parse(response);
         console.log(`Raw summarization (Responses API) response for ${recordingId}:`, JSON.stringify(responseData, null, 2));
@@ -291,12 +464,41 @@ class BackgroundTransferService {
              throw new Error('Extracted summary text is empty or null');
         }
 
+        const handled = await this.serializeSummaryParts(async () => {
+            const current = await getRecordingById(recordingId);
+            const parts = current?.summaryParts;
+            if (!parts) return false;
+            if (parts.taskIds.includes(taskId)) {
+                await this.handleSummaryPartComplete(current, taskId, summary);
+                return true;
+            }
+            if (taskId && taskId !== parts.reduceTaskId) {
+                console.warn(`Ignoring summarization task ${taskId} that is not part of the current run for ${recordingId}`);
+                return true;
+            }
+            return false; // the merged summary: finish like a single request
+        });
+        if (handled) return;
+
         const recording = await getRecordingById(recordingId);
         if (!recording) throw new Error(`Recording ${recordingId} not found`);
 
+        const cleanedSummary = cleanMarkdownText(summary);
+        const mergedSummary = recording.summaryRevisionPending
+            ? mergeSummaryRevision(recording.summary, cleanedSummary)
+            : cleanedSummary;
+        if (recording.summaryRevisionPending && mergedSummary === recording.summary) {
+            // Nothing in the summary changed, so neither does the title
+            await updateRecording({ ...recording, summaryRevisionPending: false, processingStatus: 'complete' });
+            console.log(`Summary revision for ${recordingId} changed no sections`);
+            return;
+        }
+
         const updatedRecording = {
             ...recording,
-            summary: cleanMarkdownText(summary),
+            summary: mergedSummary,
+            summaryRevisionPending: false,
+            summaryParts: null,
             processingStatus: 'processing', // remain processing until title generation completes
         };
         await updateRecording(updatedRecording);
@@ -379,6 +581,20 @@ class BackgroundTransferService {
       return []; // Return empty array on error
     }
   }
+
+  // Remove a persisted task record (the native side resolves false if it was already gone)
+  async clearTask(taskId) {
+    return BackgroundTransferManager.clearTask(taskId);
+  }
+
+  // Join the persisted tasks against recordings.json in one native pass.
+  // Resolves with a summary, or null when the native module cannot do it (older builds).
+  async reconcileTasks(recordingsPath) {
+    if (typeof BackgroundTransferManager?.reconcileTasks !== 'function') {
+      return null;
+    }
+    return BackgroundTransferManager.reconcileTasks(recordingsPath);
+  }
 }
 
 // Export a singleton instance so listeners are set up automatically upon import
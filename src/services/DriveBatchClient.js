@@ -0,0 +1,211 @@
+// Drive metadata client that coalesces requests into Drive batch calls.
+//
+// Metadata operations (folder searches, creates, renames, moves, deletes,
+// permission changes) queued within a short window are sent as one
+// multipart/mixed POST to the Drive batch endpoint, so a sync that used to cost
+// a dozen serial round-trips costs a few. Identical GETs already in flight share
+// one request. Media uploads cannot be batched and keep their own paths.
+
+const DRIVE_API_BASE = 'https://www.googleapis.com/drive/v3';
+const DRIVE_BATCH_URL = 'https://www.googleapis.com/batch/drive/v3';
+const DRIVE_API_PATH = '/drive/v3';
+
+const MAX_BATCH_SIZE = 100; // Drive rejects batches with more parts
+const BATCH_WINDOW_MS = 5;
+
+class DriveBatchClient {
+  /**
+   * @param {Function} getToken - async () => access token
+   * @param {Object} options - { apiBase, batchUrl, windowMs } (overridable for stand-in servers)
+   */
+  constructor(getToken, options = {}) {
+    this.getToken = getToken;
+    this.apiBase = options.apiBase || DRIVE_API_BASE;
+    this.batchUrl = options.batchUrl || DRIVE_BATCH_URL;
+    this.windowMs = options.windowMs ?? BATCH_WINDOW_MS;
+    this.queue = [];
+    this.inFlightGets = new Map();
+    this.flushTimer = null;
+    this.stats = { requests: 0, roundTrips: 0, batches: 0, coalesced: 0 };
+  }
+
+  // Point at a different Drive host (used by the local stand-in server)
+  configure({ apiBase, batchUrl }) {
+    if (apiBase) this.apiBase = apiBase;
+    if (batchUrl) this.batchUrl = batchUrl;
+  }
+
+  /**
+   * Queue a Drive metadata request.
+   * @param {string} method - HTTP method
+   * @param {string} path - Path relative to /drive/v3, e.g. `/files/${id}?fields=id`
+   * @param {Object} body - Optional JSON body
+   * @param {Object} headers - Optional extra request headers (e.g. If-None-Match)
+   * @returns {Promise<Object>} - { status, body, etag } with body parsed as JSON when possible
+   */
+  request(method, path, body = null, headers = null) {
+    this.stats.requests++;
+
+    const getKey = method === 'GET' ? (headers ? `${path} ${JSON.stringify(headers)}` : path) : null;
+    if (getKey && this.inFlightGets.has(getKey)) {
+      this.stats.coalesced++;
+      return this.inFlightGets.get(getKey);
+    }
+
+    const promise = new Promise((resolve, reject) => {
+      this.queue.push({ method, path, body, headers, resolve, reject });
+    });
+
+    if (getKey) {
+      this.inFlightGets.set(getKey, promise);
+      const clear = () => this.inFlightGets.delete(getKey);
+      promise.then(clear, clear);
+    }
+
+    if (this.queue.length >= MAX_BATCH_SIZE) {
+      this.flush();
+    } else if (!this.flushTimer) {
+      this.flushTimer = setTimeout(() => this.flush(), this.windowMs);
+    }
+    return promise;
+  }
+
+  /**
+   * Like request(), but throws on non-2xx so callers can keep their existing error handling.
+   * @returns {Promise<Object>} - Parsed JSON body (or null for empty responses)
+   */
+  async requestJson(method, path, body = null, { allowStatus = [] } = {}) {
+    const response = await this.request(method, path, body);
+    if ((response.status < 200 || response.status >= 300) && !allowStatus.includes(response.status)) {
+      const detail = typeof response.body === 'string' ? response.body : JSON.stringify(response.body);
+      throw new Error(`Drive API ${method} ${path.split('?')[0]} failed: ${response.status} - ${detail}`);
+    }
+    return response.body;
+  }
+
+  flush() {
+    if (this.flushTimer) {
+      clearTimeout(this.flushTimer);
+      this.flushTimer = null;
+    }
+    while (this.queue.length > 0) {
+      const operations = this.queue.splice(0, MAX_BATCH_SIZE);
+      const send = operations.length === 1 ? this.sendSingle(operations[0]) : this.sendBatch(operations);
+      send.catch(error => operations.forEach(op => op.reject(error)));
+    }
+  }
+
+  async sendSingle(op) {
+    const token = await this.getToken();
+    this.stats.roundTrips++;
+    const response = await fetch(`${this.apiBase}${op.path}`, {
+      method: op.method,
+      headers: {
+        'Authorization': `Bearer ${token}`,
+        ...(op.body ? { 'Content-Type': 'application/json' } : {}),
+        ...op.headers,
+      },
+      body: op.body ? JSON.stringify(op.body) : undefined,
+    });
+    const text = await response.text();
+    op.resolve({ status: response.status, body: parseBody(text), etag: response.headers.get('etag') });
+  }
+
+  async sendBatch(operations) {
+    const token = await this.getToken();
+    const boundary = `batch_arcoscribe_${Date.now()}_${Math.random().toString(36).slice(2)}`;
+
+    let body = '';
+    operations.forEach((op, index) => {
+      body += `--${boundary}\r\n`;
+      body += 'Content-Type: application/http\r\n';
+      body += `Content-ID: <item-${index}>\r\n\r\n`;
+      body += `${op.method} ${DRIVE_API_PATH}${op.path} HTTP/1.1\r\n`;
+      Object.entries(op.headers || {}).forEach(([name, value]) => {
+        body += `${name}: ${value}\r\n`;
+      });
+      if (op.body) {
+        const json = JSON.stringify(op.body);
+        body += 'Content-Type: application/json; charset=UTF-8\r\n\r\n';
+        body += `${json}\r\n`;
+      } else {
+        body += '\r\n';
+      }
+    });
+    body += `--${boundary}--\r\n`;
+
+    this.stats.roundTrips++;
+    this.stats.batches++;
+    const response = await fetch(this.batchUrl, {
+      method: 'POST',
+      headers: {
+        'Authorization': `Bearer ${token}`,
+        'Content-Type': `multipart/mixed; boundary=${boundary}`,
+      },
+      body,
+    });
+
+    const text = await response.text();
+    if (!response.ok) {
+      throw new Error(`Drive batch request failed: ${response.status} - ${text}`);
+    }
+
+    const contentType = response.headers.get('content-type') || '';
+    const parts = parseBatchResponse(text, contentType);
+    operations.forEach((op, index) => {
+      const part = parts.get(index);
+      if (part) {
+        op.resolve(part);
+      } else {
+        op.reject(new Error('Drive batch response missing part for request'));
+      }
+    });
+  }
+
+  getStats() {
+    return { ...this.stats };
+  }
+
+  resetStats() {
+    this.stats = { requests: 0, roundTrips: 0, batches: 0, coalesced: 0 };
+  }
+}
+
+const parseBody = (text) => {
+  if (!text) return null;
+  try {
+    return JSON.parse(text);
+  } catch (error) {
+    return text;
+  }
+};
+
+// Split a multipart/mixed batch response into { status, body, etag } keyed by request index
+const parseBatchResponse = (text, contentType) => {
+  const results = new Map();
+  const boundaryMatch = /boundary="?([^";]+)"?/i.exec(contentType);
+  if (!boundaryMatch) return results;
+
+  const segments = text.split(`--${boundaryMatch[1]}`);
+  for (const segment of segments) {
+    if (!segment.trim() || segment.startsWith('--')) continue;
+
+    const idMatch = /Content-ID:\s*<response-item-(\d+)>/i.exec(segment);
+    const statusMatch = /HTTP\/[\d.]+\s+(\d{3})/.exec(segment);
+    if (!idMatch || !statusMatch) continue;
+
+    // The embedded response body follows the blank line after its own headers
+    const afterStatus = segment.slice(statusMatch.index);
+    const bodyStart = afterStatus.search(/\r?\n\r?\n/);
+    const rawBody = bodyStart === -1 ? '' : afterStatus.slice(bodyStart).trim();
+    const etagMatch = /^ETag:\s*(.+?)\s*$/im.exec(bodyStart === -1 ? afterStatus : afterStatus.slice(0, bodyStart));
+    results.set(parseInt(idMatch[1], 10), {
+      status: parseInt(statusMatch[1], 10),
+      body: parseBody(rawBody),
+      etag: etagMatch ? etagMatch[1] : null,
+    });
+  }
+  return results;
+};
+
+export default DriveBatchClient;
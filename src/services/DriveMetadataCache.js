@@ -0,0 +1,283 @@
+// Persistent cache of Drive folder paths and file metadata.
+//
+// Folder lookups (`${parentId}/${name}` -> folder ID) and file metadata survive
+// app restarts, so a sync after launch does not have to search its way down
+// ArcoScribe Recordings/YYYY/Month again. Entries are trusted for a while after
+// they were last confirmed; the Drive changes feed (changes.list page tokens)
+// confirms everything at once and drops only the entries that actually changed,
+// and an entry that has gone stale is revalidated with its ETag (a 304 costs no
+// body). Lookups that found nothing are cached too, for a shorter time.
+import RNFS from 'react-native-fs';
+
+const CACHE_VERSION = 1;
+const CACHE_FILE_NAME = 'drive_metadata_cache.json';
+const FRESH_MS = 10 * 60 * 1000; // Trust an entry this long after it was confirmed
+const NEGATIVE_TTL_MS = 5 * 60 * 1000; // Trust "not found" this long
+const SAVE_DELAY_MS = 1000;
+
+const emptyStats = () => ({
+  hits: 0,
+  misses: 0,
+  stale: 0,
+  negativeHits: 0,
+  revalidations: 0,
+  notModified: 0,
+  changesPolls: 0,
+  changesApplied: 0,
+});
+
+class DriveMetadataCache {
+  /**
+   * @param {Object} options - { path, freshMs, negativeTtlMs }
+   */
+  constructor(options = {}) {
+    this.path = options.path || null;
+    this.freshMs = options.freshMs ?? FRESH_MS;
+    this.negativeTtlMs = options.negativeTtlMs ?? NEGATIVE_TTL_MS;
+    this.loading = null;
+    this.saveTimer = null;
+    this.stats = emptyStats();
+    this.reset();
+  }
+
+  reset() {
+    this.folders = new Map(); // `${parentId}/${name}` -> folder ID
+    this.entries = new Map(); // file ID -> { metadata, etag, checkedAt }
+    this.missing = new Map(); // `${parentId}/${name}` or `id:${fileId}` -> time it was not found
+    this.pageToken = null; // changes.list position the cache is current up to
+    this.validatedAt = 0; // last time the changes feed confirmed every entry
+  }
+
+  cachePath() {
+    return this.path || `${RNFS.DocumentDirectoryPath}/${CACHE_FILE_NAME}`;
+  }
+
+  // Load the saved cache once; later calls share the same promise
+  ready() {
+    if (!this.loading) {
+      this.loading = this.load();
+    }
+    return this.loading;
+  }
+
+  async load() {
+    try {
+      const filePath = this.cachePath();
+      if (!(await RNFS.exists(filePath))) {
+        return;
+      }
+      const saved = JSON.parse(await RNFS.readFile(filePath, 'utf8'));
+      if (saved.version !== CACHE_VERSION) {
+        return;
+      }
+      this.folders = new Map(saved.folders);
+      this.entries = new Map(saved.entries);
+      this.missing = new Map(saved.missing);
+      this.pageToken = saved.pageToken || null;
+      this.validatedAt = saved.validatedAt || 0;
+      console.log(`[DriveMetadataCache] Loaded ${this.folders.size} folders, ${this.entries.size} entries`);
+    } catch (error) {
+      console.error('[DriveMetadataCache] Failed to load cache, starting empty:', error);
+      this.reset();
+    }
+  }
+
+  async save() {
+    if (this.saveTimer) {
+      clearTimeout(this.saveTimer);
+      this.saveTimer = null;
+    }
+    try {
+      await RNFS.writeFile(this.cachePath(), JSON.stringify({
+        version: CACHE_VERSION,
+        pageToken: this.pageToken,
+        validatedAt: this.validatedAt,
+        folders: [...this.folders],
+        entries: [...this.entries],
+        missing: [...this.missing],
+      }), 'utf8');
+    } catch (error) {
+      console.error('[DriveMetadataCache] Failed to save cache:', error);
+    }
+  }
+
+  // Mutations are written out together shortly afterwards
+  scheduleSave() {
+    if (!this.saveTimer) {
+      this.saveTimer = setTimeout(() => this.save(), SAVE_DELAY_MS);
+    }
+  }
+
+  // Forget everything, on disk too (sign-out, different account)
+  async clear() {
+    this.reset();
+    this.loading = Promise.resolve();
+    await this.save();
+  }
+
+  isFresh(entry) {
+    return Date.now() - Math.max(entry.checkedAt, this.validatedAt) < this.freshMs;
+  }
+
+  /**
+   * Look up a folder by parent and name.
+   * @returns {Object|null} - { id, fresh } or null when unknown
+   */
+  getFolder(parentId, name) {
+    const id = this.folders.get(`${parentId}/${name}`);
+    const entry = id ? this.entries.get(id) : null;
+    if (!entry) {
+      this.stats.misses++;
+      return null;
+    }
+    const fresh = this.isFresh(entry);
+    this.stats[fresh ? 'hits' : 'stale']++;
+    return { id, fresh };
+  }
+
+  putFolder(parentId, name, metadata, etag = null) {
+    this.folders.set(`${parentId}/${name}`, metadata.id);
+    this.putFile(metadata, etag);
+  }
+
+  /**
+   * Look up file metadata by ID.
+   * @returns {Object|null} - { metadata, etag, fresh } or null when unknown
+   */
+  getFile(fileId) {
+    const entry = this.entries.get(fileId);
+    if (!entry) {
+      this.stats.misses++;
+      return null;
+    }
+    const fresh = this.isFresh(entry);
+    this.stats[fresh ? 'hits' : 'stale']++;
+    return { metadata: entry.metadata, etag: entry.etag, fresh };
+  }
+
+  putFile(metadata, etag = null) {
+    const previous = this.entries.get(metadata.id);
+    this.entries.set(metadata.id, {
+      metadata: { ...previous?.metadata, ...metadata },
+      etag: etag || previous?.etag || null,
+      checkedAt: Date.now(),
+    });
+    this.missing.delete(`id:${metadata.id}`);
+    (metadata.parents || []).forEach(parentId => this.missing.delete(`${parentId}/${metadata.name}`));
+    this.scheduleSave();
+  }
+
+  // ETag to send with a conditional GET for this file, if we have one
+  beginRevalidation(fileId) {
+    this.stats.revalidations++;
+    return this.entries.get(fileId)?.etag || null;
+  }
+
+  // A 304 confirmed the cached copy; returns its metadata
+  touch(fileId) {
+    const entry = this.entries.get(fileId);
+    if (!entry) {
+      return null;
+    }
+    entry.checkedAt = Date.now();
+    this.stats.notModified++;
+    this.scheduleSave();
+    return entry.metadata;
+  }
+
+  forgetFolder(parentId, name) {
+    this.folders.delete(`${parentId}/${name}`);
+    this.scheduleSave();
+  }
+
+  // Drop a file, the folder paths that lead to it, and (for folders) everything cached beneath it
+  removeFile(fileId) {
+    this.entries.delete(fileId);
+    for (const [key, id] of this.folders) {
+      if (id === fileId) {
+        this.folders.delete(key);
+      } else if (key.startsWith(`${fileId}/`)) {
+        this.folders.delete(key);
+        this.removeFile(id);
+      }
+    }
+    this.scheduleSave();
+  }
+
+  isMissing(key) {
+    const notFoundAt = this.missing.get(key);
+    if (notFoundAt && Date.now() - notFoundAt < this.negativeTtlMs) {
+      this.stats.negativeHits++;
+      return true;
+    }
+    return false;
+  }
+
+  putMissing(key) {
+    this.missing.set(key, Date.now());
+    this.scheduleSave();
+  }
+
+  /**
+   * Apply one page of changes.list results: drop what was removed or trashed,
+   * and re-point renamed or moved files at their new names and parents.
+   * @param {Array} changes - Drive change resources ({ fileId, removed, file })
+   */
+  applyChanges(changes) {
+    changes.forEach(({ fileId, removed, file }) => {
+      if (removed || !file || file.trashed) {
+        this.removeFile(fileId);
+        this.missing.set(`id:${fileId}`, Date.now());
+        return;
+      }
+      // Paths that no longer match the file's name and parents (renamed or moved)
+      for (const [key, id] of this.folders) {
+        const parentId = key.slice(0, key.indexOf('/'));
+        const name = key.slice(key.indexOf('/') + 1);
+        const stillValid = name === file.name && (parentId === 'root' || (file.parents || []).includes(parentId));
+        if (id === fileId && !stillValid) this.folders.delete(key);
+      }
+      this.missing.delete(`id:${fileId}`);
+      (file.parents || []).forEach((parentId) => {
+        this.missing.delete(`${parentId}/${file.name}`);
+        if (file.mimeType === 'application/vnd.google-apps.folder') {
+          this.folders.set(`${parentId}/${file.name}`, fileId);
+        }
+      });
+      // The feed carries no ETag, so the next conditional GET for this file fetches it in full
+      this.entries.set(fileId, { metadata: file, etag: null, checkedAt: Date.now() });
+    });
+    this.stats.changesApplied += changes.length;
+    this.scheduleSave();
+  }
+
+  // First poll: remember where the feed starts without vouching for older entries
+  setPageToken(pageToken) {
+    this.pageToken = pageToken;
+    this.scheduleSave();
+  }
+
+  // The feed is caught up: every entry that was not changed is still current
+  markValidated(pageToken) {
+    this.pageToken = pageToken;
+    this.validatedAt = Date.now();
+    this.stats.changesPolls++;
+    this.scheduleSave();
+  }
+
+  getStats() {
+    const lookups = this.stats.hits + this.stats.misses + this.stats.stale;
+    return {
+      ...this.stats,
+      folders: this.folders.size,
+      entries: this.entries.size,
+      hitRate: lookups === 0 ? null : Number((this.stats.hits / lookups).toFixed(3)),
+    };
+  }
+
+  resetStats() {
+    this.stats = emptyStats();
+  }
+}
+
+export default DriveMetadataCache;
@@ -0,0 +1,324 @@
+// Durable queue for Drive mutations (rename, move, delete, share).
+//
+// Every operation is appended to a journal file before it is acknowledged, so
+// renames and deletes made offline, or just before the app is killed, are
+// replayed on the next launch. Redundant operations collapse while they wait:
+// the last rename of a file wins, a chain of moves becomes one move to the
+// final folder, repeated share requests become one, and deleting a file drops
+// everything still queued for it (callers waiting on a share get a
+// file_deleted error rather than a link). Failed operations are retried with
+// exponential backoff; while offline the queue waits for the backoff timer or
+// the app returning to the foreground before trying again.
+import RNFS from 'react-native-fs';
+
+const JOURNAL_FILE_NAME = 'drive_operations.jsonl';
+const BASE_BACKOFF_MS = 1000;
+const MAX_BACKOFF_MS = 5 * 60 * 1000;
+const MAX_ATTEMPTS = 8; // Non-network failures give up after this many tries
+const COMPACT_AFTER_RECORDS = 200;
+
+const isNetworkError = (error) =>
+  error instanceof TypeError || /network request failed|fetch failed|network|timed? ?out/i.test(error?.message || '');
+
+const isRetryableError = (error) =>
+  isNetworkError(error) || /\b(429|500|502|503|504)\b|rate limit/i.test(error?.message || '');
+
+// What waiters of an operation a delete made moot are rejected with (their
+// result, a share link say, does not exist)
+const fileDeletedError = op => Object.assign(
+  new Error(`Drive file ${op.fileId} was deleted before its ${op.kind} ran`),
+  { code: 'file_deleted' },
+);
+
+const emptyStats = () => ({
+  submitted: 0,
+  coalesced: 0,
+  executed: 0,
+  failed: 0,
+  retries: 0,
+  replayed: 0,
+});
+
+class DriveOperationQueue {
+  /**
+   * @param {Function} perform - async (op) => result; applies one operation to Drive
+   * @param {Object} options - { path, baseBackoffMs, maxBackoffMs, concurrency }
+   */
+  constructor(perform, options = {}) {
+    this.perform = perform;
+    this.path = options.path || null;
+    this.baseBackoffMs = options.baseBackoffMs ?? BASE_BACKOFF_MS;
+    this.maxBackoffMs = options.maxBackoffMs ?? MAX_BACKOFF_MS;
+    this.concurrency = options.concurrency ?? 10;
+
+    this.pending = []; // Operations in submission order
+    this.waiters = new Map(); // op id -> [{ resolve, reject }]
+    this.nextId = 1;
+    this.journalRecords = 0;
+    this.journalWrite = Promise.resolve();
+    this.loading = null;
+    this.draining = null;
+    this.backoffTimer = null;
+    this.backoffAttempt = 0;
+    this.stats = emptyStats();
+  }
+
+  journalPath() {
+    return this.path || `${RNFS.DocumentDirectoryPath}/${JOURNAL_FILE_NAME}`;
+  }
+
+  // Load the journal once and replay whatever was still pending
+  ready() {
+    if (!this.loading) {
+      this.loading = this.load();
+    }
+    return this.loading;
+  }
+
+  async load() {
+    try {
+      const filePath = this.journalPath();
+      if (!(await RNFS.exists(filePath))) {
+        return;
+      }
+      const enqueued = [];
+      const done = new Set();
+      const lines = (await RNFS.readFile(filePath, 'utf8')).split('\n');
+      for (const line of lines) {
+        if (!line.trim()) continue;
+        let record;
+        try {
+          record = JSON.parse(line);
+        } catch (error) {
+          // A write torn by a crash can only be the last line; everything before it is intact
+          console.warn('[DriveOperationQueue] Ignoring unreadable journal record');
+          continue;
+        }
+        this.journalRecords++;
+        if (record.type === 'enqueue') {
+          enqueued.push(record.op);
+          this.nextId = Math.max(this.nextId, record.op.id + 1);
+        } else if (record.type === 'done') {
+          done.add(record.id);
+        }
+      }
+
+      // Re-run the same coalescing the original submissions went through
+      enqueued.filter(op => !done.has(op.id)).forEach((op) => {
+        this.stats.replayed++;
+        this.coalesce(op);
+      });
+      console.log(`[DriveOperationQueue] Replaying ${this.pending.length} pending operations from the journal`);
+      if (this.pending.length > 0) {
+        this.schedule(0);
+      }
+    } catch (error) {
+      console.error('[DriveOperationQueue] Failed to load journal:', error);
+    }
+  }
+
+  // Journal writes are chained so records land in the order they were made
+  appendRecords(records) {
+    const text = records.map(record => JSON.stringify(record)).join('\n') + '\n';
+    this.journalRecords += records.length;
+    this.journalWrite = this.journalWrite
+      .then(() => RNFS.appendFile(this.journalPath(), text, 'utf8'))
+      .catch(error => console.error('[DriveOperationQueue] Journal write failed:', error));
+    return this.journalWrite;
+  }
+
+  // Rewrite the journal with only the pending operations once it is mostly finished work
+  compactJournal() {
+    if (this.journalRecords < COMPACT_AFTER_RECORDS || this.journalRecords < this.pending.length * 2) {
+      return this.journalWrite;
+    }
+    const text = this.pending.map(op => JSON.stringify({ type: 'enqueue', op })).join('\n');
+    this.journalRecords = this.pending.length;
+    this.journalWrite = this.journalWrite
+      .then(() => RNFS.writeFile(this.journalPath(), text ? `${text}\n` : '', 'utf8'))
+      .catch(error => console.error('[DriveOperationQueue] Journal compaction failed:', error));
+    return this.journalWrite;
+  }
+
+  /**
+   * Queue a Drive mutation. Resolves once it is journaled (safe across restarts).
+   * @param {Object} operation - { kind: 'rename'|'move'|'delete'|'share', fileId, ...args }
+   * @returns {Promise<Object>} - { id, completion } where completion resolves with the operation's result
+   */
+  async enqueue(operation) {
+    await this.ready();
+    const op = { ...operation, id: this.nextId++, enqueuedAt: Date.now(), attempts: 0 };
+    const completion = new Promise((resolve, reject) => {
+      this.waiters.set(op.id, [{ resolve, reject }]);
+    });
+    completion.catch(() => {}); // Fire-and-forget callers should not trip unhandled rejection warnings
+
+    this.stats.submitted++;
+    await this.appendRecords([{ type: 'enqueue', op }]);
+    const superseded = this.coalesce(op);
+    if (superseded.length > 0) {
+      await this.appendRecords(superseded.map(id => ({ type: 'done', id, coalesced: true })));
+    }
+
+    if (!this.backoffTimer) {
+      this.drain();
+    }
+    return { id: op.id, completion };
+  }
+
+  // Fold `op` into the pending list. Returns the IDs of operations it made redundant.
+  coalesce(op) {
+    const sameFile = this.pending.filter(pendingOp => pendingOp.fileId === op.fileId && !pendingOp.inFlight);
+    const superseded = [];
+    // Whoever waited on the old operation now gets the result of the one that
+    // replaces it, which is only the same result for the same kind of operation;
+    // an operation a delete made moot fails instead
+    const settleSuperseded = (oldOp, survivor) => {
+      superseded.push(oldOp.id);
+      this.stats.coalesced++;
+      const oldWaiters = this.waiters.get(oldOp.id) || [];
+      this.waiters.delete(oldOp.id);
+      if (oldOp.kind === survivor.kind) {
+        this.waiters.set(survivor.id, [...(this.waiters.get(survivor.id) || []), ...oldWaiters]);
+      } else {
+        oldWaiters.forEach(waiter => waiter.reject(fileDeletedError(oldOp)));
+      }
+    };
+    const supersede = (oldOp, survivor) => {
+      this.pending.splice(this.pending.indexOf(oldOp), 1);
+      settleSuperseded(oldOp, survivor);
+    };
+
+    if (op.kind === 'delete') {
+      // Nothing queued for a file matters once it is deleted
+      sameFile.forEach(pendingOp => supersede(pendingOp, op));
+    } else if (sameFile.some(pendingOp => pendingOp.kind === 'delete')) {
+      // Already being deleted: this operation is moot
+      settleSuperseded(op, sameFile.find(pendingOp => pendingOp.kind === 'delete'));
+      return superseded;
+    } else if (op.kind === 'rename') {
+      sameFile.filter(pendingOp => pendingOp.kind === 'rename').forEach(pendingOp => supersede(pendingOp, op));
+    } else if (op.kind === 'move') {
+      // A -> B -> C is a move to C; a move that keeps the old parents cannot be folded
+      sameFile
+        .filter(pendingOp => pendingOp.kind === 'move' && pendingOp.removeFromCurrentParents && op.removeFromCurrentParents)
+        .forEach(pendingOp => supersede(pendingOp, op));
+    } else if (op.kind === 'share') {
+      sameFile
+        .filter(pendingOp => pendingOp.kind === 'share' && pendingOp.role === op.role)
+        .forEach(pendingOp => supersede(pendingOp, op));
+    }
+
+    this.pending.push(op);
+    return superseded;
+  }
+
+  // Start draining now (app foregrounded, new work queued)
+  resume() {
+    if (this.backoffTimer) {
+      clearTimeout(this.backoffTimer);
+      this.backoffTimer = null;
+    }
+    return this.drain();
+  }
+
+  schedule(delayMs) {
+    if (this.backoffTimer) return;
+    this.backoffTimer = setTimeout(() => {
+      this.backoffTimer = null;
+      this.drain();
+    }, delayMs);
+  }
+
+  drain() {
+    if (!this.draining) {
+      this.draining = this.runDrain().finally(() => {
+        this.draining = null;
+      });
+    }
+    return this.draining;
+  }
+
+  // Run the oldest pending operation of each file, up to `concurrency` at a time,
+  // so operations on one file keep their order and different files go in parallel
+  async runDrain() {
+    while (this.pending.length > 0) {
+      const busyFiles = new Set();
+      const wave = [];
+      for (const op of this.pending) {
+        if (wave.length >= this.concurrency) break;
+        if (busyFiles.has(op.fileId)) continue;
+        busyFiles.add(op.fileId);
+        wave.push(op);
+      }
+
+      wave.forEach((op) => { op.inFlight = true; });
+      const outcomes = await Promise.allSettled(wave.map(op => this.perform(op)));
+
+      let networkDown = false;
+      const finished = [];
+      outcomes.forEach((outcome, index) => {
+        const op = wave[index];
+        op.inFlight = false;
+        if (outcome.status === 'fulfilled') {
+          this.stats.executed++;
+          finished.push(op);
+          this.settle(op, null, outcome.value);
+          return;
+        }
+        op.attempts++;
+        if (isNetworkError(outcome.reason)) {
+          networkDown = true;
+        } else if (!isRetryableError(outcome.reason) || op.attempts >= MAX_ATTEMPTS) {
+          console.error(`[DriveOperationQueue] Giving up on ${op.kind} ${op.fileId}:`, outcome.reason);
+          this.stats.failed++;
+          finished.push(op);
+          this.settle(op, outcome.reason);
+          return;
+        }
+        this.stats.retries++;
+      });
+
+      finished.forEach(op => this.pending.splice(this.pending.indexOf(op), 1));
+      if (finished.length > 0) {
+        await this.appendRecords(finished.map(op => ({ type: 'done', id: op.id })));
+        await this.compactJournal();
+      }
+
+      if (finished.length < wave.length) {
+        // Back off before touching the failed operations again
+        const delay = Math.min(this.maxBackoffMs, this.baseBackoffMs * Math.pow(2, this.backoffAttempt));
+        this.backoffAttempt++;
+        console.log(`[DriveOperationQueue] ${networkDown ? 'Offline' : 'Retrying'}; ${this.pending.length} operations waiting, next attempt in ${delay}ms`);
+        this.schedule(delay * (0.75 + Math.random() * 0.5));
+        return;
+      }
+      this.backoffAttempt = 0;
+    }
+  }
+
+  settle(op, error, result) {
+    const waiters = this.waiters.get(op.id) || [];
+    this.waiters.delete(op.id);
+    waiters.forEach(waiter => (error ? waiter.reject(error) : waiter.resolve(result)));
+  }
+
+  // Resolves once everything queued so far has been applied (or the queue is waiting on backoff)
+  async idle() {
+    await this.ready();
+    while (this.draining) {
+      await this.draining;
+    }
+    await this.journalWrite;
+  }
+
+  getStats() {
+    return {
+      ...this.stats,
+      pending: this.pending.length,
+      coalescingRatio: this.stats.executed === 0 ? null : Number((this.stats.submitted / this.stats.executed).toFixed(2)),
+    };
+  }
+}
+
+export default DriveOperationQueue;
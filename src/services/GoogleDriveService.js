@@ -1,7 +1,19 @@
 import { GoogleSignin } from '@react-native-google-signin/google-signin';
 import * as Keychain from 'react-native-keychain';
-import { NativeModules } from 'react-native';
-import { getRecordingById, updateRecording } from './AudioRecordingService';
+import { AppState, NativeModules, NativeEventEmitter } from 'react-native';
+import { getRecordingById, updateRecordingFields } from './AudioRecordingService';
+import DriveBatchClient from './DriveBatchClient';
+import DriveMetadataCache from './DriveMetadataCache';
+import DriveOperationQueue from './DriveOperationQueue';
+import UploadScheduler from './UploadScheduler';
+import MetricsService from './MetricsService';
+import {
+  CHUNK_PROFILES,
+  computeTextManifest,
+  diffManifests,
+  loadManifests,
+  saveManifests,
+} from '../utils/ChunkManifest';
 
 const { BackgroundTransferManager } = NativeModules;
 
@@ -15,14 +27,240 @@ const GOOGLE_DRIVE_CONFIG = {
 
 const DRIVE_API_BASE = 'https://www.googleapis.com/drive/v3';
 const DRIVE_UPLOAD_BASE = 'https://www.googleapis.com/upload/drive/v3';
+const FOLDER_MIME_TYPE = 'application/vnd.google-apps.folder';
+const APP_FOLDER_NAME = 'ArcoScribe Recordings';
+const FILE_FIELDS = 'id,name,mimeType,parents,trashed,size';
+const CHANGES_FIELDS = `nextPageToken,newStartPageToken,changes(fileId,removed,file(${FILE_FIELDS}))`;
+const CHANGES_POLL_MS = 30 * 1000; // Syncs closer together than this share one changes.list poll
+// A waiting upload checks the native task store this often, in case its completion event was lost
+const TRANSFER_CHECK_MS = 30 * 1000;
+const TRANSFER_TIMEOUT_MS = 2 * 60 * 60 * 1000; // well past a two-hour lesson on a slow uplink
 
 class GoogleDriveService {
   constructor() {
     this.isConfigured = true; // Configuration is handled at app level
     this.appFolderId = null;
+    this.apiBase = DRIVE_API_BASE;
+    this.uploadBase = DRIVE_UPLOAD_BASE;
+    // Metadata calls go through the batch client; folder IDs and file metadata are
+    // cached on disk and kept current from the Drive changes feed
+    this.batchClient = new DriveBatchClient(() => this.getValidToken());
+    this.metadataCache = new DriveMetadataCache();
+    this.pendingFolderLookups = new Map();
+    this.createdFolderIds = new Set(); // folders created this session; children not in the cache don't exist
+    this.changesPoll = null;
+    this.lastChangesPollAt = 0;
+
+    // Renames, moves, deletes and shares are journaled and replayed, so they survive
+    // going offline or the app being killed; coming back to the foreground retries them
+    this.operationQueue = new DriveOperationQueue(op => this.performOperation(op));
+    this.operationQueue.ready();
+    AppState.addEventListener('change', (state) => {
+      if (state === 'active') this.operationQueue.resume();
+    });
+
+    // Uploads run through the scheduler; native uploads report back through transfer events
+    this.uploadScheduler = new UploadScheduler();
+    MetricsService.addSource('drive.uploads', () => {
+      const { window, active, queued } = this.uploadScheduler.getStats();
+      return { window, active, queued };
+    });
+    this.transferWaiters = new Map();
+    this.finishedTransfers = new Map();
+    const transferEmitter = new NativeEventEmitter(BackgroundTransferManager);
+    transferEmitter.addListener('onTransferComplete', event => this.settleTransfer(event, null));
+    transferEmitter.addListener('onTransferError', event => this.settleTransfer(event, event.error));
     console.log('[GoogleDriveService] Service initialized (configuration handled at app level)');
   }
 
+  // Point the service at a different Drive host (used by scripts/benchmarkDriveSync.js)
+  configureEndpoints({ apiBase, uploadBase, batchUrl }) {
+    if (apiBase) this.apiBase = apiBase;
+    if (uploadBase) this.uploadBase = uploadBase;
+    this.batchClient.configure({ apiBase, batchUrl });
+    this.clearFolderCache();
+  }
+
+  clearFolderCache() {
+    this.appFolderId = null;
+    this.pendingFolderLookups.clear();
+    this.createdFolderIds.clear();
+    this.lastChangesPollAt = 0;
+    return this.metadataCache.clear();
+  }
+
+  // Catch the metadata cache up with the Drive changes feed, at most once per
+  // CHANGES_POLL_MS; concurrent syncs share the poll. If the feed fails, stale
+  // entries are still revalidated one by one with their ETags.
+  refreshMetadataCache() {
+    if (!this.changesPoll && Date.now() - this.lastChangesPollAt >= CHANGES_POLL_MS) {
+      this.changesPoll = this.pollChanges()
+        .catch(error => console.warn('[GoogleDriveService] Changes feed poll failed:', error.message))
+        .finally(() => {
+          this.lastChangesPollAt = Date.now();
+          this.changesPoll = null;
+        });
+    }
+    return this.changesPoll || Promise.resolve();
+  }
+
+  async pollChanges() {
+    await this.metadataCache.ready();
+    let pageToken = this.metadataCache.pageToken;
+    if (!pageToken) {
+      // First poll only marks where the feed starts; entries cached so far are revalidated by ETag
+      const { startPageToken } = await this.batchClient.requestJson('GET', '/changes/startPageToken');
+      this.metadataCache.setPageToken(startPageToken);
+      return;
+    }
+    while (pageToken) {
+      const page = await this.batchClient.requestJson(
+        'GET',
+        `/changes?pageToken=${encodeURIComponent(pageToken)}&pageSize=1000&fields=${encodeURIComponent(CHANGES_FIELDS)}`
+      );
+      this.metadataCache.applyChanges(page.changes || []);
+      if (page.newStartPageToken) {
+        this.metadataCache.markValidated(page.newStartPageToken);
+        return;
+      }
+      pageToken = page.nextPageToken;
+    }
+  }
+
+  // Fetch a file's metadata, sending the cached ETag so an unchanged file costs a 304.
+  // Returns null (and remembers that) when the file is gone or trashed.
+  async fetchFileMetadata(fileId) {
+    const etag = this.metadataCache.beginRevalidation(fileId);
+    const response = await this.batchClient.request(
+      'GET',
+      `/files/${fileId}?fields=${FILE_FIELDS}`,
+      null,
+      etag ? { 'If-None-Match': etag } : null
+    );
+
+    if (response.status === 304) {
+      return this.metadataCache.touch(fileId);
+    }
+    if (response.status === 200 && !response.body.trashed) {
+      this.metadataCache.putFile(response.body, response.etag);
+      return response.body;
+    }
+    if (response.status === 200 || response.status === 404) {
+      this.metadataCache.removeFile(fileId);
+      this.metadataCache.putMissing(`id:${fileId}`);
+      return null;
+    }
+    throw new Error(`Drive API GET /files/${fileId} failed: ${response.status}`);
+  }
+
+  // Resolve or reject whoever is waiting on a driveUpload task
+  settleTransfer(event, error) {
+    if (event.taskType !== 'driveUpload') {
+      return;
+    }
+    const waiter = this.transferWaiters.get(event.taskId);
+    if (!waiter) {
+      // The event beat the waiter (tiny files); keep it for waitForTransfer
+      this.finishedTransfers.set(event.taskId, { event, error });
+      return;
+    }
+    this.transferWaiters.delete(event.taskId);
+    if (error) {
+      waiter.reject(new Error(error));
+    } else {
+      waiter.resolve(event);
+    }
+  }
+
+  // Wait for a background upload task to finish. The completion event can be
+  // lost (a JS reload, or the background session finishing the task while the
+  // app was relaunched), so the native task store is checked now and then: a
+  // task it has finished for two checks running, or no longer knows, settles
+  // the wait without the event, and nothing waits past the deadline.
+  waitForTransfer(taskId, timeoutMs = TRANSFER_TIMEOUT_MS) {
+    const finished = this.finishedTransfers.get(taskId);
+    if (finished) {
+      this.finishedTransfers.delete(taskId);
+      return finished.error ? Promise.reject(new Error(finished.error)) : Promise.resolve(finished.event);
+    }
+    return new Promise((resolve, reject) => {
+      const deadline = Date.now() + timeoutMs;
+      let timer = null;
+      let finishedStatus = null;
+      const waiter = {
+        resolve: (event) => {
+          clearTimeout(timer);
+          resolve(event);
+        },
+        reject: (error) => {
+          clearTimeout(timer);
+          reject(error);
+        },
+      };
+      const settle = (error, event = null) => {
+        if (this.transferWaiters.get(taskId) !== waiter) return;
+        this.transferWaiters.delete(taskId);
+        if (error) {
+          waiter.reject(new Error(error));
+        } else {
+          waiter.resolve(event);
+        }
+      };
+      const check = async () => {
+        let task = null;
+        try {
+          task = (await BackgroundTransferManager.getActiveTasks())[taskId] || null;
+        } catch (error) {
+          console.warn('[GoogleDriveService] Could not read transfer tasks:', error);
+        }
+        if (this.transferWaiters.get(taskId) !== waiter) return;
+        const status = task ? task.status : 'missing';
+        if (status === 'complete' || status === 'error' || status === 'missing') {
+          // Seen twice, so an event already on its way has had time to arrive
+          if (finishedStatus === status) {
+            console.warn(`[GoogleDriveService] No completion event for upload ${taskId}; task store says ${status}`);
+            if (status === 'complete') {
+              // Without the response there is no file ID; the next sync finds the file by name
+              settle(null, { taskId, taskType: 'driveUpload', response: null });
+            } else {
+              settle(status === 'error' ? `Upload ${taskId} failed` : `Upload ${taskId} is no longer known to the transfer manager`);
+            }
+            return;
+          }
+          finishedStatus = status;
+        } else {
+          finishedStatus = null;
+        }
+        if (Date.now() >= deadline) {
+          settle(`Upload ${taskId} did not finish within ${Math.round(timeoutMs / 60000)} minutes`);
+          return;
+        }
+        timer = setTimeout(check, Math.min(TRANSFER_CHECK_MS, Math.max(0, deadline - Date.now())));
+      };
+      this.transferWaiters.set(taskId, waiter);
+      timer = setTimeout(check, Math.min(TRANSFER_CHECK_MS, timeoutMs));
+    });
+  }
+
+  // Check a folder against the metadata cache, asking Drive only when the entry is stale or unknown
+  async ensureFolderAccessible(folderId) {
+    await this.metadataCache.ready();
+    const cached = this.metadataCache.getFile(folderId);
+    if (cached?.fresh) {
+      return true;
+    }
+    if (!cached && this.metadataCache.isMissing(`id:${folderId}`)) {
+      return false;
+    }
+    return this.verifyFolderAccess(folderId);
+  }
+
+  // Host part of an upload URL, for the scheduler's per-host limit
+  uploadHost() {
+    const match = /^https?:\/\/([^/]+)/.exec(this.uploadBase);
+    return match ? match[1] : this.uploadBase;
+  }
+
   // Secure token storage
   async storeTokens(accessToken, refreshToken) {
     try {
@@ -139,7 +377,7 @@ class GoogleDriveService {
     try {
       await GoogleSignin.signOut();
       await this.clearTokens();
-      this.appFolderId = null;
+      await this.clearFolderCache();
       console.log('[GoogleDriveService] Sign-out successful');
     } catch (error) {
       console.error('[GoogleDriveService] Sign-out failed:', error);
@@ -149,52 +387,46 @@ class GoogleDriveService {
 
   // Create or find app folder in Google Drive
   async getOrCreateAppFolder() {
-    if (this.appFolderId) {
+    await this.metadataCache.ready();
+    const cached = this.metadataCache.getFolder('root', APP_FOLDER_NAME);
+    if (cached && (cached.fresh || await this.verifyFolderAccess(cached.id))) {
+      this.appFolderId = cached.id;
       return this.appFolderId;
     }
 
-    try {
-      const token = await this.getValidToken();
+    // Concurrent syncs share one search/create
+    const cacheKey = `root/${APP_FOLDER_NAME}`;
+    if (!this.pendingFolderLookups.has(cacheKey)) {
+      const lookup = this.findOrCreateAppFolder().finally(() => this.pendingFolderLookups.delete(cacheKey));
+      this.pendingFolderLookups.set(cacheKey, lookup);
+    }
+    return this.pendingFolderLookups.get(cacheKey);
+  }
 
+  async findOrCreateAppFolder() {
+    try {
       // Search for existing folder
-      const searchResponse = await fetch(
-        `${DRIVE_API_BASE}/files?q=name='ArcoScribe Recordings' and mimeType='application/vnd.google-apps.folder' and trashed=false`,
-        {
-          headers: { 'Authorization': `Bearer ${token}` },
-        }
+      const searchQuery = `name='${APP_FOLDER_NAME}' and mimeType='${FOLDER_MIME_TYPE}' and trashed=false`;
+      const searchData = await this.batchClient.requestJson(
+        'GET',
+        `/files?q=${encodeURIComponent(searchQuery)}&fields=files(${FILE_FIELDS})`
       );
 
-      if (!searchResponse.ok) {
-        throw new Error(`Drive API search failed: ${searchResponse.status}`);
-      }
-
-      const searchData = await searchResponse.json();
-
       if (searchData.files && searchData.files.length > 0) {
         this.appFolderId = searchData.files[0].id;
+        this.metadataCache.putFolder('root', APP_FOLDER_NAME, searchData.files[0]);
         console.log('[GoogleDriveService] Found existing app folder:', this.appFolderId);
         return this.appFolderId;
       }
 
       // Create new folder
-      const createResponse = await fetch(`${DRIVE_API_BASE}/files`, {
-        method: 'POST',
-        headers: {
-          'Authorization': `Bearer ${token}`,
-          'Content-Type': 'application/json',
-        },
-        body: JSON.stringify({
-          name: 'ArcoScribe Recordings',
-          mimeType: 'application/vnd.google-apps.folder',
-        }),
+      const folderData = await this.batchClient.requestJson('POST', '/files', {
+        name: APP_FOLDER_NAME,
+        mimeType: FOLDER_MIME_TYPE,
       });
-
-      if (!createResponse.ok) {
-        throw new Error(`Failed to create app folder: ${createResponse.status}`);
-      }
-
-      const folderData = await createResponse.json();
       this.appFolderId = folderData.id;
+      this.createdFolderIds.add(folderData.id);
+      this.metadataCache.putFolder('root', APP_FOLDER_NAME, folderData);
       console.log('[GoogleDriveService] Created new app folder:', this.appFolderId);
       return this.appFolderId;
 
@@ -264,57 +496,67 @@ class GoogleDriveService {
 
   // Helper: Get or create subfolder
   async getOrCreateSubfolder(parentId, folderName) {
-    try {
-      const token = await this.getValidToken();
-
-      // Sanitize folder name for Drive compatibility
-      const sanitizedFolderName = this.sanitizeFolderName(folderName);
+    // Sanitize folder name for Drive compatibility
+    const sanitizedFolderName = this.sanitizeFolderName(folderName);
+    const cacheKey = `${parentId}/${sanitizedFolderName}`;
+
+    await this.metadataCache.ready();
+    const cached = this.metadataCache.getFolder(parentId, sanitizedFolderName);
+    if (cached?.fresh) {
+      return cached.id;
+    }
+    if (cached) {
+      // Stale entry: make sure the folder was not renamed, moved or trashed (a 304 if nothing changed)
+      const metadata = await this.fetchFileMetadata(cached.id).catch(() => null);
+      if (metadata && metadata.name === sanitizedFolderName && (metadata.parents || []).includes(parentId)) {
+        return cached.id;
+      }
+      this.metadataCache.forgetFolder(parentId, sanitizedFolderName);
+    }
 
-      // Search for existing subfolder
-      const searchQuery = `name='${sanitizedFolderName}' and '${parentId}' in parents and mimeType='application/vnd.google-apps.folder' and trashed=false`;
-      const searchResponse = await fetch(
-        `${DRIVE_API_BASE}/files?q=${encodeURIComponent(searchQuery)}`,
-        {
-          headers: { 'Authorization': `Bearer ${token}` },
-        }
-      );
+    // Concurrent syncs into the same month share one search/create
+    if (this.pendingFolderLookups.has(cacheKey)) {
+      return this.pendingFolderLookups.get(cacheKey);
+    }
 
-      if (!searchResponse.ok) {
-        throw new Error(`Drive API search failed: ${searchResponse.status} ${searchResponse.statusText}`);
-      }
+    const lookup = this.findOrCreateSubfolder(parentId, sanitizedFolderName)
+      .then(folder => {
+        this.metadataCache.putFolder(parentId, sanitizedFolderName, folder);
+        return folder.id;
+      })
+      .finally(() => this.pendingFolderLookups.delete(cacheKey));
+    this.pendingFolderLookups.set(cacheKey, lookup);
+    return lookup;
+  }
 
-      const searchData = await searchResponse.json();
+  async findOrCreateSubfolder(parentId, sanitizedFolderName) {
+    try {
+      // A folder we just created has no children we don't know about, so skip the search
+      if (!this.createdFolderIds.has(parentId)) {
+        const searchQuery = `name='${sanitizedFolderName}' and '${parentId}' in parents and mimeType='${FOLDER_MIME_TYPE}' and trashed=false`;
+        const searchData = await this.batchClient.requestJson(
+          'GET',
+          `/files?q=${encodeURIComponent(searchQuery)}&fields=files(${FILE_FIELDS})`
+        );
 
-      if (searchData.files && searchData.files.length > 0) {
-        console.log(`[GoogleDriveService] Found existing folder: ${sanitizedFolderName}`);
-        return searchData.files[0].id;
+        if (searchData.files && searchData.files.length > 0) {
+          console.log(`[GoogleDriveService] Found existing folder: ${sanitizedFolderName}`);
+          return searchData.files[0];
+        }
       }
 
       // Create new subfolder
-      const createResponse = await fetch(`${DRIVE_API_BASE}/files`, {
-        method: 'POST',
-        headers: {
-          'Authorization': `Bearer ${token}`,
-          'Content-Type': 'application/json',
-        },
-        body: JSON.stringify({
-          name: sanitizedFolderName,
-          mimeType: 'application/vnd.google-apps.folder',
-          parents: [parentId],
-        }),
+      const folderData = await this.batchClient.requestJson('POST', '/files', {
+        name: sanitizedFolderName,
+        mimeType: FOLDER_MIME_TYPE,
+        parents: [parentId],
       });
-
-      if (!createResponse.ok) {
-        const errorText = await createResponse.text();
-        throw new Error(`Failed to create folder: ${createResponse.status} ${createResponse.statusText} - ${errorText}`);
-      }
-
-      const folderData = await createResponse.json();
+      this.createdFolderIds.add(folderData.id);
       console.log(`[GoogleDriveService] Created new folder: ${sanitizedFolderName} (${folderData.id})`);
-      return folderData.id;
+      return { ...folderData, parents: [parentId] };
 
     } catch (error) {
-      console.error(`[GoogleDriveService] Failed to get/create subfolder "${folderName}":`, error);
+      console.error(`[GoogleDriveService] Failed to get/create subfolder "${sanitizedFolderName}":`, error);
       throw error;
     }
   }
@@ -414,18 +656,8 @@ class GoogleDriveService {
   // Verify folder exists and is accessible
   async verifyFolderAccess(folderId) {
     try {
-      const token = await this.getValidToken();
-
-      const response = await fetch(`${DRIVE_API_BASE}/files/${folderId}?fields=id,name,parents,trashed`, {
-        headers: { 'Authorization': `Bearer ${token}` },
-      });
-
-      if (!response.ok) {
-        return false;
-      }
-
-      const folderData = await response.json();
-      return !folderData.trashed;
+      // Parallel uploads into one folder share a single batched lookup
+      return Boolean(await this.fetchFileMetadata(folderId));
 
     } catch (error) {
       console.error('[GoogleDriveService] Error verifying folder access:', error);
@@ -439,7 +671,7 @@ class GoogleDriveService {
       const token = await this.getValidToken();
 
       const response = await fetch(
-        `${DRIVE_API_BASE}/files?q='${folderId}' in parents and trashed=false&pageSize=${maxResults}&fields=files(id,name,mimeType,createdTime,size)`,
+        `${this.apiBase}/files?q='${folderId}' in parents and trashed=false&pageSize=${maxResults}&fields=files(id,name,mimeType,createdTime,size)`,
         {
           headers: { 'Authorization': `Bearer ${token}` },
         }
@@ -468,8 +700,8 @@ class GoogleDriveService {
         throw new Error('Missing required parameters: filePath, fileName, or parentFolderId');
       }
 
-      // Ensure parent folder exists
-      const folderExists = await this.verifyFolderAccess(parentFolderId);
+      // Ensure parent folder exists (checked once, then remembered)
+      const folderExists = await this.ensureFolderAccessible(parentFolderId);
       if (!folderExists) {
         throw new Error(`Parent folder ${parentFolderId} does not exist or is not accessible`);
       }
@@ -493,7 +725,7 @@ class GoogleDriveService {
       // Use existing BackgroundTransferManager for consistency
       const taskId = await BackgroundTransferManager.startUploadTask({
         filePath: filePath,
-        apiUrl: `${DRIVE_UPLOAD_BASE}/files?uploadType=multipart`,
+        apiUrl: `${this.uploadBase}/files?uploadType=multipart`,
         headers: {
           'Authorization': `Bearer ${token}`,
           'Content-Type': 'multipart/related',
@@ -504,6 +736,7 @@ class GoogleDriveService {
           fileName,
           parentFolderId,
           fileType,
+          mimeType: fileType === 'pdf' ? 'application/pdf' : fileType === 'audio' ? 'audio/m4a' : 'application/octet-stream',
           originalFilePath: filePath,
           fileSize: fileStats.size,
           uploadStartTime: new Date().toISOString(),
@@ -519,22 +752,53 @@ class GoogleDriveService {
     }
   }
 
-  // Batch upload multiple files
+  // Upload a file through the background session and wait for Drive to confirm it
+  async uploadFileAndWait(filePath, fileName, parentFolderId, fileType = 'file') {
+    const taskId = await this.uploadFile(filePath, fileName, parentFolderId, fileType);
+    const event = await this.waitForTransfer(taskId);
+    let fileId = null;
+    try {
+      fileId = JSON.parse(event.response).id || null;
+    } catch (error) {
+      console.warn('[GoogleDriveService] Upload response was not JSON for task:', taskId);
+    }
+    if (fileId) {
+      this.metadataCache.putFile({ id: fileId, name: fileName, parents: [parentFolderId] });
+    }
+    return { taskId, fileId };
+  }
+
+  // Batch upload multiple files. Uploads run in parallel through the scheduler,
+  // smallest first, and this resolves once every upload has finished.
   async uploadMultipleFiles(uploads) {
+    const RNFS = require('react-native-fs');
+    const host = this.uploadHost();
+
+    // Size everything before queueing so the scheduler sees the whole batch and
+    // can put the small files first
+    const sizes = await Promise.all(uploads.map(({ filePath }) =>
+      RNFS.stat(filePath).then(stats => Number(stats.size), () => 0)));
+
+    const outcomes = await Promise.allSettled(uploads.map(({ filePath, fileName, parentFolderId, fileType }, index) =>
+      this.uploadScheduler.schedule({
+        size: sizes[index],
+        host,
+        run: () => this.uploadFileAndWait(filePath, fileName, parentFolderId, fileType),
+      })));
+
     const results = [];
     const errors = [];
-
-    for (const upload of uploads) {
-      try {
-        const { filePath, fileName, parentFolderId, fileType } = upload;
-        const result = await this.uploadFile(filePath, fileName, parentFolderId, fileType);
-        results.push({ ...upload, taskId: result, status: 'started' });
-      } catch (error) {
-        console.error(`[GoogleDriveService] Failed to start upload for ${upload.fileName}:`, error);
-        errors.push({ ...upload, error: error.message });
+    outcomes.forEach((outcome, index) => {
+      const upload = uploads[index];
+      if (outcome.status === 'fulfilled') {
+        results.push({ ...upload, ...outcome.value, status: 'uploaded' });
+      } else {
+        console.error(`[GoogleDriveService] Failed to upload ${upload.fileName}:`, outcome.reason);
+        errors.push({ ...upload, error: outcome.reason.message });
       }
-    }
+    });
 
+    console.log('[GoogleDriveService] Upload scheduler:', this.uploadScheduler.getStats());
     return { results, errors };
   }
 
@@ -555,13 +819,13 @@ class GoogleDriveService {
         throw new Error('Missing required parameters: fileName or parentFolderId');
       }
 
-      // Ensure parent folder exists
-      const folderExists = await this.verifyFolderAccess(parentFolderId);
+      // Ensure parent folder exists (checked once, then remembered)
+      const folderExists = await this.ensureFolderAccessible(parentFolderId);
       if (!folderExists) {
         throw new Error(`Parent folder ${parentFolderId} does not exist or is not accessible`);
       }
 
-      const response = await fetch(`${DRIVE_UPLOAD_BASE}/files?uploadType=multipart`, {
+      const response = await fetch(`${this.uploadBase}/files?uploadType=multipart`, {
         method: 'POST',
         headers: {
           'Authorization': `Bearer ${token}`,
@@ -579,6 +843,7 @@ class GoogleDriveService {
       }
 
       const result = await response.json();
+      this.metadataCache.putFile({ ...result, parents: [parentFolderId] });
       console.log('[GoogleDriveService] Text file uploaded:', fileName, result.id);
       return result.id;
 
@@ -613,13 +878,13 @@ class GoogleDriveService {
         throw new Error('Missing required parameters: docName or parentFolderId');
       }
 
-      // Ensure parent folder exists
-      const folderExists = await this.verifyFolderAccess(parentFolderId);
+      // Ensure parent folder exists (checked once, then remembered)
+      const folderExists = await this.ensureFolderAccessible(parentFolderId);
       if (!folderExists) {
         throw new Error(`Parent folder ${parentFolderId} does not exist or is not accessible`);
       }
 
-      const response = await fetch(`${DRIVE_UPLOAD_BASE}/files?uploadType=multipart`, {
+      const response = await fetch(`${this.uploadBase}/files?uploadType=multipart`, {
         method: 'POST',
         headers: {
           'Authorization': `Bearer ${token}`,
@@ -638,6 +903,7 @@ class GoogleDriveService {
       }
 
       const result = await response.json();
+      this.metadataCache.putFile({ ...result, parents: [parentFolderId] });
       console.log('[GoogleDriveService] Google Doc uploaded:', docName, result.id);
       return result.id;
 
@@ -697,115 +963,203 @@ class GoogleDriveService {
   async syncRecording(recordingId) {
     try {
       console.log('[GoogleDriveService] Starting sync for recording:', recordingId);
-      
+      const syncStart = Date.now();
+      const statsBefore = this.batchClient.getStats();
+      const cacheBefore = this.metadataCache.getStats();
+      await this.refreshMetadataCache();
+
       // Get recording metadata from local storage
       const recording = await getRecordingById(recordingId);
       if (!recording) {
         throw new Error('Recording not found');
       }
 
-      // Create recording folder in Drive
-      const recordingFolderId = await this.createRecordingFolder(
-        recording.title || 'Untitled Recording',
-        recording.date
-      );
+      // Reuse the folder from the last sync so unchanged artifacts stay next to updated ones
+      const previousSync = recording.googleDriveSync || null;
+      let recordingFolderId = null;
+      if (previousSync?.folderId && await this.ensureFolderAccessible(previousSync.folderId)) {
+        recordingFolderId = previousSync.folderId;
+      } else {
+        recordingFolderId = await this.createRecordingFolder(
+          recording.title || 'Untitled Recording',
+          recording.date
+        );
+      }
+
+      // Delta sync: compare chunk manifests against the last sync and skip unchanged artifacts
+      const sameFolder = recordingFolderId === previousSync?.folderId;
+      const savedManifests = previousSync ? await loadManifests(previousSync.manifestPath) : {};
+      const previousManifests = sameFolder ? savedManifests : {};
+      const previousUploads = new Map(sameFolder ? (previousSync.uploads || []).map(upload => [upload.type, upload]) : []);
+
+      // Audio evicted to Drive (see StorageManager) is not on disk to upload again; its
+      // last upload stands, even when the folder had to be recreated
+      const audioIsLocal = Boolean(recording.filePath) && recording.audioStorage !== 'drive';
+      const evictedAudioUpload = recording.audioStorage === 'drive'
+        ? (previousSync?.uploads || []).find(upload => upload?.type === 'audio' && upload.fileId) || null
+        : null;
+
+      const hashStart = Date.now();
+      const manifests = {};
+      if (audioIsLocal) {
+        manifests.audio = await this.computeAudioManifest(recording.filePath, previousManifests.audio);
+      }
+      if (recording.transcript) {
+        manifests.transcript = computeTextManifest(recording.transcript);
+      }
+      if (recording.summary) {
+        manifests.summary = computeTextManifest(recording.summary);
+      }
+      const hashMs = Date.now() - hashStart;
 
       const results = {
         folderId: recordingFolderId,
         uploads: [],
+        skipped: [],
         errors: [],
       };
 
-      // Upload audio file
-      if (recording.filePath) {
-        try {
-          const RNFS = require('react-native-fs');
-          const audioExists = await RNFS.exists(recording.filePath);
-          
-          if (audioExists) {
-            const audioFileName = `${recording.title || 'Recording'}.m4a`;
-            const audioTaskId = await this.uploadFile(
-              recording.filePath,
-              audioFileName,
-              recordingFolderId,
-              'audio'
-            );
-            results.uploads.push({
-              type: 'audio',
-              fileName: audioFileName,
-              taskId: audioTaskId,
-            });
-          } else {
-            console.warn('[GoogleDriveService] Audio file not found:', recording.filePath);
-            results.errors.push({
-              type: 'audio',
-              error: 'Audio file not found',
-            });
-          }
-        } catch (error) {
-          console.error('[GoogleDriveService] Failed to upload audio:', error);
-          results.errors.push({
-            type: 'audio',
-            error: error.message,
-          });
+      // The three uploads are independent, so they run together through the scheduler
+      const uploadAudio = async () => {
+        const RNFS = require('react-native-fs');
+        const audioExists = await RNFS.exists(recording.filePath);
+        if (!audioExists) {
+          console.warn('[GoogleDriveService] Audio file not found:', recording.filePath);
+          throw new Error('Audio file not found');
         }
-      }
+        const audioFileName = `${recording.title || 'Recording'}.m4a`;
+        const { taskId, fileId } = await this.uploadFileAndWait(
+          recording.filePath,
+          audioFileName,
+          recordingFolderId,
+          'audio'
+        );
+        return { type: 'audio', fileName: audioFileName, taskId, fileId };
+      };
 
-      // Upload transcript as Google Doc
-      if (recording.transcript) {
-        try {
-          const transcriptName = `${recording.title || 'Recording'}_Transcript`;
-          const transcriptId = await this.uploadTextAsGoogleDoc(
-            recording.transcript,
-            transcriptName,
-            recordingFolderId
-          );
-          results.uploads.push({
-            type: 'transcript',
-            fileName: transcriptName,
-            fileId: transcriptId,
-          });
-        } catch (error) {
-          console.error('[GoogleDriveService] Failed to upload transcript:', error);
-          results.errors.push({
-            type: 'transcript',
-            error: error.message,
-          });
+      // Upload transcript as Google Doc (updated in place when it was synced before)
+      const uploadTranscript = async () => {
+        const previous = previousUploads.get('transcript');
+        if (previous?.fileId && await this.updateTextFileContent(previous.fileId, recording.transcript, 'text/plain')) {
+          return previous;
         }
+        const transcriptName = `${recording.title || 'Recording'}_Transcript`;
+        const transcriptId = await this.uploadTextAsGoogleDoc(
+          recording.transcript,
+          transcriptName,
+          recordingFolderId
+        );
+        return { type: 'transcript', fileName: transcriptName, fileId: transcriptId };
+      };
+
+      // Upload summary as markdown file (updated in place when it was synced before)
+      const uploadSummary = async () => {
+        const previous = previousUploads.get('summary');
+        if (previous?.fileId && await this.updateTextFileContent(previous.fileId, recording.summary, 'text/markdown')) {
+          return previous;
+        }
+        const summaryName = `${recording.title || 'Recording'}_Summary.md`;
+        const summaryId = await this.uploadTextFile(
+          recording.summary,
+          summaryName,
+          recordingFolderId
+        );
+        return { type: 'summary', fileName: summaryName, fileId: summaryId };
+      };
+
+      const candidates = [
+        audioIsLocal && { type: 'audio', run: uploadAudio },
+        recording.transcript && { type: 'transcript', run: uploadTranscript },
+        recording.summary && { type: 'summary', run: uploadSummary },
+      ].filter(Boolean);
+
+      let bytesSkipped = 0;
+      let bytesUploaded = 0;
+      if (evictedAudioUpload) {
+        results.uploads.push(evictedAudioUpload);
+        results.skipped.push('audio');
+        if (savedManifests.audio) manifests.audio = savedManifests.audio;
+      } else if (recording.audioStorage === 'drive') {
+        console.warn('[GoogleDriveService] Audio was evicted but has no Drive upload; restore it to sync it again');
       }
+      const unchanged = await Promise.all(candidates.map(async (job) => {
+        const manifest = manifests[job.type];
+        const previous = previousUploads.get(job.type);
+        const delta = manifest ? diffManifests(previous ? previousManifests[job.type] : null, manifest) : null;
+        return Boolean(delta?.unchanged) && this.isArtifactPresent(previous, recordingFolderId, manifest);
+      }));
+
+      const jobs = [];
+      candidates.forEach((job, index) => {
+        const size = manifests[job.type]?.size || 0;
+        if (unchanged[index]) {
+          results.uploads.push(previousUploads.get(job.type));
+          results.skipped.push(job.type);
+          bytesSkipped += size;
+        } else {
+          bytesUploaded += size;
+          jobs.push(job);
+        }
+      });
 
-      // Upload summary as markdown file
-      if (recording.summary) {
-        try {
-          const summaryName = `${recording.title || 'Recording'}_Summary.md`;
-          const summaryId = await this.uploadTextFile(
-            recording.summary,
-            summaryName,
-            recordingFolderId
-          );
-          results.uploads.push({
-            type: 'summary',
-            fileName: summaryName,
-            fileId: summaryId,
-          });
-        } catch (error) {
-          console.error('[GoogleDriveService] Failed to upload summary:', error);
-          results.errors.push({
-            type: 'summary',
-            error: error.message,
-          });
+      // Scheduled so transcript and summary finish ahead of the audio
+      const host = this.uploadHost();
+      const outcomes = await Promise.allSettled(jobs.map(job => this.uploadScheduler.schedule({
+        size: manifests[job.type]?.size || 0,
+        host,
+        run: job.run,
+      })));
+      outcomes.forEach((outcome, index) => {
+        const { type } = jobs[index];
+        if (outcome.status === 'fulfilled') {
+          results.uploads.push(outcome.value);
+        } else {
+          console.error(`[GoogleDriveService] Failed to upload ${type}:`, outcome.reason);
+          results.errors.push({ type, error: outcome.reason.message });
+          delete manifests[type]; // Failed artifacts are retried in full next time
         }
+      });
+
+      // Store manifests beside the recording; the sync metadata only points at them
+      let manifestPath = previousSync?.manifestPath || null;
+      try {
+        if (!manifestPath && recording.filePath) {
+          const directory = recording.filePath.substring(0, recording.filePath.lastIndexOf('/'));
+          manifestPath = `${directory}/${recording.id}_manifest.json`;
+        }
+        if (manifestPath) {
+          await saveManifests(manifests, manifestPath);
+        }
+      } catch (error) {
+        console.error('[GoogleDriveService] Failed to save chunk manifests:', error);
+        manifestPath = null;
       }
 
-      // Update recording with sync metadata
-      await updateRecording(recordingId, {
+      // Only the sync metadata is saved, onto the recording as it is now: `recording`
+      // was read before the uploads, and its summary, title or status may have
+      // changed while they ran
+      await updateRecordingFields(recordingId, {
         googleDriveSync: {
           folderId: recordingFolderId,
           lastSynced: new Date().toISOString(),
           uploads: results.uploads,
+          manifestPath,
         },
       });
 
+      MetricsService.record('drive.hashMs', 'ms', hashMs);
+      MetricsService.count('drive.bytesUploaded', bytesUploaded);
+      MetricsService.count('drive.bytesSkipped', bytesSkipped);
+      results.skipped.forEach(type => MetricsService.count(`drive.skipped.${type}`));
+      const statsAfter = this.batchClient.getStats();
+      MetricsService.record('drive.syncMs', 'ms', Date.now() - syncStart);
+      MetricsService.count('drive.metadataRequests', statsAfter.requests - statsBefore.requests);
+      MetricsService.count('drive.metadataRoundTrips', statsAfter.roundTrips - statsBefore.roundTrips);
+      const cacheAfter = this.metadataCache.getStats();
+      MetricsService.count('drive.cacheHits', cacheAfter.hits - cacheBefore.hits);
+      MetricsService.count('drive.cacheMisses', cacheAfter.misses - cacheBefore.misses);
+      MetricsService.count('drive.cacheNotModified', cacheAfter.notModified - cacheBefore.notModified);
+      MetricsService.count('drive.cacheNegativeHits', cacheAfter.negativeHits - cacheBefore.negativeHits);
       console.log('[GoogleDriveService] Sync completed for recording:', recordingId, results);
       return results;
 
@@ -815,6 +1169,105 @@ class GoogleDriveService {
     }
   }
 
+  // Chunk manifest for the audio file, reusing the previous one when size and mtime match
+  async computeAudioManifest(filePath, previousManifest) {
+    try {
+      const RNFS = require('react-native-fs');
+      if (!(await RNFS.exists(filePath))) {
+        return null;
+      }
+      const stats = await RNFS.stat(filePath);
+      const mtime = new Date(stats.mtime).getTime();
+      if (previousManifest && previousManifest.size === Number(stats.size) && previousManifest.mtime === mtime) {
+        return previousManifest;
+      }
+      const manifest = await BackgroundTransferManager.computeChunkManifest(filePath, CHUNK_PROFILES.audio);
+      return { ...manifest, mtime };
+    } catch (error) {
+      console.error('[GoogleDriveService] Failed to compute audio manifest:', error);
+      return null;
+    }
+  }
+
+  // Confirm a skipped artifact still exists in Drive. Audio synced by older versions
+  // only recorded the upload task, so it has to be looked up by name.
+  async isArtifactPresent(previousUpload, folderId, manifest) {
+    if (previousUpload.fileId) {
+      const cached = this.metadataCache.getFile(previousUpload.fileId);
+      if (cached?.fresh) {
+        return true;
+      }
+      if (!cached && this.metadataCache.isMissing(`id:${previousUpload.fileId}`)) {
+        return false;
+      }
+      return Boolean(await this.fetchFileMetadata(previousUpload.fileId));
+    }
+    const missingKey = `${folderId}/${previousUpload.fileName}`;
+    if (this.metadataCache.isMissing(missingKey)) {
+      return false;
+    }
+    const searchQuery = `name='${previousUpload.fileName.replace(/'/g, "\\'")}' and '${folderId}' in parents and trashed=false`;
+    const response = await this.batchClient.request('GET', `/files?q=${encodeURIComponent(searchQuery)}&fields=files(${FILE_FIELDS})`);
+    const file = response.status === 200 ? response.body.files?.[0] : null;
+    if (!file) {
+      if (response.status === 200) this.metadataCache.putMissing(missingKey);
+      return false;
+    }
+    if (Number(file.size) === manifest.size) {
+      previousUpload.fileId = file.id;
+      this.metadataCache.putFile(file);
+      return true;
+    }
+    return false;
+  }
+
+  // Replace the content of an existing Drive file. Returns false if the file is gone.
+  async updateTextFileContent(fileId, content, mimeType) {
+    const token = await this.getValidToken();
+    const response = await fetch(`${this.uploadBase}/files/${fileId}?uploadType=media`, {
+      method: 'PATCH',
+      headers: {
+        'Authorization': `Bearer ${token}`,
+        'Content-Type': mimeType,
+      },
+      body: content,
+    });
+
+    if (response.status === 404) {
+      this.metadataCache.removeFile(fileId);
+      return false;
+    }
+    if (!response.ok) {
+      const errorText = await response.text();
+      throw new Error(`Update failed: ${response.status} ${response.statusText} - ${errorText}`);
+    }
+    this.metadataCache.putFile(await response.json());
+    console.log('[GoogleDriveService] Updated file content:', fileId);
+    return true;
+  }
+
+  // Sync several recordings with a few in flight at once, so their folder lookups
+  // and checks share batched requests instead of running back to back
+  async syncRecordings(recordingIds, concurrency = 4) {
+    const results = [];
+    const errors = [];
+    let next = 0;
+
+    const worker = async () => {
+      while (next < recordingIds.length) {
+        const recordingId = recordingIds[next++];
+        try {
+          results.push({ recordingId, ...(await this.syncRecording(recordingId)) });
+        } catch (error) {
+          errors.push({ recordingId, error: error.message });
+        }
+      }
+    };
+
+    await Promise.all(Array.from({ length: Math.min(concurrency, recordingIds.length) }, worker));
+    return { results, errors };
+  }
+
   // Get active upload tasks
   async getActiveUploadTasks() {
     try {
@@ -886,42 +1339,11 @@ class GoogleDriveService {
     }
   }
 
-  // Create shareable link for a file
+  // Create shareable link for a file (queued with the other mutations; resolves once applied)
   async createShareableLink(fileId, permissions = 'reader') {
     try {
-      const token = await this.getValidToken();
-
-      // Create permission for anyone with link
-      const permissionResponse = await fetch(`${DRIVE_API_BASE}/files/${fileId}/permissions`, {
-        method: 'POST',
-        headers: {
-          'Authorization': `Bearer ${token}`,
-          'Content-Type': 'application/json',
-        },
-        body: JSON.stringify({
-          type: 'anyone',
-          role: permissions,
-        }),
-      });
-
-      if (!permissionResponse.ok) {
-        throw new Error(`Failed to create permission: ${permissionResponse.status}`);
-      }
-
-      // Get the shareable link
-      const fileResponse = await fetch(`${DRIVE_API_BASE}/files/${fileId}?fields=webViewLink,webContentLink`, {
-        headers: { 'Authorization': `Bearer ${token}` },
-      });
-
-      if (!fileResponse.ok) {
-        throw new Error(`Failed to get file info: ${fileResponse.status}`);
-      }
-
-      const fileData = await fileResponse.json();
-      return {
-        viewLink: fileData.webViewLink,
-        downloadLink: fileData.webContentLink,
-      };
+      const { completion } = await this.operationQueue.enqueue({ kind: 'share', fileId, role: permissions });
+      return await completion;
 
     } catch (error) {
       console.error('[GoogleDriveService] Failed to create shareable link:', error);
@@ -929,21 +1351,12 @@ class GoogleDriveService {
     }
   }
 
-  // Delete file or folder
+  // Delete file or folder. Like rename and move, this is journaled and resolves once
+  // queued, so it works offline and survives the app being killed.
   async deleteFile(fileId) {
     try {
-      const token = await this.getValidToken();
-
-      const response = await fetch(`${DRIVE_API_BASE}/files/${fileId}`, {
-        method: 'DELETE',
-        headers: { 'Authorization': `Bearer ${token}` },
-      });
-
-      if (!response.ok && response.status !== 404) {
-        throw new Error(`Failed to delete file: ${response.status}`);
-      }
-
-      console.log('[GoogleDriveService] File deleted:', fileId);
+      await this.operationQueue.enqueue({ kind: 'delete', fileId });
+      console.log('[GoogleDriveService] File delete queued:', fileId);
       return true;
 
     } catch (error) {
@@ -955,34 +1368,8 @@ class GoogleDriveService {
   // Move file to a different folder
   async moveFile(fileId, newParentId, removeFromCurrentParents = true) {
     try {
-      const token = await this.getValidToken();
-
-      let url = `${DRIVE_API_BASE}/files/${fileId}?addParents=${newParentId}`;
-      
-      if (removeFromCurrentParents) {
-        // Get current parents first
-        const fileResponse = await fetch(`${DRIVE_API_BASE}/files/${fileId}?fields=parents`, {
-          headers: { 'Authorization': `Bearer ${token}` },
-        });
-        
-        if (fileResponse.ok) {
-          const fileData = await fileResponse.json();
-          if (fileData.parents && fileData.parents.length > 0) {
-            url += `&removeParents=${fileData.parents.join(',')}`;
-          }
-        }
-      }
-
-      const response = await fetch(url, {
-        method: 'PATCH',
-        headers: { 'Authorization': `Bearer ${token}` },
-      });
-
-      if (!response.ok) {
-        throw new Error(`Failed to move file: ${response.status}`);
-      }
-
-      console.log('[GoogleDriveService] File moved:', fileId, 'to', newParentId);
+      await this.operationQueue.enqueue({ kind: 'move', fileId, newParentId, removeFromCurrentParents });
+      console.log('[GoogleDriveService] File move queued:', fileId, 'to', newParentId);
       return true;
 
     } catch (error) {
@@ -994,26 +1381,94 @@ class GoogleDriveService {
   // Rename file or folder
   async renameFile(fileId, newName) {
     try {
-      const token = await this.getValidToken();
+      await this.operationQueue.enqueue({ kind: 'rename', fileId, name: newName });
+      console.log('[GoogleDriveService] File rename queued:', fileId, 'to', newName);
+      return true;
 
-      const response = await fetch(`${DRIVE_API_BASE}/files/${fileId}`, {
-        method: 'PATCH',
-        headers: {
-          'Authorization': `Bearer ${token}`,
-          'Content-Type': 'application/json',
-        },
-        body: JSON.stringify({ name: newName }),
-      });
+    } catch (error) {
+      console.error('[GoogleDriveService] Failed to rename file:', error);
+      throw error;
+    }
+  }
 
-      if (!response.ok) {
-        throw new Error(`Failed to rename file: ${response.status}`);
+  // Apply one queued mutation to Drive (called by the operation queue, possibly after a restart)
+  async performOperation(op) {
+    switch (op.kind) {
+      case 'share': {
+        // The permission create and link lookup are independent, so they go out in one batch
+        const [, fileData] = await Promise.all([
+          this.batchClient.requestJson('POST', `/files/${op.fileId}/permissions`, {
+            type: 'anyone',
+            role: op.role,
+          }),
+          this.batchClient.requestJson('GET', `/files/${op.fileId}?fields=webViewLink,webContentLink`),
+        ]);
+        return {
+          viewLink: fileData.webViewLink,
+          downloadLink: fileData.webContentLink,
+        };
       }
 
-      console.log('[GoogleDriveService] File renamed:', fileId, 'to', newName);
-      return true;
+      case 'delete':
+        await this.batchClient.requestJson('DELETE', `/files/${op.fileId}`, null, { allowStatus: [404] });
+        this.metadataCache.removeFile(op.fileId);
+        console.log('[GoogleDriveService] File deleted:', op.fileId);
+        return true;
+
+      case 'move': {
+        let path = `/files/${op.fileId}?addParents=${op.newParentId}`;
+        if (op.removeFromCurrentParents) {
+          // Get current parents first
+          const fileResponse = await this.batchClient.request('GET', `/files/${op.fileId}?fields=parents`);
+          const parents = (fileResponse.status === 200 ? fileResponse.body.parents : null) || [];
+          const removeParents = parents.filter(id => id !== op.newParentId);
+          if (removeParents.length > 0) {
+            path += `&removeParents=${removeParents.join(',')}`;
+          }
+        }
+        await this.batchClient.requestJson('PATCH', path, {});
+        this.metadataCache.removeFile(op.fileId); // Cached paths under the old parent no longer apply
+        console.log('[GoogleDriveService] File moved:', op.fileId, 'to', op.newParentId);
+        return true;
+      }
 
+      case 'rename':
+        await this.batchClient.requestJson('PATCH', `/files/${op.fileId}`, { name: op.name });
+        this.metadataCache.removeFile(op.fileId);
+        console.log('[GoogleDriveService] File renamed:', op.fileId, 'to', op.name);
+        return true;
+
+      default:
+        throw new Error(`Unknown Drive operation: ${op.kind}`);
+    }
+  }
+
+  // Download a file's content to a local path (e.g. audio evicted by StorageManager).
+  // Written to a temp file first so a failed download never leaves a partial file behind.
+  async downloadFile(fileId, destPath) {
+    const RNFS = require('react-native-fs');
+    const tempPath = `${destPath}.download`;
+    try {
+      const token = await this.getValidToken();
+      const { promise } = RNFS.downloadFile({
+        fromUrl: `${this.apiBase}/files/${fileId}?alt=media`,
+        toFile: tempPath,
+        headers: { 'Authorization': `Bearer ${token}` },
+      });
+      const { statusCode, bytesWritten } = await promise;
+      if (statusCode < 200 || statusCode >= 300) {
+        throw new Error(`Failed to download file: ${statusCode}`);
+      }
+      if (await RNFS.exists(destPath)) {
+        await RNFS.unlink(destPath);
+      }
+      await RNFS.moveFile(tempPath, destPath);
+      return bytesWritten;
     } catch (error) {
-      console.error('[GoogleDriveService] Failed to rename file:', error);
+      if (await RNFS.exists(tempPath)) {
+        await RNFS.unlink(tempPath).catch(() => {});
+      }
+      console.error('[GoogleDriveService] Failed to download file:', error);
       throw error;
     }
   }
@@ -1021,10 +1476,16 @@ class GoogleDriveService {
   // Get file metadata
   async getFileMetadata(fileId) {
     try {
+      await this.metadataCache.ready();
+      const cached = this.metadataCache.getFile(fileId);
+      if (cached?.fresh && cached.metadata.webViewLink) {
+        return cached.metadata;
+      }
+
       const token = await this.getValidToken();
 
       const response = await fetch(
-        `${DRIVE_API_BASE}/files/${fileId}?fields=id,name,mimeType,size,createdTime,modifiedTime,parents,webViewLink,webContentLink`,
+        `${this.apiBase}/files/${fileId}?fields=id,name,mimeType,size,createdTime,modifiedTime,parents,webViewLink,webContentLink`,
         {
           headers: { 'Authorization': `Bearer ${token}` },
         }
@@ -1034,7 +1495,9 @@ class GoogleDriveService {
         throw new Error(`Failed to get file metadata: ${response.status}`);
       }
 
-      return await response.json();
+      const metadata = await response.json();
+      this.metadataCache.putFile(metadata);
+      return metadata;
 
     } catch (error) {
       console.error('[GoogleDriveService] Failed to get file metadata:', error);
@@ -1048,7 +1511,7 @@ class GoogleDriveService {
       const token = await this.getValidToken();
 
       const response = await fetch(
-        `${DRIVE_API_BASE}/files?q=${encodeURIComponent(query)}&pageSize=${pageSize}&fields=files(id,name,mimeType,createdTime,size)`,
+        `${this.apiBase}/files?q=${encodeURIComponent(query)}&pageSize=${pageSize}&fields=files(id,name,mimeType,createdTime,size)`,
         {
           headers: { 'Authorization': `Bearer ${token}` },
         }
@@ -1073,7 +1536,7 @@ class GoogleDriveService {
       const token = await this.getValidToken();
 
       const response = await fetch(
-        `${DRIVE_API_BASE}/about?fields=storageQuota`,
+        `${this.apiBase}/about?fields=storageQuota`,
         {
           headers: { 'Authorization': `Bearer ${token}` },
         }
@@ -1092,20 +1555,21 @@ class GoogleDriveService {
     }
   }
 
-  // Batch delete multiple files
+  // Batch delete multiple files (queued together, so they drain as one batched round-trip)
   async batchDelete(fileIds) {
     const results = [];
     const errors = [];
 
-    for (const fileId of fileIds) {
-      try {
-        await this.deleteFile(fileId);
-        results.push({ fileId, status: 'deleted' });
-      } catch (error) {
-        console.error(`[GoogleDriveService] Failed to delete file ${fileId}:`, error);
-        errors.push({ fileId, error: error.message });
+    const outcomes = await Promise.allSettled(fileIds.map(fileId => this.deleteFile(fileId)));
+    outcomes.forEach((outcome, index) => {
+      const fileId = fileIds[index];
+      if (outcome.status === 'fulfilled') {
+        results.push({ fileId, status: 'queued' });
+      } else {
+        console.error(`[GoogleDriveService] Failed to delete file ${fileId}:`, outcome.reason);
+        errors.push({ fileId, error: outcome.reason.message });
       }
-    }
+    });
 
     return { results, errors };
   }
@@ -1151,7 +1615,7 @@ class GoogleDriveService {
       const token = await this.getValidToken();
       
       const response = await fetch(
-        `${DRIVE_API_BASE}/about?fields=user`,
+        `${this.apiBase}/about?fields=user`,
         {
           headers: { 'Authorization': `Bearer ${token}` },
         }
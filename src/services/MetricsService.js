@@ -0,0 +1,223 @@
+// Runtime metrics: the native registry (ios/ASMetrics.h) fed by the recorder,
+// exports and transfers - rollover gaps, export times, upload throughput,
+// in-flight transfers, bridge event counts - plus counters and histograms the
+// JS services record (Drive syncs, task recovery, eviction) and gauges from JS
+// sources such as the Drive upload queue, read in one getMetrics() call.
+//
+// With PERSIST_METRICS=true in .env, what accumulated since the last save is
+// merged into one file per day (ArcoScribe/metrics/YYYY-MM-DD.json) when the
+// app goes to the background and every PERSIST_INTERVAL_MS, so field
+// performance can be followed across launches. Counters and histogram buckets
+// add up over the day; gauges keep the last value and the day's peak.
+
+import { AppState, NativeModules } from 'react-native';
+import RNFS from 'react-native-fs';
+import { PERSIST_METRICS } from '@env';
+import { createDirectory, readJsonFile, saveJsonFile } from '../utils/FileUtils';
+
+const { AudioRecorderModule } = NativeModules;
+
+const METRICS_DIR = 'metrics';
+const PERSIST_INTERVAL_MS = 60 * 60 * 1000;
+const KEEP_DAYS = 30;
+const PERCENTILES = { p50: 0.5, p90: 0.9, p99: 0.99, p999: 0.999 };
+
+// Histogram buckets come as [lower bound, count]: exact below 32, then 16 per power of two
+const bucketWidth = lower => (lower < 32 ? 1 : 2 ** (Math.floor(Math.log2(lower)) - 4));
+
+// The native bucketing, for histograms recorded in JS
+const bucketLower = (value) => {
+  if (value < 32) return value;
+  const width = bucketWidth(value);
+  return Math.floor(value / width) * width;
+};
+
+export const percentileFromBuckets = (buckets, fraction, min = 0, max = Infinity) => {
+  const sorted = Object.entries(buckets).map(([lower, count]) => [Number(lower), count]).sort((a, b) => a[0] - b[0]);
+  const total = sorted.reduce((sum, [, count]) => sum + count, 0);
+  if (total === 0) return 0;
+  const rank = Math.min(total - 1, Math.floor(fraction * total));
+  let seen = 0;
+  for (const [lower, count] of sorted) {
+    seen += count;
+    if (seen > rank) return Math.min(max, Math.max(min, lower + Math.floor(bucketWidth(lower) / 2)));
+  }
+  return max;
+};
+
+const dayKey = (date = new Date()) => {
+  const pad = value => String(value).padStart(2, '0');
+  return `${date.getFullYear()}-${pad(date.getMonth() + 1)}-${pad(date.getDate())}`;
+};
+
+class MetricsService {
+  constructor() {
+    this.startedAt = Date.now();
+    this.counters = new Map();
+    this.histograms = new Map(); // name -> { unit, count, sum, min, max, buckets: { lower: count } }
+    this.sources = new Map();
+    this.lastSaved = null; // the snapshot (with buckets) the day file already includes
+    this.persistTimer = null;
+    this.appStateSubscription = null;
+    this.saving = null;
+  }
+
+  /**
+   * Add to a counter kept in JS.
+   * @param {string} name - 'area.metric', e.g. 'drive.bytesUploaded'
+   * @param {number} amount - Amount to add
+   */
+  count(name, amount = 1) {
+    this.counters.set(name, (this.counters.get(name) || 0) + amount);
+  }
+
+  /**
+   * Record a value in a histogram kept in JS (bucketed like the native ones).
+   * @param {string} name - 'area.metric', e.g. 'drive.syncMs'
+   * @param {string} unit - 'ms', 'us', 'bytes', ...
+   * @param {number} value - Non-negative value; rounded to an integer
+   */
+  record(name, unit, value) {
+    const rounded = Math.max(0, Math.round(value));
+    let histogram = this.histograms.get(name);
+    if (!histogram) {
+      histogram = { unit, count: 0, sum: 0, min: rounded, max: 0, buckets: {} };
+      this.histograms.set(name, histogram);
+    }
+    const lower = bucketLower(rounded);
+    histogram.buckets[lower] = (histogram.buckets[lower] || 0) + 1;
+    histogram.count++;
+    histogram.sum += rounded;
+    histogram.min = Math.min(histogram.min, rounded);
+    histogram.max = Math.max(histogram.max, rounded);
+  }
+
+  /**
+   * Register gauges computed in JS, reported under `gauges` as `${name}.${key}`.
+   * @param {string} name - Source name, e.g. 'drive.uploads'
+   * @param {Function} read - () => ({ key: number, ... })
+   */
+  addSource(name, read) {
+    this.sources.set(name, read);
+  }
+
+  /**
+   * Everything since launch: { since, uptime, counters, gauges: { name: { value, peak } },
+   * histograms: { name: { unit, count, sum, min, max, mean, p50, p90, p99, p999 } } }.
+   * @param {Object} options - { buckets: true } adds each histogram's [lower, count] buckets
+   * @returns {Promise<Object>}
+   */
+  async getMetrics(options = {}) {
+    const metrics = AudioRecorderModule?.getMetrics
+      ? await AudioRecorderModule.getMetrics(options)
+      : { since: this.startedAt, uptime: (Date.now() - this.startedAt) / 1000, counters: {}, gauges: {}, histograms: {} };
+    this.counters.forEach((value, name) => {
+      metrics.counters[name] = value;
+    });
+    this.histograms.forEach(({ buckets, ...histogram }, name) => {
+      const entry = { ...histogram, mean: histogram.count ? histogram.sum / histogram.count : 0 };
+      Object.entries(PERCENTILES).forEach(([key, fraction]) => {
+        entry[key] = percentileFromBuckets(buckets, fraction, histogram.min, histogram.max);
+      });
+      if (options.buckets) {
+        entry.buckets = Object.entries(buckets).map(([lower, count]) => [Number(lower), count]).sort((a, b) => a[0] - b[0]);
+      }
+      metrics.histograms[name] = entry;
+    });
+    for (const [name, read] of this.sources) {
+      try {
+        Object.entries(read() || {}).forEach(([key, value]) => {
+          metrics.gauges[`${name}.${key}`] = { value, peak: value };
+        });
+      } catch (error) {
+        console.warn(`[MetricsService] Source ${name} failed:`, error);
+      }
+    }
+    return metrics;
+  }
+
+  // Starts daily persistence when PERSIST_METRICS is set (or `force`); safe to call again
+  start(force = false) {
+    if ((PERSIST_METRICS !== 'true' && !force) || this.persistTimer) return;
+    this.persistTimer = setInterval(() => this.persist(), PERSIST_INTERVAL_MS);
+    this.appStateSubscription = AppState.addEventListener('change', (state) => {
+      if (state === 'background') this.persist();
+    });
+    console.log('[MetricsService] Daily metrics persistence started');
+  }
+
+  stop() {
+    if (this.persistTimer) clearInterval(this.persistTimer);
+    this.persistTimer = null;
+    this.appStateSubscription?.remove();
+    this.appStateSubscription = null;
+  }
+
+  // One save at a time; a save asked for during another runs after it
+  persist() {
+    const previous = this.saving || Promise.resolve();
+    this.saving = previous.then(() => this.mergeIntoDay()).catch((error) => {
+      console.error('[MetricsService] Failed to persist metrics:', error);
+    });
+    return this.saving;
+  }
+
+  async mergeIntoDay() {
+    const snapshot = await this.getMetrics({ buckets: true });
+    const date = dayKey();
+    const fileName = `${date}.json`;
+    const day = (await readJsonFile(fileName, METRICS_DIR)) || { date, counters: {}, gauges: {}, histograms: {} };
+    // The registry restarts with the process: a snapshot from an earlier launch is no baseline
+    const base = this.lastSaved?.since === snapshot.since ? this.lastSaved : null;
+
+    Object.entries(snapshot.counters).forEach(([name, value]) => {
+      day.counters[name] = (day.counters[name] || 0) + value - (base?.counters[name] || 0);
+    });
+    Object.entries(snapshot.gauges).forEach(([name, { value, peak }]) => {
+      day.gauges[name] = { value, peak: Math.max(peak, day.gauges[name]?.peak ?? peak) };
+    });
+    Object.entries(snapshot.histograms).forEach(([name, histogram]) => {
+      const saved = day.histograms[name] || { unit: histogram.unit, count: 0, sum: 0, min: histogram.min, max: 0, buckets: {} };
+      const baseBuckets = new Map(base?.histograms[name]?.buckets || []);
+      histogram.buckets.forEach(([lower, count]) => {
+        const added = count - (baseBuckets.get(lower) || 0);
+        if (added > 0) saved.buckets[lower] = (saved.buckets[lower] || 0) + added;
+      });
+      saved.count += histogram.count - (base?.histograms[name]?.count || 0);
+      saved.sum += histogram.sum - (base?.histograms[name]?.sum || 0);
+      // Since launch, so a launch that spans midnight lends the new day its extremes
+      if (histogram.count > 0) {
+        saved.min = Math.min(saved.min, histogram.min);
+        saved.max = Math.max(saved.max, histogram.max);
+      }
+      Object.entries(PERCENTILES).forEach(([key, fraction]) => {
+        saved[key] = percentileFromBuckets(saved.buckets, fraction, saved.min, saved.max);
+      });
+      day.histograms[name] = saved;
+    });
+    day.updatedAt = new Date().toISOString();
+
+    await saveJsonFile(fileName, day, METRICS_DIR);
+    this.lastSaved = snapshot;
+    await this.pruneDays();
+  }
+
+  async pruneDays() {
+    const dir = await createDirectory(METRICS_DIR);
+    const files = (await RNFS.readDir(dir)).filter(file => /^\d{4}-\d{2}-\d{2}\.json$/.test(file.name));
+    const expired = files.map(file => file.name).sort().slice(0, Math.max(0, files.length - KEEP_DAYS));
+    await Promise.all(expired.map(name => RNFS.unlink(`${dir}/${name}`).catch(() => {})));
+  }
+
+  /**
+   * The persisted days, oldest first.
+   * @returns {Promise<Array<Object>>}
+   */
+  async getDailyMetrics() {
+    const dir = await createDirectory(METRICS_DIR);
+    const names = (await RNFS.readDir(dir)).map(file => file.name).filter(name => name.endsWith('.json')).sort();
+    return (await Promise.all(names.map(name => readJsonFile(name, METRICS_DIR)))).filter(Boolean);
+  }
+}
+
+export default new MetricsService();
@@ -0,0 +1,544 @@
+// Local storage accounting and eviction for recordings.
+//
+// Every file in the recordings directories (segments, the merged file, the
+// alignment/speaker/manifest sidecars) is attributed to the recording that
+// references it, or recognised by its name, so the app knows how many bytes
+// each recording holds. When free space runs low, space is reclaimed in tiers:
+//   1. orphans: files of recordings that no longer exist
+//   2. redundant: segments already merged into `_merged.m4a` (after checking the
+//      merge, see commitMergedExports), merged files nothing points at, and
+//      per-speaker extracts
+//   3. synced: audio whose Drive copy is current, least recently used first; the
+//      recording is kept (audioStorage: 'drive') and restored on playback
+//   4. archive (opt-in): old, unsynced audio re-encoded to a small mono AAC file
+// Recordings that are being recorded or processed are never touched, and files
+// younger than a grace period are skipped so an in-flight export or a recording
+// whose metadata is not saved yet cannot be mistaken for an orphan.
+import RNFS from 'react-native-fs';
+import { NativeModules } from 'react-native';
+import MetricsService from './MetricsService';
+import {
+  commitMergedExports,
+  getRecordingById,
+  getRecordings,
+  getRecordingsFilePath,
+  updateRecordingFields,
+  updateRecordings,
+} from './AudioRecordingService';
+
+const { AudioRecorderModule } = NativeModules;
+
+const ACCESS_LOG_FILE_NAME = 'storage_access.json';
+// Files the recordings store itself needs; never evicted
+const STORE_FILE_NAMES = new Set(['recordings.json', 'recordings_index.json', ACCESS_LOG_FILE_NAME, 'test_write.txt']);
+const SEGMENT_NAME = /^rec_(.+?)_\d{8}T\d{6}Z_segment\d+\.m4a$/;
+const SIDECAR_NAME = /^(.+?)_(merged\.m4a|archive\.m4a|alignment\.bin|speakers\.json|manifest\.json)$/;
+const SIDECAR_KINDS = {
+  'merged.m4a': 'merged',
+  'archive.m4a': 'audio',
+  'alignment.bin': 'alignment',
+  'speakers.json': 'speakers',
+  'manifest.json': 'manifest',
+};
+// Per-speaker extracts (extractSpeakerAudio), named after the ElevenLabs speaker_id
+const SPEAKER_EXTRACT_NAME = /^(.+?)_speaker_[^/]+\.m4a$/;
+const BUSY_STATUSES = new Set(['recording_active', 'processing']);
+
+// The native recorder refuses to start below 100 MB; keep room for two hours of
+// 128 kbps audio on top of that before a new recording starts
+const NATIVE_MINIMUM_FREE_BYTES = 100 * 1024 * 1024;
+const RECORDING_BYTES_PER_HOUR = (128000 / 8) * 3600;
+export const DEFAULT_RECORDING_RESERVE_BYTES = NATIVE_MINIMUM_FREE_BYTES + 2 * RECORDING_BYTES_PER_HOUR;
+
+const GRACE_MS = 24 * 60 * 60 * 1000;
+const ARCHIVE_AFTER_MS = 30 * 24 * 60 * 60 * 1000;
+const ARCHIVE_PROFILE = { sampleRate: 22050, bitRate: 32000 };
+const ARCHIVE_RATIO = ARCHIVE_PROFILE.bitRate / 128000;
+
+const TIERS = ['orphan', 'redundant', 'synced', 'archive'];
+
+const directoryOf = filePath => filePath.substring(0, filePath.lastIndexOf('/'));
+const toMs = value => (value instanceof Date ? value.getTime() : Number(new Date(value)) || 0);
+
+const audioUploadOf = recording => (recording.googleDriveSync?.uploads || [])
+  .find(upload => upload?.type === 'audio' && upload.fileId) || null;
+
+const nameOf = filePath => filePath.substring(filePath.lastIndexOf('/') + 1);
+
+// Until the segments are merged, filePath is the first segment and the rest of
+// the audio lives only in the other segments (Drive has just the first one).
+// Decided from the files on disk rather than segmentPaths, which older builds
+// did not keep.
+const playsFromSegment = recording => SEGMENT_NAME.test(nameOf(recording.filePath || ''));
+
+/**
+ * Attribute scanned files to recordings.
+ * @param {Array<Object>} files - { path, name, size, mtime } from readDir (mtime in ms or Date)
+ * @param {Array<Object>} recordings - All recordings
+ * @param {Object} accessLog - recording ID -> last time it was opened (ms)
+ * @returns {Object} - { totalBytes, storeBytes, otherBytes, fileCount, orphans, byRecording: Map }
+ */
+export const buildStorageIndex = (files, recordings, accessLog = {}) => {
+  const recordingsById = new Map(recordings.map(recording => [recording.id, recording]));
+
+  // Paths the recordings point at; filePath wins over a segment at the same path
+  const owners = new Map();
+  recordings.forEach((recording) => {
+    (recording.segmentPaths || []).forEach((segmentPath) => {
+      if (segmentPath) owners.set(segmentPath, { recordingId: recording.id, kind: 'segment' });
+    });
+    [
+      [recording.alignmentPath, 'alignment'],
+      [recording.speakerTimelinePath, 'speakers'],
+      [recording.googleDriveSync?.manifestPath, 'manifest'],
+      [recording.filePath, 'audio'],
+    ].forEach(([filePath, kind]) => {
+      if (filePath) owners.set(filePath, { recordingId: recording.id, kind });
+    });
+  });
+
+  const index = { totalBytes: 0, storeBytes: 0, otherBytes: 0, fileCount: 0, orphans: [], byRecording: new Map() };
+  files.forEach((file) => {
+    const entry = { path: file.path, name: file.name, size: file.size, mtime: toMs(file.mtime) };
+    index.totalBytes += entry.size;
+    index.fileCount++;
+    if (STORE_FILE_NAMES.has(entry.name)) {
+      index.storeBytes += entry.size;
+      return;
+    }
+
+    let owner = owners.get(entry.path);
+    if (!owner) {
+      const segment = SEGMENT_NAME.exec(entry.name);
+      const sidecar = segment ? null : SIDECAR_NAME.exec(entry.name);
+      const extract = segment || sidecar ? null : SPEAKER_EXTRACT_NAME.exec(entry.name);
+      if (segment) {
+        owner = { recordingId: segment[1], kind: 'segment' };
+      } else if (sidecar) {
+        owner = { recordingId: sidecar[1], kind: SIDECAR_KINDS[sidecar[2]] };
+      } else if (extract) {
+        owner = { recordingId: extract[1], kind: 'extract' };
+      }
+      // Named like a recording file but not referenced: the recording's files moved on
+      // (extracts are never referenced; they are found by name only)
+      if (owner && owner.kind !== 'extract') owner = { ...owner, unreferenced: true };
+    }
+
+    if (!owner) {
+      // Not a recording file; counted but never evicted
+      index.otherBytes += entry.size;
+      return;
+    }
+    const recording = recordingsById.get(owner.recordingId);
+    if (!recording) {
+      entry.recordingId = owner.recordingId;
+      entry.kind = owner.kind;
+      index.orphans.push(entry);
+      return;
+    }
+    let bucket = index.byRecording.get(recording.id);
+    if (!bucket) {
+      bucket = { recording, bytes: 0, audioBytes: 0, files: [], lastAccessedAt: accessLog[recording.id] || 0 };
+      index.byRecording.set(recording.id, bucket);
+    }
+    const isAudio = owner.kind === 'audio' || owner.kind === 'segment' || owner.kind === 'merged';
+    entry.kind = owner.kind;
+    entry.unreferenced = Boolean(owner.unreferenced);
+    bucket.files.push(entry);
+    bucket.bytes += entry.size;
+    if (isAudio) bucket.audioBytes += entry.size;
+    // Without an access record, the newest file stands in for the last use
+    if (!accessLog[recording.id]) bucket.lastAccessedAt = Math.max(bucket.lastAccessedAt, entry.mtime);
+  });
+  return index;
+};
+
+/**
+ * Choose files to remove (or re-encode) until `bytesNeeded` would be freed,
+ * working through the tiers in order and least recently used first within one.
+ * @param {Object} index - From buildStorageIndex
+ * @param {number} bytesNeeded - Bytes to reclaim; Infinity plans every candidate
+ * @param {Object} options - { now, tiers, graceMs, archiveAfterMs }
+ * @returns {Object} - { actions, bytesPlanned, satisfied }
+ */
+export const planEviction = (index, bytesNeeded, options = {}) => {
+  const now = options.now ?? Date.now();
+  const tiers = options.tiers || ['orphan', 'redundant', 'synced'];
+  const graceMs = options.graceMs ?? GRACE_MS;
+  const archiveAfterMs = options.archiveAfterMs ?? ARCHIVE_AFTER_MS;
+  const settled = file => now - file.mtime >= graceMs;
+
+  const candidates = { orphan: [], redundant: [], synced: [], archive: [] };
+  index.orphans.filter(settled).forEach((file) => {
+    candidates.orphan.push({ tier: 'orphan', recordingId: file.recordingId, paths: [file.path], bytes: file.size, lastAccessedAt: file.mtime });
+  });
+
+  index.byRecording.forEach((bucket) => {
+    const { recording } = bucket;
+    if (BUSY_STATUSES.has(recording.processingStatus)) return;
+    const audioFile = bucket.files.find(file => file.path === recording.filePath);
+    const fromSegment = playsFromSegment(recording);
+    const segments = bucket.files.filter(file => file.kind === 'segment' && file !== audioFile)
+      .sort((a, b) => (a.name < b.name ? -1 : 1));
+    // A verified merge commit leaves segmentPaths pointing at the merged file alone
+    const mergeCommitted = recording.segmentPaths?.length === 1 && recording.segmentPaths[0] === recording.filePath;
+
+    // Segments only matter until the merged file exists. Leftovers of a committed
+    // merge just go; segments behind a merge made before verification existed are
+    // removed through commitMergedExports, which checks the merge first.
+    if (audioFile && !fromSegment && segments.length > 0 && segments.every(settled)) {
+      candidates.redundant.push({
+        tier: 'redundant',
+        recordingId: recording.id,
+        paths: segments.map(file => file.path),
+        bytes: segments.reduce((sum, file) => sum + file.size, 0),
+        lastAccessedAt: bucket.lastAccessedAt,
+        verifyMerge: !mergeCommitted,
+        mergedPath: audioFile.path,
+      });
+    }
+    // Merged files nothing points at (an export whose verification failed, or superseded)
+    const leftovers = bucket.files.filter(file => settled(file) && file.kind === 'merged' && file.unreferenced);
+    if (leftovers.length > 0) {
+      candidates.redundant.push({
+        tier: 'redundant',
+        recordingId: recording.id,
+        paths: leftovers.map(file => file.path),
+        bytes: leftovers.reduce((sum, file) => sum + file.size, 0),
+        lastAccessedAt: bucket.lastAccessedAt,
+      });
+    }
+
+    // Speaker extracts are cut again from the audio whenever they are asked for
+    const extracts = bucket.files.filter(file => settled(file) && file.kind === 'extract');
+    if (extracts.length > 0) {
+      candidates.redundant.push({
+        tier: 'redundant',
+        recordingId: recording.id,
+        paths: extracts.map(file => file.path),
+        bytes: extracts.reduce((sum, file) => sum + file.size, 0),
+        lastAccessedAt: bucket.lastAccessedAt,
+      });
+    }
+
+    // Whole-recording eviction needs every byte of the audio in the one file
+    const singleFile = fromSegment ? segments.length === 0 : (segments.length === 0 || mergeCommitted);
+    if (!audioFile || recording.audioStorage || !singleFile) return;
+    const audioFiles = bucket.files.filter(file => file.kind === 'audio' || file.kind === 'segment');
+    const audioBytes = audioFiles.reduce((sum, file) => sum + file.size, 0);
+    const upload = audioUploadOf(recording);
+    const lastSynced = toMs(recording.googleDriveSync?.lastSynced);
+    if (upload && audioFile.mtime <= lastSynced) {
+      candidates.synced.push({
+        tier: 'synced',
+        recordingId: recording.id,
+        paths: audioFiles.map(file => file.path),
+        bytes: audioBytes,
+        lastAccessedAt: bucket.lastAccessedAt,
+        fileId: upload.fileId,
+        audioSize: audioFile.size,
+      });
+    } else if (!upload && recording.processingStatus === 'complete' && now - bucket.lastAccessedAt >= archiveAfterMs) {
+      candidates.archive.push({
+        tier: 'archive',
+        recordingId: recording.id,
+        paths: audioFiles.map(file => file.path),
+        bytes: Math.round(audioBytes * (1 - ARCHIVE_RATIO)), // estimated saving
+        lastAccessedAt: bucket.lastAccessedAt,
+        sourcePath: audioFile.path,
+      });
+    }
+  });
+
+  const actions = [];
+  const claimed = new Set();
+  let bytesPlanned = 0;
+  for (const tier of TIERS) {
+    if (bytesPlanned >= bytesNeeded) break;
+    if (!tiers.includes(tier)) continue;
+    candidates[tier].sort((a, b) => a.lastAccessedAt - b.lastAccessedAt || b.bytes - a.bytes);
+    for (const action of candidates[tier]) {
+      if (bytesPlanned >= bytesNeeded) break;
+      // Segments planned as redundant are not counted again with the synced audio
+      const claimedBytes = action.tier === 'synced'
+        ? index.byRecording.get(action.recordingId).files
+          .filter(file => claimed.has(file.path) && action.paths.includes(file.path))
+          .reduce((sum, file) => sum + file.size, 0)
+        : 0;
+      action.paths.forEach(filePath => claimed.add(filePath));
+      actions.push(action);
+      bytesPlanned += action.bytes - claimedBytes;
+    }
+  }
+  return { actions, bytesPlanned, satisfied: bytesPlanned >= bytesNeeded };
+};
+
+class StorageManager {
+  constructor() {
+    this.accessLog = null;
+    this.accessLogPath = null;
+    this.evicting = null;
+  }
+
+  // Caches/recordings (JS store, merged files, sidecars) and Documents/recordings (native segments)
+  async getDirectories() {
+    const recordingsDir = directoryOf(await getRecordingsFilePath());
+    const directories = [recordingsDir];
+    if (RNFS.DocumentDirectoryPath) {
+      const segmentsDir = `${RNFS.DocumentDirectoryPath}/recordings`;
+      if (segmentsDir !== recordingsDir) directories.push(segmentsDir);
+    }
+    return directories;
+  }
+
+  async loadAccessLog() {
+    if (this.accessLog) return this.accessLog;
+    const recordingsDir = directoryOf(await getRecordingsFilePath());
+    this.accessLogPath = `${recordingsDir}/${ACCESS_LOG_FILE_NAME}`;
+    try {
+      if (await RNFS.exists(this.accessLogPath)) {
+        this.accessLog = JSON.parse(await RNFS.readFile(this.accessLogPath, 'utf8')) || {};
+      }
+    } catch (error) {
+      console.warn('[StorageManager] Could not read access log, starting empty:', error);
+    }
+    this.accessLog = this.accessLog || {};
+    return this.accessLog;
+  }
+
+  /**
+   * Record that a recording was opened (keeps it at the back of the eviction order).
+   * @param {string} recordingId - Recording id
+   */
+  async touch(recordingId) {
+    try {
+      const accessLog = await this.loadAccessLog();
+      accessLog[recordingId] = Date.now();
+      await RNFS.writeFile(this.accessLogPath, JSON.stringify(accessLog), 'utf8');
+    } catch (error) {
+      console.warn('[StorageManager] Failed to record access:', error);
+    }
+  }
+
+  // One readDir per directory; the listing already carries sizes and mtimes
+  async scanFiles() {
+    const directories = await this.getDirectories();
+    const listings = await Promise.all(directories.map(async (directory) => {
+      if (!(await RNFS.exists(directory))) return [];
+      const items = await RNFS.readDir(directory);
+      return items.filter(item => item.isFile()).map(item => ({
+        path: item.path,
+        name: item.name,
+        size: Number(item.size) || 0,
+        mtime: item.mtime,
+      }));
+    }));
+    return listings.flat();
+  }
+
+  async buildIndex() {
+    const [files, recordings, accessLog] = await Promise.all([
+      this.scanFiles(),
+      getRecordings(),
+      this.loadAccessLog(),
+    ]);
+    return buildStorageIndex(files, recordings, accessLog);
+  }
+
+  /**
+   * Bytes held per recording, largest first.
+   * @returns {Promise<Object>} - { totalBytes, storeBytes, otherBytes, orphanBytes, fileCount, recordings }
+   */
+  async getUsage() {
+    const index = await this.buildIndex();
+    const recordings = [...index.byRecording.values()]
+      .map(bucket => ({
+        recordingId: bucket.recording.id,
+        title: bucket.recording.title,
+        bytes: bucket.bytes,
+        audioBytes: bucket.audioBytes,
+        sidecarBytes: bucket.bytes - bucket.audioBytes,
+        fileCount: bucket.files.length,
+        audioStorage: bucket.recording.audioStorage || 'local',
+        lastAccessedAt: bucket.lastAccessedAt,
+      }))
+      .sort((a, b) => b.bytes - a.bytes);
+    return {
+      totalBytes: index.totalBytes,
+      storeBytes: index.storeBytes,
+      otherBytes: index.otherBytes,
+      orphanBytes: index.orphans.reduce((sum, file) => sum + file.size, 0),
+      fileCount: index.fileCount,
+      recordings,
+    };
+  }
+
+  /**
+   * Free at least `bytesNeeded` bytes. Only one eviction runs at a time.
+   * @param {number} bytesNeeded - Bytes to reclaim; Infinity reclaims every candidate in the tiers
+   * @param {Object} options - { tiers, verifyRemote } (see planEviction for tiers)
+   * @returns {Promise<Object>} - { freedBytes, actions, satisfied }
+   */
+  async evict(bytesNeeded, options = {}) {
+    if (this.evicting) {
+      await this.evicting.catch(() => {});
+    }
+    this.evicting = this.runEviction(bytesNeeded, options);
+    try {
+      return await this.evicting;
+    } finally {
+      this.evicting = null;
+    }
+  }
+
+  async runEviction(bytesNeeded, { tiers, verifyRemote = true } = {}) {
+    const scanStart = Date.now();
+    const index = await this.buildIndex();
+    const planStart = Date.now();
+    const plan = planEviction(index, bytesNeeded, { tiers });
+    const planMs = Date.now() - planStart;
+    const sizes = new Map(index.orphans.map(file => [file.path, file.size]));
+    index.byRecording.forEach(bucket => bucket.files.forEach(file => sizes.set(file.path, file.size)));
+
+    let freedBytes = 0;
+    const done = [];
+
+    // Segments behind an unchecked merge go through the verified merge commit, all in one write
+    const merges = plan.actions.filter(action => action.verifyMerge);
+    if (merges.length > 0) {
+      const results = await commitMergedExports(merges.map(action => ({
+        recordingId: action.recordingId,
+        segmentPaths: action.paths,
+        mergedPath: action.mergedPath,
+      })));
+      results.forEach((result, i) => {
+        if (result.committed) {
+          freedBytes += result.freedBytes;
+          done.push(merges[i]);
+        }
+      });
+    }
+
+    const evictedToDrive = new Set();
+    for (const action of plan.actions) {
+      if (action.verifyMerge) continue;
+      try {
+        if (action.tier === 'archive') {
+          freedBytes += await this.archiveAudio(index.byRecording.get(action.recordingId).recording, action, sizes);
+          done.push(action);
+          continue;
+        }
+        if (action.tier === 'synced' && verifyRemote && !(await this.isDriveCopyCurrent(action))) {
+          console.warn(`[StorageManager] Drive copy of ${action.recordingId} could not be confirmed; keeping local audio`);
+          continue;
+        }
+        freedBytes += await this.removeFiles(action.paths, sizes);
+        done.push(action);
+        if (action.tier === 'synced') {
+          evictedToDrive.add(action.recordingId);
+        }
+      } catch (error) {
+        console.error(`[StorageManager] Failed to evict ${action.tier} files of ${action.recordingId || 'unknown'}:`, error);
+      }
+    }
+    if (evictedToDrive.size > 0) {
+      // Only these fields are written, so edits made while files were being removed are kept
+      const current = (await getRecordings()).filter(recording => evictedToDrive.has(recording.id));
+      await updateRecordings(current.map(recording => ({ id: recording.id, audioStorage: 'drive', segmentPaths: [recording.filePath] })));
+    }
+
+    MetricsService.record('storage.evictionScanMs', 'ms', planStart - scanStart);
+    MetricsService.record('storage.evictionPlanMs', 'ms', planMs);
+    MetricsService.count('storage.evictedBytes', freedBytes);
+    TIERS.forEach(tier => MetricsService.count(`storage.evicted.${tier}`, done.filter(action => action.tier === tier).length));
+    return { freedBytes, actions: done, satisfied: freedBytes >= bytesNeeded };
+  }
+
+  // Sizes come from the scan, so each file costs one unlink; files already gone are skipped
+  async removeFiles(paths, sizes) {
+    let freed = 0;
+    for (const filePath of paths) {
+      try {
+        await RNFS.unlink(filePath);
+        freed += sizes.get(filePath) || 0;
+      } catch (error) {
+        // Removed by someone else since the scan
+      }
+    }
+    return freed;
+  }
+
+  // The upload must still exist on Drive with the same size before the local copy goes
+  async isDriveCopyCurrent(action) {
+    try {
+      const GoogleDriveService = require('./GoogleDriveService').default;
+      const metadata = await GoogleDriveService.getFileMetadata(action.fileId);
+      return Boolean(metadata) && !metadata.trashed && Number(metadata.size) === action.audioSize;
+    } catch (error) {
+      return false;
+    }
+  }
+
+  // Re-encode to the archive profile, then drop the original audio files
+  async archiveAudio(recording, action, sizes) {
+    if (!AudioRecorderModule?.transcodeToArchive) {
+      throw new Error('Archive transcoding is not available in this build');
+    }
+    const archivePath = `${directoryOf(action.sourcePath)}/${recording.id}_archive.m4a`;
+    const result = await AudioRecorderModule.transcodeToArchive(action.sourcePath, archivePath, ARCHIVE_PROFILE);
+    // The scan's copy is stale after a long transcode: only the audio fields are written, and
+    // a recording deleted in the meantime keeps nothing
+    const updated = await updateRecordingFields(recording.id, { filePath: archivePath, segmentPaths: [archivePath], audioStorage: 'archived' });
+    if (!updated) {
+      await RNFS.unlink(archivePath).catch(() => {});
+      return 0;
+    }
+    const removed = await this.removeFiles(action.paths.filter(filePath => filePath !== archivePath), sizes);
+    return Math.max(0, removed - (Number(result?.size) || 0));
+  }
+
+  /**
+   * Make sure there is room for a new recording, evicting if needed.
+   * @param {number} requiredBytes - Free space wanted
+   * @returns {Promise<Object>} - { freeBytes, freedBytes, satisfied }
+   */
+  async ensureFreeSpace(requiredBytes = DEFAULT_RECORDING_RESERVE_BYTES) {
+    const { freeSpace } = await RNFS.getFSInfo();
+    if (freeSpace >= requiredBytes) {
+      return { freeBytes: freeSpace, freedBytes: 0, satisfied: true };
+    }
+    console.log(`[StorageManager] ${(freeSpace / 1048576).toFixed(0)} MB free, need ${(requiredBytes / 1048576).toFixed(0)} MB; evicting`);
+    const { freedBytes } = await this.evict(requiredBytes - freeSpace);
+    const freeBytes = freeSpace + freedBytes;
+    return { freeBytes, freedBytes, satisfied: freeBytes >= requiredBytes };
+  }
+
+  /**
+   * Bring audio evicted to Drive back to its local path.
+   * @param {string} recordingId - Recording id
+   * @returns {Promise<Object>} - The updated recording
+   */
+  async restoreAudio(recordingId) {
+    const recording = await getRecordingById(recordingId);
+    if (!recording) {
+      throw new Error('Recording not found');
+    }
+    if (recording.audioStorage !== 'drive') {
+      return recording;
+    }
+    const upload = audioUploadOf(recording);
+    if (!upload) {
+      throw new Error('No Drive copy of this recording\'s audio');
+    }
+    const GoogleDriveService = require('./GoogleDriveService').default;
+    await GoogleDriveService.downloadFile(upload.fileId, recording.filePath);
+    // Only the storage field is written, so edits made during the download are kept
+    await updateRecordingFields(recordingId, { audioStorage: null });
+    const restored = await getRecordingById(recordingId);
+    await this.touch(recordingId);
+    console.log(`[StorageManager] Restored audio for ${recordingId} from Drive`);
+    return restored;
+  }
+}
+
+export default new StorageManager();
@@ -1,4 +1,6 @@
 import { updateRecording } from './AudioRecordingService';
+import MetricsService from './MetricsService';
+import { diffTranscripts } from '../utils/TranscriptDiff';
 
 /**
  * Clean up markdown text by removing code block delimiters
@@ -20,3 +22,150 @@ export const cleanMarkdownText = (text) => {
   
   return cleanedText;
 };
+
+// --- Incremental re-summarization ---
+// After an edit or re-transcription, only the transcript spans that changed
+// are sent back, with the current summary as context; the reply holds just the
+// sections that must change and is merged back here.
+
+export const NO_SUMMARY_CHANGES = 'NO_CHANGES';
+
+const CONTEXT_WORDS = 40; // transcript words kept either side of a change
+const MAX_EDITED_FRACTION = 0.05; // past this share of the words edited, summarize in full
+const MAX_REVISION_FRACTION = 0.6; // a revision request must be this much smaller than a full one
+
+const HEADING_LINE = /^(#{1,6})\s+(.+?)\s*#*\s*$/;
+
+const headingKey = (title) => title.toLowerCase().replace(/[^\p{L}\p{N}]+/gu, ' ').trim();
+
+// Headings of the revision input itself, in case the reply echoes them
+const INPUT_HEADING_KEYS = /^(current summary|corrected transcript passages|passage \d+)$/;
+
+/**
+ * Split a Markdown summary into sections at its heading lines.
+ * @param {string} summary - Cleaned Markdown summary
+ * @returns {Array} - [{ key, heading, text }]; text before the first heading has key ''
+ */
+export const splitSummarySections = (summary) => {
+  const sections = [];
+  let current = { key: '', heading: '', lines: [] };
+  for (const line of (summary || '').split('\n')) {
+    const heading = HEADING_LINE.exec(line);
+    if (heading) {
+      sections.push(current);
+      current = { key: headingKey(heading[2]), heading: line, lines: [line] };
+    } else {
+      current.lines.push(line);
+    }
+  }
+  sections.push(current);
+  return sections
+    .map(({ key, heading, lines }) => ({ key, heading, text: lines.join('\n').trim() }))
+    .filter(section => section.key || section.text);
+};
+
+/**
+ * Merge the sections returned by a revision pass into the summary they revise.
+ * Sections with a known heading replace the old ones in place; new sections go
+ * after the last section that was replaced, or at the end.
+ * @param {string} summary - Current summary
+ * @param {string} revision - Cleaned reply of the revision pass
+ * @returns {string} - Merged summary
+ */
+export const mergeSummaryRevision = (summary, revision) => {
+  const text = (revision || '').trim();
+  if (!text || text === NO_SUMMARY_CHANGES) return summary;
+
+  const sections = splitSummarySections(summary);
+  let insertAt = sections.length;
+  for (const section of splitSummarySections(text)) {
+    // Text outside any section is commentary, not summary
+    if (!section.key || INPUT_HEADING_KEYS.test(section.key)) continue;
+    const existing = sections.findIndex(candidate => candidate.key === section.key);
+    if (existing !== -1) {
+      sections[existing] = section;
+      insertAt = existing + 1;
+    } else {
+      sections.splice(insertAt, 0, section);
+      insertAt++;
+    }
+  }
+  return sections.map(section => section.text).join('\n\n');
+};
+
+/**
+ * Join the summaries of consecutive transcript parts without a merge request.
+ * The first part's title stays; the other parts' titles are dropped.
+ * @param {Array<string>} summaries - Cleaned part summaries in order
+ * @returns {string} - One summary
+ */
+export const joinPartSummaries = (summaries) => summaries
+  .flatMap((summary, i) => splitSummarySections(summary)
+    .filter(section => i === 0 || !/^#\s/.test(section.heading))
+    .map(section => section.text))
+  .join('\n\n');
+
+// Word ranges of the new transcript to quote: each change plus context, overlapping ranges joined
+const excerptRanges = (diff) => {
+  const ranges = [];
+  for (const hunk of diff.hunks) {
+    const start = Math.max(0, hunk.newStart - CONTEXT_WORDS);
+    const end = Math.min(diff.newWords.count, hunk.newEnd + CONTEXT_WORDS);
+    const last = ranges[ranges.length - 1];
+    if (last && start <= last.end) {
+      last.end = Math.max(last.end, end);
+      last.hunks.push(hunk);
+    } else {
+      ranges.push({ start, end, hunks: [hunk] });
+    }
+  }
+  return ranges;
+};
+
+const wordSpan = (text, words, start, end) => (end > start ? text.substring(words.starts[start], words.ends[end - 1]) : '');
+
+/**
+ * Build the input of a revision pass.
+ * @param {string} summary - Current summary
+ * @param {string} previousTranscript - Transcript the summary was written from
+ * @param {string} transcript - Current transcript
+ * @param {Object} diff - Result of diffTranscripts(previousTranscript, transcript)
+ * @returns {string} - Summary, then each changed passage with the wording it replaced
+ */
+export const buildSummaryRevisionInput = (summary, previousTranscript, transcript, diff) => {
+  const passages = excerptRanges(diff).map((range, i) => {
+    const replaced = range.hunks
+      .map(hunk => wordSpan(previousTranscript, diff.oldWords, hunk.oldStart, hunk.oldEnd))
+      .filter(Boolean);
+    const lines = [`## Passage ${i + 1}`, wordSpan(transcript, diff.newWords, range.start, range.end) || '(removed)'];
+    if (replaced.length > 0) lines.push(`Previously: ${replaced.map(span => `"${span}"`).join(' … ')}`);
+    return lines.join('\n');
+  });
+  return `# Current summary\n\n${summary}\n\n# Corrected transcript passages\n\n${passages.join('\n\n')}`;
+};
+
+/**
+ * Decide how to re-summarize a transcript that replaces an earlier one.
+ * @param {Object} recording - Recording with its current summary and (new) transcript
+ * @param {string} previousTranscript - Transcript the summary was written from
+ * @returns {Object|null} - { unchanged: true } when the words did not change,
+ *   { input, editedWords, hunks } for a revision pass, or null for a full pass
+ */
+export const planSummaryRevision = (recording, previousTranscript) => {
+  const { summary, transcript } = recording;
+  if (!summary || !previousTranscript || !transcript) return null;
+  if (!splitSummarySections(summary).some(section => section.key)) return null; // nothing to merge into
+
+  const started = Date.now();
+  const diff = diffTranscripts(previousTranscript, transcript, { maxEditRatio: MAX_EDITED_FRACTION });
+  if (!diff) return null;
+  if (diff.hunks.length === 0) return { unchanged: true };
+
+  const input = buildSummaryRevisionInput(summary, previousTranscript, transcript, diff);
+  MetricsService.record('summary.revisionDiffMs', 'ms', Date.now() - started);
+  MetricsService.record('summary.revisionEditedWords', 'words', diff.editedWords);
+  // Share of the full transcript sent instead, in percent
+  MetricsService.record('summary.revisionInputPct', 'percent', (100 * input.length) / transcript.length);
+  if (input.length > MAX_REVISION_FRACTION * transcript.length) return null;
+  return { input, editedWords: diff.editedWords, hunks: diff.hunks.length };
+};
@@ -1,95 +1,112 @@
 import BackgroundTransferService from './BackgroundTransferService';
-import { getRecordingById, updateRecording } from './AudioRecordingService';
+import MetricsService from './MetricsService';
+import {
+  getRecordings, getRecordingsFilePath, updateRecordings, withRecordingsWriteLock,
+} from './AudioRecordingService';
 
 /**
- * Checks for persisted background tasks upon app launch and attempts to reconcile
- * the application state (recording status) with the persisted task information.
+ * Decide what to do with one persisted task, given the recording it belongs to.
+ * The native reconcileTasks pass applies the same rules (keep them in step).
+ * @returns {Object} - { action: 'clear' | 'markProcessing' | 'none', reason }
  */
-export const recoverTasks = async () => {
-  try {
-    console.log('[TaskRecovery] Checking for persisted background tasks...');
-    // Get tasks persisted by the native module (returns a dictionary/map)
-    // Assumes BackgroundTransferService.getActiveTasks() calls the native getActiveTransfers
-    const persistedTasks = await BackgroundTransferService.getActiveTasks(); 
-    const taskIds = Object.keys(persistedTasks);
-    console.log(`[TaskRecovery] Found ${taskIds.length} persisted tasks.`);
-
-    if (taskIds.length === 0) {
-        console.log('[TaskRecovery] No persisted tasks found.');
-        return;
-    }
-
-    for (const taskId of taskIds) {
-      const taskInfo = persistedTasks[taskId]; // Get the persisted info (type, metadata, etc.)
-      // Ensure metadata and recordingId exist. Adjust path if metadata structure is different.
-      const recordingId = taskInfo?.metadata?.recordingId; 
+export const classifyTask = (taskInfo, recording) => {
+  if (!taskInfo?.recordingId && !taskInfo?.metadata?.recordingId) {
+    return { action: 'clear', reason: 'missingRecordingId' };
+  }
+  if (!recording) {
+    // Recording doesn't exist in our app state - orphan task
+    return { action: 'clear', reason: 'orphan' };
+  }
+  if (recording.processingStatus === 'complete' || recording.processingStatus === 'error') {
+    // The recording is already finished, but the native task persisted - a zombie task
+    return { action: 'clear', reason: 'finished' };
+  }
+  if (recording.processingStatus !== 'processing') {
+    // The app quit after the native task started but before JS could update the status
+    return { action: 'markProcessing', reason: recording.processingStatus };
+  }
+  // Already 'processing'; the native task is handling it
+  return { action: 'none', reason: 'processing' };
+};
 
-      console.log(`[TaskRecovery] Processing persisted task ${taskId} with info:`, taskInfo);
+// Same join as the native pass: the recordings are read once for the join and every
+// status fix goes out in a single updateRecordings write, carrying only the status
+const reconcileInJs = async () => {
+  const startedAt = Date.now();
+  const persistedTasks = (await BackgroundTransferService.getActiveTasks()) || {};
+  const summary = { tasks: 0, cleared: [], updated: [], inProgress: 0, source: 'js' };
+  const taskIds = Object.keys(persistedTasks);
+  summary.tasks = taskIds.length;
+  if (taskIds.length === 0) {
+    summary.elapsedMs = Date.now() - startedAt;
+    return summary;
+  }
 
-      if (!recordingId) {
-        console.warn(`[TaskRecovery] Task ${taskId} has missing or invalid recordingId in metadata. Clearing task.`);
-        // Ensure BackgroundTransferService.clearTask exists and is implemented in native code
-        try {
-            await BackgroundTransferService.clearTask(taskId); 
-        } catch(clearError) {
-            console.error(`[TaskRecovery] Failed to clear task ${taskId} with missing recordingId:`, clearError);
-        }
-        continue;
-      }
+  const recordingsById = new Map((await getRecordings()).map(recording => [recording.id, recording]));
+  const changed = new Map();
+  const toClear = [];
+  taskIds.forEach((taskId) => {
+    const taskInfo = persistedTasks[taskId];
+    const recordingId = taskInfo?.recordingId || taskInfo?.metadata?.recordingId;
+    const recording = changed.get(recordingId) || recordingsById.get(recordingId);
+    const { action, reason } = classifyTask(taskInfo, recording);
 
-      // Check the application's state for the associated recording
-      let recording = null;
-      try {
-          recording = await getRecordingById(recordingId);
-      } catch (getRecordingError) {
-          console.error(`[TaskRecovery] Error fetching recording ${recordingId} for task ${taskId}:`, getRecordingError);
-          // Decide if we should clear the task or retry later. For now, let's log and continue.
-          continue; 
-      }
-      
+    if (action === 'clear') {
+      toClear.push(taskId);
+      summary.cleared.push({ taskId, recordingId: recordingId || null, reason });
+    } else if (action === 'markProcessing') {
+      changed.set(recordingId, { ...recording, processingStatus: 'processing' });
+    } else {
+      summary.inProgress++;
+    }
+  });
 
-      if (!recording) {
-        // Recording doesn't exist in our app state - orphan task
-        console.warn(`[TaskRecovery] Recording ${recordingId} for task ${taskId} not found in app state. Clearing task.`);
-        try {
-            await BackgroundTransferService.clearTask(taskId);
-        } catch(clearError) {
-            console.error(`[TaskRecovery] Failed to clear orphan task ${taskId}:`, clearError);
-        }
-        continue;
-      }
+  await updateRecordings([...changed.keys()].map(id => ({ id, processingStatus: 'processing' })));
+  summary.updated = [...changed.keys()];
+  await Promise.all(toClear.map(taskId => BackgroundTransferService.clearTask(taskId).catch((error) => {
+    console.error(`[TaskRecovery] Failed to clear task ${taskId}:`, error);
+  })));
+  summary.elapsedMs = Date.now() - startedAt;
+  return summary;
+};
 
-      console.log(`[TaskRecovery] Recording ${recording.id} current status: ${recording.processingStatus}`);
+/**
+ * Checks for persisted background tasks upon app launch and reconciles the
+ * recordings' processing status with them in a single pass: tasks whose
+ * recording is gone or already finished are cleared, and recordings whose task
+ * is still running are marked 'processing'. The native module does the join
+ * (one read and at most one write of recordings.json, one write of the task
+ * store) while holding the JS recordings write lock, so no JS update is lost
+ * to its rewrite; older native builds fall back to the same pass in JS.
+ * Run it after recoverMergeJournals() at launch.
+ * @returns {Promise<Object|null>} - { tasks, cleared, updated, inProgress, elapsedMs, source }
+ */
+export const recoverTasks = async () => {
+  try {
+    console.log('[TaskRecovery] Checking for persisted background tasks...');
+    const recordingsPath = await getRecordingsFilePath();
+    let summary = await withRecordingsWriteLock(() => BackgroundTransferService.reconcileTasks(recordingsPath));
+    if (summary) {
+      summary = { ...summary, source: 'native' };
+    } else {
+      summary = await reconcileInJs();
+    }
 
-      // Check if the recording state is already final
-      if (recording.processingStatus === 'complete' || recording.processingStatus === 'error') {
-        // The recording is already finished, but the native task persisted. Clean up the zombie task.
-        console.warn(`[TaskRecovery] Recording ${recording.id} is already '${recording.processingStatus}', but task ${taskId} persists. Clearing task.`);
-         try {
-            await BackgroundTransferService.clearTask(taskId);
-        } catch(clearError) {
-            console.error(`[TaskRecovery] Failed to clear zombie task ${taskId} for recording ${recording.id}:`, clearError);
-        }
-      } else if (recording.processingStatus !== 'processing') {
-        // The recording is NOT finished and NOT marked as 'processing'.
-        // This likely means the app quit after the native task started but before the JS could update the status.
-        // Update the status to 'processing' so the UI reflects the ongoing background work.
-        console.log(`[TaskRecovery] Updating recording ${recording.id} status from '${recording.processingStatus}' to 'processing'.`);
-        const updatedRecording = { ...recording, processingStatus: 'processing' };
-        try {
-            await updateRecording(updatedRecording);
-        } catch(updateError) {
-            console.error(`[TaskRecovery] Failed to update recording ${recording.id} status to 'processing':`, updateError);
-            // If update fails, the task might get stuck. Consider implications.
-        }
-      } else {
-        // Recording is already marked as 'processing'. Assume the native task is handling it.
-        console.log(`[TaskRecovery] Recording ${recording.id} is already 'processing'. No state change needed.`);
-      }
+    summary.cleared.forEach(({ taskId, recordingId, reason }) => {
+      console.warn(`[TaskRecovery] Cleared task ${taskId} (recording ${recordingId || 'unknown'}): ${reason}`);
+    });
+    if (summary.updated.length > 0) {
+      console.log(`[TaskRecovery] Marked ${summary.updated.length} recordings as 'processing':`, summary.updated.join(', '));
     }
-    console.log('[TaskRecovery] Task recovery check finished.');
+    MetricsService.record('taskRecovery.ms', 'ms', summary.elapsedMs);
+    MetricsService.count('taskRecovery.tasks', summary.tasks);
+    MetricsService.count('taskRecovery.cleared', summary.cleared.length);
+    MetricsService.count('taskRecovery.updated', summary.updated.length);
+    MetricsService.count('taskRecovery.inProgress', summary.inProgress);
+    return summary;
   } catch (error) {
-    // Catch errors from getActiveTasks() itself or other unexpected issues
+    // Catch errors from the task store or recordings file, or other unexpected issues
     console.error('[TaskRecovery] Critical error during task recovery process:', error);
+    return null;
   }
-}; 
\ No newline at end of file
+};
@@ -0,0 +1,226 @@
+// Bandwidth-aware upload scheduler.
+//
+// Runs queued uploads inside a concurrency window that an AIMD controller tunes
+// from measured throughput. Like TCP it starts in slow start (doubling the
+// window while throughput keeps improving), then grows by one per improving
+// sample and cuts the window multiplicatively when throughput drops or the
+// server pushes back (429/503). Each host also has a hard connection cap.
+// Small artifacts (transcripts, summaries) are started ahead of large audio so
+// they are not stuck behind a long upload. Audio goes largest-first, which keeps
+// the tail short once only a few uploads are left, and queued jobs age so a
+// file that has waited a long time still gets its turn.
+
+const DEFAULT_OPTIONS = {
+  initialWindow: 4,
+  minWindow: 1,
+  maxWindow: 6,
+  perHostLimit: 4,
+  // Throughput must move by more than this fraction before the window changes
+  throughputTolerance: 0.05,
+  // Throughput is compared over samples at least this long
+  sampleMs: 250,
+  // Window multiplier applied on a drop or backoff
+  decreaseFactor: 0.5,
+  // Waiting this long counts as 1 MB of priority when picking the next job
+  agingMsPerMB: 2000,
+};
+
+const SMALL_ARTIFACT_BYTES = 512 * 1024;
+// Large uploads rank behind small ones by this many MB of priority
+const LARGE_ARTIFACT_OFFSET_MB = 1024;
+
+const isBackoffError = (error) => /\b(429|503)\b|rate limit|quota/i.test(error?.message || '');
+
+class UploadScheduler {
+  constructor(options = {}) {
+    this.options = { ...DEFAULT_OPTIONS, ...options };
+    this.window = this.options.initialWindow;
+    this.queue = [];
+    this.active = new Set();
+    this.activeByHost = new Map();
+    this.nextJobId = 1;
+    this.pumpScheduled = false;
+
+    // Time integral of the number of active uploads, so each finished upload
+    // knows how many connections it shared the link with on average
+    this.concurrencyArea = 0;
+    this.areaUpdatedAt = Date.now();
+
+    // Aggregate throughput estimates (bytes/ms), compared once per sample
+    this.sampleStart = null;
+    this.sampleEstimates = [];
+    this.lastThroughput = null;
+    this.slowStart = true;
+
+    this.stats = { completed: 0, failed: 0, bytes: 0, windowIncreases: 0, windowDecreases: 0, peakWindow: this.window };
+  }
+
+  /**
+   * Queue an upload.
+   * @param {Object} job - { size, host, run } where run() resolves when the transfer has finished
+   * @returns {Promise<*>} - Result of job.run()
+   */
+  schedule({ size = 0, host = 'default', run }) {
+    return new Promise((resolve, reject) => {
+      this.queue.push({
+        id: this.nextJobId++,
+        size,
+        host,
+        run,
+        resolve,
+        reject,
+        enqueuedAt: Date.now(),
+      });
+      this.schedulePump();
+    });
+  }
+
+  // Start jobs on the next microtask so a batch queued in one go is ordered by
+  // priority instead of whichever was scheduled first
+  schedulePump() {
+    if (this.pumpScheduled) return;
+    this.pumpScheduled = true;
+    Promise.resolve().then(() => {
+      this.pumpScheduled = false;
+      this.pump();
+    });
+  }
+
+  updateConcurrencyArea() {
+    const now = Date.now();
+    this.concurrencyArea += this.active.size * (now - this.areaUpdatedAt);
+    this.areaUpdatedAt = now;
+  }
+
+  // Lowest score wins: small artifacts smallest-first, then large ones largest-first,
+  // each less an allowance for time already waited
+  pickNext(includeLarge = true) {
+    const now = Date.now();
+    let bestIndex = -1;
+    let bestScore = Infinity;
+    this.queue.forEach((job, index) => {
+      if ((this.activeByHost.get(job.host) || 0) >= this.options.perHostLimit) return;
+      if (!includeLarge && job.size > SMALL_ARTIFACT_BYTES) return;
+      const sizeMB = job.size / (1024 * 1024);
+      const waitedMB = (now - job.enqueuedAt) / this.options.agingMsPerMB;
+      const score = (job.size <= SMALL_ARTIFACT_BYTES ? sizeMB : LARGE_ARTIFACT_OFFSET_MB - sizeMB) - waitedMB;
+      if (score < bestScore) {
+        bestScore = score;
+        bestIndex = index;
+      }
+    });
+    return bestIndex === -1 ? null : this.queue.splice(bestIndex, 1)[0];
+  }
+
+  // Small artifacts are latency-bound rather than bandwidth-bound, so they may
+  // also use spare connections beyond the window (up to the per-host cap)
+  pump() {
+    while (this.queue.length > 0) {
+      const windowOpen = this.active.size < Math.floor(this.window);
+      if (!windowOpen && this.active.size >= this.options.perHostLimit) break;
+      const job = this.pickNext(windowOpen);
+      if (!job) break; // Remaining jobs are waiting on the window or their host's connection cap
+      this.start(job);
+    }
+  }
+
+  start(job) {
+    this.updateConcurrencyArea();
+    this.active.add(job);
+    this.activeByHost.set(job.host, (this.activeByHost.get(job.host) || 0) + 1);
+    if (this.sampleStart === null) {
+      this.sampleStart = Date.now();
+    }
+    job.startedAt = Date.now();
+    job.areaAtStart = this.concurrencyArea;
+
+    Promise.resolve()
+      .then(() => job.run())
+      .then(result => {
+        this.finish(job, null);
+        job.resolve(result);
+      }, error => {
+        this.finish(job, error);
+        job.reject(error);
+      });
+  }
+
+  finish(job, error) {
+    this.updateConcurrencyArea();
+    this.active.delete(job);
+    this.activeByHost.set(job.host, this.activeByHost.get(job.host) - 1);
+
+    if (error) {
+      this.stats.failed++;
+      if (isBackoffError(error)) {
+        this.decreaseWindow();
+      }
+    } else {
+      this.stats.completed++;
+      this.stats.bytes += job.size;
+      this.recordThroughput(job);
+    }
+    this.pump();
+  }
+
+  // A finished upload's rate times the connections it shared the link with
+  // estimates the aggregate throughput over its lifetime. Small files are
+  // dominated by request latency and say nothing about bandwidth.
+  recordThroughput(job) {
+    const durationMs = Date.now() - job.startedAt;
+    if (job.size < SMALL_ARTIFACT_BYTES || durationMs <= 0) {
+      return;
+    }
+    const averageConcurrency = (this.concurrencyArea - job.areaAtStart) / durationMs;
+    this.sampleEstimates.push((job.size / durationMs) * Math.max(1, averageConcurrency));
+    this.adjustWindow();
+  }
+
+  // Additive increase while throughput improves, multiplicative decrease when it falls
+  adjustWindow() {
+    if (Date.now() - this.sampleStart < this.options.sampleMs) {
+      return;
+    }
+    const throughput = this.sampleEstimates.reduce((sum, value) => sum + value, 0) / this.sampleEstimates.length;
+    const previous = this.lastThroughput;
+    this.lastThroughput = throughput;
+    this.sampleEstimates = [];
+    this.sampleStart = this.active.size > 0 ? Date.now() : null;
+
+    if (previous === null || throughput > previous * (1 + this.options.throughputTolerance)) {
+      this.increaseWindow();
+    } else if (throughput < previous * (1 - 2 * this.options.throughputTolerance)) {
+      this.decreaseWindow();
+    }
+  }
+
+  increaseWindow() {
+    if (this.window < this.options.maxWindow) {
+      const step = this.slowStart ? this.window : 1;
+      this.window = Math.min(this.options.maxWindow, this.window + step);
+      this.stats.windowIncreases++;
+      this.stats.peakWindow = Math.max(this.stats.peakWindow, this.window);
+    }
+  }
+
+  decreaseWindow() {
+    this.slowStart = false;
+    const next = Math.max(this.options.minWindow, Math.floor(this.window * this.options.decreaseFactor));
+    if (next < this.window) {
+      this.window = next;
+      this.stats.windowDecreases++;
+    }
+  }
+
+  getStats() {
+    return {
+      ...this.stats,
+      window: this.window,
+      active: this.active.size,
+      queued: this.queue.length,
+      throughputKBps: this.lastThroughput === null ? null : Math.round(this.lastThroughput * 1000 / 1024),
+    };
+  }
+}
+
+export default UploadScheduler;
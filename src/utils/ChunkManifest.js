@@ -0,0 +1,283 @@
+/**
+ * Content-defined chunk manifests for delta sync.
+ *
+ * Artifacts are split with a FastCDC-style gear hash (normalized chunking) and
+ * each chunk gets a SHA-256. Cut points depend only on nearby content, so an
+ * edit in one place changes only the chunks around it. Audio files are chunked
+ * natively (BackgroundTransferManager.computeChunkManifest) with the same gear
+ * table and cut rules as below; text artifacts are chunked here.
+ */
+import RNFS from 'react-native-fs';
+
+const MANIFEST_VERSION = 1;
+export const MANIFEST_ALGORITHM = 'fastcdc-gear32-sha256';
+
+// Chunk size profiles (bytes). Keep in sync with BackgroundTransferManager.m.
+export const CHUNK_PROFILES = {
+  audio: { minSize: 16 * 1024, avgSize: 64 * 1024, maxSize: 256 * 1024 },
+  text: { minSize: 2 * 1024, avgSize: 8 * 1024, maxSize: 64 * 1024 },
+};
+
+// 256 pseudo-random 32-bit gear values from xorshift32, seeded identically in native code
+const GEAR = (() => {
+  const table = new Uint32Array(256);
+  let x = 0x9e3779b9;
+  for (let i = 0; i < 256; i++) {
+    x ^= x << 13;
+    x ^= x >>> 17;
+    x ^= x << 5;
+    table[i] = x >>> 0;
+  }
+  return table;
+})();
+
+// Mask with the top `bits` bits set; the gear hash mixes most in its high bits
+const highMask = (bits) => (bits >= 32 ? 0xffffffff : ((2 ** bits - 1) * 2 ** (32 - bits))) >>> 0;
+
+const masksFor = ({ avgSize }) => {
+  const bits = Math.round(Math.log2(avgSize));
+  // Harder mask before the average size, easier after it (normalized chunking)
+  return { maskS: highMask(bits + 2) | 0, maskL: highMask(bits - 2) | 0 };
+};
+
+/**
+ * Length of the chunk starting at `offset`.
+ * @param {Uint8Array} bytes - Data
+ * @param {number} offset - Chunk start
+ * @param {Object} profile - { minSize, avgSize, maxSize }
+ * @param {Object} masks - From masksFor(profile)
+ * @returns {number} - Chunk length in bytes
+ */
+const cutPoint = (bytes, offset, profile, masks) => {
+  const remaining = bytes.length - offset;
+  if (remaining <= profile.minSize) {
+    return remaining;
+  }
+  const end = Math.min(remaining, profile.maxSize);
+  const normal = Math.min(profile.avgSize, end);
+  let hash = 0;
+  let i = profile.minSize;
+
+  for (; i < normal; i++) {
+    hash = ((hash << 1) + GEAR[bytes[offset + i]]) | 0;
+    if ((hash & masks.maskS) === 0) return i + 1;
+  }
+  for (; i < end; i++) {
+    hash = ((hash << 1) + GEAR[bytes[offset + i]]) | 0;
+    if ((hash & masks.maskL) === 0) return i + 1;
+  }
+  return end;
+};
+
+/**
+ * Split bytes into content-defined chunks.
+ * @param {Uint8Array} bytes - Data
+ * @param {Object} profile - One of CHUNK_PROFILES
+ * @returns {Array<Object>} - [{ offset, length }]
+ */
+export const chunkBytes = (bytes, profile = CHUNK_PROFILES.text) => {
+  const masks = masksFor(profile);
+  const chunks = [];
+  let offset = 0;
+  while (offset < bytes.length) {
+    const length = cutPoint(bytes, offset, profile, masks);
+    chunks.push({ offset, length });
+    offset += length;
+  }
+  return chunks;
+};
+
+// --- SHA-256 ---------------------------------------------------------------
+
+const K = new Uint32Array([
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+]);
+
+const W = new Int32Array(64);
+
+const compress = (state, block, at) => {
+  for (let t = 0; t < 16; t++) {
+    const j = at + t * 4;
+    W[t] = (block[j] << 24) | (block[j + 1] << 16) | (block[j + 2] << 8) | block[j + 3];
+  }
+  for (let t = 16; t < 64; t++) {
+    const w15 = W[t - 15];
+    const w2 = W[t - 2];
+    const s0 = ((w15 >>> 7) | (w15 << 25)) ^ ((w15 >>> 18) | (w15 << 14)) ^ (w15 >>> 3);
+    const s1 = ((w2 >>> 17) | (w2 << 15)) ^ ((w2 >>> 19) | (w2 << 13)) ^ (w2 >>> 10);
+    W[t] = (W[t - 16] + s0 + W[t - 7] + s1) | 0;
+  }
+
+  let a = state[0], b = state[1], c = state[2], d = state[3];
+  let e = state[4], f = state[5], g = state[6], h = state[7];
+  for (let t = 0; t < 64; t++) {
+    const S1 = ((e >>> 6) | (e << 26)) ^ ((e >>> 11) | (e << 21)) ^ ((e >>> 25) | (e << 7));
+    const ch = (e & f) ^ (~e & g);
+    const temp1 = (h + S1 + ch + K[t] + W[t]) | 0;
+    const S0 = ((a >>> 2) | (a << 30)) ^ ((a >>> 13) | (a << 19)) ^ ((a >>> 22) | (a << 10));
+    const maj = (a & b) ^ (a & c) ^ (b & c);
+    const temp2 = (S0 + maj) | 0;
+    h = g; g = f; f = e; e = (d + temp1) | 0;
+    d = c; c = b; b = a; a = (temp1 + temp2) | 0;
+  }
+  state[0] = (state[0] + a) | 0; state[1] = (state[1] + b) | 0;
+  state[2] = (state[2] + c) | 0; state[3] = (state[3] + d) | 0;
+  state[4] = (state[4] + e) | 0; state[5] = (state[5] + f) | 0;
+  state[6] = (state[6] + g) | 0; state[7] = (state[7] + h) | 0;
+};
+
+/**
+ * SHA-256 of bytes[start, end).
+ * @returns {string} - Lowercase hex digest
+ */
+export const sha256Hex = (bytes, start = 0, end = bytes.length) => {
+  const state = new Int32Array([
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+  ]);
+  const length = end - start;
+  let at = start;
+  for (; at + 64 <= end; at += 64) {
+    compress(state, bytes, at);
+  }
+
+  // Final block(s): remaining bytes, 0x80, zero padding, 64-bit big-endian bit length
+  const tail = new Uint8Array(end - at < 56 ? 64 : 128);
+  tail.set(bytes.subarray(at, end));
+  tail[end - at] = 0x80;
+  const bitLength = length * 8;
+  const view = new DataView(tail.buffer);
+  view.setUint32(tail.length - 8, Math.floor(bitLength / 0x100000000));
+  view.setUint32(tail.length - 4, bitLength >>> 0);
+  for (let i = 0; i < tail.length; i += 64) {
+    compress(state, tail, i);
+  }
+
+  let hex = '';
+  for (let i = 0; i < 8; i++) {
+    hex += (state[i] >>> 0).toString(16).padStart(8, '0');
+  }
+  return hex;
+};
+
+// --- Manifests --------------------------------------------------------------
+
+/**
+ * UTF-8 encode a string.
+ * @param {string} text - Text
+ * @returns {Uint8Array} - Bytes
+ */
+export const encodeUTF8 = (text) => {
+  const bytes = new Uint8Array(text.length * 3);
+  let n = 0;
+  for (let i = 0; i < text.length; i++) {
+    let code = text.charCodeAt(i);
+    if (code >= 0xd800 && code <= 0xdbff && i + 1 < text.length) {
+      const low = text.charCodeAt(i + 1);
+      if (low >= 0xdc00 && low <= 0xdfff) {
+        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        i++;
+      }
+    }
+    if (code < 0x80) {
+      bytes[n++] = code;
+    } else if (code < 0x800) {
+      bytes[n++] = 0xc0 | (code >> 6);
+      bytes[n++] = 0x80 | (code & 0x3f);
+    } else if (code < 0x10000) {
+      bytes[n++] = 0xe0 | (code >> 12);
+      bytes[n++] = 0x80 | ((code >> 6) & 0x3f);
+      bytes[n++] = 0x80 | (code & 0x3f);
+    } else {
+      bytes[n++] = 0xf0 | (code >> 18);
+      bytes[n++] = 0x80 | ((code >> 12) & 0x3f);
+      bytes[n++] = 0x80 | ((code >> 6) & 0x3f);
+      bytes[n++] = 0x80 | (code & 0x3f);
+    }
+  }
+  return bytes.subarray(0, n);
+};
+
+/**
+ * Build a chunk manifest for in-memory bytes.
+ * @param {Uint8Array} bytes - Data
+ * @param {Object} profile - One of CHUNK_PROFILES
+ * @returns {Object} - { algorithm, size, digest, chunks: [{ length, hash }] }
+ */
+export const computeManifest = (bytes, profile = CHUNK_PROFILES.text) => ({
+  algorithm: MANIFEST_ALGORITHM,
+  size: bytes.length,
+  digest: sha256Hex(bytes),
+  chunks: chunkBytes(bytes, profile).map(({ offset, length }) => ({
+    length,
+    hash: sha256Hex(bytes, offset, offset + length),
+  })),
+});
+
+/**
+ * Build a chunk manifest for a text artifact (transcript, summary).
+ * @param {string} text - Text content
+ * @returns {Object} - Manifest (see computeManifest)
+ */
+export const computeTextManifest = (text) => computeManifest(encodeUTF8(text || ''), CHUNK_PROFILES.text);
+
+/**
+ * Compare a new manifest against the one recorded at the last sync.
+ * @param {Object|null} previous - Manifest from the last sync
+ * @param {Object} next - Manifest of the current content
+ * @returns {Object} - { unchanged, reusedBytes, changedBytes }
+ */
+export const diffManifests = (previous, next) => {
+  if (!previous || previous.algorithm !== next.algorithm) {
+    return { unchanged: false, reusedBytes: 0, changedBytes: next.size };
+  }
+  if (previous.digest === next.digest && previous.size === next.size) {
+    return { unchanged: true, reusedBytes: next.size, changedBytes: 0 };
+  }
+
+  const known = new Set((previous.chunks || []).map(chunk => chunk.hash));
+  let reusedBytes = 0;
+  for (const chunk of next.chunks) {
+    if (known.has(chunk.hash)) reusedBytes += chunk.length;
+  }
+  return { unchanged: false, reusedBytes, changedBytes: next.size - reusedBytes };
+};
+
+/**
+ * Write the per-artifact manifests recorded at a sync.
+ * @param {Object} manifests - { audio, transcript, summary }
+ * @param {string} filePath - Destination path
+ * @returns {Promise<string>} - filePath
+ */
+export const saveManifests = async (manifests, filePath) => {
+  await RNFS.writeFile(filePath, JSON.stringify({ version: MANIFEST_VERSION, manifests }), 'utf8');
+  return filePath;
+};
+
+/**
+ * Load manifests saved by saveManifests.
+ * @param {string} filePath - Path to the manifest file
+ * @returns {Promise<Object>} - { audio, transcript, summary } (empty if missing or invalid)
+ */
+export const loadManifests = async (filePath) => {
+  try {
+    if (!filePath || !(await RNFS.exists(filePath))) {
+      return {};
+    }
+    const saved = JSON.parse(await RNFS.readFile(filePath, 'utf8'));
+    if (saved?.version !== MANIFEST_VERSION || !saved.manifests) {
+      console.warn('[ChunkManifest] Ignoring invalid manifest file:', filePath);
+      return {};
+    }
+    return saved.manifests;
+  } catch (error) {
+    console.error('[ChunkManifest] Failed to load manifests:', error);
+    return {};
+  }
+};
@@ -4,22 +4,36 @@ export class Recording {
     id,
     title,
     filePath,
+    segmentPaths = null, // native segment files in order; filePath is the first until they are merged
     date,
     duration,
     transcript = null,
     summary = null,
     processingStatus = 'pending', // pending, processing, complete, error
-    userModifiedTitle = false
+    userModifiedTitle = false,
+    alignmentPath = null, // binary word-timing index (see TranscriptAlignment)
+    speakerTimelinePath = null, // diarized speaker turns (see SpeakerTimeline)
+    summaryRevisionPending = false, // the running summarization is a revision to merge (see SummarizationService)
+    summaryParts = null, // { taskIds, summaries, reduceTaskId } while a long lesson is summarized in parts (see SummaryChunks)
+    googleDriveSync = null, // { folderId, lastSynced, uploads } after a Drive sync
+    audioStorage = null // null (local), 'drive' (evicted, restored on playback) or 'archived' (see StorageManager)
   }) {
     this.id = id;
     this.title = title;
     this.filePath = filePath;
+    this.segmentPaths = segmentPaths;
     this.date = date;
     this.duration = duration;
     this.transcript = transcript;
     this.summary = summary;
     this.processingStatus = processingStatus;
     this.userModifiedTitle = userModifiedTitle;
+    this.alignmentPath = alignmentPath;
+    this.speakerTimelinePath = speakerTimelinePath;
+    this.summaryRevisionPending = summaryRevisionPending;
+    this.summaryParts = summaryParts;
+    this.googleDriveSync = googleDriveSync;
+    this.audioStorage = audioStorage;
   }
 
   // Convert to plain object for storage
@@ -28,12 +42,19 @@ export class Recording {
       id: this.id,
       title: this.title,
       filePath: this.filePath,
+      segmentPaths: this.segmentPaths,
       date: this.date,
       duration: this.duration,
       transcript: this.transcript,
       summary: this.summary,
       processingStatus: this.processingStatus,
-      userModifiedTitle: this.userModifiedTitle
+      userModifiedTitle: this.userModifiedTitle,
+      alignmentPath: this.alignmentPath,
+      speakerTimelinePath: this.speakerTimelinePath,
+      summaryRevisionPending: this.summaryRevisionPending,
+      summaryParts: this.summaryParts,
+      googleDriveSync: this.googleDriveSync,
+      audioStorage: this.audioStorage
     };
   }
 
@@ -0,0 +1,464 @@
+/**
+ * Lightweight Markdown -> HTML renderer for summary exports.
+ *
+ * Covers the CommonMark subset our summaries actually use (ATX/setext headings,
+ * paragraphs, nested lists, blockquotes, fenced code, rules, GFM tables and the
+ * usual inline spans). iterateBlocks() makes a single pass over the lines and
+ * yields each block as it closes; renderMarkdown() appends HTML for each block
+ * with no token stream or DOM in between.
+ *
+ * Kept free of React Native imports so scripts/ can load it under Node.
+ */
+
+const HTML_ESCAPES = { '&': '&amp;', '<': '&lt;', '>': '&gt;', '"': '&quot;' };
+const escapeHtml = (text) => text.replace(/[&<>"]/g, (ch) => HTML_ESCAPES[ch]);
+
+// Backslash escapes are swapped for private-use placeholders so inline rules skip them
+const ESCAPE_OPEN = '\uE000';
+const ESCAPE_CLOSE = '\uE001';
+const CODE_OPEN = '\uE002';
+const CODE_CLOSE = '\uE003';
+
+const HEADING_RE = /^ {0,3}(#{1,6})(?:[ \t]+(.*?))?(?:[ \t]+#+)?[ \t]*$/;
+const RULE_RE = /^ {0,3}([-*_])(?:[ \t]*\1){2,}[ \t]*$/;
+const LIST_ITEM_RE = /^([ \t]*)([-*+]|\d{1,9}[.)])(?:[ \t]+(.*)|$)/;
+const FENCE_RE = /^ {0,3}(`{3,}|~{3,})[ \t]*([^`\s]*)/;
+const BLOCKQUOTE_RE = /^ {0,3}> ?(.*)$/;
+const TABLE_DELIMITER_RE = /^ {0,3}\|?[ \t]*:?-+:?[ \t]*(\|[ \t]*:?-+:?[ \t]*)*\|?[ \t]*$/;
+const SETEXT_H1_RE = /^ {0,3}=+[ \t]*$/;
+const SETEXT_H2_RE = /^ {0,3}-+[ \t]*$/;
+
+// Same policy as markdown-it's validateLink: no script or file URLs, and data:
+// only for raster images. Browsers ignore control characters inside a scheme.
+const BAD_PROTOCOL_RE = /^(vbscript|javascript|file|data):/;
+const GOOD_DATA_RE = /^data:image\/(gif|png|jpeg|webp);/;
+const isSafeUrl = (url) => {
+  const normalized = url.replace(/[\u0000-\u001F\u007F]/g, '').toLowerCase();
+  return !BAD_PROTOCOL_RE.test(normalized) || GOOD_DATA_RE.test(normalized);
+};
+
+const indentWidth = (whitespace) => whitespace.replace(/\t/g, '    ').length;
+
+const ESCAPE_PLACEHOLDER_RE = new RegExp(`${ESCAPE_OPEN}(\\d+)${ESCAPE_CLOSE}`, 'g');
+const CODE_PLACEHOLDER_RE = new RegExp(`${CODE_OPEN}(\\d+)${CODE_CLOSE}`, 'g');
+const HTML_SPECIAL_RE = /[&<>"]/;
+
+/**
+ * Render inline markdown (emphasis, code, links, breaks) to HTML.
+ * Each rule only runs when its trigger character is present, which keeps
+ * plain-text lines (most of a summary) close to a straight copy.
+ * @param {string} text - Inline markdown
+ * @returns {string} - HTML
+ */
+export const renderInline = (text) => {
+  const hasEscapes = text.includes('\\');
+  const codeSpans = [];
+  let html = text;
+
+  if (hasEscapes) {
+    html = html.replace(/\\([!-/:-@[-`{-~])/g, (_, ch) => `${ESCAPE_OPEN}${ch.charCodeAt(0)}${ESCAPE_CLOSE}`);
+  }
+  if (html.includes('`')) {
+    html = html.replace(/(`+)([\s\S]*?[^`])\1(?!`)/g, (_, ticks, code) => {
+      codeSpans.push(`<code>${escapeHtml(code.replace(/\n/g, ' ').trim())}</code>`);
+      return `${CODE_OPEN}${codeSpans.length - 1}${CODE_CLOSE}`;
+    });
+  }
+  if (HTML_SPECIAL_RE.test(html)) {
+    html = escapeHtml(html);
+  }
+  if (html.includes('](')) {
+    html = html
+      // A link with an unsafe URL stays as its source text
+      .replace(/!\[([^\]]*)\]\(([^)\s]+)(?:\s+&quot;([^&]*)&quot;)?\)/g, (source, alt, src, title) =>
+        (isSafeUrl(src) ? `<img src="${src}" alt="${alt}"${title ? ` title="${title}"` : ''}>` : source))
+      .replace(/\[([^\]]+)\]\(([^)\s]+)(?:\s+&quot;([^&]*)&quot;)?\)/g, (source, label, href, title) =>
+        (isSafeUrl(href) ? `<a href="${href}"${title ? ` title="${title}"` : ''}>${label}</a>` : source));
+  }
+  if (html.includes('*')) {
+    html = html
+      .replace(/\*\*(?=\S)([\s\S]*?\S)\*\*/g, '<strong>$1</strong>')
+      .replace(/\*(?=[^\s*])([\s\S]*?[^\s*])\*/g, '<em>$1</em>')
+      .replace(/\*(?=[^\s*])([^*])\*/g, '<em>$1</em>');
+  }
+  if (html.includes('_')) {
+    html = html
+      .replace(/(^|[^\w])__(?=\S)([\s\S]*?\S)__(?!\w)/g, '$1<strong>$2</strong>')
+      .replace(/(^|[^\w])_(?=\S)([\s\S]*?\S)_(?!\w)/g, '$1<em>$2</em>');
+  }
+  if (html.includes('~~')) {
+    html = html.replace(/~~(?=\S)([\s\S]*?\S)~~/g, '<s>$1</s>');
+  }
+  if (html.includes('\n')) {
+    html = html.replace(/(?: {2,}|\\)\n/g, '<br>\n');
+  }
+
+  if (codeSpans.length > 0) {
+    html = html.replace(CODE_PLACEHOLDER_RE, (_, i) => codeSpans[i]);
+  }
+  if (hasEscapes) {
+    html = html.replace(ESCAPE_PLACEHOLDER_RE, (_, code) => escapeHtml(String.fromCharCode(code)));
+  }
+  return html;
+};
+
+const splitTableRow = (line) => {
+  let row = line.trim();
+  if (row.startsWith('|')) row = row.slice(1);
+  if (row.endsWith('|') && !row.endsWith('\\|')) row = row.slice(0, -1);
+  return row.split(/(?<!\\)\|/).map(cell => cell.trim());
+};
+
+const tableAlignments = (delimiterLine) => splitTableRow(delimiterLine).map(cell => {
+  const left = cell.startsWith(':');
+  const right = cell.endsWith(':');
+  if (left && right) return 'center';
+  if (right) return 'right';
+  if (left) return 'left';
+  return null;
+});
+
+/**
+ * Walk the block structure of a markdown document, yielding each block as soon
+ * as it closes. This is the single parser behind every output format (HTML
+ * here, PDF in PDFWriter), in the spirit of md4c's callback API.
+ *
+ * Block shapes:
+ *   { type: 'heading', level, text }       { type: 'paragraph', text }
+ *   { type: 'listItem', indent, ordered, number, text }
+ *   { type: 'code', language, text }       { type: 'rule' }
+ *   { type: 'blockquote', markdown }       { type: 'table', header, alignments, rows }
+ *
+ * @param {string} markdown - Markdown source
+ * @returns {Generator<Object>} - Blocks in document order
+ */
+export function* iterateBlocks(markdown) {
+  const lines = (markdown || '').replace(/\r\n?/g, '\n').split('\n');
+  let paragraph = [];
+  let item = null; // list item being collected: { indent, ordered, number, lines }
+  let sawBlankInList = false;
+
+  const takeParagraph = () => {
+    const block = paragraph.length > 0 ? { type: 'paragraph', text: paragraph.join('\n') } : null;
+    paragraph = [];
+    return block;
+  };
+
+  const takeItem = () => {
+    if (!item) return null;
+    const { lines: itemLines, ...rest } = item;
+    item = null;
+    return { type: 'listItem', ...rest, text: itemLines.join('\n').trim() };
+  };
+
+  function* closeAllBlocks() {
+    const pending = takeParagraph() || takeItem();
+    if (pending) yield pending;
+    sawBlankInList = false;
+  }
+
+  for (let i = 0; i < lines.length; i++) {
+    const line = lines[i];
+
+    // Block rules are keyed on the first non-blank character so plain text lines skip the regexes
+    const first = line.trimStart().charAt(0);
+    if (first === '') {
+      if (item) {
+        sawBlankInList = true;
+      } else {
+        const block = takeParagraph();
+        if (block) yield block;
+      }
+      continue;
+    }
+
+    // Fenced code: copy verbatim up to the closing fence
+    const fence = (first === '`' || first === '~') && FENCE_RE.exec(line);
+    if (fence) {
+      yield* closeAllBlocks();
+      const marker = fence[1];
+      const code = [];
+      for (i++; i < lines.length && !lines[i].trim().startsWith(marker); i++) {
+        code.push(lines[i]);
+      }
+      yield { type: 'code', language: fence[2] || null, text: code.join('\n') };
+      continue;
+    }
+
+    // Setext headings underline the paragraph collected so far
+    if (paragraph.length > 0 && (first === '=' || first === '-')) {
+      const level = SETEXT_H1_RE.test(line) ? 1 : SETEXT_H2_RE.test(line) ? 2 : 0;
+      if (level) {
+        yield { type: 'heading', level, text: takeParagraph().text.trim() };
+        continue;
+      }
+    }
+
+    const headingMatch = first === '#' && HEADING_RE.exec(line);
+    if (headingMatch) {
+      yield* closeAllBlocks();
+      yield { type: 'heading', level: headingMatch[1].length, text: (headingMatch[2] || '').trim() };
+      continue;
+    }
+
+    if ((first === '-' || first === '*' || first === '_') && RULE_RE.test(line)) {
+      yield* closeAllBlocks();
+      yield { type: 'rule' };
+      continue;
+    }
+
+    // Blockquotes: gather the quoted run; consumers treat it as a nested document
+    if (first === '>' && BLOCKQUOTE_RE.test(line)) {
+      yield* closeAllBlocks();
+      const quoted = [];
+      for (; i < lines.length; i++) {
+        const quoteMatch = BLOCKQUOTE_RE.exec(lines[i]);
+        if (!quoteMatch) break;
+        quoted.push(quoteMatch[1]);
+      }
+      i--;
+      yield { type: 'blockquote', markdown: quoted.join('\n') };
+      continue;
+    }
+
+    // GFM tables need one line of lookahead for the delimiter row
+    if (line.includes('|') && i + 1 < lines.length && TABLE_DELIMITER_RE.test(lines[i + 1]) &&
+        lines[i + 1].includes('-')) {
+      yield* closeAllBlocks();
+      const header = splitTableRow(line);
+      const alignments = tableAlignments(lines[i + 1]);
+      const rows = [];
+      for (i += 2; i < lines.length && lines[i].trim() !== '' && lines[i].includes('|'); i++) {
+        const cells = splitTableRow(lines[i]);
+        rows.push(header.map((_, col) => cells[col] || ''));
+      }
+      i--;
+      yield { type: 'table', header, alignments, rows };
+      continue;
+    }
+
+    const listMatch = (first === '-' || first === '*' || first === '+' || (first >= '0' && first <= '9')) &&
+      LIST_ITEM_RE.exec(line);
+    if (listMatch && (paragraph.length === 0 || /^[-*+]$|^1[.)]$/.test(listMatch[2]))) {
+      yield* closeAllBlocks();
+      const ordered = /\d/.test(listMatch[2]);
+      item = {
+        indent: indentWidth(listMatch[1]),
+        ordered,
+        number: ordered ? parseInt(listMatch[2], 10) : null,
+        lines: listMatch[3] ? [listMatch[3].trim()] : [],
+      };
+      continue;
+    }
+
+    if (item) {
+      const lineIndent = indentWidth(/^[ \t]*/.exec(line)[0]);
+      if (!sawBlankInList || lineIndent > item.indent) {
+        // Continuation (or lazy continuation) of the open item
+        if (sawBlankInList) item.lines.push('');
+        sawBlankInList = false;
+        item.lines.push(line.trim());
+        continue;
+      }
+      // Unindented text after a blank line ends the list
+      yield* closeAllBlocks();
+    }
+
+    paragraph.push(line.replace(/^[ \t]+/, ''));
+  }
+
+  yield* closeAllBlocks();
+}
+
+/**
+ * Render markdown to an HTML fragment.
+ * @param {string} markdown - Markdown source
+ * @param {Object} options - { headingAttributes: { h1: ' style="..."', ... } } extra attributes per heading tag
+ * @returns {string} - HTML fragment
+ */
+export const renderMarkdown = (markdown, options = {}) => {
+  const headingAttributes = options.headingAttributes || {};
+  const out = [];
+  const lists = []; // open lists, innermost last: { tag, indent }
+
+  const closeListsDeeperThan = (indent) => {
+    while (lists.length > 0 && lists[lists.length - 1].indent > indent) {
+      out.push(`</li>\n</${lists.pop().tag}>\n`);
+    }
+  };
+
+  const alignAttribute = (alignment) => (alignment ? ` style="text-align:${alignment}"` : '');
+
+  for (const block of iterateBlocks(markdown)) {
+    if (block.type !== 'listItem') {
+      closeListsDeeperThan(-1);
+    }
+
+    switch (block.type) {
+      case 'paragraph':
+        out.push(`<p>${renderInline(block.text)}</p>\n`);
+        break;
+      case 'heading': {
+        const tag = `h${block.level}`;
+        out.push(`<${tag}${headingAttributes[tag] || ''}>${renderInline(block.text)}</${tag}>\n`);
+        break;
+      }
+      case 'rule':
+        out.push('<hr>\n');
+        break;
+      case 'code': {
+        const language = block.language ? ` class="language-${escapeHtml(block.language)}"` : '';
+        out.push(`<pre><code${language}>${escapeHtml(block.text)}${block.text ? '\n' : ''}</code></pre>\n`);
+        break;
+      }
+      case 'blockquote':
+        out.push(`<blockquote>\n${renderMarkdown(block.markdown, options)}</blockquote>\n`);
+        break;
+      case 'table':
+        out.push('<table>\n<thead>\n<tr>\n');
+        block.header.forEach((cell, col) =>
+          out.push(`<th${alignAttribute(block.alignments[col])}>${renderInline(cell)}</th>\n`));
+        out.push('</tr>\n</thead>\n');
+        if (block.rows.length > 0) {
+          out.push('<tbody>\n');
+          for (const row of block.rows) {
+            out.push('<tr>\n');
+            row.forEach((cell, col) =>
+              out.push(`<td${alignAttribute(block.alignments[col])}>${renderInline(cell)}</td>\n`));
+            out.push('</tr>\n');
+          }
+          out.push('</tbody>\n');
+        }
+        out.push('</table>\n');
+        break;
+      case 'listItem': {
+        const tag = block.ordered ? 'ol' : 'ul';
+        closeListsDeeperThan(block.indent + 1);
+        const current = lists[lists.length - 1];
+        if (current && block.indent < current.indent + 2 && current.tag === tag) {
+          out.push('</li>\n');
+        } else {
+          if (current && block.indent < current.indent + 2) {
+            // Same depth but a different list type closes the old list
+            out.push(`</li>\n</${lists.pop().tag}>\n`);
+          }
+          if (lists.length > 0) out.push('\n'); // nested list starts on its own line inside the item
+          out.push(block.ordered && block.number !== 1 ? `<ol start="${block.number}">\n` : `<${tag}>\n`);
+          lists.push({ tag, indent: block.indent });
+        }
+        // Items of a tight list render without <p> wrappers, like markdown-it
+        out.push(`<li>${renderInline(block.text)}`);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  closeListsDeeperThan(-1);
+  return out.join('');
+};
+
+const INLINE_TOKEN_RE = /\\([!-/:-@[-`{-~])|(`+)([\s\S]*?[^`])\2(?!`)|!?\[([^\]]*)\]\([^)\s]+(?:\s+"[^"]*")?\)|\*\*(?=\S)([\s\S]*?\S)\*\*|(?<![\w])__(?=\S)([\s\S]*?\S)__(?!\w)|\*(?=[^\s*])([\s\S]*?[^\s*])\*|(?<![\w])_(?=\S)([\s\S]*?\S)_(?!\w)|~~(?=\S)([\s\S]*?\S)~~/g;
+
+/**
+ * Split inline markdown into styled text runs, for layout engines that draw
+ * text directly (e.g. PDFWriter). Links keep only their label.
+ * @param {string} text - Inline markdown
+ * @param {Object} style - Inherited { bold, italic, code }
+ * @returns {Array<Object>} - [{ text, bold, italic, code }]
+ */
+export const parseInlineRuns = (text, style = {}) => {
+  const runs = [];
+  const push = (runText, runStyle) => {
+    if (!runText) return;
+    const normalized = runText.replace(/[ \t]*\n[ \t]*/g, ' ');
+    const bold = !!runStyle.bold;
+    const italic = !!runStyle.italic;
+    const code = !!runStyle.code;
+    const previous = runs[runs.length - 1];
+    if (previous && previous.bold === bold && previous.italic === italic && previous.code === code) {
+      previous.text += normalized;
+    } else {
+      runs.push({ text: normalized, bold, italic, code });
+    }
+  };
+  const pushNested = (inner, nestedStyle) => {
+    for (const run of parseInlineRuns(inner, nestedStyle)) push(run.text, run);
+  };
+
+  const tokenRe = new RegExp(INLINE_TOKEN_RE.source, 'g');
+  let last = 0;
+  let match;
+  while ((match = tokenRe.exec(text)) !== null) {
+    push(text.slice(last, match.index), style);
+    if (match[1]) {
+      push(match[1], style);
+    } else if (match[2]) {
+      push(match[3].replace(/\n/g, ' ').trim(), { ...style, code: true });
+    } else if (match[4] !== undefined) {
+      pushNested(match[4], style);
+    } else if (match[5] || match[6]) {
+      pushNested(match[5] || match[6], { ...style, bold: true });
+    } else if (match[7] || match[8]) {
+      pushNested(match[7] || match[8], { ...style, italic: true });
+    } else if (match[9]) {
+      pushNested(match[9], style);
+    }
+    last = tokenRe.lastIndex;
+  }
+  push(text.slice(last), style);
+  return runs;
+};
+
+/**
+ * 32-bit FNV-1a hash of a string, as 8 hex characters.
+ * @param {string} text - Input
+ * @returns {string} - Hex digest
+ */
+export const hashString = (text) => {
+  let hash = 0x811c9dc5;
+  for (let i = 0; i < text.length; i++) {
+    hash ^= text.charCodeAt(i);
+    hash = Math.imul(hash, 0x01000193);
+  }
+  return (hash >>> 0).toString(16).padStart(8, '0');
+};
+
+// Rendered fragments per recording, most recently used last
+const MAX_CACHED_FRAGMENTS = 64;
+const fragmentCache = new Map();
+const cacheStats = { hits: 0, misses: 0 };
+
+/**
+ * Render markdown, reusing the cached HTML when the source is unchanged.
+ * @param {string} cacheKey - Stable key, e.g. the recording id
+ * @param {string} markdown - Markdown source
+ * @param {Object} options - Passed to renderMarkdown; must be the same for a given key
+ * @returns {string} - HTML fragment
+ */
+export const renderMarkdownCached = (cacheKey, markdown, options = {}) => {
+  const hash = hashString(markdown || '');
+  const cached = fragmentCache.get(cacheKey);
+  if (cached && cached.hash === hash) {
+    fragmentCache.delete(cacheKey);
+    fragmentCache.set(cacheKey, cached);
+    cacheStats.hits++;
+    return cached.html;
+  }
+
+  cacheStats.misses++;
+  const html = renderMarkdown(markdown, options);
+  fragmentCache.delete(cacheKey);
+  fragmentCache.set(cacheKey, { hash, html });
+  if (fragmentCache.size > MAX_CACHED_FRAGMENTS) {
+    fragmentCache.delete(fragmentCache.keys().next().value);
+  }
+  return html;
+};
+
+/**
+ * Cache hit/miss counters for diagnostics.
+ * @returns {Object} - { hits, misses, size }
+ */
+export const getRenderCacheStats = () => ({ ...cacheStats, size: fragmentCache.size });
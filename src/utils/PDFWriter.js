@@ -0,0 +1,546 @@
+/**
+ * Streaming PDF writer for summary exports.
+ *
+ * Lays out markdown blocks (from MarkdownRenderer.iterateBlocks) directly onto
+ * US Letter pages using the standard-14 Helvetica/Courier metrics, and hands
+ * each finished page to a sink as soon as it is complete. Only the current page
+ * and the object offset table are held in memory, so a 100-lesson export costs
+ * the same memory as a single lesson. No WebView is involved.
+ *
+ * Kept free of React Native imports; callers supply the sink (see ShareUtils
+ * for the RNFS-backed one, scripts/benchmarkPDF.js for Node).
+ */
+import { iterateBlocks, parseInlineRuns } from './MarkdownRenderer';
+
+// --- Font metrics (AFM advance widths for WinAnsi 32..126, 1/1000 em) ---
+
+const HELVETICA_WIDTHS = [
+  278, 278, 355, 556, 556, 889, 667, 191, 333, 333, 389, 584, 278, 333, 278, 278,
+  556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 278, 278, 584, 584, 584, 556,
+  1015, 667, 667, 722, 722, 667, 611, 778, 722, 278, 500, 667, 556, 833, 722, 778,
+  667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 278, 278, 278, 469, 556,
+  333, 556, 556, 500, 556, 556, 278, 556, 556, 222, 222, 500, 222, 833, 556, 556,
+  556, 556, 333, 500, 278, 556, 500, 722, 500, 500, 500, 334, 260, 334, 584,
+];
+
+const HELVETICA_BOLD_WIDTHS = [
+  278, 333, 474, 556, 556, 889, 722, 238, 333, 333, 389, 584, 278, 333, 278, 278,
+  556, 556, 556, 556, 556, 556, 556, 556, 556, 556, 333, 333, 584, 584, 584, 611,
+  975, 722, 722, 722, 722, 667, 611, 778, 722, 278, 556, 722, 611, 833, 722, 778,
+  667, 778, 722, 667, 611, 722, 667, 944, 667, 667, 611, 333, 278, 333, 584, 556,
+  333, 556, 611, 556, 611, 556, 333, 611, 611, 278, 278, 556, 278, 889, 611, 611,
+  611, 611, 389, 556, 333, 611, 556, 778, 556, 556, 500, 389, 280, 389, 584,
+];
+
+// Unicode punctuation that WinAnsiEncoding carries in the 0x80-0x9F range
+const WIN_ANSI_EXTRAS = {
+  0x2013: [0x96, 556, 556], // en dash
+  0x2014: [0x97, 1000, 1000], // em dash
+  0x2018: [0x91, 222, 278], // left single quote
+  0x2019: [0x92, 222, 278], // right single quote
+  0x201c: [0x93, 333, 500], // left double quote
+  0x201d: [0x94, 333, 500], // right double quote
+  0x2022: [0x95, 350, 350], // bullet
+  0x2026: [0x85, 1000, 1000], // ellipsis
+  0x20ac: [0x80, 556, 556], // euro
+};
+
+// Resource names: F1 regular, F2 bold, F3 oblique, F4 bold oblique, F5 courier
+const FONTS = [
+  { name: 'F1', base: 'Helvetica', widths: HELVETICA_WIDTHS },
+  { name: 'F2', base: 'Helvetica-Bold', widths: HELVETICA_BOLD_WIDTHS },
+  { name: 'F3', base: 'Helvetica-Oblique', widths: HELVETICA_WIDTHS },
+  { name: 'F4', base: 'Helvetica-BoldOblique', widths: HELVETICA_BOLD_WIDTHS },
+  { name: 'F5', base: 'Courier', widths: null },
+];
+
+const fontForRun = (run) => {
+  if (run.code) return FONTS[4];
+  return FONTS[(run.bold ? 1 : 0) + (run.italic ? 2 : 0)];
+};
+
+// WinAnsi byte for a UTF-16 code unit, or '?' when the font cannot show it
+const winAnsiCode = (code) => {
+  if (code >= 32 && code <= 126) return code;
+  if (code >= 160 && code <= 255) return code;
+  const extra = WIN_ANSI_EXTRAS[code];
+  return extra ? extra[0] : 63;
+};
+
+/**
+ * Whether every character of `text` can be shown with the standard fonts
+ * (WinAnsiEncoding); anything else would print as '?'.
+ * @param {string} text - Text to check
+ * @returns {boolean}
+ */
+export const canEncodeWinAnsi = (text) => {
+  for (let i = 0; i < text.length; i++) {
+    const code = text.charCodeAt(i);
+    if (code === 10 || code === 13 || code === 9) continue;
+    if (winAnsiCode(code) === 63 && code !== 63) return false;
+  }
+  return true;
+};
+
+const charWidth = (font, code) => {
+  if (!font.widths) return 600; // Courier is monospaced
+  if (code >= 32 && code <= 126) return font.widths[code - 32];
+  const extra = WIN_ANSI_EXTRAS[code];
+  if (extra) return font === FONTS[1] || font === FONTS[3] ? extra[2] : extra[1];
+  return 556; // Latin-1 letters are close to the digit width
+};
+
+/**
+ * Width of a string in points.
+ * @param {Object} font - Entry from FONTS
+ * @param {string} text - Text to measure
+ * @param {number} size - Font size in points
+ * @returns {number} - Advance width in points
+ */
+const measureText = (font, text, size) => {
+  let units = 0;
+  for (let i = 0; i < text.length; i++) {
+    units += charWidth(font, text.charCodeAt(i));
+  }
+  return (units * size) / 1000;
+};
+
+// PDF literal string with non-ASCII bytes as octal escapes, so output stays 7-bit
+const pdfString = (text) => {
+  let out = '(';
+  for (let i = 0; i < text.length; i++) {
+    const byte = winAnsiCode(text.charCodeAt(i));
+    if (byte === 40 || byte === 41 || byte === 92) {
+      out += `\\${String.fromCharCode(byte)}`;
+    } else if (byte > 126) {
+      out += `\\${byte.toString(8)}`;
+    } else {
+      out += String.fromCharCode(byte);
+    }
+  }
+  return `${out})`;
+};
+
+const hexToRgb = (hex) => {
+  const value = parseInt(hex.replace('#', ''), 16);
+  return [(value >> 16) & 255, (value >> 8) & 255, value & 255].map(c => (c / 255).toFixed(3)).join(' ');
+};
+
+const fmt = (n) => (Math.round(n * 100) / 100).toString();
+
+// --- Page geometry and styles (mirrors the HTML export stylesheet) ---
+
+const PAGE_WIDTH = 612;
+const PAGE_HEIGHT = 792;
+const MARGIN_X = 50;
+const MARGIN_TOP = 40;
+const MARGIN_BOTTOM = 50;
+const HEADER_HEIGHT = 28;
+const CONTENT_WIDTH = PAGE_WIDTH - MARGIN_X * 2;
+const LIST_INDENT = 22;
+
+const STYLES = {
+  h1: { size: 20, bold: true, color: '#007AFF', before: 24, after: 10, rule: true },
+  h2: { size: 16, bold: true, color: '#0062CC', before: 14, after: 8 },
+  h3: { size: 14, bold: true, color: '#444444', before: 12, after: 6 },
+  h4: { size: 13, bold: true, color: '#555555', before: 10, after: 4 },
+  body: { size: 12, color: '#333333', after: 8 },
+  listItem: { size: 12, color: '#333333', after: 4 },
+  code: { size: 11, color: '#333333', after: 8 },
+  quote: { size: 12, italic: true, color: '#555555', after: 8 },
+  table: { size: 11, color: '#333333', after: 10 },
+};
+const LINE_HEIGHT = 1.25;
+
+/**
+ * Streams a PDF document to a sink, one page at a time.
+ *
+ * Usage:
+ *   const writer = new PDFDocumentWriter(sink, { title });
+ *   await writer.begin();
+ *   await writer.addMarkdown(markdown);
+ *   const { pageCount, bytes } = await writer.finish();
+ *
+ * The sink is `{ write(chunk: string): Promise<void> }`; chunks are 7-bit ASCII.
+ */
+export class PDFDocumentWriter {
+  constructor(sink, { title = 'ArcoScribe Summary', footer = null } = {}) {
+    this.sink = sink;
+    this.title = title;
+    this.footer = footer;
+    this.offsets = []; // byte offset of each object, index = object number - 1
+    this.bytesWritten = 0;
+    this.pageObjectNumbers = [];
+    this.nextObjectNumber = 1;
+    this.page = null; // { ops: [], y, atTop } for the page being laid out
+  }
+
+  // Object numbers 1 (catalog) and 2 (page tree) are reserved; fonts follow
+  async begin() {
+    this.catalogNumber = this.allocateObject();
+    this.pagesNumber = this.allocateObject();
+    await this.writeRaw('%PDF-1.4\n');
+    this.fontNumbers = [];
+    for (const font of FONTS) {
+      const number = this.allocateObject();
+      this.fontNumbers.push(number);
+      await this.writeObject(number,
+        `<< /Type /Font /Subtype /Type1 /BaseFont /${font.base} /Encoding /WinAnsiEncoding >>`);
+    }
+  }
+
+  allocateObject() {
+    return this.nextObjectNumber++;
+  }
+
+  async writeRaw(chunk) {
+    this.bytesWritten += chunk.length;
+    await this.sink.write(chunk);
+  }
+
+  async writeObject(number, body) {
+    this.offsets[number - 1] = this.bytesWritten;
+    await this.writeRaw(`${number} 0 obj\n${body}\nendobj\n`);
+  }
+
+  // --- Page management ---
+
+  startPage() {
+    this.page = { ops: [], y: PAGE_HEIGHT - MARGIN_TOP, atTop: true };
+    const isFirstPage = this.pageObjectNumbers.length === 0;
+    if (isFirstPage) {
+      // Title band like the HTML export header
+      const bandHeight = HEADER_HEIGHT + 8;
+      this.page.ops.push(`${hexToRgb('#0062CC')} rg 0 ${fmt(PAGE_HEIGHT - bandHeight)} ${PAGE_WIDTH} ${bandHeight} re f`);
+      this.drawText(this.title, FONTS[0], 12, '#FFFFFF', MARGIN_X - 10, PAGE_HEIGHT - bandHeight + 13);
+      this.page.y = PAGE_HEIGHT - bandHeight - 16;
+    }
+  }
+
+  async finishPage() {
+    if (!this.page) return;
+    const pageNumber = this.pageObjectNumbers.length + 1;
+    const label = `${pageNumber}`;
+    this.drawText(label, FONTS[0], 10, '#888888', PAGE_WIDTH - 40 - measureText(FONTS[0], label, 10), 15);
+
+    const content = this.page.ops.join('\n');
+    const contentNumber = this.allocateObject();
+    const pageNumberObj = this.allocateObject();
+    await this.writeObject(contentNumber, `<< /Length ${content.length} >>\nstream\n${content}\nendstream`);
+    const fontResources = FONTS.map((font, i) => `/${font.name} ${this.fontNumbers[i]} 0 R`).join(' ');
+    await this.writeObject(pageNumberObj,
+      `<< /Type /Page /Parent ${this.pagesNumber} 0 R /MediaBox [0 0 ${PAGE_WIDTH} ${PAGE_HEIGHT}] ` +
+      `/Resources << /Font << ${fontResources} >> >> /Contents ${contentNumber} 0 R >>`);
+    this.pageObjectNumbers.push(pageNumberObj);
+    this.page = null;
+  }
+
+  // Make sure `height` points fit on the current page, starting a new one if not
+  async ensureSpace(height) {
+    if (!this.page) {
+      this.startPage();
+      return;
+    }
+    if (this.page.y - height < MARGIN_BOTTOM) {
+      await this.finishPage();
+      this.startPage();
+    }
+  }
+
+  drawText(text, font, size, color, x, y) {
+    this.page.ops.push(`BT ${hexToRgb(color)} rg /${font.name} ${size} Tf ${fmt(x)} ${fmt(y)} Td ${pdfString(text)} Tj ET`);
+  }
+
+  drawLine(x1, y1, x2, y2, color, width = 1) {
+    this.page.ops.push(`${hexToRgb(color)} RG ${width} w ${fmt(x1)} ${fmt(y1)} m ${fmt(x2)} ${fmt(y2)} l S`);
+  }
+
+  // --- Text layout ---
+
+  /**
+   * Greedy line breaking over styled runs.
+   * @returns {Array<Array<Object>>} - Lines of { text, font, width }
+   */
+  breakLines(runs, size, maxWidth) {
+    const lines = [];
+    let line = [];
+    let lineWidth = 0;
+
+    const pushPiece = (text, font) => {
+      const width = measureText(font, text, size);
+      const previous = line[line.length - 1];
+      if (previous && previous.font === font) {
+        previous.text += text;
+        previous.width += width;
+      } else {
+        line.push({ text, font, width });
+      }
+      lineWidth += width;
+    };
+
+    const wrap = (spaceWidth) => {
+      // Drop the trailing space before wrapping
+      const last = line[line.length - 1];
+      if (last.text.endsWith(' ')) {
+        last.text = last.text.slice(0, -1);
+        last.width -= spaceWidth;
+      }
+      lines.push(line);
+      line = [];
+      lineWidth = 0;
+    };
+
+    for (const run of runs) {
+      const font = fontForRun(run);
+      const spaceWidth = measureText(font, ' ', size);
+      for (const word of run.text.split(/(\s+)/)) {
+        if (!word) continue;
+        if (/^\s+$/.test(word)) {
+          if (line.length > 0) pushPiece(' ', font);
+          continue;
+        }
+        const wordWidth = measureText(font, word, size);
+        if (lineWidth + wordWidth > maxWidth && line.length > 0) {
+          wrap(spaceWidth);
+        }
+        if (wordWidth <= maxWidth) {
+          pushPiece(word, font);
+          continue;
+        }
+        // Wider than a whole line (a long URL): break it wherever the line fills
+        let piece = '';
+        let pieceWidth = 0;
+        for (const ch of word) {
+          const width = measureText(font, ch, size);
+          if (lineWidth + pieceWidth + width > maxWidth && (piece || line.length > 0)) {
+            if (piece) pushPiece(piece, font);
+            wrap(spaceWidth);
+            piece = '';
+            pieceWidth = 0;
+          }
+          piece += ch;
+          pieceWidth += width;
+        }
+        if (piece) pushPiece(piece, font);
+      }
+    }
+    if (line.length > 0) lines.push(line);
+    return lines;
+  }
+
+  async layoutRuns(runs, style, x, maxWidth, marker = null) {
+    const size = style.size;
+    const lineHeight = size * LINE_HEIGHT;
+    const lines = this.breakLines(runs, size, maxWidth);
+    if (lines.length === 0) return;
+    for (let i = 0; i < lines.length; i++) {
+      await this.ensureSpace(lineHeight);
+      this.page.y -= lineHeight;
+      const baseline = this.page.y + (lineHeight - size) / 2 + size * 0.2;
+      if (i === 0 && marker) {
+        this.drawText(marker, FONTS[0], size, style.color, x - measureText(FONTS[0], marker, size) - 6, baseline);
+      }
+      let cursor = x;
+      for (const piece of lines[i]) {
+        this.drawText(piece.text, piece.font, size, style.color, cursor, baseline);
+        cursor += piece.width;
+      }
+      if (style.quoteBar) {
+        this.drawLine(x - 10, this.page.y, x - 10, this.page.y + lineHeight, '#0062CC', 3);
+      }
+      this.page.atTop = false;
+    }
+    this.page.y -= style.after || 0;
+  }
+
+  async addHeading(level, text) {
+    const style = STYLES[`h${Math.min(level, 4)}`];
+    await this.ensureSpace(style.before + style.size * LINE_HEIGHT * 2);
+    if (!this.page.atTop) this.page.y -= style.before;
+    const runs = parseInlineRuns(text, { bold: style.bold });
+    await this.layoutRuns(runs, { ...style, after: 0 }, MARGIN_X, CONTENT_WIDTH);
+    if (style.rule) {
+      this.page.y -= 4;
+      this.drawLine(MARGIN_X, this.page.y, PAGE_WIDTH - MARGIN_X, this.page.y, '#E5E5E5', 1);
+    }
+    this.page.y -= style.after;
+  }
+
+  async addTable(block) {
+    const style = STYLES.table;
+    const columns = block.header.length;
+    const columnWidth = CONTENT_WIDTH / columns;
+    const drawRow = async (cells, bold) => {
+      const cellLines = cells.map(cell =>
+        this.breakLines(parseInlineRuns(cell, { bold }), style.size, columnWidth - 12));
+      const rowLines = Math.max(1, ...cellLines.map(lines => lines.length));
+      const lineHeight = style.size * LINE_HEIGHT;
+      const rowHeight = rowLines * lineHeight + 8;
+      await this.ensureSpace(rowHeight);
+      const top = this.page.y;
+      cellLines.forEach((lines, col) => {
+        const x = MARGIN_X + col * columnWidth + 6;
+        lines.forEach((line, i) => {
+          let cursor = x;
+          const lineWidth = line.reduce((sum, piece) => sum + piece.width, 0);
+          if (block.alignments[col] === 'right') cursor = x + columnWidth - 12 - lineWidth;
+          if (block.alignments[col] === 'center') cursor = x + (columnWidth - 12 - lineWidth) / 2;
+          for (const piece of line) {
+            this.drawText(piece.text, piece.font, style.size, style.color, cursor, top - 4 - (i + 1) * lineHeight + 3);
+            cursor += piece.width;
+          }
+        });
+      });
+      this.page.y -= rowHeight;
+      this.page.atTop = false;
+      this.drawLine(MARGIN_X, this.page.y, PAGE_WIDTH - MARGIN_X, this.page.y, '#DDDDDD', 0.5);
+    };
+    await drawRow(block.header, true);
+    for (const row of block.rows) {
+      await drawRow(row, false);
+    }
+    this.page.y -= style.after;
+  }
+
+  /**
+   * Lay out a markdown document, flushing pages as they fill.
+   * @param {string} markdown - Markdown source
+   * @param {number} indent - Extra left indent in points (used for blockquotes)
+   */
+  async addMarkdown(markdown, indent = 0, quoted = false) {
+    const orderedCounters = new Map(); // list indent -> next number
+    for (const block of iterateBlocks(markdown)) {
+      const x = MARGIN_X + indent;
+      const width = CONTENT_WIDTH - indent;
+      if (block.type !== 'listItem') orderedCounters.clear();
+
+      switch (block.type) {
+        case 'heading':
+          await this.addHeading(block.level, block.text);
+          break;
+        case 'paragraph': {
+          const style = quoted ? { ...STYLES.quote, quoteBar: true } : STYLES.body;
+          await this.layoutRuns(parseInlineRuns(block.text, { italic: quoted }), style, x, width);
+          break;
+        }
+        case 'listItem': {
+          const depth = Math.floor(block.indent / 2);
+          let marker = depth % 2 === 0 ? '•' : '-';
+          if (block.ordered) {
+            const number = orderedCounters.has(block.indent) ? orderedCounters.get(block.indent) : block.number;
+            orderedCounters.set(block.indent, number + 1);
+            marker = `${number}.`;
+          }
+          const itemX = x + LIST_INDENT * (depth + 1);
+          await this.layoutRuns(parseInlineRuns(block.text, { italic: quoted }), STYLES.listItem,
+            itemX, CONTENT_WIDTH - (itemX - MARGIN_X), marker);
+          break;
+        }
+        case 'code': {
+          const lines = block.text.split('\n');
+          for (const line of lines) {
+            await this.layoutRuns([{ text: line || ' ', code: true }], { ...STYLES.code, after: 0 }, x + 10, width - 10);
+          }
+          this.page.y -= STYLES.code.after;
+          break;
+        }
+        case 'rule':
+          await this.ensureSpace(16);
+          this.page.y -= 8;
+          this.drawLine(x, this.page.y, PAGE_WIDTH - MARGIN_X, this.page.y, '#E5E5E5', 1);
+          this.page.y -= 8;
+          break;
+        case 'blockquote':
+          await this.addMarkdown(block.markdown, indent + 15, true);
+          break;
+        case 'table':
+          await this.addTable(block);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  /**
+   * Write the footer, page tree, catalog and cross-reference table.
+   * @returns {Promise<Object>} - { pageCount, bytes }
+   */
+  async finish() {
+    if (this.footer) {
+      await this.ensureSpace(40);
+      this.page.y -= 16;
+      this.drawLine(MARGIN_X, this.page.y, PAGE_WIDTH - MARGIN_X, this.page.y, '#EEEEEE', 1);
+      this.page.y -= 16;
+      const width = measureText(FONTS[0], this.footer, 10);
+      this.drawText(this.footer, FONTS[0], 10, '#999999', (PAGE_WIDTH - width) / 2, this.page.y);
+    }
+    if (!this.page && this.pageObjectNumbers.length === 0) this.startPage();
+    await this.finishPage();
+
+    const kids = this.pageObjectNumbers.map(n => `${n} 0 R`).join(' ');
+    await this.writeObject(this.pagesNumber,
+      `<< /Type /Pages /Kids [${kids}] /Count ${this.pageObjectNumbers.length} >>`);
+    await this.writeObject(this.catalogNumber, `<< /Type /Catalog /Pages ${this.pagesNumber} 0 R >>`);
+
+    const xrefOffset = this.bytesWritten;
+    const entries = this.offsets.map(offset => `${String(offset).padStart(10, '0')} 00000 n \n`).join('');
+    await this.writeRaw(
+      `xref\n0 ${this.offsets.length + 1}\n0000000000 65535 f \n${entries}` +
+      `trailer\n<< /Size ${this.offsets.length + 1} /Root ${this.catalogNumber} 0 R /Info << /Title ${pdfString(this.title)} /Producer (ArcoScribe) >> >>\n` +
+      `startxref\n${xrefOffset}\n%%EOF\n`);
+
+    return { pageCount: this.pageObjectNumbers.length, bytes: this.bytesWritten };
+  }
+}
+
+/**
+ * Buffer sink writes into larger chunks so the underlying file API is called
+ * a few times per export rather than once per object.
+ * @param {Function} appendChunk - async (chunk: string) => void
+ * @param {number} flushBytes - Buffer size before appending
+ * @returns {Object} - Sink with write() and flush()
+ */
+export const createBufferedSink = (appendChunk, flushBytes = 64 * 1024) => {
+  let buffer = [];
+  let buffered = 0;
+  const flush = async () => {
+    if (buffered === 0) return;
+    const chunk = buffer.join('');
+    buffer = [];
+    buffered = 0;
+    await appendChunk(chunk);
+  };
+  return {
+    async write(chunk) {
+      buffer.push(chunk);
+      buffered += chunk.length;
+      if (buffered >= flushBytes) await flush();
+    },
+    flush,
+  };
+};
+
+/**
+ * Write one or more markdown sections to a PDF.
+ * @param {Object} sink - Sink from createBufferedSink
+ * @param {string} title - Document title (shown in the header band)
+ * @param {Array<Object>} sections - [{ heading, markdown }]; heading is optional
+ * @param {string} footer - Optional footer line on the last page
+ * @returns {Promise<Object>} - { pageCount, bytes }
+ */
+export const writeMarkdownPDF = async (sink, title, sections, footer = null) => {
+  const writer = new PDFDocumentWriter(sink, { title, footer });
+  await writer.begin();
+  for (let i = 0; i < sections.length; i++) {
+    const section = sections[i];
+    if (section.heading) await writer.addHeading(2, section.heading);
+    await writer.addMarkdown(section.markdown);
+    if (i < sections.length - 1 && sections.length > 1) {
+      await writer.addMarkdown('---');
+    }
+  }
+  const result = await writer.finish();
+  if (sink.flush) await sink.flush();
+  return result;
+};
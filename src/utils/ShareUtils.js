@@ -1,10 +1,34 @@
 import { Share, Platform, Alert } from 'react-native';
 import RNFS from 'react-native-fs';
 import RNHTMLtoPDF from 'react-native-html-to-pdf';
-import MarkdownIt from 'markdown-it';
+import { renderMarkdown, renderMarkdownCached } from './MarkdownRenderer';
+import { writeMarkdownPDF, createBufferedSink, canEncodeWinAnsi } from './PDFWriter';
+import MetricsService from '../services/MetricsService';
 
-// Initialize markdown parser
-const md = new MarkdownIt();
+// Lay PDFs out directly with PDFWriter instead of rendering HTML in a WebView
+const USE_STREAMING_PDF_WRITER = true;
+
+// Inline heading styles (kept inline as well as in the stylesheet so PDF renderers
+// that drop <style> rules still color the headings)
+const HEADING_ATTRIBUTES = {
+  h1: ' style="color:#007AFF; font-size:20px; font-weight:600; margin-top:30px; margin-bottom:12px; border-bottom:1px solid #e5e5e5; padding-bottom:6px;"',
+  h2: ' style="color:#0062CC; font-size:16px; font-weight:500; margin-top:16px; margin-bottom:10px;"',
+  h3: ' style="color:#444; font-size:14px; font-weight:500; margin-top:15px; margin-bottom:8px;"',
+};
+const RENDER_OPTIONS = { headingAttributes: HEADING_ATTRIBUTES };
+
+/**
+ * Render a summary to an HTML fragment, reusing the cached fragment when the
+ * summary text has not changed since it was last rendered.
+ * @param {string} markdownContent - Markdown content
+ * @param {string} cacheKey - Optional cache key (recording id); omit to skip the cache
+ * @returns {string} - HTML fragment
+ */
+export const renderSummaryFragment = (markdownContent, cacheKey = null) => {
+  return cacheKey
+    ? renderMarkdownCached(cacheKey, markdownContent, RENDER_OPTIONS)
+    : renderMarkdown(markdownContent, RENDER_OPTIONS);
+};
 
 /**
  * Create a PDF file from HTML content
@@ -36,22 +60,77 @@ export const createPDFFromHTML = async (title, htmlContent) => {
   }
 };
 
+/**
+ * Create a PDF file directly from markdown, streaming pages to disk
+ * @param {string} title - Title of the content (header band and file name)
+ * @param {Array<Object>} sections - [{ heading, markdown }] laid out in order
+ * @returns {Promise<string>} - Path to the created PDF file
+ */
+export const createPDFFromMarkdown = async (title, sections) => {
+  const startMs = Date.now();
+  try {
+    const sanitizedTitle = title
+      .replace(/[^a-z0-9]/gi, '_')
+      .toLowerCase();
+    const filePath = `${RNFS.DocumentDirectoryPath}/${sanitizedTitle}_summary.pdf`;
+    await RNFS.writeFile(filePath, '', 'ascii');
+
+    const sink = createBufferedSink(chunk => RNFS.appendFile(filePath, chunk, 'ascii'));
+    const currentDate = new Date().toLocaleDateString('en-US', {
+      year: 'numeric',
+      month: 'long',
+      day: 'numeric'
+    });
+    const { pageCount, bytes } = await writeMarkdownPDF(sink, title, sections,
+      `Generated on ${currentDate} with ArcoScribe`);
+
+    MetricsService.record('pdf.streamingExportMs', 'ms', Date.now() - startMs);
+    MetricsService.record('pdf.streamingPages', 'pages', pageCount);
+    MetricsService.record('pdf.streamingBytes', 'bytes', bytes);
+    return filePath;
+  } catch (error) {
+    console.error('Error creating PDF:', error);
+    throw error;
+  }
+};
+
+/**
+ * Create a summary PDF with whichever PDF path is enabled
+ * @param {string} title - Title of the content
+ * @param {string} markdownContent - Cleaned summary markdown
+ * @param {string} cacheKey - Optional cache key (recording id) for the HTML path
+ * @returns {Promise<string>} - Path to the created PDF file
+ */
+export const createSummaryPDF = async (title, markdownContent, cacheKey = null) => {
+  // The streaming writer only has the standard WinAnsi fonts; Czech, Polish,
+  // Cyrillic or CJK text goes through the WebView, which has system fonts
+  if (USE_STREAMING_PDF_WRITER && canEncodeWinAnsi(title) && canEncodeWinAnsi(markdownContent || '')) {
+    return createPDFFromMarkdown(title, [{ markdown: markdownContent }]);
+  }
+  const startMs = Date.now();
+  const pdfPath = await createPDFFromHTML(title, generateHTMLFromMarkdown(title, markdownContent, cacheKey));
+  MetricsService.record('pdf.webviewExportMs', 'ms', Date.now() - startMs);
+  return pdfPath;
+};
+
 /**
  * Generate HTML from markdown string
  * @param {string} title - Title of content
  * @param {string} markdownContent - Markdown content to convert to HTML
+ * @param {string} cacheKey - Optional cache key (recording id) for the rendered body
  * @returns {string} - HTML string
  */
-export const generateHTMLFromMarkdown = (title, markdownContent) => {
-  // Convert markdown to HTML using MarkdownIt
-  let renderedHtml = md.render(markdownContent);
-  
-  // Enhanced inline styling for headings - more comprehensive approach
-  renderedHtml = renderedHtml
-    .replace(/<h1(.*?)>/g, '<h1$1 style="color:#007AFF; font-size:20px; font-weight:600; margin-top:30px; margin-bottom:12px; border-bottom:1px solid #e5e5e5; padding-bottom:6px;">')
-    .replace(/<h2(.*?)>/g, '<h2$1 style="color:#0062CC; font-size:16px; font-weight:500; margin-top:16px; margin-bottom:10px;">')
-    .replace(/<h3(.*?)>/g, '<h3$1 style="color:#444; font-size:14px; font-weight:500; margin-top:15px; margin-bottom:8px;">');
-  
+export const generateHTMLFromMarkdown = (title, markdownContent, cacheKey = null) => {
+  return wrapHTMLDocument(title, renderSummaryFragment(markdownContent, cacheKey));
+};
+
+/**
+ * Wrap a rendered HTML fragment in the styled export document
+ * @param {string} title - Title of content
+ * @param {string} renderedHtml - Body HTML fragment
+ * @returns {string} - HTML string
+ */
+export const wrapHTMLDocument = (title, renderedHtml) => {
   // Get current date for PDF footer
   const currentDate = new Date().toLocaleDateString('en-US', {
     year: 'numeric',
@@ -369,12 +448,15 @@ export const shareContentAsMD = async (title, markdownContent) => {
  * Share content as a PDF file.
  * @param {string} title - Base title for the shared file.
  * @param {string} markdownContent - The markdown content to convert and share.
+ * @param {string} prerenderedHtml - Optional full HTML document; skips rendering markdownContent.
+ * @param {string} cacheKey - Optional cache key (recording id) for the HTML path
  * @returns {Promise<boolean>}
  */
-export const shareContentAsPDF = async (title, markdownContent) => {
+export const shareContentAsPDF = async (title, markdownContent, prerenderedHtml = null, cacheKey = null) => {
   try {
-    const htmlContent = generateHTMLFromMarkdown(title, markdownContent);
-    const pdfPath = await createPDFFromHTML(title, htmlContent);
+    const pdfPath = prerenderedHtml
+      ? await createPDFFromHTML(title, prerenderedHtml)
+      : await createSummaryPDF(title, markdownContent, cacheKey);
     
     const shareOptions = {
       title: `${title} Summary`,
@@ -399,9 +481,11 @@ export const shareContentAsPDF = async (title, markdownContent) => {
  * Show format selection dialog and share the generated content.
  * @param {string} title - Base title for the shared file.
  * @param {string} contentGenerator - Function that generates the markdown content to share (e.g., () => recording.summary or () => generateCombinedSummaryContent(selectedRecordings)).
+ * @param {Function} htmlGenerator - Optional function returning the PDF's HTML document for the WebView PDF path (e.g., () => generateHTMLFromMarkdown(title, summary, recording.id)).
+ * @param {string} cacheKey - Optional cache key (recording id) for the PDF when it is rendered from contentGenerator's markdown.
  * @returns {Promise<boolean>} - True if shared, false if cancelled.
  */
-export const showFormatSelectionAndShare = async (title, contentGenerator) => {
+export const showFormatSelectionAndShare = async (title, contentGenerator, htmlGenerator = null, cacheKey = null) => {
   return new Promise((resolve, reject) => {
     Alert.alert(
       'Choose Format',
@@ -423,8 +507,12 @@ export const showFormatSelectionAndShare = async (title, contentGenerator) => {
           text: 'PDF (.pdf)',
           onPress: async () => {
             try {
-              const content = contentGenerator(); // Generate content only when needed
-              await shareContentAsPDF(title, content);
+              if (htmlGenerator && !USE_STREAMING_PDF_WRITER) {
+                await shareContentAsPDF(title, null, htmlGenerator());
+              } else {
+                const content = contentGenerator(); // Generate content only when needed
+                await shareContentAsPDF(title, content, null, cacheKey);
+              }
               resolve(true);
             } catch (error) {
               reject(error);
@@ -452,5 +540,10 @@ export const shareRecordingSummary = async (recording) => {
     return false;
   }
   const cleanedSummary = cleanSummaryMarkdown(recording.summary);
-  return showFormatSelectionAndShare(recording.title, () => cleanedSummary);
+  return showFormatSelectionAndShare(
+    recording.title,
+    () => cleanedSummary,
+    () => generateHTMLFromMarkdown(recording.title, cleanedSummary, recording.id),
+    recording.id
+  );
 }; 
\ No newline at end of file
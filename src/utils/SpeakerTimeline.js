@@ -0,0 +1,177 @@
+/**
+ * Speaker-diarization timeline.
+ *
+ * Collapses the per-word `speaker_id` values from the ElevenLabs response
+ * (`diarize: true`) into speaker turns. Turns come from a single audio stream,
+ * so they never overlap; keeping them sorted by start time lets every interval
+ * query run as a binary search instead of a scan.
+ */
+import RNFS from 'react-native-fs';
+
+// Words from the same speaker separated by less than this are merged into one turn
+const TURN_MERGE_GAP_MS = 1500;
+const TIMELINE_VERSION = 1;
+
+/**
+ * Build a speaker timeline from ElevenLabs words.
+ * @param {Array<Object>} words - `responseData.words` ({ text, type, start, end, speaker_id })
+ * @returns {Object|null} - { version, speakers, turns: [{ speakerId, startMs, endMs }] } or null
+ */
+export const buildSpeakerTimeline = (words) => {
+  if (!Array.isArray(words) || words.length === 0) {
+    return null;
+  }
+
+  const turns = [];
+  let current = null;
+
+  for (const word of words) {
+    if (!word || word.type !== 'word' || !word.speaker_id) {
+      continue;
+    }
+    const startMs = Math.round((word.start || 0) * 1000);
+    const endMs = Math.max(startMs, Math.round((word.end || 0) * 1000));
+
+    if (current && current.speakerId === word.speaker_id &&
+        startMs - current.endMs <= TURN_MERGE_GAP_MS) {
+      current.endMs = Math.max(current.endMs, endMs);
+      current.wordCount++;
+      continue;
+    }
+
+    // Clamp to the previous turn so the list stays sorted and non-overlapping
+    const clampedStart = current ? Math.max(startMs, current.endMs) : startMs;
+    current = {
+      speakerId: word.speaker_id,
+      startMs: clampedStart,
+      endMs: Math.max(clampedStart, endMs),
+      wordCount: 1,
+    };
+    turns.push(current);
+  }
+
+  if (turns.length === 0) {
+    return null;
+  }
+
+  return {
+    version: TIMELINE_VERSION,
+    speakers: getSpeakerStats({ turns }),
+    turns,
+  };
+};
+
+/**
+ * Total talk time and turn count per speaker, most talkative first.
+ * @param {Object} timeline - Speaker timeline
+ * @returns {Array<Object>} - [{ speakerId, totalMs, turnCount }]
+ */
+export const getSpeakerStats = (timeline) => {
+  const stats = new Map();
+  for (const turn of timeline?.turns || []) {
+    const entry = stats.get(turn.speakerId) || { speakerId: turn.speakerId, totalMs: 0, turnCount: 0 };
+    entry.totalMs += turn.endMs - turn.startMs;
+    entry.turnCount++;
+    stats.set(turn.speakerId, entry);
+  }
+  return [...stats.values()].sort((a, b) => b.totalMs - a.totalMs);
+};
+
+// Index of the first turn whose end is after timeMs
+const firstTurnEndingAfter = (turns, timeMs) => {
+  let lo = 0;
+  let hi = turns.length;
+  while (lo < hi) {
+    const mid = (lo + hi) >>> 1;
+    if (turns[mid].endMs <= timeMs) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+};
+
+/**
+ * Speaker talking at a given time.
+ * @param {Object} timeline - Speaker timeline
+ * @param {number} timeMs - Position in milliseconds
+ * @returns {string|null} - Speaker id, or null during silence
+ */
+export const speakerAtTime = (timeline, timeMs) => {
+  const turns = timeline?.turns || [];
+  const index = firstTurnEndingAfter(turns, timeMs);
+  const turn = turns[index];
+  return turn && turn.startMs <= timeMs ? turn.speakerId : null;
+};
+
+/**
+ * Turns overlapping [startMs, endMs).
+ * @param {Object} timeline - Speaker timeline
+ * @param {number} startMs - Range start in milliseconds
+ * @param {number} endMs - Range end in milliseconds
+ * @returns {Array<Object>} - Overlapping turns in time order
+ */
+export const turnsInRange = (timeline, startMs, endMs) => {
+  const turns = timeline?.turns || [];
+  const result = [];
+  for (let i = firstTurnEndingAfter(turns, startMs); i < turns.length && turns[i].startMs < endMs; i++) {
+    result.push(turns[i]);
+  }
+  return result;
+};
+
+/**
+ * Time ranges spoken by one speaker, with short gaps bridged so the
+ * extracted audio does not chop between breaths.
+ * @param {Object} timeline - Speaker timeline
+ * @param {string} speakerId - Speaker to keep
+ * @param {number} bridgeGapMs - Merge ranges separated by less than this
+ * @returns {Array<Object>} - [{ startMs, endMs }]
+ */
+export const rangesForSpeaker = (timeline, speakerId, bridgeGapMs = 500) => {
+  const ranges = [];
+  for (const turn of timeline?.turns || []) {
+    if (turn.speakerId !== speakerId) continue;
+    const last = ranges[ranges.length - 1];
+    if (last && turn.startMs - last.endMs <= bridgeGapMs) {
+      last.endMs = turn.endMs;
+    } else {
+      ranges.push({ startMs: turn.startMs, endMs: turn.endMs });
+    }
+  }
+  return ranges;
+};
+
+/**
+ * Save a timeline as JSON.
+ * @param {Object} timeline - Speaker timeline
+ * @param {string} filePath - Destination path
+ * @returns {Promise<string>} - The written file path
+ */
+export const saveSpeakerTimeline = async (timeline, filePath) => {
+  await RNFS.writeFile(filePath, JSON.stringify(timeline), 'utf8');
+  return filePath;
+};
+
+/**
+ * Load a timeline saved by saveSpeakerTimeline.
+ * @param {string} filePath - Path to the timeline file
+ * @returns {Promise<Object|null>} - Speaker timeline, or null if missing or invalid
+ */
+export const loadSpeakerTimeline = async (filePath) => {
+  try {
+    if (!filePath || !(await RNFS.exists(filePath))) {
+      return null;
+    }
+    const timeline = JSON.parse(await RNFS.readFile(filePath, 'utf8'));
+    if (timeline?.version !== TIMELINE_VERSION || !Array.isArray(timeline.turns)) {
+      console.warn('[SpeakerTimeline] Ignoring invalid speaker timeline:', filePath);
+      return null;
+    }
+    return timeline;
+  } catch (error) {
+    console.error('[SpeakerTimeline] Failed to load speaker timeline:', error);
+    return null;
+  }
+};
@@ -0,0 +1,136 @@
+/**
+ * Token-aware transcript parts for long-lesson summarization.
+ *
+ * A lesson whose transcript is too long for one summarization request is split
+ * into parts that are summarized in parallel and then merged. Only transcripts
+ * that would not fit are split: the merge has to write the whole summary again,
+ * so below the limit one request is as fast and reads better. Parts are built
+ * from the paragraph blocks of TranscriptChunks, so they end at speaker turns or
+ * sentence ends, and each one repeats the last few blocks of the one before it
+ * so no passage loses its context at a cut.
+ *
+ * Token counts are estimated in one pass over the text, following the way the
+ * GPT-4o family's BPE vocabularies split text: a word and the space before it
+ * are one token up to about six letters, digits go in groups of three, and
+ * punctuation and non-Latin characters cost roughly a token each. It is an
+ * estimate; the limits below leave room for its error.
+ */
+
+import { chunkTranscript } from './TranscriptChunks';
+
+// gpt-4o: 128k tokens of context, shared by the instructions, the transcript and the reply
+export const SINGLE_REQUEST_TOKENS = 90000; // up to this, the transcript goes in one request
+export const PART_TOKENS = 30000; // otherwise, parts of at most this many
+export const OVERLAP_TOKENS = 400; // repeated from the end of the previous part
+export const MERGE_INPUT_TOKENS = 12000; // part summaries past this are joined, not merged by the model (16k reply limit)
+
+const LETTERS_PER_TOKEN = 6;
+const ACCENTED_LETTERS_PER_TOKEN = 3;
+const DIGITS_PER_TOKEN = 3;
+
+const CLASS_SPACE = 0;
+const CLASS_NEWLINE = 1;
+const CLASS_LETTER = 2;
+const CLASS_ACCENTED = 3; // Latin letters outside ASCII: split into more pieces
+const CLASS_DIGIT = 4;
+const CLASS_OTHER = 5; // punctuation, symbols, other scripts: about a token each
+
+const charClass = (code) => {
+  if ((code >= 97 && code <= 122) || (code >= 65 && code <= 90) || code === 39) return CLASS_LETTER;
+  if (code === 32 || code === 9) return CLASS_SPACE;
+  if (code === 10 || code === 13) return CLASS_NEWLINE;
+  if (code >= 48 && code <= 57) return CLASS_DIGIT;
+  if (code >= 0xc0 && code <= 0x24f && code !== 0xd7 && code !== 0xf7) return CLASS_ACCENTED;
+  if (code === 0xa0 || (code >= 0x2000 && code <= 0x200a)) return CLASS_SPACE;
+  return CLASS_OTHER;
+};
+
+/**
+ * Estimate how many tokens a model's tokenizer makes of a span of text.
+ * @param {string} text - Text
+ * @param {number} start - First character (default 0)
+ * @param {number} end - Character after the last (default text.length)
+ * @returns {number} - Estimated token count
+ */
+export const estimateTokens = (text, start = 0, end = text ? text.length : 0) => {
+  let tokens = 0;
+  let i = start;
+  while (i < end) {
+    const kind = charClass(text.charCodeAt(i));
+    if (kind === CLASS_OTHER) {
+      tokens++;
+      i++;
+      continue;
+    }
+    const runStart = i;
+    let accented = 0;
+    while (i < end) {
+      const next = charClass(text.charCodeAt(i));
+      if (next === CLASS_ACCENTED && kind === CLASS_LETTER) {
+        accented++;
+      } else if (next !== kind && !(kind === CLASS_ACCENTED && next === CLASS_LETTER)) {
+        break;
+      }
+      i++;
+    }
+    const length = i - runStart;
+    if (kind === CLASS_LETTER || kind === CLASS_ACCENTED) {
+      tokens += accented > 0 || kind === CLASS_ACCENTED
+        ? Math.ceil(length / ACCENTED_LETTERS_PER_TOKEN)
+        : Math.ceil(length / LETTERS_PER_TOKEN);
+    } else if (kind === CLASS_DIGIT) {
+      tokens += Math.ceil(length / DIGITS_PER_TOKEN);
+    } else if (kind === CLASS_NEWLINE || length > 1) {
+      tokens++; // a single space rides on the next word
+    }
+  }
+  return tokens;
+};
+
+/**
+ * Split a transcript into overlapping parts for parallel summarization.
+ * @param {string} transcript - Full transcript text
+ * @param {Object} options - { alignmentIndex, timeline } to cut at speaker turns (see
+ *   chunkTranscript), { singleRequestTokens, partTokens, overlapTokens } to override the limits
+ * @returns {Object|null} - { totalTokens, parts: [{ start, end, newStart, tokens }] }, where
+ *   [start, end) is the text to send and new material begins at newStart; null when the
+ *   transcript fits in one request
+ */
+export const planSummaryParts = (transcript, {
+  alignmentIndex = null,
+  timeline = null,
+  singleRequestTokens = SINGLE_REQUEST_TOKENS,
+  partTokens = PART_TOKENS,
+  overlapTokens = OVERLAP_TOKENS,
+} = {}) => {
+  const chunks = chunkTranscript(transcript, { alignmentIndex, timeline });
+  if (!chunks) return null;
+  const { blocks } = chunks;
+  const tokens = new Uint32Array(blocks.length);
+  let totalTokens = 0;
+  for (let b = 0; b < blocks.length; b++) {
+    tokens[b] = estimateTokens(transcript, blocks[b].start, blocks[b].end) + 1; // + the break before it
+    totalTokens += tokens[b];
+  }
+  if (totalTokens <= singleRequestTokens) return null;
+
+  // A part always takes at least one new block, so this ends even with tiny limits
+  const limit = Math.max(partTokens, overlapTokens * 2);
+  const parts = [];
+  let first = 0; // first block of the part, including the overlap
+  let fresh = 0; // first block not in the previous part
+  while (fresh < blocks.length) {
+    let sum = 0;
+    for (let b = first; b < fresh; b++) sum += tokens[b];
+    let end = fresh;
+    while (end < blocks.length && (end === fresh || sum + tokens[end] <= limit)) sum += tokens[end++];
+    parts.push({ start: blocks[first].start, end: blocks[end - 1].end, newStart: blocks[fresh].start, tokens: sum });
+
+    // The next part starts with the trailing blocks of this one that fit in the overlap
+    let overlap = 0;
+    first = end;
+    while (first > fresh + 1 && overlap + tokens[first - 1] <= overlapTokens) overlap += tokens[--first];
+    fresh = end;
+  }
+  return { totalTokens, parts };
+};
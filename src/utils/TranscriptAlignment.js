@@ -0,0 +1,228 @@
+/**
+ * Transcript-to-audio alignment index.
+ *
+ * Maps character offsets in a transcript to audio time and back using the
+ * word-level timestamps returned by ElevenLabs (`timestamps_granularity: "word"`).
+ * Words are stored as parallel sorted arrays so both directions are a binary
+ * search, and the whole index round-trips through a compact binary file.
+ */
+import RNFS from 'react-native-fs';
+
+// File layout (little-endian uint32): [magic, version, wordCount, transcriptLength,
+// charStart[n], charEnd[n], startMs[n], endMs[n]]
+const ALIGNMENT_MAGIC = 0x49415341; // 'ASAI'
+const ALIGNMENT_VERSION = 1;
+const HEADER_WORDS = 4;
+
+/**
+ * Build an alignment index from an ElevenLabs transcription response.
+ * @param {string} transcript - Full transcript text (`responseData.text`)
+ * @param {Array<Object>} words - `responseData.words` ({ text, type, start, end })
+ * @returns {Object|null} - Index with parallel typed arrays, or null if no words could be aligned
+ */
+export const buildAlignmentIndex = (transcript, words) => {
+  if (!transcript || !Array.isArray(words) || words.length === 0) {
+    return null;
+  }
+
+  const charStart = new Uint32Array(words.length);
+  const charEnd = new Uint32Array(words.length);
+  const startMs = new Uint32Array(words.length);
+  const endMs = new Uint32Array(words.length);
+
+  let count = 0;
+  let cursor = 0;
+  let lastStartMs = 0;
+
+  for (const word of words) {
+    // Spacing and audio-event entries carry no searchable text
+    if (!word || word.type !== 'word' || !word.text) {
+      continue;
+    }
+    const offset = transcript.indexOf(word.text, cursor);
+    if (offset === -1) {
+      continue;
+    }
+
+    // Keep start times monotonic so the time -> word search stays valid
+    const wordStartMs = Math.max(lastStartMs, Math.round((word.start || 0) * 1000));
+    const wordEndMs = Math.max(wordStartMs, Math.round((word.end || 0) * 1000));
+
+    charStart[count] = offset;
+    charEnd[count] = offset + word.text.length;
+    startMs[count] = wordStartMs;
+    endMs[count] = wordEndMs;
+    lastStartMs = wordStartMs;
+    cursor = offset + word.text.length;
+    count++;
+  }
+
+  if (count === 0) {
+    return null;
+  }
+
+  return {
+    count,
+    transcriptLength: transcript.length,
+    charStart: charStart.subarray(0, count),
+    charEnd: charEnd.subarray(0, count),
+    startMs: startMs.subarray(0, count),
+    endMs: endMs.subarray(0, count),
+  };
+};
+
+// Index of the last element <= value, or -1 if every element is greater
+const upperBoundIndex = (array, count, value) => {
+  let lo = 0;
+  let hi = count;
+  while (lo < hi) {
+    const mid = (lo + hi) >>> 1;
+    if (array[mid] <= value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo - 1;
+};
+
+/**
+ * Find the word containing (or immediately preceding) a character offset.
+ * @param {Object} index - Alignment index
+ * @param {number} offset - Character offset in the transcript
+ * @returns {number} - Word index, or -1 if the offset precedes the first word
+ */
+export const wordIndexAtOffset = (index, offset) => {
+  if (!index) return -1;
+  return upperBoundIndex(index.charStart, index.count, offset);
+};
+
+/**
+ * Find the word being spoken at a playback position.
+ * @param {Object} index - Alignment index
+ * @param {number} timeMs - Playback position in milliseconds
+ * @returns {number} - Word index, or -1 if playback has not reached the first word
+ */
+export const wordIndexAtTime = (index, timeMs) => {
+  if (!index) return -1;
+  return upperBoundIndex(index.startMs, index.count, timeMs);
+};
+
+/**
+ * Audio time (ms) at which the word covering a character offset starts.
+ * @param {Object} index - Alignment index
+ * @param {number} offset - Character offset in the transcript
+ * @returns {number|null} - Start time in milliseconds, or null if unaligned
+ */
+export const timeForOffset = (index, offset) => {
+  const wordIndex = wordIndexAtOffset(index, offset);
+  return wordIndex >= 0 ? index.startMs[wordIndex] : null;
+};
+
+// --- Binary persistence ---
+
+const BASE64_ALPHABET = 'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/';
+const BASE64_LOOKUP = new Uint8Array(128);
+for (let i = 0; i < BASE64_ALPHABET.length; i++) {
+  BASE64_LOOKUP[BASE64_ALPHABET.charCodeAt(i)] = i;
+}
+
+const bytesToBase64 = (bytes) => {
+  const parts = [];
+  let chunk = '';
+  let i = 0;
+  for (; i + 2 < bytes.length; i += 3) {
+    const n = (bytes[i] << 16) | (bytes[i + 1] << 8) | bytes[i + 2];
+    chunk += BASE64_ALPHABET[(n >> 18) & 63] + BASE64_ALPHABET[(n >> 12) & 63] +
+      BASE64_ALPHABET[(n >> 6) & 63] + BASE64_ALPHABET[n & 63];
+    if (chunk.length >= 8192) {
+      parts.push(chunk);
+      chunk = '';
+    }
+  }
+  const remaining = bytes.length - i;
+  if (remaining === 1) {
+    const n = bytes[i] << 16;
+    chunk += BASE64_ALPHABET[(n >> 18) & 63] + BASE64_ALPHABET[(n >> 12) & 63] + '==';
+  } else if (remaining === 2) {
+    const n = (bytes[i] << 16) | (bytes[i + 1] << 8);
+    chunk += BASE64_ALPHABET[(n >> 18) & 63] + BASE64_ALPHABET[(n >> 12) & 63] +
+      BASE64_ALPHABET[(n >> 6) & 63] + '=';
+  }
+  parts.push(chunk);
+  return parts.join('');
+};
+
+const base64ToBytes = (base64) => {
+  const clean = base64.replace(/[^A-Za-z0-9+/]/g, '');
+  const bytes = new Uint8Array(Math.floor((clean.length * 3) / 4));
+  let byteIndex = 0;
+  for (let i = 0; i < clean.length; i += 4) {
+    const n = (BASE64_LOOKUP[clean.charCodeAt(i)] << 18) |
+      (BASE64_LOOKUP[clean.charCodeAt(i + 1)] << 12) |
+      (BASE64_LOOKUP[clean.charCodeAt(i + 2)] << 6) |
+      BASE64_LOOKUP[clean.charCodeAt(i + 3)];
+    bytes[byteIndex++] = (n >> 16) & 255;
+    if (i + 2 < clean.length) bytes[byteIndex++] = (n >> 8) & 255;
+    if (i + 3 < clean.length) bytes[byteIndex++] = n & 255;
+  }
+  return bytes.subarray(0, byteIndex);
+};
+
+/**
+ * Serialize an alignment index to a binary file.
+ * @param {Object} index - Alignment index
+ * @param {string} filePath - Destination path
+ * @returns {Promise<string>} - The written file path
+ */
+export const saveAlignmentIndex = async (index, filePath) => {
+  const { count } = index;
+  const words = new Uint32Array(HEADER_WORDS + count * 4);
+  words[0] = ALIGNMENT_MAGIC;
+  words[1] = ALIGNMENT_VERSION;
+  words[2] = count;
+  words[3] = index.transcriptLength;
+  words.set(index.charStart, HEADER_WORDS);
+  words.set(index.charEnd, HEADER_WORDS + count);
+  words.set(index.startMs, HEADER_WORDS + count * 2);
+  words.set(index.endMs, HEADER_WORDS + count * 3);
+
+  await RNFS.writeFile(filePath, bytesToBase64(new Uint8Array(words.buffer)), 'base64');
+  return filePath;
+};
+
+/**
+ * Load an alignment index previously written by saveAlignmentIndex.
+ * @param {string} filePath - Path to the binary index
+ * @returns {Promise<Object|null>} - Alignment index, or null if missing or invalid
+ */
+export const loadAlignmentIndex = async (filePath) => {
+  try {
+    if (!filePath || !(await RNFS.exists(filePath))) {
+      return null;
+    }
+    const bytes = base64ToBytes(await RNFS.readFile(filePath, 'base64'));
+    if (bytes.length < HEADER_WORDS * 4 || bytes.length % 4 !== 0) {
+      return null;
+    }
+    // Copy into a fresh buffer so the Uint32Array view is 4-byte aligned
+    const words = new Uint32Array(bytes.slice().buffer);
+    const count = words[2];
+    if (words[0] !== ALIGNMENT_MAGIC || words[1] !== ALIGNMENT_VERSION ||
+        words.length !== HEADER_WORDS + count * 4) {
+      console.warn('[TranscriptAlignment] Ignoring invalid alignment index:', filePath);
+      return null;
+    }
+    return {
+      count,
+      transcriptLength: words[3],
+      charStart: words.subarray(HEADER_WORDS, HEADER_WORDS + count),
+      charEnd: words.subarray(HEADER_WORDS + count, HEADER_WORDS + count * 2),
+      startMs: words.subarray(HEADER_WORDS + count * 2, HEADER_WORDS + count * 3),
+      endMs: words.subarray(HEADER_WORDS + count * 3, HEADER_WORDS + count * 4),
+    };
+  } catch (error) {
+    console.error('[TranscriptAlignment] Failed to load alignment index:', error);
+    return null;
+  }
+};
@@ -0,0 +1,128 @@
+/**
+ * Transcript blocks for virtualized rendering.
+ *
+ * Splits a transcript into paragraph-sized blocks so the detail screen lays out
+ * only the blocks on screen instead of one text node for the whole lesson.
+ * Blocks end at speaker turns when a diarization timeline is available, else at
+ * line breaks or sentence ends once a block is long enough. Each block keeps its
+ * character range and, with an alignment index, its word range, so the playing
+ * word maps to its block with a binary search. One pass over the text.
+ */
+
+const TARGET_BLOCK_CHARS = 600; // start looking for a sentence end here
+const MAX_BLOCK_CHARS = 1500; // cut at the last space before this
+const MIN_BLOCK_CHARS = 80; // line breaks closer than this to the block start stay in it
+
+const SENTENCE_END = /[.!?…]["'”’)\]]*\s+/g;
+const WHITESPACE = /\s/;
+
+// Character offsets where a new speaker turn starts (the first word at or after each turn)
+const turnBreakOffsets = (transcript, alignmentIndex, timeline) => {
+  const turns = timeline?.turns;
+  if (!turns || turns.length < 2 || !alignmentIndex || alignmentIndex.transcriptLength !== transcript.length) {
+    return [];
+  }
+  const offsets = [];
+  let word = 0;
+  for (let t = 1; t < turns.length; t++) {
+    if (turns[t].speakerId === turns[t - 1].speakerId) continue;
+    while (word < alignmentIndex.count && alignmentIndex.startMs[word] < turns[t].startMs) word++;
+    if (word === alignmentIndex.count) break;
+    const offset = alignmentIndex.charStart[word];
+    if (offsets.length === 0 || offset > offsets[offsets.length - 1]) offsets.push(offset);
+  }
+  return offsets;
+};
+
+// Where the block starting at `start` ends: a turn, a line break, a sentence end, a space
+const findBlockEnd = (transcript, start, nextTurn, options) => {
+  const length = transcript.length;
+  const limit = Math.min(length, start + options.maxChars);
+  if (nextTurn <= limit) return nextTurn; // every speaker turn starts a block, however short
+  if (limit === length && length - start <= options.targetChars) return length;
+
+  // The next line break is remembered, so a transcript without any is not rescanned per block
+  if (options.lineBreak !== -1 && options.lineBreak < start + MIN_BLOCK_CHARS) {
+    options.lineBreak = transcript.indexOf('\n', start + MIN_BLOCK_CHARS);
+  }
+  if (options.lineBreak !== -1 && options.lineBreak < limit) return options.lineBreak + 1;
+
+  // Search only up to the limit, so text without punctuation stays linear
+  const from = start + options.targetChars;
+  SENTENCE_END.lastIndex = 0;
+  const sentence = SENTENCE_END.exec(transcript.substring(from, limit));
+  if (sentence) return from + sentence.index + sentence[0].length;
+  if (limit === length) return length;
+
+  for (let i = limit - 1; i > start + MIN_BLOCK_CHARS; i--) {
+    if (WHITESPACE.test(transcript[i])) return i + 1;
+  }
+  return limit;
+};
+
+/**
+ * Split a transcript into blocks.
+ * @param {string} transcript - Full transcript text
+ * @param {Object} options - { alignmentIndex, timeline, targetChars, maxChars }; the
+ *   alignment index is only used when it was built for this transcript
+ * @returns {Object|null} - { count, transcriptLength, blocks: [{ key, start, end, firstWord, wordEnd }] },
+ *   where [start, end) excludes surrounding whitespace and [firstWord, wordEnd) are
+ *   the aligned words inside it (0/0 without an index)
+ */
+export const chunkTranscript = (transcript, {
+  alignmentIndex = null,
+  timeline = null,
+  targetChars = TARGET_BLOCK_CHARS,
+  maxChars = MAX_BLOCK_CHARS,
+} = {}) => {
+  if (!transcript) return null;
+  const index = alignmentIndex && alignmentIndex.transcriptLength === transcript.length ? alignmentIndex : null;
+  const turnBreaks = turnBreakOffsets(transcript, index, timeline);
+  const options = { targetChars, maxChars: Math.max(maxChars, targetChars + MIN_BLOCK_CHARS), lineBreak: 0 };
+
+  const blocks = [];
+  let turn = 0;
+  let word = 0;
+  let cursor = 0;
+  while (cursor < transcript.length) {
+    let start = cursor;
+    while (start < transcript.length && WHITESPACE.test(transcript[start])) start++;
+    if (start === transcript.length) break;
+
+    while (turn < turnBreaks.length && turnBreaks[turn] <= start) turn++;
+    const boundary = findBlockEnd(transcript, start, turn < turnBreaks.length ? turnBreaks[turn] : Infinity, options);
+    let end = boundary;
+    while (end > start && WHITESPACE.test(transcript[end - 1])) end--;
+
+    const firstWord = word;
+    if (index) {
+      while (word < index.count && index.charStart[word] < boundary) word++;
+    }
+    blocks.push({ key: `b${start}`, start, end, firstWord, wordEnd: word });
+    cursor = boundary;
+  }
+
+  return { count: blocks.length, transcriptLength: transcript.length, blocks };
+};
+
+/**
+ * Block containing a word.
+ * @param {Object} chunks - Result of chunkTranscript
+ * @param {number} wordIndex - Word index in the alignment index
+ * @returns {number} - Block index, or -1 if no block holds the word
+ */
+export const blockIndexForWord = (chunks, wordIndex) => {
+  if (!chunks || wordIndex < 0) return -1;
+  const { blocks } = chunks;
+  let lo = 0;
+  let hi = blocks.length;
+  while (lo < hi) {
+    const mid = (lo + hi) >>> 1;
+    if (blocks[mid].wordEnd <= wordIndex) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo < blocks.length && blocks[lo].firstWord <= wordIndex ? lo : -1;
+};
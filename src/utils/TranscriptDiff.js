@@ -0,0 +1,209 @@
+/**
+ * Word-level transcript diff.
+ *
+ * Finds which spans of a transcript changed between two versions (an edit or
+ * a re-transcription), so only those spans need to be summarized again. Words
+ * are interned to integers and compared with Myers' O(ND) algorithm in its
+ * linear-space form (middle snake, divide and conquer), after trimming the
+ * common prefix and suffix of every sub-range. Changes come back as hunks of
+ * word indices into both versions, with each word's character offsets.
+ */
+
+// Give up (and let the caller fall back to a full pass) past this many word edits
+const DEFAULT_MAX_EDITS = 20000;
+
+const TOO_MANY_EDITS = Symbol('tooManyEdits');
+
+// The characters \s matches
+const isSpace = (code) => code === 32 || (code >= 9 && code <= 13) || code === 0xa0 || code === 0x1680
+  || (code >= 0x2000 && code <= 0x200a) || code === 0x2028 || code === 0x2029 || code === 0x202f
+  || code === 0x205f || code === 0x3000 || code === 0xfeff;
+
+const grow = (array) => {
+  const grown = new array.constructor(array.length * 2);
+  grown.set(array);
+  return grown;
+};
+
+/**
+ * Split text into words (runs of non-whitespace) with their character offsets.
+ * @param {string} text - Transcript text
+ * @param {Map} dictionary - Optional word -> id map, shared across calls so equal words get equal ids
+ * @returns {Object} - { count, starts: Uint32Array, ends: Uint32Array, ids: Int32Array|null }
+ */
+export const tokenizeWords = (text, dictionary = null) => {
+  const source = text || '';
+  let starts = new Uint32Array(Math.max(16, Math.min(1 << 16, source.length >> 2)));
+  let ends = new Uint32Array(starts.length);
+  let ids = dictionary ? new Int32Array(starts.length) : null;
+  let count = 0;
+  let i = 0;
+  while (i < source.length) {
+    while (i < source.length && isSpace(source.charCodeAt(i))) i++;
+    if (i === source.length) break;
+    const start = i;
+    while (i < source.length && !isSpace(source.charCodeAt(i))) i++;
+    if (count === starts.length) {
+      starts = grow(starts);
+      ends = grow(ends);
+      if (ids) ids = grow(ids);
+    }
+    starts[count] = start;
+    ends[count] = i;
+    if (ids) {
+      const word = source.substring(start, i);
+      let id = dictionary.get(word);
+      if (id === undefined) {
+        id = dictionary.size;
+        dictionary.set(word, id);
+      }
+      ids[count] = id;
+    }
+    count++;
+  }
+  return {
+    count,
+    starts: starts.subarray(0, count),
+    ends: ends.subarray(0, count),
+    ids: ids ? ids.subarray(0, count) : null,
+  };
+};
+
+// The middle snake of a[aStart, aEnd) vs b[bStart, bEnd): a point on an optimal
+// edit path, searched from both ends at once. Null when the ranges share nothing.
+const bisect = (a, aStart, aEnd, b, bStart, bEnd, maxHalfEdits) => {
+  const n = aEnd - aStart;
+  const m = bEnd - bStart;
+  const maxD = Math.ceil((n + m) / 2);
+  const vOffset = maxD + 1;
+  const vLength = 2 * maxD + 3;
+  const v1 = new Int32Array(vLength).fill(-1);
+  const v2 = new Int32Array(vLength).fill(-1);
+  v1[vOffset + 1] = 0;
+  v2[vOffset + 1] = 0;
+  const delta = n - m;
+  const front = delta % 2 !== 0; // the forward path detects the overlap when delta is odd
+  let k1start = 0;
+  let k1end = 0;
+  let k2start = 0;
+  let k2end = 0;
+
+  for (let d = 0; d < maxD; d++) {
+    if (d > maxHalfEdits) throw TOO_MANY_EDITS;
+    for (let k1 = -d + k1start; k1 <= d - k1end; k1 += 2) {
+      const k1Offset = vOffset + k1;
+      let x1 = k1 === -d || (k1 !== d && v1[k1Offset - 1] < v1[k1Offset + 1])
+        ? v1[k1Offset + 1]
+        : v1[k1Offset - 1] + 1;
+      let y1 = x1 - k1;
+      while (x1 < n && y1 < m && a[aStart + x1] === b[bStart + y1]) {
+        x1++;
+        y1++;
+      }
+      v1[k1Offset] = x1;
+      if (x1 > n) {
+        k1end += 2; // ran off the right
+      } else if (y1 > m) {
+        k1start += 2; // ran off the bottom
+      } else if (front) {
+        const k2Offset = vOffset + delta - k1;
+        if (k2Offset >= 0 && k2Offset < vLength && v2[k2Offset] !== -1 && x1 >= n - v2[k2Offset]) {
+          return [aStart + x1, bStart + y1];
+        }
+      }
+    }
+
+    for (let k2 = -d + k2start; k2 <= d - k2end; k2 += 2) {
+      const k2Offset = vOffset + k2;
+      let x2 = k2 === -d || (k2 !== d && v2[k2Offset - 1] < v2[k2Offset + 1])
+        ? v2[k2Offset + 1]
+        : v2[k2Offset - 1] + 1;
+      let y2 = x2 - k2;
+      while (x2 < n && y2 < m && a[aEnd - x2 - 1] === b[bEnd - y2 - 1]) {
+        x2++;
+        y2++;
+      }
+      v2[k2Offset] = x2;
+      if (x2 > n) {
+        k2end += 2;
+      } else if (y2 > m) {
+        k2start += 2;
+      } else if (!front) {
+        const k1Offset = vOffset + delta - k2;
+        if (k1Offset >= 0 && k1Offset < vLength && v1[k1Offset] !== -1) {
+          const x1 = v1[k1Offset];
+          const y1 = x1 - (k1Offset - vOffset);
+          if (x1 >= n - x2) {
+            return [aStart + x1, bStart + y1];
+          }
+        }
+      }
+    }
+  }
+  return null;
+};
+
+const pushHunk = (hunks, oldStart, oldEnd, newStart, newEnd) => {
+  const last = hunks[hunks.length - 1];
+  if (last && last.oldEnd === oldStart && last.newEnd === newStart) {
+    last.oldEnd = oldEnd;
+    last.newEnd = newEnd;
+    return;
+  }
+  hunks.push({ oldStart, oldEnd, newStart, newEnd });
+};
+
+const diffRange = (a, aStart, aEnd, b, bStart, bEnd, hunks, maxHalfEdits) => {
+  while (aStart < aEnd && bStart < bEnd && a[aStart] === b[bStart]) {
+    aStart++;
+    bStart++;
+  }
+  while (aEnd > aStart && bEnd > bStart && a[aEnd - 1] === b[bEnd - 1]) {
+    aEnd--;
+    bEnd--;
+  }
+  if (aStart === aEnd && bStart === bEnd) return;
+  if (aStart === aEnd || bStart === bEnd) {
+    pushHunk(hunks, aStart, aEnd, bStart, bEnd);
+    return;
+  }
+  const split = bisect(a, aStart, aEnd, b, bStart, bEnd, maxHalfEdits);
+  if (!split) {
+    pushHunk(hunks, aStart, aEnd, bStart, bEnd);
+    return;
+  }
+  diffRange(a, aStart, split[0], b, bStart, split[1], hunks, maxHalfEdits);
+  diffRange(a, split[0], aEnd, b, split[1], bEnd, hunks, maxHalfEdits);
+};
+
+/**
+ * Diff two transcript versions word by word.
+ * @param {string} oldText - Previous transcript
+ * @param {string} newText - Current transcript
+ * @param {Object} options - { maxEdits, maxEditRatio }: give up past this many word insertions
+ *   + deletions, or past this fraction of the new transcript's word count
+ * @returns {Object|null} - { hunks: [{ oldStart, oldEnd, newStart, newEnd }], oldWords, newWords,
+ *   editedWords } with hunks in word indices (see tokenizeWords), or null past maxEdits
+ */
+export const diffTranscripts = (oldText, newText, { maxEdits = DEFAULT_MAX_EDITS, maxEditRatio = Infinity } = {}) => {
+  const dictionary = new Map();
+  const oldWords = tokenizeWords(oldText, dictionary);
+  const newWords = oldText === newText ? oldWords : tokenizeWords(newText, dictionary);
+  const editLimit = Math.min(maxEdits, Math.ceil(maxEditRatio * Math.max(1, newWords.count)));
+
+  const hunks = [];
+  try {
+    if (newWords !== oldWords) {
+      diffRange(oldWords.ids, 0, oldWords.count, newWords.ids, 0, newWords.count, hunks, Math.ceil(editLimit / 2));
+    }
+  } catch (error) {
+    if (error === TOO_MANY_EDITS) return null;
+    throw error;
+  }
+
+  let editedWords = 0;
+  for (const hunk of hunks) {
+    editedWords += (hunk.oldEnd - hunk.oldStart) + (hunk.newEnd - hunk.newStart);
+  }
+  return editedWords > editLimit ? null : { hunks, oldWords, newWords, editedWords };
+};